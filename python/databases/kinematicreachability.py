@@ -67,6 +67,7 @@ from . import convexdecomposition, inversekinematics
 import numpy
 import time
 import os.path
+import tempfile
 from os import makedirs
 from heapq import nsmallest # for nth smallest element
 from optparse import OptionParser
@@ -226,6 +227,7 @@ class ReachabilityModel(DatabaseGenerator):
         xyzdelta=None
         quatdelta=None
         usefreespace=False
+        numthreads=None
         if options is not None:
             if options.maxradius is not None:
                 maxradius = options.maxradius
@@ -234,6 +236,7 @@ class ReachabilityModel(DatabaseGenerator):
             if options.quatdelta is not None:
                 quatdelta=options.quatdelta
             usefreespace=options.usefreespace
+            numthreads=options.numthreads
         if self.robot.GetKinematicsGeometryHash() == 'e829feb384e6417bbf5bd015f1c6b49a' or self.robot.GetKinematicsGeometryHash() == '22548f4f2ecf83e88ae7e2f3b2a0bd08': # wam 7dof
             if maxradius is None:
                 maxradius = 1.1
@@ -242,7 +245,7 @@ class ReachabilityModel(DatabaseGenerator):
                 xyzdelta = 0.03
             if quatdelta is None:
                 quatdelta = 0.2
-        return maxradius,translationonly,xyzdelta,quatdelta,usefreespace
+        return maxradius,translationonly,xyzdelta,quatdelta,usefreespace,numthreads
 
     def getOrderedArmJoints(self):
         return [j for j in self.robot.GetDependencyOrderedJoints() if j.GetJointIndex() in self.manip.GetArmIndices()]
@@ -268,8 +271,10 @@ class ReachabilityModel(DatabaseGenerator):
                     links.append(newlink)
         return links
 
-    def generatepcg(self,maxradius=None,translationonly=False,xyzdelta=None,quatdelta=None,usefreespace=False):
-        """Generate producer, consumer, and gatherer functions allowing parallelization
+    def _samplePoses(self,maxradius=None,translationonly=False,xyzdelta=None,quatdelta=None,usefreespace=False):
+        """Samples the end effector positions and rotations of the reachability map
+
+        :return: robot transform placing the manipulator base at the origin, base anchor, all points, indices of the points inside the radius, grid shape, quaternions, rotation matrices
         """
         if not self.ikmodel.load():
             self.ikmodel.autogenerate()
@@ -311,7 +316,13 @@ class ReachabilityModel(DatabaseGenerator):
                     neighdists.append(nsmallest(2,quatArrayTDist(q,qarray))[1])
                 self.quatdelta = mean(neighdists)
             log.info('radius: %f, xyzsamples: %d, quatdelta: %f, rot samples: %d, freespace: %d',maxradius,len(insideinds),self.quatdelta,len(rotations),usefreespace)
-            
+        quats = array([[1.0,0,0,0]]) if translationonly else qarray
+        return Trobot,baseanchor,allpoints,insideinds,shape,quats,rotations
+
+    def generatepcg(self,maxradius=None,translationonly=False,xyzdelta=None,quatdelta=None,usefreespace=False):
+        """Generate producer, consumer, and gatherer functions allowing parallelization
+        """
+        Trobot,baseanchor,allpoints,insideinds,shape,quats,rotations = self._samplePoses(maxradius,translationonly,xyzdelta,quatdelta,usefreespace)
         self.reachabilitydensity3d = zeros(prod(shape))
         self.reachability3d = zeros(prod(shape))
         self.reachabilitystats = []
@@ -358,6 +369,46 @@ class ReachabilityModel(DatabaseGenerator):
 
         return producer, consumer, gatherer, len(insideinds)
 
+    def generate(self,maxradius=None,translationonly=False,xyzdelta=None,quatdelta=None,usefreespace=False,numthreads=None):
+        """Computes the reachability map with the ComputeReachability command of the ikfast module, which solves the poses on several threads.
+
+        Falls back to the producer/consumer/gatherer functions of :meth:`generatepcg` if the ikfast module is not available.
+
+        :param numthreads: number of threads solving the ik, if None uses all the cores
+        """
+        if self.ikmodel.ikfastproblem is None:
+            return DatabaseGenerator.generate(self,maxradius,translationonly,xyzdelta,quatdelta,usefreespace)
+
+        starttime = time.time()
+        Trobot,baseanchor,allpoints,insideinds,shape,quats,rotations = self._samplePoses(maxradius,translationonly,xyzdelta,quatdelta,usefreespace)
+        points = allpoints[insideinds]+baseanchor
+        log.info('database %s has %d items',self.__class__.__name__.split()[-1],len(insideinds))
+        cmd = 'ComputeReachability robot %s manip %s usefreespace %d '%(self.robot.GetName(),self.manip.GetName(),usefreespace)
+        if numthreads is not None:
+            cmd += 'numthreads %d '%numthreads
+        statsfile,statsfilename = tempfile.mkstemp(suffix='.stats')
+        os.close(statsfile)
+        cmd += 'statsfile %s rotations %d %s points %d %s'%(statsfilename,len(quats),' '.join(str(f) for f in quats.flat),len(points),' '.join(str(f) for f in points.flat))
+        with self.env:
+            with self.robot:
+                # same state as the consumer of generatepcg, the links disabled by _samplePoses are enabled again
+                self.robot.SetTransform(Trobot)
+                res = self.ikmodel.ikfastproblem.SendCommand(cmd)
+        if res is None:
+            os.remove(statsfilename)
+            raise ValueError('failed to compute reachability')
+
+        results = reshape(array([int(s) for s in res.split()]),(len(points),2))
+        self.reachabilitydensity3d = zeros(prod(shape))
+        self.reachability3d = zeros(prod(shape))
+        self.reachabilitydensity3d[insideinds] = results[:,0]/float(len(rotations))
+        self.reachability3d[insideinds] = results[:,1]/float(len(rotations))
+        self.reachability3d = reshape(self.reachability3d,shape)
+        self.reachabilitydensity3d = reshape(self.reachabilitydensity3d,shape)
+        self.reachabilitystats = numpy.fromfile(statsfilename,dtype='<f8').reshape(-1,8)
+        os.remove(statsfilename)
+        log.info('database %s finished in %fs',self.__class__.__name__,time.time()-starttime)
+
 
     def show(self,showrobot=True,contours=[0.01,0.1,0.2,0.5,0.8,0.9,0.99],opacity=None,figureid=1, xrange=None,options=None):
         try:
@@ -423,6 +474,8 @@ class ReachabilityModel(DatabaseGenerator):
                           help='The max radius of the arm to perform the computation (default=0.5)')
         parser.add_option('--usefreespace',action='store_true',dest='usefreespace',default=False,
                           help='If set, will record the number of IK solutions that exist for every transform rather than just finding one. More useful map, but much slower to produce')
+        parser.add_option('--numthreads',action='store',type='int',dest='numthreads',default=None,
+                          help='Number of threads computing the ik solutions, uses all the cores if not set')
         parser.add_option('--showscale',action='store',type='float',dest='showscale',default=1.0,
                           help='Scales the reachability by this much in order to show colors better (default=%default)')
         return parser
@@ -65,11 +65,13 @@ class TaskManipulation:
         self.robot = robot
         return self.prob.SendCommand(u'setrobot '+robot.GetName())
     
-    def GraspPlanning(self,graspindices=None,grasps=None,target=None,approachoffset=0,destposes=None,seedgrasps=None,seeddests=None,seedik=None,maxiter=None,randomgrasps=None,randomdests=None, execute=None,outputtraj=None,grasptranslationstepmult=None,graspfinestep=None,outputtrajobj=None,gmodel=None,paddedgeometryinfo=None,steplength=None,releasegil=False):
+    def GraspPlanning(self,graspindices=None,grasps=None,target=None,approachoffset=0,destposes=None,seedgrasps=None,seeddests=None,seedik=None,maxiter=None,randomgrasps=None,randomdests=None, execute=None,outputtraj=None,grasptranslationstepmult=None,graspfinestep=None,outputtrajobj=None,gmodel=None,paddedgeometryinfo=None,steplength=None,numthreads=None,maxfeasiblegrasps=None,releasegil=False):
         """See :ref:`module-taskmanipulation-graspplanning`
 
         If gmodel is specified, then do not have to fill graspindices, grasps, target, grasptranslationstepmult, graspfinestep
         :param paddedgeometryinfo: (groupname, padding)
+        :param numthreads: if > 1, evaluates the grasps in parallel on that many cloned environments before planning them
+        :param maxfeasiblegrasps: number of feasible grasps every parallel evaluation looks for, defaults to seedgrasps
         """
         if gmodel is not None:
             if target is None:
@@ -124,6 +126,10 @@ class TaskManipulation:
             cmd.write('execute %d '%execute)
         if paddedgeometryinfo is not None:
             cmd.write('paddedgeometryinfo %s %f '%tuple(paddedgeometryinfo))
+        if numthreads is not None:
+            cmd.write('numthreads %d '%numthreads)
+        if maxfeasiblegrasps is not None:
+            cmd.write('maxfeasiblegrasps %d '%maxfeasiblegrasps)
         if (outputtraj is not None and outputtraj) or (outputtrajobj is not None and outputtrajobj):
             cmd.write('outputtraj ')
         res = self.prob.SendCommand(cmd.getvalue(),releasegil=releasegil)
@@ -129,6 +129,17 @@ class VisualFeedback:
         
         return int(res)
     
+    def ComputeVisibilitySamples(self):
+        """See :ref:`module-visualfeedback-computevisibilitysamples`
+
+        :return: Nx3 array of the x, y of every sample of the target on the z=1 plane of the camera and 1 if it is visible, 0 otherwise
+        """
+        res = self.prob.SendCommand('ComputeVisibilitySamples ')
+        if res is None:
+            raise PlanningError()
+        
+        return numpy.reshape(numpy.array([numpy.float(s) for s in res.split()],numpy.float),(-1,3))
+    
     def ComputeVisibleConfiguration(self,pose):
         """See :ref:`module-visualfeedback-computevisibleconfiguration`
         """
@@ -204,7 +215,7 @@ class VisualFeedback:
         if res is None:
             raise PlanningError()
         return res
-    def SetParameter(self,raydensity=None,raymindist=None,allowableocclusion=None):
+    def SetParameter(self,raydensity=None,raymindist=None,allowableocclusion=None,usedepthbuffer=None,depthbufferscale=None):
         """See :ref:`module-visualfeedback-setparameter`
         """
         cmd = 'SetParameter '
@@ -214,4 +225,8 @@ class VisualFeedback:
             cmd += 'raymindist %.15e '%raymindist
         if allowableocclusion is not None:
             cmd += 'allowableocclusion %.15e '%allowableocclusion
+        if usedepthbuffer is not None:
+            cmd += 'usedepthbuffer %d '%usedepthbuffer
+        if depthbufferscale is not None:
+            cmd += 'depthbufferscale %.15e '%depthbufferscale
         return self.prob.SendCommand(cmd)
@@ -54,6 +54,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <limits>
 #include <string>
 #include <stdexcept>
 
@@ -127,7 +128,9 @@ using bpndarray = np::ndarray; // boost::python::numeric::array;
 // https://stackoverflow.com/questions/35041268/how-to-convert-a-vector-to-numpy-array-with-templates-and-boost
 template <typename T>
 struct select_npy_type
-{};
+{
+    const static NPY_TYPES type = NPY_NOTYPE; ///< no numpy type, values have to be converted one at a time
+};
 
 template <>
 struct select_npy_type<double>
@@ -205,12 +208,50 @@ public:
     boost::shared_ptr<void const> _handle;
 };
 
+/// \brief converts o to a contiguous numpy array of T with one call into numpy.
+///
+/// Works for numpy arrays and (nested) python lists and tuples of numbers. Values are only force-cast when T is a floating
+/// point type, for integer types numpy has to be able to cast safely so that floats are not truncated silently.
+/// Returns NULL without setting a python error when o cannot be converted or T has no numpy type, otherwise a new reference.
+template <typename T>
+inline PyArrayObject* _ExtractContiguousArray(const object& o)
+{
+    if( select_npy_type<T>::type == NPY_NOTYPE ) {
+        return NULL;
+    }
+    PyObject* pyobj = o.ptr();
+    if( !PyArray_Check(pyobj) && !PyList_Check(pyobj) && !PyTuple_Check(pyobj) ) {
+        return NULL;
+    }
+    int flags = NPY_ARRAY_CARRAY_RO;
+    if( !std::numeric_limits<T>::is_integer ) {
+        flags |= NPY_ARRAY_FORCECAST;
+    }
+    PyObject* pyarray = PyArray_FROMANY(pyobj, select_npy_type<T>::type, 0, 0, flags);
+    if( pyarray == NULL ) {
+        PyErr_Clear();
+    }
+    return reinterpret_cast<PyArrayObject*>(pyarray);
+}
+
 template <typename T>
 inline std::vector<T> ExtractArray(const object& o)
 {
     if( IS_PYTHONOBJECT_NONE(o) ) {
         return std::vector<T>();
     }
+    PyArrayObject* pyarray = _ExtractContiguousArray<T>(o);
+    if( pyarray != NULL ) {
+        if( PyArray_NDIM(pyarray) == 1 ) {
+            const T* pvalues = reinterpret_cast<const T*>(PyArray_DATA(pyarray));
+            std::vector<T> v(pvalues, pvalues+PyArray_SIZE(pyarray));
+            Py_DECREF(pyarray);
+            return v;
+        }
+        // let the element-wise conversion report the error
+        Py_DECREF(pyarray);
+    }
+    // integer types are only extracted from python integers, so non-integer values are rejected here
     std::vector<T> v(len(o));
     for(size_t i = 0; i < v.size(); ++i) {
         v[i] = boost::python::extract<T>(o[i]);
@@ -218,6 +259,27 @@ inline std::vector<T> ExtractArray(const object& o)
     return v;
 }
 
+/// \brief extracts all the values of a numpy array or nested sequence of any dimension in row-major order
+///
+/// \param[out] dims the shape of o
+template <typename T>
+inline std::vector<T> ExtractArrayND(const object& o, std::vector<npy_intp>& dims)
+{
+    dims.resize(0);
+    if( IS_PYTHONOBJECT_NONE(o) ) {
+        return std::vector<T>();
+    }
+    PyArrayObject* pyarray = _ExtractContiguousArray<T>(o);
+    if( pyarray == NULL ) {
+        throw std::invalid_argument("object cannot be converted to a numeric array");
+    }
+    dims.assign(PyArray_DIMS(pyarray), PyArray_DIMS(pyarray)+PyArray_NDIM(pyarray));
+    const T* pvalues = reinterpret_cast<const T*>(PyArray_DATA(pyarray));
+    std::vector<T> v(pvalues, pvalues+PyArray_SIZE(pyarray));
+    Py_DECREF(pyarray);
+    return v;
+}
+
 template <typename T>
 inline std::set<T> ExtractSet(const object& o)
 {
@@ -366,13 +428,18 @@ void init_python_bindings();
 //     memmove(p, data, N*sizeof(T));
 // }
 
+/// \brief wraps a new reference to a numpy array without copying its data
+inline bpndarray toPyArrayNoCopy(PyObject* pyvalues)
+{
+    return bpndarray(boost::python::detail::new_reference(pyvalues));
+}
+
 template <typename T>
-inline bpndarray toPyArrayN(const T* data, size_t N)
+inline bpndarray toPyArrayN(const T* pvalues, size_t N)
 {
-    boost::python::tuple shapeA = boost::python::make_tuple(1, N);
-    np::ndarray A = np::zeros(shapeA, np::dtype::get_builtin<T>());
-    for(uint8_t j = 0; j < N; ++j) {
-        A[0][j] = *(data + j);
+    bpndarray A = np::empty(boost::python::make_tuple(N), np::dtype::get_builtin<T>());
+    if( pvalues != NULL && N > 0 ) {
+        memcpy(A.get_data(), pvalues, N * sizeof(T));
     }
     return A;
 }
@@ -420,14 +487,11 @@ inline bpndarray toPyArrayN(const T* pvalues, std::vector<npy_intp>& dims)
     if( totalsize == 0 ) {
         return np::array(boost::python::list(), dt);
     }
-    PyObject *pyvalues = PyArray_SimpleNew(dims.size(), dims.data(), select_npy_type<T>::type);
+    bpndarray A = np::empty(dims.size(), dims.data(), dt);
     if( pvalues != NULL ) {
-        memcpy(PyArray_DATA(pyvalues), pvalues, totalsize * sizeof(T));
+        memcpy(A.get_data(), pvalues, totalsize * sizeof(T));
     }
-    // https://www.boost.org/doc/libs/1_71_0/libs/python/doc/html/tutorial/tutorial/object.html
-    boost::python::object o((boost::python::handle<>(pyvalues)));
-    return np::array(o, dt);
-    // return static_cast<bpndarray>(handle<>(pyvalues));
+    return A;
 }
 
 
@@ -80,13 +80,15 @@ public:
         contacts = newcontacts;
 
         boost::python::list newLinkColliding;
-        FOREACHC(itlinks, report->vLinkColliding) {
+        EnvironmentBasePtr penv = report->vCompactLinkColliding.size() > 0 ? openravepy::GetEnvironment(pyenv) : EnvironmentBasePtr();
+        for(size_t ipair = 0; ipair < report->GetNumLinkColliding(); ++ipair) {
+            std::pair<KinBody::LinkConstPtr, KinBody::LinkConstPtr> links = report->GetLinkColliding(penv, ipair);
             object pylink1, pylink2;
-            if( !!itlinks->first ) {
-                pylink1 = openravepy::toPyKinBodyLink(boost::const_pointer_cast<KinBody::Link>(itlinks->first), pyenv);
+            if( !!links.first ) {
+                pylink1 = openravepy::toPyKinBodyLink(boost::const_pointer_cast<KinBody::Link>(links.first), pyenv);
             }
-            if( !!itlinks->second ) {
-                pylink2 = openravepy::toPyKinBodyLink(boost::const_pointer_cast<KinBody::Link>(itlinks->second), pyenv);
+            if( !!links.second ) {
+                pylink2 = openravepy::toPyKinBodyLink(boost::const_pointer_cast<KinBody::Link>(links.second), pyenv);
             }
             newLinkColliding.append(boost::python::make_tuple(pylink1, pylink2));
         }
@@ -101,6 +103,13 @@ public:
         return ConvertStringToUnicode(__str__());
     }
 
+    bool GetCompactLinkColliding() const {
+        return report->bCompactLinkColliding;
+    }
+    void SetCompactLinkColliding(bool bCompactLinkColliding) {
+        report->bCompactLinkColliding = bCompactLinkColliding;
+    }
+
     int options;
     object plink1, plink2;
 
@@ -521,6 +530,12 @@ public:
         }
         CollisionReport report;
         CollisionReportPtr preport(&report,null_deleter());
+        std::vector<npy_intp> vraydims;
+        std::vector<dReal> vrays = ExtractArrayND<dReal>(rays, vraydims);
+        KinBodyConstPtr pkinbody;
+        if( !!pbody ) {
+            pkinbody = openravepy::GetKinBody(pbody);
+        }
 
         RAY r;
         npy_intp dims[] = { num,6};
@@ -528,39 +543,39 @@ public:
         dReal* ppos = (dReal*)PyArray_DATA(pypos);
         PyObject* pycollision = PyArray_SimpleNew(1,&dims[0], PyArray_BOOL);
         bool* pcollision = (bool*)PyArray_DATA(pycollision);
-        for(int i = 0; i < num; ++i, ppos += 6) {
-            vector<dReal> ray = ExtractArray<dReal>(rays[i]);
-            r.pos.x = ray[0];
-            r.pos.y = ray[1];
-            r.pos.z = ray[2];
-            r.dir.x = ray[3];
-            r.dir.y = ray[4];
-            r.dir.z = ray[5];
-            bool bCollision;
-            if( !pbody ) {
-                bCollision = _pCollisionChecker->CheckCollision(r, preport);
-            }
-            else {
-                bCollision = _pCollisionChecker->CheckCollision(r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), preport);
-            }
-            pcollision[i] = false;
-            ppos[0] = 0; ppos[1] = 0; ppos[2] = 0; ppos[3] = 0; ppos[4] = 0; ppos[5] = 0;
-            if( bCollision &&( report.contacts.size() > 0) ) {
-                if( !bFrontFacingOnly ||( report.contacts[0].norm.dot3(r.dir)<0) ) {
-                    pcollision[i] = true;
-                    ppos[0] = report.contacts[0].pos.x;
-                    ppos[1] = report.contacts[0].pos.y;
-                    ppos[2] = report.contacts[0].pos.z;
-                    ppos[3] = report.contacts[0].norm.x;
-                    ppos[4] = report.contacts[0].norm.y;
-                    ppos[5] = report.contacts[0].norm.z;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            const dReal* pray = &vrays[0];
+            for(int i = 0; i < num; ++i, ppos += 6, pray += 6) {
+                r.pos.x = pray[0];
+                r.pos.y = pray[1];
+                r.pos.z = pray[2];
+                r.dir.x = pray[3];
+                r.dir.y = pray[4];
+                r.dir.z = pray[5];
+                bool bCollision;
+                if( !pkinbody ) {
+                    bCollision = _pCollisionChecker->CheckCollision(r, preport);
+                }
+                else {
+                    bCollision = _pCollisionChecker->CheckCollision(r, pkinbody, preport);
+                }
+                pcollision[i] = false;
+                ppos[0] = 0; ppos[1] = 0; ppos[2] = 0; ppos[3] = 0; ppos[4] = 0; ppos[5] = 0;
+                if( bCollision &&( report.contacts.size() > 0) ) {
+                    if( !bFrontFacingOnly ||( report.contacts[0].norm.dot3(r.dir)<0) ) {
+                        pcollision[i] = true;
+                        ppos[0] = report.contacts[0].pos.x;
+                        ppos[1] = report.contacts[0].pos.y;
+                        ppos[2] = report.contacts[0].pos.z;
+                        ppos[3] = report.contacts[0].norm.x;
+                        ppos[4] = report.contacts[0].norm.y;
+                        ppos[5] = report.contacts[0].norm.z;
+                    }
                 }
             }
         }
-        return boost::python::make_tuple(
-            toPyArrayN(pcollision, num),
-            toPyArrayN(ppos, 6 * num)
-        );
+        return boost::python::make_tuple(toPyArrayNoCopy(pycollision), toPyArrayNoCopy(pypos));
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray)
@@ -721,6 +736,7 @@ void init_openravepy_collisionchecker()
     .def_readonly("contacts",&PyCollisionReport::contacts)
     .def_readonly("vLinkColliding",&PyCollisionReport::vLinkColliding)
     .def_readonly("nKeepPrevious", &PyCollisionReport::nKeepPrevious)
+    .add_property("bCompactLinkColliding", &PyCollisionReport::GetCompactLinkColliding, &PyCollisionReport::SetCompactLinkColliding)
     .def("__str__",&PyCollisionReport::__str__)
     .def("__unicode__",&PyCollisionReport::__unicode__)
     ;
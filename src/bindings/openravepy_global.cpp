@@ -223,14 +223,14 @@ public:
             *pvdata++ = itv->y;
             *pvdata++ = itv->z;
         }
-        vertices = toPyArrayN((dReal*)PyArray_DATA(pyvertices), 3 * mesh.vertices.size());
+        vertices = toPyArrayNoCopy(pyvertices);
 
         dims[0] = mesh.indices.size()/3;
         dims[1] = 3;
         PyObject *pyindices = PyArray_SimpleNew(2,dims, PyArray_INT32);
         int32_t* pidata = reinterpret_cast<int32_t*>PyArray_DATA(pyindices);
         std::memcpy(pidata, mesh.indices.data(), mesh.indices.size() * sizeof(int32_t));
-        indices = toPyArrayN(pidata, mesh.indices.size());
+        indices = toPyArrayNoCopy(pyindices);
     }
 
     void GetTriMesh(TriMesh& mesh) {
@@ -809,6 +809,20 @@ void pyRaveSetDataAccess(object oaccess)
     OpenRAVE::RaveSetDataAccess(pyGetIntFromPy(oaccess, Level_Info));
 }
 
+std::string pyRaveGetProfileChromeTrace()
+{
+    std::stringstream ss;
+    OpenRAVE::RaveWriteProfileChromeTrace(ss);
+    return ss.str();
+}
+
+std::string pyRaveGetProfileHistograms()
+{
+    std::stringstream ss;
+    OpenRAVE::RaveWriteProfileHistograms(ss);
+    return ss.str();
+}
+
 // return None if nothing found
 object pyRaveInvertFileLookup(const std::string& filename)
 {
@@ -1003,7 +1017,7 @@ object poseFromMatrices(object otransforms)
         pvalues[4] = tpose.trans.x; pvalues[5] = tpose.trans.y; pvalues[6] = tpose.trans.z;
         pvalues += 7;
     }
-    return toPyArrayN((dReal*)PyArray_DATA(pyvalues), 7 * N);
+    return toPyArrayNoCopy(pyvalues);
 }
 
 object InvertPoses(object o)
@@ -1022,7 +1036,7 @@ object InvertPoses(object o)
         ptrans[0] = t.rot.x; ptrans[1] = t.rot.y; ptrans[2] = t.rot.z; ptrans[3] = t.rot.w;
         ptrans[4] = t.trans.x; ptrans[5] = t.trans.y; ptrans[6] = t.trans.z;
     }
-    return toPyArrayN((dReal*)PyArray_DATA(pytrans), 7 * N);
+    return toPyArrayNoCopy(pytrans);
 }
 
 object InvertPose(object opose)
@@ -1080,7 +1094,7 @@ object poseTransformPoints(object opose, object opoints)
         Vector newpoint = t*ExtractVector3(opoints[i]);
         ptrans[0] = newpoint.x; ptrans[1] = newpoint.y; ptrans[2] = newpoint.z;
     }
-    return toPyArrayN((dReal*)PyArray_DATA(pytrans), 3 * N);
+    return toPyArrayNoCopy(pytrans);
 }
 
 object TransformLookat(object olookat, object ocamerapos, object ocameraup)
@@ -1155,6 +1169,10 @@ void init_openravepy_global()
     .value("Verbose",Level_Verbose)
     .value("VerifyPlans",Level_VerifyPlans)
     ;
+    enum_<LogBackend>("LogBackend" DOXY_ENUM(LogBackend))
+    .value("Console",LB_Console)
+    .value("Asynchronous",LB_Asynchronous)
+    ;
     enum_<SerializationOptions>("SerializationOptions" DOXY_ENUM(SerializationOptions))
     .value("Kinematics",SO_Kinematics)
     .value("Dynamics",SO_Dynamics)
@@ -1335,6 +1353,16 @@ void init_openravepy_global()
 
     def("RaveSetDebugLevel",openravepy::pyRaveSetDebugLevel,args("level"), DOXY_FN1(RaveSetDebugLevel));
     def("RaveGetDebugLevel",OpenRAVE::RaveGetDebugLevel,DOXY_FN1(RaveGetDebugLevel));
+    def("RaveSetLogBackend",OpenRAVE::RaveSetLogBackend,args("backend"), DOXY_FN1(RaveSetLogBackend));
+    def("RaveGetLogBackend",OpenRAVE::RaveGetLogBackend, DOXY_FN1(RaveGetLogBackend));
+    def("RaveFlushLog",OpenRAVE::RaveFlushLog, DOXY_FN1(RaveFlushLog));
+    def("RaveGetNumDroppedLogMessages",OpenRAVE::RaveGetNumDroppedLogMessages, DOXY_FN1(RaveGetNumDroppedLogMessages));
+    def("RaveSetProfilingEnabled",OpenRAVE::RaveSetProfilingEnabled,args("enable"), DOXY_FN1(RaveSetProfilingEnabled));
+    def("RaveIsProfilingEnabled",OpenRAVE::RaveIsProfilingEnabled, DOXY_FN1(RaveIsProfilingEnabled));
+    def("RaveClearProfileEvents",OpenRAVE::RaveClearProfileEvents, DOXY_FN1(RaveClearProfileEvents));
+    def("RaveGetNumDroppedProfileEvents",OpenRAVE::RaveGetNumDroppedProfileEvents, DOXY_FN1(RaveGetNumDroppedProfileEvents));
+    def("RaveGetProfileChromeTrace",openravepy::pyRaveGetProfileChromeTrace, "Returns the recorded profiling events in the Chrome trace event JSON format, see RaveWriteProfileChromeTrace");
+    def("RaveGetProfileHistograms",openravepy::pyRaveGetProfileHistograms, "Returns the statistics of every profiling event name as a JSON string, see RaveWriteProfileHistograms");
     def("RaveSetDataAccess",openravepy::pyRaveSetDataAccess,args("accessoptions"), DOXY_FN1(RaveSetDataAccess));
     def("RaveGetDataAccess",OpenRAVE::RaveGetDataAccess, DOXY_FN1(RaveGetDataAccess));
     def("RaveGetDefaultViewerType", OpenRAVE::RaveGetDefaultViewerType, DOXY_FN1(RaveGetDefaultViewerType));
@@ -255,7 +255,7 @@ object toPyArray(const TransformMatrix& t)
     pdata[4] = t.m[4]; pdata[5] = t.m[5]; pdata[6] = t.m[6]; pdata[7] = t.trans.y;
     pdata[8] = t.m[8]; pdata[9] = t.m[9]; pdata[10] = t.m[10]; pdata[11] = t.trans.z;
     pdata[12] = 0; pdata[13] = 0; pdata[14] = 0; pdata[15] = 1;
-    return toPyArrayN(pdata, 16);
+    return toPyArrayNoCopy(pyvalues);
 }
 
 
@@ -266,7 +266,7 @@ object toPyArray(const Transform& t)
     dReal* pdata = (dReal*)PyArray_DATA(pyvalues);
     pdata[0] = t.rot.x; pdata[1] = t.rot.y; pdata[2] = t.rot.z; pdata[3] = t.rot.w;
     pdata[4] = t.trans.x; pdata[5] = t.trans.y; pdata[6] = t.trans.z;
-    return toPyArrayN(pdata, 7);
+    return toPyArrayNoCopy(pyvalues);
 }
 
 AttributesList toAttributesList(boost::python::dict odict)
@@ -841,12 +841,20 @@ public:
     bool CheckCollision(PyKinBodyPtr pbody1)
     {
         CHECK_POINTER(pbody1);
-        return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)));
+        KinBodyConstPtr pkinbody1 = openravepy::GetKinBody(pbody1);
+        openravepy::PythonThreadSaver threadsaver;
+        return _penv->CheckCollision(pkinbody1);
     }
     bool CheckCollision(PyKinBodyPtr pbody1, PyCollisionReportPtr pReport)
     {
         CHECK_POINTER(pbody1);
-        bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), openravepy::GetCollisionReport(pReport));
+        KinBodyConstPtr pkinbody1 = openravepy::GetKinBody(pbody1);
+        CollisionReportPtr preport = openravepy::GetCollisionReport(pReport);
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            bCollision = _penv->CheckCollision(pkinbody1, preport);
+        }
         openravepy::UpdateCollisionReport(pReport,shared_from_this());
         return bCollision;
     }
@@ -855,14 +863,22 @@ public:
     {
         CHECK_POINTER(pbody1);
         CHECK_POINTER(pbody2);
-        return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)));
+        KinBodyConstPtr pkinbody1 = openravepy::GetKinBody(pbody1), pkinbody2 = openravepy::GetKinBody(pbody2);
+        openravepy::PythonThreadSaver threadsaver;
+        return _penv->CheckCollision(pkinbody1, pkinbody2);
     }
 
     bool CheckCollision(PyKinBodyPtr pbody1, PyKinBodyPtr pbody2, PyCollisionReportPtr pReport)
     {
         CHECK_POINTER(pbody1);
         CHECK_POINTER(pbody2);
-        bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), openravepy::GetCollisionReport(pReport));
+        KinBodyConstPtr pkinbody1 = openravepy::GetKinBody(pbody1), pkinbody2 = openravepy::GetKinBody(pbody2);
+        CollisionReportPtr preport = openravepy::GetCollisionReport(pReport);
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            bCollision = _penv->CheckCollision(pkinbody1, pkinbody2, preport);
+        }
         openravepy::UpdateCollisionReport(pReport,shared_from_this());
         return bCollision;
     }
@@ -1207,11 +1223,15 @@ public:
         npy_intp dims[] = { nRays,6};
         PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal) == sizeof(double) ? PyArray_DOUBLE : PyArray_FLOAT);
         dReal* ppos = (dReal*)PyArray_DATA(pypos);
-        std::memset(ppos, 0, nRays * sizeof(dReal));
+        std::memset(ppos, 0, 6 * nRays * sizeof(dReal));
         PyObject* pycollision = PyArray_SimpleNew(1,&dims[0], PyArray_BOOL);
         // numpy bool = uint8_t
         uint8_t* pcollision = (uint8_t*)PyArray_DATA(pycollision);
         std::memset(pcollision, 0, nRays * sizeof(uint8_t));
+        KinBodyConstPtr pkinbody;
+        if( !!pbody ) {
+            pkinbody = openravepy::GetKinBody(pbody);
+        }
         {
             openravepy::PythonThreadSaver threadsaver;
 
@@ -1235,11 +1255,11 @@ public:
                 }
 
                 bool bCollision;
-                if( !pbody ) {
+                if( !pkinbody ) {
                     bCollision = _penv->CheckCollision(r, preport);
                 }
                 else {
-                    bCollision = _penv->CheckCollision(r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), preport);
+                    bCollision = _penv->CheckCollision(r, pkinbody, preport);
                 }
 
                 if( bCollision &&( report.contacts.size() > 0) ) {
@@ -1256,10 +1276,7 @@ public:
             }
         }
 
-        return boost::python::make_tuple(
-            toPyArrayN(pcollision, nRays),
-            toPyArrayN(ppos, 6 * nRays)
-        );
+        return boost::python::make_tuple(toPyArrayNoCopy(pycollision), toPyArrayNoCopy(pypos));
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray)
@@ -2118,6 +2135,55 @@ EnvironmentBasePtr GetEnvironment(object o)
     return EnvironmentBasePtr();
 }
 
+class PySimulationScheduler
+{
+public:
+    PySimulationScheduler(int numthreads=0) : _pscheduler(new SimulationScheduler(numthreads)) {
+    }
+
+    void AddEnvironment(PyEnvironmentBasePtr pyenv) {
+        _pscheduler->AddEnvironment(GetEnvironment(pyenv));
+    }
+    bool RemoveEnvironment(PyEnvironmentBasePtr pyenv) {
+        return _pscheduler->RemoveEnvironment(GetEnvironment(pyenv));
+    }
+    object GetEnvironments() const {
+        std::vector<EnvironmentBasePtr> venvs;
+        _pscheduler->GetEnvironments(venvs);
+        boost::python::list oenvironments;
+        FOREACH(itenv, venvs) {
+            oenvironments.append(PyEnvironmentBasePtr(new PyEnvironmentBase(*itenv)));
+        }
+        return oenvironments;
+    }
+    void Step(dReal fTimeStep, int numsteps=1) {
+        openravepy::PythonThreadSaver threadsaver;
+        _pscheduler->Step(fTimeStep, numsteps);
+    }
+    object GetStatistics() const {
+        std::vector<SimulationScheduler::StepStatistics> vstats;
+        _pscheduler->GetStatistics(vstats);
+        boost::python::list ostats;
+        FOREACH(itstats, vstats) {
+            boost::python::dict ostat;
+            ostat["numsteps"] = itstats->numsteps;
+            ostat["totalsteptime"] = itstats->totalsteptime;
+            ostat["maxsteptime"] = itstats->maxsteptime;
+            ostats.append(ostat);
+        }
+        return ostats;
+    }
+    void ResetStatistics() {
+        _pscheduler->ResetStatistics();
+    }
+    int GetNumThreads() const {
+        return _pscheduler->GetNumThreads();
+    }
+
+private:
+    SimulationSchedulerPtr _pscheduler;
+};
+
 object toPyEnvironment(object o)
 {
     extract<PyInterfaceBasePtr> pyinterface(o);
@@ -2187,6 +2253,7 @@ PyInterfaceBasePtr RaveCreateInterface(PyEnvironmentBasePtr pyenv, InterfaceType
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(LoadURI_overloads, LoadURI, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SetCamera_overloads, SetCamera, 2, 4)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(StartSimulation_overloads, StartSimulation, 1, 2)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SchedulerStep_overloads, Step, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(StopSimulation_overloads, StopSimulation, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SetViewer_overloads, SetViewer, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SetDefaultViewer_overloads, SetDefaultViewer, 0, 1)
@@ -2528,6 +2595,17 @@ Because race conditions can pop up when trying to lock the openrave environment
         env.attr("TriangulateOptions") = selectionoptions;
     }
 
+    class_<PySimulationScheduler, boost::shared_ptr<PySimulationScheduler> >("SimulationScheduler", DOXY_CLASS(SimulationScheduler))
+    .def(init<optional<int> >(args("numthreads")))
+    .def("AddEnvironment",&PySimulationScheduler::AddEnvironment,args("env"), DOXY_FN(SimulationScheduler,AddEnvironment))
+    .def("RemoveEnvironment",&PySimulationScheduler::RemoveEnvironment,args("env"), DOXY_FN(SimulationScheduler,RemoveEnvironment))
+    .def("GetEnvironments",&PySimulationScheduler::GetEnvironments, DOXY_FN(SimulationScheduler,GetEnvironments))
+    .def("Step",&PySimulationScheduler::Step,SchedulerStep_overloads(args("timestep","numsteps"), DOXY_FN(SimulationScheduler,Step)))
+    .def("GetStatistics",&PySimulationScheduler::GetStatistics, DOXY_FN(SimulationScheduler,GetStatistics))
+    .def("ResetStatistics",&PySimulationScheduler::ResetStatistics, DOXY_FN(SimulationScheduler,ResetStatistics))
+    .def("GetNumThreads",&PySimulationScheduler::GetNumThreads, DOXY_FN(SimulationScheduler,GetNumThreads))
+    ;
+
     {
         scope options = class_<DummyStruct>("options")
                         .add_static_property("returnTransformQuaternion",GetReturnTransformQuaternions,SetReturnTransformQuaternions);
@@ -340,36 +340,26 @@ inline object toPyArray3(const std::vector<RaveVector<float> >& v)
 {
     npy_intp dims[] = { npy_intp(v.size()), npy_intp(3) };
     PyObject *pyvalues = PyArray_SimpleNew(2,dims, PyArray_FLOAT);
-    float* pf = nullptr;
-    if( v.empty() ) {
-        return toPyArrayN(pf, 0);
-    }
-    pf = (float*) PyArray_DATA(pyvalues);
+    float* pf = (float*) PyArray_DATA(pyvalues);
     FOREACHC(it, v) {
         *pf++ = it->x;
         *pf++ = it->y;
         *pf++ = it->z;
     }
-    return toPyArrayN(pf, 3 * v.size());
-    // return static_cast<numeric::array>(handle<>(pyvalues));
+    return toPyArrayNoCopy(pyvalues);
 }
 
 inline object toPyArray3(const std::vector<RaveVector<double> >& v)
 {
     npy_intp dims[] = { npy_intp(v.size()), npy_intp(3) };
     PyObject *pyvalues = PyArray_SimpleNew(2,dims, PyArray_DOUBLE);
-    double* pf = nullptr;
-    if( v.empty() ) {
-        return toPyArrayN(pf, 0);
-    }
-    pf = (double*) PyArray_DATA(pyvalues);
+    double* pf = (double*) PyArray_DATA(pyvalues);
     FOREACHC(it, v) {
         *pf++ = it->x;
         *pf++ = it->y;
         *pf++ = it->z;
     }
-    return toPyArrayN(pf, 3 * v.size());
-    // return static_cast<numeric::array>(handle<>(pyvalues));
+    return toPyArrayNoCopy(pyvalues);
 }
 
 inline object toPyVector2(Vector v)
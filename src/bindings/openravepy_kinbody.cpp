@@ -898,8 +898,7 @@ public:
         pdata[0] = t.m[0]; pdata[1] = t.m[1]; pdata[2] = t.m[2];
         pdata[3] = t.m[4]; pdata[4] = t.m[5]; pdata[5] = t.m[6];
         pdata[6] = t.m[8]; pdata[7] = t.m[9]; pdata[8] = t.m[10];
-        return toPyArrayN(pdata, 9);
-        // return static_cast<np::array>(handle<>(pyvalues));
+        return toPyArrayNoCopy(pyvalues);
     }
     object GetGlobalInertia() const {
         TransformMatrix t = _plink->GetGlobalInertia();
@@ -909,8 +908,7 @@ public:
         pdata[0] = t.m[0]; pdata[1] = t.m[1]; pdata[2] = t.m[2];
         pdata[3] = t.m[4]; pdata[4] = t.m[5]; pdata[5] = t.m[6];
         pdata[6] = t.m[8]; pdata[7] = t.m[9]; pdata[8] = t.m[10];
-        return toPyArrayN(pdata, 9);
-        // return static_cast<np::array>(handle<>(pyvalues));
+        return toPyArrayNoCopy(pyvalues);
     }
     dReal GetMass() const {
         return _plink->GetMass();
@@ -2207,7 +2205,10 @@ object PyKinBody::GetLinkTransformations(bool returndoflastvlaues) const
     boost::python::list otransforms;
     vector<Transform> vtransforms;
     std::vector<dReal> vdoflastsetvalues;
-    _pbody->GetLinkTransformations(vtransforms, vdoflastsetvalues);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _pbody->GetLinkTransformations(vtransforms, vdoflastsetvalues);
+    }
     FOREACHC(it, vtransforms) {
         otransforms.append(ReturnTransform(*it));
     }
@@ -2322,8 +2323,7 @@ object PyKinBody::GetLinkVelocities() const
         pfvel[6*i+4] = velocities[i].second.y;
         pfvel[6*i+5] = velocities[i].second.z;
     }
-    return toPyArrayN(pfvel, 6 * velocities.size());
-    // return static_cast<np::array>(handle<>(pyvel));
+    return toPyArrayNoCopy(pyvel);
 }
 
 object PyKinBody::GetLinkAccelerations(object odofaccelerations, object oexternalaccelerations=object()) const
@@ -2360,8 +2360,7 @@ object PyKinBody::GetLinkAccelerations(object odofaccelerations, object oexterna
         pf[6*i+4] = vLinkAccelerations[i].second.y;
         pf[6*i+5] = vLinkAccelerations[i].second.z;
     }
-    return toPyArrayN(pf, 6 * vLinkAccelerations.size());
-    // return static_cast<np::array>(handle<>(pyaccel));
+    return toPyArrayNoCopy(pyaccel);
 }
 
 object PyKinBody::ComputeAABB(bool bEnabledOnlyLinks)
@@ -2734,11 +2733,60 @@ PyInterfaceBasePtr PyKinBody::GetSelfCollisionChecker()
 
 bool PyKinBody::CheckSelfCollision(PyCollisionReportPtr pReport, PyCollisionCheckerBasePtr pycollisionchecker)
 {
-    bool bCollision = _pbody->CheckSelfCollision(openravepy::GetCollisionReport(pReport), openravepy::GetCollisionChecker(pycollisionchecker));
+    CollisionReportPtr preport = openravepy::GetCollisionReport(pReport);
+    CollisionCheckerBasePtr pchecker = openravepy::GetCollisionChecker(pycollisionchecker);
+    bool bCollision;
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        bCollision = _pbody->CheckSelfCollision(preport, pchecker);
+    }
     openravepy::UpdateCollisionReport(pReport,GetEnv());
     return bCollision;
 }
 
+object PyKinBody::CheckCollisionConfigurations(object oconfigurations, object oindices, bool bcheckself)
+{
+    std::vector<int> vindices;
+    if( !IS_PYTHONOBJECT_NONE(oindices) ) {
+        vindices = ExtractArray<int>(oindices);
+    }
+    size_t numvalues = vindices.size() > 0 ? vindices.size() : _pbody->GetDOF();
+    std::vector<npy_intp> dims;
+    std::vector<dReal> vconfigurations = ExtractArrayND<dReal>(oconfigurations, dims);
+    size_t numconfigurations = 0;
+    if( vconfigurations.size() > 0 ) {
+        if( dims.size() != 2 || dims[1] != (npy_intp)numvalues ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("configurations need to be a Nx%d array"), numvalues, ORE_InvalidArguments);
+        }
+        numconfigurations = dims[0];
+    }
+
+    std::vector<uint8_t> vcollisions(numconfigurations, 0);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        KinBody::KinBodyStateSaver saver(_pbody);
+        EnvironmentBasePtr penv = _pbody->GetEnv();
+        std::vector<dReal> vvalues(numvalues);
+        for(size_t iconfig = 0; iconfig < numconfigurations; ++iconfig) {
+            std::copy(vconfigurations.begin()+iconfig*numvalues, vconfigurations.begin()+(iconfig+1)*numvalues, vvalues.begin());
+            if( vindices.size() > 0 ) {
+                _pbody->SetDOFValues(vvalues, KinBody::CLA_CheckLimits, vindices);
+            }
+            else {
+                _pbody->SetDOFValues(vvalues, KinBody::CLA_CheckLimits);
+            }
+            vcollisions[iconfig] = penv->CheckCollision(KinBodyConstPtr(_pbody)) || (bcheckself && _pbody->CheckSelfCollision());
+        }
+    }
+
+    npy_intp pydims[] = { npy_intp(numconfigurations) };
+    PyObject* pycollisions = PyArray_SimpleNew(1, pydims, PyArray_BOOL);
+    if( numconfigurations > 0 ) {
+        memcpy(PyArray_DATA(pycollisions), &vcollisions[0], numconfigurations);
+    }
+    return toPyArrayNoCopy(pycollisions);
+}
+
 bool PyKinBody::IsAttached(PyKinBodyPtr pattachbody)
 {
     CHECK_POINTER(pattachbody);
@@ -3320,6 +3368,7 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetFloatParameters_overloads, GetFloatPar
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetIntParameters_overloads, GetIntParameters, 0, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetStringParameters_overloads, GetStringParameters, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CheckSelfCollision_overloads, CheckSelfCollision, 0, 2)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CheckCollisionConfigurations_overloads, CheckCollisionConfigurations, 1, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetLinkAccelerations_overloads, GetLinkAccelerations, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(InitCollisionMesh_overloads, InitCollisionMesh, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(InitFromBoxes_overloads, InitFromBoxes, 1, 3)
@@ -3653,6 +3702,7 @@ void init_openravepy_kinbody()
                         .def("SetSelfCollisionChecker",&PyKinBody::SetSelfCollisionChecker,args("collisionchecker"), DOXY_FN(KinBody,SetSelfCollisionChecker))
                         .def("GetSelfCollisionChecker",&PyKinBody::GetSelfCollisionChecker,args("collisionchecker"), DOXY_FN(KinBody,GetSelfCollisionChecker))
                         .def("CheckSelfCollision",&PyKinBody::CheckSelfCollision, CheckSelfCollision_overloads(args("report","collisionchecker"), DOXY_FN(KinBody,CheckSelfCollision)))
+                        .def("CheckCollisionConfigurations",&PyKinBody::CheckCollisionConfigurations, CheckCollisionConfigurations_overloads(args("configurations","dofindices","checkself"), "Sets every row of the Nxd configurations array as the dof values of dofindices (all dofs if None) and checks the body for environment and optionally self collisions. The body state is restored and the GIL is released while checking.\n\n:return: bool array with N entries, True if the configuration is in collision"))
                         .def("IsAttached",&PyKinBody::IsAttached,args("body"), DOXY_FN(KinBody,IsAttached))
                         .def("GetAttached",&PyKinBody::GetAttached, DOXY_FN(KinBody,GetAttached))
                         .def("SetZeroConfiguration",&PyKinBody::SetZeroConfiguration, DOXY_FN(KinBody,SetZeroConfiguration))
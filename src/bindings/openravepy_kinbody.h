@@ -246,6 +246,8 @@ public:
     void SetSelfCollisionChecker(PyCollisionCheckerBasePtr pycollisionchecker);
     PyInterfaceBasePtr GetSelfCollisionChecker();
     bool CheckSelfCollision(PyCollisionReportPtr pReport=PyCollisionReportPtr(), PyCollisionCheckerBasePtr pycollisionchecker=PyCollisionCheckerBasePtr());
+    /// \brief sets every row of oconfigurations as the dof values and checks for collisions, returns a bool array with one entry per row
+    object CheckCollisionConfigurations(object oconfigurations, object oindices=object(), bool bcheckself=true);
     bool IsAttached(PyKinBodyPtr pattachbody);
     object GetAttached() const;
     void SetZeroConfiguration();
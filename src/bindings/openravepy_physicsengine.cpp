@@ -104,7 +104,7 @@ public:
             pfvel[6*i+4] = velocities[i].second.y;
             pfvel[6*i+5] = velocities[i].second.z;
         }
-        return toPyArrayN(pfvel, 6 * velocities.size());
+        return toPyArrayNoCopy(pyvel);
     }
 
     bool SetBodyForce(object pylink, object force, object position, bool bAdd)
@@ -198,6 +198,57 @@ public:
             return object(ret);
         }
 
+        /// \brief python check on top of the current _checkpathvelocityconstraintsfn
+        class PyCheckPathConstraintsFunction
+        {
+public:
+            PyCheckPathConstraintsFunction(object fncheck, const PlannerBase::PlannerParameters::CheckPathVelocityConstraintFn& checkfn) : _fncheck(fncheck), _checkfn(checkfn) {
+            }
+
+            int operator()(const std::vector<dReal>& q0, const std::vector<dReal>& q1, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, IntervalType interval, int options, ConstraintFilterReturnPtr filterreturn)
+            {
+                if( !!_checkfn ) {
+                    int ret = _checkfn(q0, q1, dq0, dq1, timeelapsed, interval, options, filterreturn);
+                    if( ret != 0 ) {
+                        return ret;
+                    }
+                }
+                if( !(options & CFO_CheckUserConstraints) ) {
+                    return 0;
+                }
+                bool bvalid = false;
+                PyGILState_STATE gstate = PyGILState_Ensure();
+                try {
+                    bvalid = extract<bool>(_fncheck(toPyArray(q0), toPyArray(q1), timeelapsed));
+                }
+                catch(...) {
+                    RAVELOG_ERROR("exception occured in python check path constraints function:\n");
+                    PyErr_Print();
+                }
+                PyGILState_Release(gstate);
+                return bvalid ? 0 : CFO_CheckUserConstraints;
+            }
+
+            object _fncheck;
+            PlannerBase::PlannerParameters::CheckPathVelocityConstraintFn _checkfn;
+        };
+
+        void AddCheckPathConstraintsFunction(object fncheck)
+        {
+            if( !_paramswrite ) {
+                throw OPENRAVE_EXCEPTION_FORMAT0(_("PlannerParameters needs to be non-const"),ORE_Failed);
+            }
+            if( !fncheck ) {
+                throw openrave_exception(_("check function not specified"));
+            }
+            _paramswrite->_checkpathvelocityconstraintsfn = PyCheckPathConstraintsFunction(fncheck, _paramswrite->_checkpathvelocityconstraintsfn);
+            _paramswrite->_bDefaultFunctions = false;
+        }
+
+        bool HasDefaultFunctions() const {
+            return _paramsread->HasDefaultFunctions();
+        }
+
         void SetPostProcessing(const std::string& plannername, const std::string& plannerparameters)
         {
             _paramswrite->_sPostProcessingPlanner = plannername;
@@ -425,6 +476,8 @@ void init_openravepy_planner()
         .def("SetConfigResolution",&PyPlannerBase::PyPlannerParameters::SetConfigResolution,args("resolutions"),"sets PlannerParameters::_vConfigResolution")
         .def("SetMaxIterations",&PyPlannerBase::PyPlannerParameters::SetMaxIterations,args("maxiterations"),"sets PlannerParameters::_nMaxIterations")
         .def("CheckPathAllConstraints",&PyPlannerBase::PyPlannerParameters::CheckPathAllConstraints,CheckPathAllConstraints_overloads(args("q0","q1","dq0","dq1","timeelapsed","interval","options", "filterreturn"),DOXY_FN(PlannerBase::PlannerParameters, CheckPathAllConstraints)))
+        .def("HasDefaultFunctions",&PyPlannerBase::PyPlannerParameters::HasDefaultFunctions, DOXY_FN(PlannerBase::PlannerParameters, HasDefaultFunctions))
+        .def("AddCheckPathConstraintsFunction",&PyPlannerBase::PyPlannerParameters::AddCheckPathConstraintsFunction,args("fncheck"),"adds a user constraint to PlannerParameters::_checkpathvelocityconstraintsfn. fncheck(q0,q1,timeelapsed) returns True if the path from q0 to q1 is valid. Because it is a custom function, the parameters cannot be cloned to other environments anymore.")
         .def("SetPostProcessing", &PyPlannerBase::PyPlannerParameters::SetPostProcessing, args("plannername", "plannerparameters"), "sets the post processing parameters")
         .def("__str__",&PyPlannerBase::PyPlannerParameters::__str__)
         .def("__unicode__",&PyPlannerBase::PyPlannerParameters::__unicode__)
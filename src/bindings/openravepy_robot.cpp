@@ -510,7 +510,7 @@ public:
                     std::copy(itsol->begin(),itsol->end(),ppos);
                     ppos += itsol->size();
                 }
-                return toPyArrayN((dReal*)PyArray_DATA(pysolutions), vsolutions.size() * _pmanip->GetArmDOF());
+                return toPyArrayNoCopy(pysolutions);
             }
         }
 
@@ -557,7 +557,7 @@ public:
                     std::copy(itsol->begin(),itsol->end(),ppos);
                     ppos += itsol->size();
                 }
-                return toPyArrayN((dReal*)PyArray_DATA(pysolutions), vsolutions.size() * _pmanip->GetArmDOF());
+                return toPyArrayNoCopy(pysolutions);
             }
         }
 
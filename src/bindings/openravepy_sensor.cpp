@@ -372,10 +372,7 @@ public:
                     memcpy(PyArray_DATA(pyvalues), &pdata->vimagedata[0], pdata->vimagedata.size());
                 }
 
-                np::dtype dt = np::dtype::get_builtin<uint8_t>();
-                boost::python::object o((boost::python::handle<>(pyvalues)));
-                imagedata = np::array(o, dt);
-                // imagedata = static_cast<numeric::array>(handle<>(pyvalues));
+                imagedata = toPyArrayNoCopy(pyvalues);
             }
         }
 
@@ -387,10 +384,7 @@ public:
                 PyObject *pyvalues = PyArray_SimpleNew(3, dims, PyArray_UINT8);
                 memset(PyArray_DATA(pyvalues), 0, pgeom->height*pgeom->width*3);
 
-                np::dtype dt = np::dtype::get_builtin<uint8_t>();
-                boost::python::object o((boost::python::handle<>(pyvalues)));
-                imagedata = np::array(o, dt);
-                // imagedata = static_cast<numeric::array>(handle<>(pyvalues));
+                imagedata = toPyArrayNoCopy(pyvalues);
             }
             {
                 const std::vector<dReal> v {
@@ -145,9 +145,7 @@ protected:
         npy_intp dims[] = { npy_intp(samples.size()/dim), npy_intp(dim) };
         PyObject *pyvalues = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
         memcpy(PyArray_DATA(pyvalues), &samples.at(0), samples.size()*sizeof(samples[0]));
-
-        boost::python::object o((boost::python::handle<>(pyvalues)));
-        return np::array(o, dt);
+        return toPyArrayNoCopy(pyvalues);
     }
 
     object _ReturnSamples2D(const std::vector<uint32_t>&samples)
@@ -160,9 +158,7 @@ protected:
         npy_intp dims[] = { npy_intp(samples.size()/dim), npy_intp(dim) };
         PyObject *pyvalues = PyArray_SimpleNew(2,dims, PyArray_UINT32);
         memcpy(PyArray_DATA(pyvalues),&samples.at(0),samples.size()*sizeof(samples[0]));
-
-        boost::python::object o((boost::python::handle<>(pyvalues)));
-        return np::array(o, dt);
+        return toPyArrayNoCopy(pyvalues);
     }
 };
 
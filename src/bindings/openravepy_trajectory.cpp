@@ -98,10 +98,7 @@ public:
             memcpy(PyArray_DATA(pypos), &values[0], values.size()*sizeof(values[0]));
         }
 
-        np::dtype dt = sizeof(dReal)==8 ? np::dtype::get_builtin<double>() : np::dtype::get_builtin<float>();
-        boost::python::object o((boost::python::handle<>(pypos)));
-        return np::array(o, dt);
-        // return static_cast<numeric::array>(handle<>(pypos));
+        return toPyArrayNoCopy(pypos);
     }
 
     object SamplePoints2D(object otimes, PyConfigurationSpecificationPtr pyspec) const
@@ -117,10 +114,7 @@ public:
             memcpy(PyArray_DATA(pypos), &values[0], values.size()*sizeof(values[0]));
         }
 
-        np::dtype dt = sizeof(dReal)==8 ? np::dtype::get_builtin<double>() : np::dtype::get_builtin<float>();
-        boost::python::object o((boost::python::handle<>(pypos)));
-        return np::array(o, dt);
-        // return static_cast<numeric::array>(handle<>(pypos));
+        return toPyArrayNoCopy(pypos);
     }
 
     object GetConfigurationSpecification() const {
@@ -134,14 +128,21 @@ public:
     object GetWaypoints(size_t startindex, size_t endindex) const
     {
         vector<dReal> values;
-        _ptrajectory->GetWaypoints(startindex,endindex,values);
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            _ptrajectory->GetWaypoints(startindex,endindex,values);
+        }
         return toPyArray(values);
     }
 
     object GetWaypoints(size_t startindex, size_t endindex, PyConfigurationSpecificationPtr pyspec) const
     {
         vector<dReal> values;
-        _ptrajectory->GetWaypoints(startindex,endindex,values,openravepy::GetConfigurationSpecification(pyspec));
+        ConfigurationSpecification spec = openravepy::GetConfigurationSpecification(pyspec);
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            _ptrajectory->GetWaypoints(startindex,endindex,values,spec);
+        }
         return toPyArray(values);
     }
 
@@ -149,7 +150,10 @@ public:
     object GetWaypoints2D(size_t startindex, size_t endindex) const
     {
         vector<dReal> values;
-        _ptrajectory->GetWaypoints(startindex,endindex,values);
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            _ptrajectory->GetWaypoints(startindex,endindex,values);
+        }
         int numdof = _ptrajectory->GetConfigurationSpecification().GetDOF();
         npy_intp dims[] = { npy_intp(values.size()/numdof), npy_intp(numdof) };
         PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
@@ -157,9 +161,7 @@ public:
             memcpy(PyArray_DATA(pypos), &values[0], values.size()*sizeof(values[0]));
         }
 
-        np::dtype dt = sizeof(dReal)==8 ? np::dtype::get_builtin<double>() : np::dtype::get_builtin<float>();
-        boost::python::object o((boost::python::handle<>(pypos)));
-        return np::array(o, dt);
+        return toPyArrayNoCopy(pypos);
     }
 
     object __getitem__(int index) const
@@ -192,9 +194,7 @@ public:
             memcpy(PyArray_BYTES(pypos)+(i*waypointSize), &values[0], waypointSize);
         }
 
-        np::dtype dt = sizeof(dReal)==8 ? np::dtype::get_builtin<double>() : np::dtype::get_builtin<float>();
-        boost::python::object o((boost::python::handle<>(pypos)));
-        return np::array(o, dt);
+        return toPyArrayNoCopy(pypos);
     }
 
     object GetAllWaypoints2D() const
@@ -206,16 +206,17 @@ public:
     {
         vector<dReal> values;
         ConfigurationSpecification spec = openravepy::GetConfigurationSpecification(pyspec);
-        _ptrajectory->GetWaypoints(startindex,endindex,values,spec);
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            _ptrajectory->GetWaypoints(startindex,endindex,values,spec);
+        }
         npy_intp dims[] = { npy_intp(values.size()/spec.GetDOF()), npy_intp(spec.GetDOF()) };
         PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
         if( values.size() > 0 ) {
             memcpy(PyArray_DATA(pypos), &values[0], values.size()*sizeof(values[0]));
         }
 
-        np::dtype dt = sizeof(dReal)==8 ? np::dtype::get_builtin<double>() : np::dtype::get_builtin<float>();
-        boost::python::object o((boost::python::handle<>(pypos)));
-        return np::array(o, dt);
+        return toPyArrayNoCopy(pypos);
     }
 
     object GetAllWaypoints2D(PyConfigurationSpecificationPtr pyspec) const
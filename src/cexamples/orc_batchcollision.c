@@ -0,0 +1,89 @@
+/** @example orc_batchcollision.c
+    @author Rosen Diankov
+
+    Measures the time to check many robot configurations for collisions, once with one call of ORCBodySetDOFValues
+    and ORCEnvironmentCheckCollision per configuration and once with a single ORCBodyCheckConfigurations call, also
+    split among several threads.
+
+    Usage:
+    orc_batchcollision [numconfigurations] [numthreads]
+ */
+#include <openrave-core_c.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <sys/time.h>
+
+static double GetTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec*1e-6;
+}
+
+int main(int argc, char ** argv)
+{
+    int numconfigurations = argc > 1 ? atoi(argv[1]) : 10000;
+    int numthreads = argc > 2 ? atoi(argv[2]) : 4;
+    ORCInitialize(0, 3);
+    void* env = ORCEnvironmentCreate();
+    ORCEnvironmentLoad(env, "data/lab1.env.xml");
+
+    int numrobots = ORCEnvironmentGetRobots(env, NULL);
+    void** robots = (void**)malloc(sizeof(void*)*numrobots);
+    ORCEnvironmentGetRobots(env, robots);
+    void* robot = robots[0];
+    int dof = ORCBodyGetDOF(robot);
+    int numlinks = ORCBodyGetLinks(robot, NULL);
+
+    // random perturbations of the initial configuration
+    OpenRAVEReal* initialvalues = (OpenRAVEReal*)malloc(sizeof(OpenRAVEReal)*dof);
+    ORCBodyGetDOFValues(robot, initialvalues);
+    OpenRAVEReal* configurations = (OpenRAVEReal*)malloc(sizeof(OpenRAVEReal)*dof*numconfigurations);
+    int i, j;
+    srand(0);
+    for(i = 0; i < numconfigurations; ++i) {
+        for(j = 0; j < dof; ++j) {
+            configurations[i*dof+j] = initialvalues[j] + 0.5*((OpenRAVEReal)rand()/RAND_MAX-0.5);
+        }
+    }
+
+    int* collisions = (int*)malloc(sizeof(int)*numconfigurations);
+
+    // one call per configuration
+    double starttime = GetTime();
+    int numcollisions = 0;
+    ORCEnvironmentLock(env);
+    for(i = 0; i < numconfigurations; ++i) {
+        ORCBodySetDOFValues(robot, configurations+i*dof);
+        numcollisions += ORCEnvironmentCheckCollision(env, robot);
+    }
+    ORCBodySetDOFValues(robot, initialvalues);
+    ORCEnvironmentUnlock(env);
+    double percalltime = GetTime()-starttime;
+
+    starttime = GetTime();
+    int numbatchcollisions = ORCBodyCheckConfigurations(robot, configurations, numconfigurations, 0, 1, collisions, NULL, NULL);
+    double batchtime = GetTime()-starttime;
+
+    starttime = GetTime();
+    int numparallelcollisions = ORCBodyCheckConfigurations(robot, configurations, numconfigurations, 0, numthreads, collisions, NULL, NULL);
+    double paralleltime = GetTime()-starttime;
+
+    printf("%d configurations of %d dofs and %d links\n", numconfigurations, dof, numlinks);
+    printf("per call: %f configurations/s, %d in collision\n", numconfigurations/percalltime, numcollisions);
+    printf("batch: %f configurations/s, %d in collision\n", numconfigurations/batchtime, numbatchcollisions);
+    printf("batch with %d threads: %f configurations/s, %d in collision\n", numthreads, numconfigurations/paralleltime, numparallelcollisions);
+
+    free(collisions);
+    free(configurations);
+    free(initialvalues);
+    for(i = 0; i < numrobots; ++i) {
+        ORCInterfaceRelease(robots[i]);
+    }
+    free(robots);
+    ORCEnvironmentDestroy(env);
+    ORCEnvironmentRelease(env);
+    ORCDestroy();
+    return 0;
+}
@@ -0,0 +1,626 @@
+/** \example orcollisionbenchmark.cpp
+
+    Records the collision queries of real planning runs and replays them on several collision checkers, so that the
+    checkers can be compared on identical workloads.
+
+    In record mode, the collision checker of the environment is wrapped by a checker that forwards every query and
+    saves its type, collision options, result and the states (transform, dof values, link enable states and for robots
+    the active dofs) of the queried bodies. Then
+    birrt plans between random configurations of the arm of the first robot of the scene.
+
+    In replay mode, the queries are executed in order with each checker after restoring the recorded body states.
+    For each query type (env, bodybody, link, linklink, linkbody, linkenv, bodyenv, self, linkself, ray, raylink,
+    raybody) the number of queries, the latency percentiles and the number of results that differ from the recorded
+    ones are printed, followed by the total throughput of the checker.
+
+    Usage:
+    \verbatim
+    orcollisionbenchmark record queryfile [numplans] [scene] [checker]
+    orcollisionbenchmark replay queryfile [scene] [checker1 checker2 ...]
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+#include <boost/format.hpp>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+/// \brief state of a body when a query was recorded
+struct RecordedBodyState
+{
+    RecordedBodyState() : bRobot(false), affinedofs(0) {
+    }
+    std::string name;
+    Transform transform;
+    std::vector<dReal> vdofvalues;
+    std::vector<uint8_t> vlinkenablestates; ///< \see KinBody::GetLinkEnableStates
+    bool bRobot; ///< if true, the active dofs below are valid
+    std::vector<int> vactivedofindices;
+    int affinedofs; ///< \see RobotBase::GetAffineDOF
+    Vector vaffinerotationaxis;
+};
+
+/// \brief a recorded collision query
+struct RecordedQuery
+{
+    RecordedQuery() : options(0), bCollision(false) {
+    }
+    std::string type; ///< name of the CheckCollision variant, see the example description
+    int options; ///< collision options of the checker during the query
+    bool bCollision; ///< result of the query when it was recorded
+    std::vector<RecordedBodyState> vstates; ///< states of the bodies passed to the query
+    std::vector<std::string> vlinks; ///< pairs of body and link names for the links passed to the query
+    std::vector<std::string> vexcluded; ///< names of the excluded bodies for the queries taking an exclusion list
+    RAY ray;
+};
+
+static void WriteQuery(std::ostream& O, const RecordedQuery& query)
+{
+    O << query.type << " " << query.options << " " << (int)query.bCollision << " " << query.vstates.size();
+    for(size_t istate = 0; istate < query.vstates.size(); ++istate) {
+        const RecordedBodyState& state = query.vstates[istate];
+        O << " " << state.name << " " << state.transform << " " << state.vdofvalues.size();
+        for(size_t idof = 0; idof < state.vdofvalues.size(); ++idof) {
+            O << " " << state.vdofvalues[idof];
+        }
+        O << " " << state.vlinkenablestates.size();
+        for(size_t ilink = 0; ilink < state.vlinkenablestates.size(); ++ilink) {
+            O << " " << (int)state.vlinkenablestates[ilink];
+        }
+        O << " " << (int)state.bRobot;
+        if( state.bRobot ) {
+            O << " " << state.vactivedofindices.size();
+            for(size_t idof = 0; idof < state.vactivedofindices.size(); ++idof) {
+                O << " " << state.vactivedofindices[idof];
+            }
+            O << " " << state.affinedofs << " " << state.vaffinerotationaxis.x << " " << state.vaffinerotationaxis.y << " " << state.vaffinerotationaxis.z;
+        }
+    }
+    O << " " << query.vlinks.size()/2;
+    for(size_t i = 0; i < query.vlinks.size(); ++i) {
+        O << " " << query.vlinks[i];
+    }
+    O << " " << query.vexcluded.size();
+    for(size_t i = 0; i < query.vexcluded.size(); ++i) {
+        O << " " << query.vexcluded[i];
+    }
+    O << " " << query.ray.pos.x << " " << query.ray.pos.y << " " << query.ray.pos.z << " " << query.ray.dir.x << " " << query.ray.dir.y << " " << query.ray.dir.z << endl;
+}
+
+static bool ReadQuery(std::istream& I, RecordedQuery& query)
+{
+    int bCollision = 0;
+    size_t numstates = 0, numlinks = 0, numexcluded = 0;
+    I >> query.type >> query.options >> bCollision >> numstates;
+    if( !I ) {
+        return false;
+    }
+    query.bCollision = bCollision != 0;
+    query.vstates.resize(numstates);
+    for(size_t istate = 0; istate < numstates; ++istate) {
+        RecordedBodyState& state = query.vstates[istate];
+        size_t numdof = 0, numlinks = 0;
+        I >> state.name >> state.transform >> numdof;
+        state.vdofvalues.resize(numdof);
+        for(size_t idof = 0; idof < numdof; ++idof) {
+            I >> state.vdofvalues[idof];
+        }
+        I >> numlinks;
+        state.vlinkenablestates.resize(numlinks);
+        for(size_t ilink = 0; ilink < numlinks; ++ilink) {
+            int enabled = 0;
+            I >> enabled;
+            state.vlinkenablestates[ilink] = enabled != 0;
+        }
+        int bRobot = 0;
+        I >> bRobot;
+        state.bRobot = bRobot != 0;
+        if( state.bRobot ) {
+            size_t numactivedofs = 0;
+            I >> numactivedofs;
+            state.vactivedofindices.resize(numactivedofs);
+            for(size_t idof = 0; idof < numactivedofs; ++idof) {
+                I >> state.vactivedofindices[idof];
+            }
+            I >> state.affinedofs >> state.vaffinerotationaxis.x >> state.vaffinerotationaxis.y >> state.vaffinerotationaxis.z;
+        }
+    }
+    I >> numlinks;
+    query.vlinks.resize(2*numlinks);
+    for(size_t i = 0; i < query.vlinks.size(); ++i) {
+        I >> query.vlinks[i];
+    }
+    I >> numexcluded;
+    query.vexcluded.resize(numexcluded);
+    for(size_t i = 0; i < numexcluded; ++i) {
+        I >> query.vexcluded[i];
+    }
+    I >> query.ray.pos.x >> query.ray.pos.y >> query.ray.pos.z >> query.ray.dir.x >> query.ray.dir.y >> query.ray.dir.z;
+    return !!I;
+}
+
+/// \brief forwards all queries to another checker and records them
+///
+/// The name of the checker to forward to is passed as the first argument when creating the interface.
+class RecordingCollisionChecker : public CollisionCheckerBase
+{
+public:
+    RecordingCollisionChecker(EnvironmentBasePtr penv, std::istream& sinput) : CollisionCheckerBase(penv) {
+        __description = "Forwards all collision queries to another checker and records them, used for benchmarking";
+        std::string checkername;
+        sinput >> checkername;
+        _pchecker = RaveCreateCollisionChecker(penv, checkername);
+        if( !_pchecker ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("failed to create collision checker %s", checkername, ORE_InvalidArguments);
+        }
+    }
+
+    static InterfaceBasePtr Create(EnvironmentBasePtr penv, std::istream& sinput) {
+        return InterfaceBasePtr(new RecordingCollisionChecker(penv, sinput));
+    }
+
+    const std::vector<RecordedQuery>& GetQueries() const {
+        return _vqueries;
+    }
+
+    virtual bool SetCollisionOptions(int collisionoptions) {
+        return _pchecker->SetCollisionOptions(collisionoptions);
+    }
+    virtual int GetCollisionOptions() const {
+        return _pchecker->GetCollisionOptions();
+    }
+    virtual void SetTolerance(dReal tolerance) {
+        _pchecker->SetTolerance(tolerance);
+    }
+    virtual void SetGeometryGroup(const std::string& groupname) {
+        _pchecker->SetGeometryGroup(groupname);
+    }
+    virtual const std::string& GetGeometryGroup() const {
+        return _pchecker->GetGeometryGroup();
+    }
+    virtual bool SetBodyGeometryGroup(KinBodyConstPtr pbody, const std::string& groupname) {
+        return _pchecker->SetBodyGeometryGroup(pbody, groupname);
+    }
+    virtual const std::string& GetBodyGeometryGroup(KinBodyConstPtr pbody) const {
+        return _pchecker->GetBodyGeometryGroup(pbody);
+    }
+    virtual bool InitEnvironment() {
+        return _pchecker->InitEnvironment();
+    }
+    virtual void DestroyEnvironment() {
+        _pchecker->DestroyEnvironment();
+    }
+    virtual bool InitKinBody(KinBodyPtr pbody) {
+        return _pchecker->InitKinBody(pbody);
+    }
+    virtual void RemoveKinBody(KinBodyPtr pbody) {
+        _pchecker->RemoveKinBody(pbody);
+    }
+
+    virtual bool CheckCollision(KinBodyConstPtr pbody1, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("env", _pchecker->CheckCollision(pbody1, report), pbody1);
+    }
+    virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("bodybody", _pchecker->CheckCollision(pbody1, pbody2, report), pbody1, pbody2);
+    }
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("link", _pchecker->CheckCollision(plink, report), plink->GetParent(), KinBodyConstPtr(), plink);
+    }
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink1, KinBody::LinkConstPtr plink2, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("linklink", _pchecker->CheckCollision(plink1, plink2, report), plink1->GetParent(), plink2->GetParent(), plink1, plink2);
+    }
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("linkbody", _pchecker->CheckCollision(plink, pbody, report), plink->GetParent(), pbody, plink);
+    }
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report = CollisionReportPtr()) {
+        bool bCollision = _pchecker->CheckCollision(plink, vbodyexcluded, vlinkexcluded, report);
+        if( vlinkexcluded.size() > 0 ) {
+            // link exclusions are rare and not replayed
+            return bCollision;
+        }
+        return _Record("linkenv", bCollision, plink->GetParent(), KinBodyConstPtr(), plink, KinBody::LinkConstPtr(), &vbodyexcluded);
+    }
+    virtual bool CheckCollision(KinBodyConstPtr pbody, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report = CollisionReportPtr()) {
+        bool bCollision = _pchecker->CheckCollision(pbody, vbodyexcluded, vlinkexcluded, report);
+        if( vlinkexcluded.size() > 0 ) {
+            return bCollision;
+        }
+        return _Record("bodyenv", bCollision, pbody, KinBodyConstPtr(), KinBody::LinkConstPtr(), KinBody::LinkConstPtr(), &vbodyexcluded);
+    }
+    virtual bool CheckCollision(const RAY& ray, KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("raylink", _pchecker->CheckCollision(ray, plink, report), plink->GetParent(), KinBodyConstPtr(), plink, KinBody::LinkConstPtr(), NULL, &ray);
+    }
+    virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("raybody", _pchecker->CheckCollision(ray, pbody, report), pbody, KinBodyConstPtr(), KinBody::LinkConstPtr(), KinBody::LinkConstPtr(), NULL, &ray);
+    }
+    virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("ray", _pchecker->CheckCollision(ray, report), KinBodyConstPtr(), KinBodyConstPtr(), KinBody::LinkConstPtr(), KinBody::LinkConstPtr(), NULL, &ray);
+    }
+    virtual bool CheckCollision(const TriMesh& trimesh, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        return _pchecker->CheckCollision(trimesh, pbody, report);
+    }
+    virtual bool CheckCollision(const TriMesh& trimesh, CollisionReportPtr report = CollisionReportPtr()) {
+        return _pchecker->CheckCollision(trimesh, report);
+    }
+    virtual bool CheckCollision(const AABB& ab, const Transform& aabbPose, CollisionReportPtr report = CollisionReportPtr()) {
+        return _pchecker->CheckCollision(ab, aabbPose, report);
+    }
+    virtual bool CheckCollision(const AABB& ab, const Transform& aabbPose, const std::vector<KinBodyConstPtr>& vbodies, CollisionReportPtr report = CollisionReportPtr()) {
+        return _pchecker->CheckCollision(ab, aabbPose, vbodies, report);
+    }
+    virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("self", _pchecker->CheckStandaloneSelfCollision(pbody, report), pbody);
+    }
+    virtual bool CheckStandaloneSelfCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        return _Record("linkself", _pchecker->CheckStandaloneSelfCollision(plink, report), plink->GetParent(), KinBodyConstPtr(), plink);
+    }
+
+protected:
+    static void _AddState(RecordedQuery& query, KinBodyConstPtr pbody)
+    {
+        query.vstates.push_back(RecordedBodyState());
+        RecordedBodyState& state = query.vstates.back();
+        state.name = pbody->GetName();
+        state.transform = pbody->GetTransform();
+        pbody->GetDOFValues(state.vdofvalues);
+        pbody->GetLinkEnableStates(state.vlinkenablestates);
+        // checkers like fcl track the active dofs of robots, so they change which links are updated
+        RobotBaseConstPtr probot = RaveInterfaceConstCast<RobotBase>(pbody);
+        if( !!probot ) {
+            state.bRobot = true;
+            state.vactivedofindices = probot->GetActiveDOFIndices();
+            state.affinedofs = probot->GetAffineDOF();
+            state.vaffinerotationaxis = probot->GetAffineRotationAxis();
+        }
+    }
+
+    static void _AddLink(RecordedQuery& query, KinBody::LinkConstPtr plink)
+    {
+        query.vlinks.push_back(plink->GetParent()->GetName());
+        query.vlinks.push_back(plink->GetName());
+    }
+
+    bool _Record(const char* type, bool bCollision, KinBodyConstPtr pbody1, KinBodyConstPtr pbody2=KinBodyConstPtr(), KinBody::LinkConstPtr plink1=KinBody::LinkConstPtr(), KinBody::LinkConstPtr plink2=KinBody::LinkConstPtr(), const std::vector<KinBodyConstPtr>* pvbodyexcluded=NULL, const RAY* pray=NULL)
+    {
+        _vqueries.push_back(RecordedQuery());
+        RecordedQuery& query = _vqueries.back();
+        query.type = type;
+        query.options = _pchecker->GetCollisionOptions();
+        query.bCollision = bCollision;
+        if( !!pbody1 ) {
+            _AddState(query, pbody1);
+        }
+        if( !!pbody2 && pbody2 != pbody1 ) {
+            _AddState(query, pbody2);
+        }
+        if( !!plink1 ) {
+            _AddLink(query, plink1);
+        }
+        if( !!plink2 ) {
+            _AddLink(query, plink2);
+        }
+        if( !!pvbodyexcluded ) {
+            for(size_t ibody = 0; ibody < pvbodyexcluded->size(); ++ibody) {
+                query.vexcluded.push_back(pvbodyexcluded->at(ibody)->GetName());
+            }
+        }
+        if( !!pray ) {
+            query.ray = *pray;
+        }
+        return bCollision;
+    }
+
+    CollisionCheckerBasePtr _pchecker; ///< checker doing the actual queries
+    std::vector<RecordedQuery> _vqueries;
+};
+
+/// \brief latencies of all the queries of one type
+struct QueryTypeStatistics
+{
+    QueryTypeStatistics() : numcollisions(0), nummismatches(0) {
+    }
+    std::vector<uint64_t> vlatencies; ///< ns
+    int numcollisions;
+    int nummismatches; ///< number of results different from the recorded ones
+};
+
+class CollisionBenchmarkExample : public OpenRAVEExample
+{
+public:
+    CollisionBenchmarkExample() : OpenRAVEExample("") {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        if( argc < 3 ) {
+            RAVELOG_INFO("orcollisionbenchmark record queryfile [numplans] [scene] [checker]\n");
+            RAVELOG_INFO("orcollisionbenchmark replay queryfile [scene] [checker1 checker2 ...]\n");
+            return;
+        }
+        string mode = argv[1];
+        string queryfilename = argv[2];
+        if( mode == "record" ) {
+            int numplans = argc > 3 ? atoi(argv[3]) : 10;
+            string scenefilename = argc > 4 ? argv[4] : "data/lab1.env.xml";
+            penv->Load(scenefilename);
+            string checkername = argc > 5 ? argv[5] : (!!penv->GetCollisionChecker() ? penv->GetCollisionChecker()->GetXMLId() : string("ode"));
+            _Record(queryfilename, numplans, checkername);
+        }
+        else if( mode == "replay" ) {
+            string scenefilename = argc > 3 ? argv[3] : "data/lab1.env.xml";
+            std::vector<string> vcheckernames;
+            for(int iarg = 4; iarg < argc; ++iarg) {
+                vcheckernames.push_back(argv[iarg]);
+            }
+            if( vcheckernames.size() == 0 ) {
+                vcheckernames.push_back("fcl_");
+                vcheckernames.push_back("ode");
+                vcheckernames.push_back("pqp");
+                vcheckernames.push_back("bullet");
+            }
+            penv->Load(scenefilename);
+            _Replay(queryfilename, vcheckernames);
+        }
+        else {
+            RAVELOG_WARN_FORMAT("unknown mode %s", mode);
+        }
+    }
+
+protected:
+    /// \brief plans numplans times with the arm of the first robot while recording the collision queries
+    void _Record(const string& queryfilename, int numplans, const string& checkername)
+    {
+        UserDataPtr handle = RaveRegisterInterface(PT_CollisionChecker, "recordingchecker", OPENRAVE_COLLISIONCHECKER_HASH, OPENRAVE_ENVIRONMENT_HASH, RecordingCollisionChecker::Create);
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        boost::shared_ptr<RecordingCollisionChecker> precorder = boost::dynamic_pointer_cast<RecordingCollisionChecker>(RaveCreateCollisionChecker(penv, "recordingchecker " + checkername));
+        penv->SetCollisionChecker(precorder);
+
+        std::vector<RobotBasePtr> vrobots;
+        penv->GetRobots(vrobots);
+        RobotBasePtr probot = vrobots.at(0);
+        RobotBase::ManipulatorPtr pmanip = probot->GetManipulators().at(0);
+        probot->SetActiveDOFs(pmanip->GetArmIndices());
+        std::vector<dReal> vlower, vupper;
+        probot->GetActiveDOFLimits(vlower, vupper);
+
+        PlannerBasePtr planner = RaveCreatePlanner(penv, "birrt");
+        int numsuccessful = 0;
+        for(int iplan = 0; iplan < numplans; ++iplan) {
+            PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+            params->_nMaxIterations = 4000;
+            params->SetRobotActiveJoints(probot);
+            params->vgoalconfig.resize(probot->GetActiveDOF());
+            {
+                RobotBase::RobotStateSaver saver(probot);
+                while(1) {
+                    for(size_t i = 0; i < vlower.size(); ++i) {
+                        params->vgoalconfig[i] = vlower[i] + (vupper[i]-vlower[i])*RaveRandomFloat();
+                    }
+                    probot->SetActiveDOFValues(params->vgoalconfig);
+                    if( !penv->CheckCollision(probot) && !probot->CheckSelfCollision() ) {
+                        break;
+                    }
+                }
+            }
+            probot->GetActiveDOFValues(params->vinitialconfig);
+            TrajectoryBasePtr ptraj = RaveCreateTrajectory(penv, "");
+            if( planner->InitPlan(probot, params) && planner->PlanPath(ptraj).HasSolution() ) {
+                ++numsuccessful;
+                // continue from the goal so that the next plan starts elsewhere
+                std::vector<dReal> vgoal;
+                ptraj->GetWaypoint(-1, vgoal, probot->GetActiveConfigurationSpecification());
+                probot->SetActiveDOFValues(vgoal);
+            }
+        }
+
+        const std::vector<RecordedQuery>& vqueries = precorder->GetQueries();
+        std::ofstream f(queryfilename.c_str());
+        f << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+        for(size_t iquery = 0; iquery < vqueries.size(); ++iquery) {
+            WriteQuery(f, vqueries[iquery]);
+        }
+        RAVELOG_INFO_FORMAT("recorded %d queries of %d/%d successful plans with %s into %s", vqueries.size()%numsuccessful%numplans%checkername%queryfilename);
+
+        // the recording checker has to be removed before the interface is unregistered
+        penv->SetCollisionChecker(RaveCreateCollisionChecker(penv, checkername));
+    }
+
+    /// \brief replays the queries of queryfilename with every checker and prints their latency distributions
+    void _Replay(const string& queryfilename, const std::vector<string>& vcheckernames)
+    {
+        std::vector<RecordedQuery> vqueries;
+        {
+            std::ifstream f(queryfilename.c_str());
+            RecordedQuery query;
+            while( ReadQuery(f, query) ) {
+                vqueries.push_back(query);
+            }
+        }
+        RAVELOG_INFO_FORMAT("replaying %d queries from %s", vqueries.size()%queryfilename);
+
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        for(size_t ichecker = 0; ichecker < vcheckernames.size(); ++ichecker) {
+            CollisionCheckerBasePtr pchecker = RaveCreateCollisionChecker(penv, vcheckernames[ichecker]);
+            if( !pchecker ) {
+                RAVELOG_WARN_FORMAT("collision checker %s is not available, skipping", vcheckernames[ichecker]);
+                continue;
+            }
+            penv->SetCollisionChecker(pchecker);
+
+            std::map<string, QueryTypeStatistics> mapstatistics;
+            int numskipped = 0;
+            uint64_t totaltime = 0;
+            for(size_t iquery = 0; iquery < vqueries.size(); ++iquery) {
+                const RecordedQuery& query = vqueries[iquery];
+                if( !_SetQueryState(query) ) {
+                    ++numskipped;
+                    continue;
+                }
+                CollisionOptionsStateSaver optionsaver(pchecker, query.options, false);
+                bool bCollision = false;
+                uint64_t starttime = utils::GetNanoPerformanceTime();
+                if( !_ExecuteQuery(pchecker, query, bCollision) ) {
+                    ++numskipped;
+                    continue;
+                }
+                uint64_t elapsedtime = utils::GetNanoPerformanceTime() - starttime;
+                totaltime += elapsedtime;
+                QueryTypeStatistics& stats = mapstatistics[query.type];
+                stats.vlatencies.push_back(elapsedtime);
+                if( bCollision ) {
+                    stats.numcollisions++;
+                }
+                if( bCollision != query.bCollision ) {
+                    stats.nummismatches++;
+                }
+            }
+
+            RAVELOG_INFO_FORMAT("checker %s:", vcheckernames[ichecker]);
+            RAVELOG_INFO("type count collisions mismatches mean(us) p50(us) p90(us) p99(us) max(us)\n");
+            size_t numexecuted = 0;
+            for(std::map<string, QueryTypeStatistics>::iterator it = mapstatistics.begin(); it != mapstatistics.end(); ++it) {
+                std::vector<uint64_t>& vlatencies = it->second.vlatencies;
+                std::sort(vlatencies.begin(), vlatencies.end());
+                uint64_t sum = 0;
+                for(size_t i = 0; i < vlatencies.size(); ++i) {
+                    sum += vlatencies[i];
+                }
+                numexecuted += vlatencies.size();
+                RAVELOG_INFO_FORMAT("%s %d %d %d %.3f %.3f %.3f %.3f %.3f", it->first%vlatencies.size()%it->second.numcollisions%it->second.nummismatches%(sum*1e-3/vlatencies.size())%(_GetPercentile(vlatencies, 0.5)*1e-3)%(_GetPercentile(vlatencies, 0.9)*1e-3)%(_GetPercentile(vlatencies, 0.99)*1e-3)%(vlatencies.back()*1e-3));
+            }
+            RAVELOG_INFO_FORMAT("%d queries in %fs, %f queries/s, %d skipped", numexecuted%(totaltime*1e-9)%(totaltime > 0 ? numexecuted/(totaltime*1e-9) : 0)%numskipped);
+        }
+    }
+
+    static uint64_t _GetPercentile(const std::vector<uint64_t>& vsorted, dReal fpercentile)
+    {
+        size_t index = std::min(vsorted.size()-1, (size_t)(fpercentile*vsorted.size()));
+        return vsorted.at(index);
+    }
+
+    /// \brief restores the recorded body states, returns false if a body does not exist in the scene
+    bool _SetQueryState(const RecordedQuery& query)
+    {
+        for(size_t istate = 0; istate < query.vstates.size(); ++istate) {
+            const RecordedBodyState& state = query.vstates[istate];
+            KinBodyPtr pbody = penv->GetKinBody(state.name);
+            if( !pbody || pbody->GetDOF() != (int)state.vdofvalues.size() || pbody->GetLinks().size() != state.vlinkenablestates.size() ) {
+                return false;
+            }
+            pbody->SetLinkEnableStates(state.vlinkenablestates);
+            if( state.bRobot ) {
+                RobotBasePtr probot = RaveInterfaceCast<RobotBase>(pbody);
+                if( !probot ) {
+                    return false;
+                }
+                probot->SetActiveDOFs(state.vactivedofindices, state.affinedofs, state.vaffinerotationaxis);
+            }
+            if( state.vdofvalues.size() > 0 ) {
+                pbody->SetDOFValues(state.vdofvalues, state.transform, KinBody::CLA_Nothing);
+            }
+            else {
+                pbody->SetTransform(state.transform);
+            }
+        }
+        return true;
+    }
+
+    KinBody::LinkPtr _GetLink(const RecordedQuery& query, size_t ilink)
+    {
+        if( 2*ilink+1 >= query.vlinks.size() ) {
+            return KinBody::LinkPtr();
+        }
+        KinBodyPtr pbody = penv->GetKinBody(query.vlinks[2*ilink]);
+        if( !pbody ) {
+            return KinBody::LinkPtr();
+        }
+        return pbody->GetLink(query.vlinks[2*ilink+1]);
+    }
+
+    KinBodyConstPtr _GetBody(const RecordedQuery& query, size_t ibody)
+    {
+        if( ibody >= query.vstates.size() ) {
+            return KinBodyConstPtr();
+        }
+        return penv->GetKinBody(query.vstates[ibody].name);
+    }
+
+    /// \brief executes the query with pchecker, returns false if the query could not be reconstructed
+    bool _ExecuteQuery(CollisionCheckerBasePtr pchecker, const RecordedQuery& query, bool& bCollision)
+    {
+        KinBodyConstPtr pbody1 = _GetBody(query, 0), pbody2 = _GetBody(query, 1);
+        KinBody::LinkConstPtr plink1 = _GetLink(query, 0), plink2 = _GetLink(query, 1);
+        if( query.type == "env" && !!pbody1 ) {
+            bCollision = pchecker->CheckCollision(pbody1);
+        }
+        else if( query.type == "bodybody" && !!pbody1 ) {
+            // both bodies are the same when a body is checked against itself
+            bCollision = pchecker->CheckCollision(pbody1, !!pbody2 ? pbody2 : pbody1);
+        }
+        else if( query.type == "link" && !!plink1 ) {
+            bCollision = pchecker->CheckCollision(plink1);
+        }
+        else if( query.type == "linklink" && !!plink1 && !!plink2 ) {
+            bCollision = pchecker->CheckCollision(plink1, plink2);
+        }
+        else if( query.type == "linkbody" && !!plink1 && query.vstates.size() > 0 ) {
+            bCollision = pchecker->CheckCollision(plink1, query.vstates.size() > 1 ? pbody2 : pbody1);
+        }
+        else if( (query.type == "linkenv" && !!plink1) || (query.type == "bodyenv" && !!pbody1) ) {
+            std::vector<KinBodyConstPtr> vbodyexcluded;
+            std::vector<KinBody::LinkConstPtr> vlinkexcluded;
+            for(size_t ibody = 0; ibody < query.vexcluded.size(); ++ibody) {
+                KinBodyPtr pbody = penv->GetKinBody(query.vexcluded[ibody]);
+                if( !!pbody ) {
+                    vbodyexcluded.push_back(pbody);
+                }
+            }
+            if( query.type == "linkenv" ) {
+                bCollision = pchecker->CheckCollision(plink1, vbodyexcluded, vlinkexcluded);
+            }
+            else {
+                bCollision = pchecker->CheckCollision(pbody1, vbodyexcluded, vlinkexcluded);
+            }
+        }
+        else if( query.type == "self" && !!pbody1 ) {
+            bCollision = pchecker->CheckStandaloneSelfCollision(pbody1);
+        }
+        else if( query.type == "linkself" && !!plink1 ) {
+            bCollision = pchecker->CheckStandaloneSelfCollision(plink1);
+        }
+        else if( query.type == "ray" ) {
+            bCollision = pchecker->CheckCollision(query.ray);
+        }
+        else if( query.type == "raylink" && !!plink1 ) {
+            bCollision = pchecker->CheckCollision(query.ray, plink1);
+        }
+        else if( query.type == "raybody" && !!pbody1 ) {
+            bCollision = pchecker->CheckCollision(query.ray, pbody1);
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::CollisionBenchmarkExample example;
+    return example.main(argc,argv);
+}
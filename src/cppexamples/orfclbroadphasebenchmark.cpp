@@ -0,0 +1,162 @@
+/** \example orfclbroadphasebenchmark.cpp
+
+    Compares the broadphase algorithms of the fcl_ collision checker against its adaptive selection (SetBroadphaseAlgorithm Auto)
+    on scenes of a moving robot next to a growing number of small box items. Between every query the robot moves to a random
+    configuration and a fraction of the items are displaced.
+
+    Usage:
+    \verbatim
+    orfclbroadphasebenchmark [maxitems] [numqueries] [movingfraction] [robot]
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <sstream>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+class FCLBroadphaseBenchmarkExample : public OpenRAVEExample
+{
+public:
+    FCLBroadphaseBenchmarkExample() : OpenRAVEExample("") {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        int maxitems = argc > 1 ? atoi(argv[1]) : 4096;
+        int numqueries = argc > 2 ? atoi(argv[2]) : 2000;
+        dReal fmovingfraction = argc > 3 ? atof(argv[3]) : 0.01;
+        string robotfilename = argc > 4 ? argv[4] : "robots/barrettwam.robot.xml";
+
+        CollisionCheckerBasePtr pchecker = RaveCreateCollisionChecker(penv, "fcl_");
+        if( !pchecker ) {
+            RAVELOG_WARN("fcl_ collision checker is not available\n");
+            return;
+        }
+        penv->SetCollisionChecker(pchecker);
+        penv->Load(robotfilename);
+        std::vector<RobotBasePtr> vrobots;
+        penv->GetRobots(vrobots);
+        if( vrobots.size() == 0 ) {
+            RAVELOG_WARN_FORMAT("failed to load robot %s", robotfilename);
+            return;
+        }
+        RobotBasePtr probot = vrobots.at(0);
+
+        const char* algorithms[] = { "Naive", "DynamicAABBTree2", "SpatialHashing", "Auto" };
+        const int numalgorithms = sizeof(algorithms)/sizeof(algorithms[0]);
+        std::stringstream ssheader;
+        ssheader << "numitems";
+        for(int ialgorithm = 0; ialgorithm < numalgorithms; ++ialgorithm) {
+            ssheader << " " << algorithms[ialgorithm] << "(ms/query)";
+        }
+        RAVELOG_INFO_FORMAT("%d queries per scene, %f of the items move between queries", numqueries%fmovingfraction);
+        RAVELOG_INFO_FORMAT("%s chosen", ssheader.str());
+
+        std::vector<KinBodyPtr> vitems;
+        for(int numitems = 8; numitems <= maxitems; numitems *= 8) {
+            _AddItems(vitems, numitems);
+            std::stringstream ssresult, sschosen;
+            ssresult << numitems;
+            for(int ialgorithm = 0; ialgorithm < numalgorithms; ++ialgorithm) {
+                dReal fQueryTime = _MeasureQueryTime(probot, vitems, algorithms[ialgorithm], numqueries, fmovingfraction);
+                ssresult << " " << fQueryTime*1000;
+            }
+            // algorithms the adaptive selection ended with
+            std::stringstream ssinput, ssoutput;
+            ssinput << "GetBroadphaseStatistics";
+            if( pchecker->SendCommand(ssoutput, ssinput) ) {
+                std::string line;
+                while( !!getline(ssoutput, line) ) {
+                    std::stringstream ssline(line);
+                    std::string type, algorithm;
+                    ssline >> type >> algorithm;
+                    sschosen << " " << type << ":" << algorithm;
+                }
+            }
+            RAVELOG_INFO_FORMAT("%s%s", ssresult.str()%sschosen.str());
+        }
+    }
+
+protected:
+    /// \brief adds small boxes in a grid to the side of the robot until there are numitems of them
+    void _AddItems(std::vector<KinBodyPtr>& vitems, int numitems)
+    {
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        const dReal fspacing = 0.05;
+        const int numperside = 16;
+        std::vector<AABB> vboxes(1, AABB(Vector(0,0,0), Vector(0.015,0.015,0.015)));
+        while( (int)vitems.size() < numitems ) {
+            int index = (int)vitems.size();
+            KinBodyPtr pitem = RaveCreateKinBody(penv, "");
+            pitem->InitFromBoxes(vboxes, true);
+            pitem->SetName(str(boost::format("item%d")%index));
+            penv->Add(pitem, true);
+            Transform t;
+            t.trans = Vector(0.6 + fspacing*(index%numperside), -0.4 + fspacing*((index/numperside)%numperside), 0.02 + fspacing*(index/(numperside*numperside)));
+            pitem->SetTransform(t);
+            vitems.push_back(pitem);
+        }
+    }
+
+    /// \brief returns the average time of one robot/environment query in seconds
+    dReal _MeasureQueryTime(RobotBasePtr probot, const std::vector<KinBodyPtr>& vitems, const std::string& algorithm, int numqueries, dReal fmovingfraction)
+    {
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        CollisionCheckerBasePtr pchecker = penv->GetCollisionChecker();
+        std::stringstream ssinput, ssoutput;
+        ssinput << "SetBroadphaseAlgorithm " << algorithm;
+        pchecker->SendCommand(ssoutput, ssinput);
+
+        RobotBase::RobotStateSaver saver(probot);
+        std::vector<dReal> vlower, vupper, vvalues(probot->GetDOF());
+        probot->GetDOFLimits(vlower, vupper);
+        std::vector<Transform> vitemtransforms(vitems.size());
+        for(size_t iitem = 0; iitem < vitems.size(); ++iitem) {
+            vitemtransforms[iitem] = vitems[iitem]->GetTransform();
+        }
+        int nummoving = (int)(fmovingfraction*vitems.size());
+
+        // same random sequence for every algorithm
+        srand(0);
+        int numcollisions = 0;
+        uint64_t elapsedtime = 0;
+        for(int iquery = 0; iquery < numqueries; ++iquery) {
+            for(size_t idof = 0; idof < vvalues.size(); ++idof) {
+                vvalues[idof] = vlower[idof] + (vupper[idof]-vlower[idof])*((dReal)rand()/RAND_MAX);
+            }
+            probot->SetDOFValues(vvalues);
+            for(int imoving = 0; imoving < nummoving; ++imoving) {
+                size_t iitem = rand()%vitems.size();
+                Transform t = vitemtransforms[iitem];
+                t.trans.z += 0.01*((dReal)rand()/RAND_MAX);
+                vitems[iitem]->SetTransform(t);
+            }
+            uint64_t starttime = utils::GetMicroTime();
+            if( penv->CheckCollision(KinBodyConstPtr(probot)) ) {
+                ++numcollisions;
+            }
+            elapsedtime += utils::GetMicroTime() - starttime;
+        }
+        for(size_t iitem = 0; iitem < vitems.size(); ++iitem) {
+            vitems[iitem]->SetTransform(vitemtransforms[iitem]);
+        }
+        RAVELOG_DEBUG_FORMAT("%s: %d/%d queries in collision", algorithm%numcollisions%numqueries);
+        return elapsedtime*1e-6/numqueries;
+    }
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::FCLBroadphaseBenchmarkExample example;
+    return example.main(argc,argv);
+}
@@ -0,0 +1,152 @@
+/** \example orgraspplanningbenchmark.cpp
+
+    Measures the pick cycle latency of the TaskManipulation GraspPlanning command, once with the grasps evaluated
+    serially and once for every power of two number of evaluation threads up to maxthreads. The grasp table holds
+    side grasps all around the target at three heights and two rolls, given as grasp transforms so that no grasper
+    planner is needed. Grasps are tried in table order, so every run evaluates the same grasps. The robot is not
+    moved, so every cycle starts from the same state. Prints the median, the mean and the maximum of the cycle times
+    and the number of cycles that found a grasp.
+
+    Usage:
+    \verbatim
+    orgraspplanningbenchmark [numcycles] [maxthreads] [scene] [targetname]
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+class GraspPlanningBenchmarkExample : public OpenRAVEExample
+{
+public:
+    GraspPlanningBenchmarkExample() : OpenRAVEExample("") {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        int numcycles = argc > 1 ? atoi(argv[1]) : 10;
+        int maxthreads = argc > 2 ? atoi(argv[2]) : (int)boost::thread::hardware_concurrency();
+        string scenefilename = argc > 3 ? argv[3] : "data/lab1.env.xml";
+        string targetname = argc > 4 ? argv[4] : "mug1";
+        penv->Load(scenefilename);
+
+        ModuleBasePtr ptaskmodule;
+        std::string graspcommand;
+        {
+            EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+            std::vector<RobotBasePtr> vrobots;
+            penv->GetRobots(vrobots);
+            KinBodyPtr ptarget = penv->GetKinBody(targetname);
+            if( vrobots.size() == 0 || !ptarget ) {
+                throw OPENRAVE_EXCEPTION_FORMAT("scene %s needs a robot and a body named %s", scenefilename%targetname, ORE_InvalidArguments);
+            }
+            RobotBasePtr probot = vrobots.at(0);
+
+            ModuleBasePtr pikfast = RaveCreateModule(penv,"ikfast");
+            penv->Add(pikfast,true,"");
+            stringstream ssin,ssout;
+            ssin << "LoadIKFastSolver " << probot->GetName() << " " << (int)IKP_Transform6D;
+            if( !pikfast->SendCommand(ssout,ssin) ) {
+                throw OPENRAVE_EXCEPTION_FORMAT0("failed to load iksolver", ORE_Assert);
+            }
+
+            ptaskmodule = RaveCreateModule(penv,"TaskManipulation");
+            penv->Add(ptaskmodule,true,probot->GetName());
+
+            std::vector<dReal> vgrasps;
+            _ComputeSideGrasps(ptarget, probot->GetActiveManipulator(), vgrasps);
+            stringstream sscmd;
+            sscmd << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+            sscmd << "GraspPlanning target " << targetname << " approachoffset 0.02 grasptrans_nocol 0 grasps " << vgrasps.size()/12 << " 12 ";
+            for(size_t i = 0; i < vgrasps.size(); ++i) {
+                sscmd << vgrasps[i] << " ";
+            }
+            sscmd << "seedgrasps 3 seedik 1 maxiter 1000 randomgrasps 0 randomdests 0 execute 0 outputtraj ";
+            graspcommand = sscmd.str();
+            RAVELOG_INFO_FORMAT("%d grasps, %d cycles, %d hardware threads", (vgrasps.size()/12)%numcycles%boost::thread::hardware_concurrency());
+        }
+
+        RAVELOG_INFO("numthreads median(s) mean(s) max(s) successes\n");
+        for(int numthreads = 1; numthreads <= std::max(maxthreads, 1); numthreads *= 2) {
+            std::vector<dReal> vtimes;
+            int numsuccesses = 0;
+            for(int icycle = 0; icycle < numcycles; ++icycle) {
+                EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+                stringstream ssin, ssout;
+                ssin << graspcommand << "numthreads " << numthreads;
+                uint64_t starttime = utils::GetMicroTime();
+                if( ptaskmodule->SendCommand(ssout,ssin) ) {
+                    ++numsuccesses;
+                }
+                vtimes.push_back(1e-6*(utils::GetMicroTime() - starttime));
+            }
+            std::sort(vtimes.begin(), vtimes.end());
+            dReal fsum = 0;
+            for(size_t i = 0; i < vtimes.size(); ++i) {
+                fsum += vtimes[i];
+            }
+            RAVELOG_INFO_FORMAT("%d %f %f %f %d/%d", numthreads%vtimes.at(vtimes.size()/2)%(fsum/vtimes.size())%vtimes.back()%numsuccesses%numcycles);
+        }
+    }
+
+protected:
+    /// \brief fills vgrasps with 12 values per grasp, the columns of the rotation and the translation of the manipulator
+    /// in the target frame. The tool direction points to the center of the target from all around it.
+    void _ComputeSideGrasps(KinBodyPtr ptarget, RobotBase::ManipulatorPtr pmanip, std::vector<dReal>& vgrasps)
+    {
+        const int numdirections = 16;
+        const dReal fstandoff = 0.05;
+        AABB ab = ptarget->ComputeAABB();
+        Transform tinvtarget = ptarget->GetTransform().inverse();
+        Vector vlocaldir = pmanip->GetLocalToolDirection();
+        vgrasps.resize(0);
+        for(int iheight = -1; iheight <= 1; ++iheight) {
+            for(int idirection = 0; idirection < numdirections; ++idirection) {
+                dReal fangle = 2*PI*idirection/numdirections;
+                Vector vdir(RaveCos(fangle), RaveSin(fangle), 0);
+                for(int iroll = 0; iroll < 2; ++iroll) {
+                    // tool direction along vdir, the other axes vertical and horizontal
+                    Vector vup(0,0,iroll == 0 ? 1 : -1);
+                    TransformMatrix tmtool;
+                    Vector vside = vup.cross(vdir);
+                    tmtool.m[0] = vside.x; tmtool.m[4] = vside.y; tmtool.m[8] = vside.z;
+                    tmtool.m[1] = vup.x; tmtool.m[5] = vup.y; tmtool.m[9] = vup.z;
+                    tmtool.m[2] = vdir.x; tmtool.m[6] = vdir.y; tmtool.m[10] = vdir.z;
+                    // rotate the local tool direction onto the z-axis of tmtool
+                    Transform tdir = matrixFromQuat(quatRotateDirection(vlocaldir, Vector(0,0,1)));
+                    Transform tgrasp = Transform(tmtool) * tdir;
+                    tgrasp.trans = ab.pos + Vector(0,0,0.5*iheight*ab.extents.z) - vdir*(RaveSqrt(ab.extents.x*ab.extents.x+ab.extents.y*ab.extents.y)+fstandoff);
+                    TransformMatrix tm = tinvtarget * tgrasp;
+                    for(int icolumn = 0; icolumn < 3; ++icolumn) {
+                        vgrasps.push_back(tm.m[icolumn]);
+                        vgrasps.push_back(tm.m[4+icolumn]);
+                        vgrasps.push_back(tm.m[8+icolumn]);
+                    }
+                    vgrasps.push_back(tm.trans.x);
+                    vgrasps.push_back(tm.trans.y);
+                    vgrasps.push_back(tm.trans.z);
+                }
+            }
+        }
+    }
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::GraspPlanningBenchmarkExample example;
+    return example.main(argc,argv);
+}
@@ -0,0 +1,352 @@
+/** \example orikfastbenchmark.cpp
+
+    Benchmarks the ikfast solvers bundled with the ikfastsolvers plugin on the same reachable end effector poses
+    every run. The poses are the forward kinematics of joint values sampled inside the joint limits by a mt19937 sampler
+    with a fixed seed. Every solver is timed three times:
+
+    - raw: the generated ComputeIk function alone, through the PerfTiming command of the solver.
+    - batch: the same poses packed 64 at a time into one contiguous layout and solved one after another with ComputeIk,
+      through the PerfTiming command. The latency of a pose is the time of its batch divided by the batch size.
+    - filtered: RobotBase::Manipulator::FindIKSolutions with IKFO_CheckEnvCollisions, which also runs the joint limit
+      checks, the custom filters and the collision checks of the solver.
+
+    For both, prints the solves per second, the 50th and 99th percentile latencies, the success rate and the mean number
+    of solutions, and writes them to a JSON file. If the file of an earlier run is given as baseline, returns 1 when the
+    solves per second of a solver dropped by more than the tolerance ratio or its success rate dropped by more than the
+    tolerance.
+
+    Usage:
+    \verbatim
+    orikfastbenchmark [numposes] [outputfile] [baselinefile] [tolerance]
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+/// \brief a bundled solver and the robot it was generated for. If the manipulator name is empty or does not match, all manipulators are tried.
+struct BenchmarkedIkSolver
+{
+    const char* solvername;
+    const char* robotfilename;
+    const char* manipname;
+};
+
+static const BenchmarkedIkSolver s_benchmarkediksolvers[] = {
+    {"wam7ikfast", "robots/barrettwam.robot.xml", "arm"},
+    {"pa10ikfast", "robots/pa10schunk.robot.xml", "arm"},
+    {"pumaikfast", "robots/puma.robot.xml", "arm"},
+    {"ikfast_pr2_head", "robots/pr2-beta-static.zae", "head"},
+    {"ikfast_pr2_head_torso", "robots/pr2-beta-static.zae", "head_torso"},
+    {"ikfast_pr2_leftarm", "robots/pr2-beta-static.zae", "leftarm"},
+    {"ikfast_pr2_leftarm_torso", "robots/pr2-beta-static.zae", "leftarm_torso"},
+    {"ikfast_pr2_rightarm", "robots/pr2-beta-static.zae", "rightarm"},
+    {"ikfast_pr2_rightarm_torso", "robots/pr2-beta-static.zae", "rightarm_torso"},
+    {"ikfast_schunk_lwa3", "robots/schunk-lwa3.zae", ""},
+    {"ikfast_katana5d", "robots/neuronics-katana.zae", "arm"},
+    {"ikfast_katana5d_trans", "robots/neuronics-katana.zae", ""},
+};
+
+/// \brief the seed of the sampler of the joint values, fixed so that every run solves the same poses
+static const uint32_t s_benchmarkseed = 0;
+
+/// \brief the number of poses packed into one contiguous layout by the batch timing
+static const int s_benchmarkbatchsize = 64;
+
+/// \brief timings of one solver on all poses
+class IkTimingStatistics
+{
+public:
+    IkTimingStatistics() : numposes(0), numsuccesses(0), numsolutions(0), totaltime(0), p50time(0), p99time(0) {
+    }
+
+    /// \brief adds the time of solving one pose in nano-seconds and the number of solutions it found
+    void Add(uint64_t solvetime, int nsolutions)
+    {
+        _vtimes.push_back(solvetime);
+        ++numposes;
+        totaltime += solvetime;
+        if( nsolutions > 0 ) {
+            ++numsuccesses;
+            numsolutions += nsolutions;
+        }
+    }
+
+    /// \brief computes the percentiles once all poses were added
+    void Finish()
+    {
+        if( _vtimes.size() == 0 ) {
+            return;
+        }
+        std::sort(_vtimes.begin(), _vtimes.end());
+        p50time = _vtimes[(size_t)(0.5*(_vtimes.size()-1))];
+        p99time = _vtimes[(size_t)(0.99*(_vtimes.size()-1))];
+    }
+
+    double GetSolvesPerSecond() const {
+        return totaltime > 0 ? numposes/(1e-9*totaltime) : 0;
+    }
+    double GetSuccessRate() const {
+        return numposes > 0 ? (double)numsuccesses/numposes : 0;
+    }
+    double GetMeanSolutions() const {
+        return numsuccesses > 0 ? (double)numsolutions/numsuccesses : 0;
+    }
+
+    void WriteJSON(std::ostream& O) const
+    {
+        O << "{\"solvespersec\": " << GetSolvesPerSecond() << ", \"p50latency\": " << 1e-9*p50time << ", \"p99latency\": " << 1e-9*p99time;
+        O << ", \"successrate\": " << GetSuccessRate() << ", \"meansolutions\": " << GetMeanSolutions() << ", \"numposes\": " << numposes << "}";
+    }
+
+    int numposes, numsuccesses, numsolutions;
+    uint64_t totaltime, p50time, p99time; ///< nano-seconds
+
+private:
+    std::vector<uint64_t> _vtimes;
+};
+
+/// \brief the results of one solver
+struct IkBenchmarkResult
+{
+    std::string solvername, robotfilename, manipname, iktypename;
+    IkTimingStatistics raw, batch, filtered;
+};
+
+class IkFastBenchmarkExample : public OpenRAVEExample
+{
+public:
+    IkFastBenchmarkExample() : OpenRAVEExample(""), _numregressions(0) {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        int numposes = argc > 1 ? atoi(argv[1]) : 1000;
+        string outputfilename = argc > 2 ? argv[2] : "ikfastbenchmark.json";
+        string baselinefilename = argc > 3 ? argv[3] : "";
+        dReal ftolerance = argc > 4 ? atof(argv[4]) : 0.2;
+
+        std::vector<IkBenchmarkResult> vresults;
+        for(size_t isolver = 0; isolver < sizeof(s_benchmarkediksolvers)/sizeof(s_benchmarkediksolvers[0]); ++isolver) {
+            IkBenchmarkResult result;
+            if( _BenchmarkSolver(s_benchmarkediksolvers[isolver], numposes, result) ) {
+                RAVELOG_INFO_FORMAT("%s (%s): raw %f solves/s, p50=%fus, p99=%fus, success=%f, solutions=%f", result.solvername%result.iktypename%result.raw.GetSolvesPerSecond()%(1e-3*result.raw.p50time)%(1e-3*result.raw.p99time)%result.raw.GetSuccessRate()%result.raw.GetMeanSolutions());
+                RAVELOG_INFO_FORMAT("%s (%s): batch %f solves/s (%fx raw), success=%f", result.solvername%result.iktypename%result.batch.GetSolvesPerSecond()%(result.batch.GetSolvesPerSecond()/result.raw.GetSolvesPerSecond())%result.batch.GetSuccessRate());
+                RAVELOG_INFO_FORMAT("%s (%s): filtered %f solves/s, p50=%fus, p99=%fus, success=%f, solutions=%f", result.solvername%result.iktypename%result.filtered.GetSolvesPerSecond()%(1e-3*result.filtered.p50time)%(1e-3*result.filtered.p99time)%result.filtered.GetSuccessRate()%result.filtered.GetMeanSolutions());
+                vresults.push_back(result);
+            }
+        }
+
+        std::stringstream ss;
+        ss << std::setprecision(9);
+        ss << "{\"numposes\": " << numposes << ", \"seed\": " << s_benchmarkseed << ", \"solvers\": {";
+        for(size_t iresult = 0; iresult < vresults.size(); ++iresult) {
+            const IkBenchmarkResult& result = vresults[iresult];
+            ss << (iresult > 0 ? "," : "") << "\n\"" << result.solvername << "\": {\"robot\": \"" << result.robotfilename << "\", \"manip\": \"" << result.manipname << "\", \"iktype\": \"" << result.iktypename << "\",\n  \"raw\": ";
+            result.raw.WriteJSON(ss);
+            ss << ",\n  \"batch\": ";
+            result.batch.WriteJSON(ss);
+            ss << ",\n  \"filtered\": ";
+            result.filtered.WriteJSON(ss);
+            ss << "}";
+        }
+        ss << "\n}}\n";
+        ofstream outputfile(outputfilename.c_str());
+        outputfile << ss.rdbuf();
+        RAVELOG_INFO_FORMAT("wrote results of %d solvers to %s", vresults.size()%outputfilename);
+
+        if( baselinefilename.size() > 0 ) {
+#ifdef OPENRAVE_RAPIDJSON
+            _numregressions = _CompareToBaseline(vresults, baselinefilename, ftolerance);
+#else
+            RAVELOG_WARN_FORMAT("openrave was built without rapidjson, cannot compare to baseline %s with tolerance %f", baselinefilename%ftolerance);
+#endif
+        }
+    }
+
+    /// \brief the number of solvers whose performance dropped compared to the baseline
+    int GetNumRegressions() const {
+        return _numregressions;
+    }
+
+protected:
+    /// \brief finds a manipulator of the robot matching the kinematics of the solver, and the ik type it is solved with
+    bool _SetupSolver(RobotBasePtr probot, IkSolverBasePtr psolver, const std::string& manipname, RobotBase::ManipulatorPtr& pmanip, IkParameterizationType& iktype)
+    {
+        std::vector<RobotBase::ManipulatorPtr> vmanips;
+        if( !!probot->GetManipulator(manipname) ) {
+            vmanips.push_back(probot->GetManipulator(manipname));
+        }
+        vmanips.insert(vmanips.end(), probot->GetManipulators().begin(), probot->GetManipulators().end());
+        for(size_t imanip = 0; imanip < vmanips.size(); ++imanip) {
+            const std::map<IkParameterizationType, std::string>& mapiktypes = RaveGetIkParameterizationMap();
+            for(std::map<IkParameterizationType, std::string>::const_iterator ittype = mapiktypes.begin(); ittype != mapiktypes.end(); ++ittype) {
+                // comparing the hashes first avoids the errors of initializing a solver with a different manipulator
+                if( psolver->Supports(ittype->first) && vmanips[imanip]->GetInverseKinematicsStructureHash(ittype->first) == psolver->GetKinematicsStructureHash() ) {
+                    if( vmanips[imanip]->SetIkSolver(psolver) ) {
+                        pmanip = vmanips[imanip];
+                        iktype = ittype->first;
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool _BenchmarkSolver(const BenchmarkedIkSolver& benchmarkedsolver, int numposes, IkBenchmarkResult& result)
+    {
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        penv->Reset();
+        if( !penv->Load(benchmarkedsolver.robotfilename) ) {
+            RAVELOG_WARN_FORMAT("%s: failed to load %s, skipping", benchmarkedsolver.solvername%benchmarkedsolver.robotfilename);
+            return false;
+        }
+        std::vector<RobotBasePtr> vrobots;
+        penv->GetRobots(vrobots);
+        IkSolverBasePtr psolver = RaveCreateIkSolver(penv, benchmarkedsolver.solvername);
+        RobotBase::ManipulatorPtr pmanip;
+        IkParameterizationType iktype = IKP_None;
+        if( vrobots.size() == 0 || !psolver || !_SetupSolver(vrobots.at(0), psolver, benchmarkedsolver.manipname, pmanip, iktype) ) {
+            RAVELOG_WARN_FORMAT("%s: no manipulator of %s matches the solver, skipping", benchmarkedsolver.solvername%benchmarkedsolver.robotfilename);
+            return false;
+        }
+        RobotBasePtr probot = pmanip->GetRobot();
+        result.solvername = benchmarkedsolver.solvername;
+        result.robotfilename = benchmarkedsolver.robotfilename;
+        result.manipname = pmanip->GetName();
+        result.iktypename = RaveGetIkParameterizationMap().find(iktype)->second;
+
+        // raw and batch, the solver samples its own joint values with the same seed
+        if( !_RunPerfTiming(psolver, numposes, 0, result.raw) || !_RunPerfTiming(psolver, numposes, s_benchmarkbatchsize, result.batch) ) {
+            RAVELOG_WARN_FORMAT("%s: PerfTiming failed, skipping", benchmarkedsolver.solvername);
+            return false;
+        }
+
+        // filtered, samples the joint values the same way as PerfTiming
+        {
+            RobotBase::RobotStateSaver saver(probot);
+            std::vector<dReal> vlower, vupper, vsample, vvalues(pmanip->GetArmIndices().size()), vinitialvalues;
+            probot->GetDOFLimits(vlower, vupper, pmanip->GetArmIndices());
+            probot->GetDOFValues(vinitialvalues);
+            SpaceSamplerBasePtr psampler = RaveCreateSpaceSampler(penv, "mt19937");
+            psampler->SetSeed(s_benchmarkseed);
+            std::vector< std::vector<dReal> > vsolutions;
+            for(int ipose = 0; ipose < numposes; ++ipose) {
+                psampler->SampleSequence(vsample, vvalues.size(), IT_Closed);
+                for(size_t j = 0; j < vvalues.size(); ++j) {
+                    if( vupper[j]-vlower[j] <= 2*PI ) {
+                        vvalues[j] = vlower[j] + vsample[j]*(vupper[j]-vlower[j]);
+                    }
+                    else {
+                        vvalues[j] = -PI + vsample[j]*2*PI;
+                    }
+                }
+                probot->SetDOFValues(vvalues, KinBody::CLA_Nothing, pmanip->GetArmIndices());
+                IkParameterization ikparam = pmanip->GetIkParameterization(iktype);
+                probot->SetDOFValues(vinitialvalues);
+                uint64_t starttime = utils::GetNanoPerformanceTime();
+                pmanip->FindIKSolutions(ikparam, vsolutions, IKFO_CheckEnvCollisions);
+                result.filtered.Add(utils::GetNanoPerformanceTime()-starttime, (int)vsolutions.size());
+            }
+            result.filtered.Finish();
+        }
+        return true;
+    }
+
+    bool _RunPerfTiming(IkSolverBasePtr psolver, int numposes, int batchsize, IkTimingStatistics& statistics)
+    {
+        std::stringstream sout, sinput;
+        sinput << "PerfTiming " << numposes << " " << s_benchmarkseed << " " << batchsize;
+        if( !psolver->SendCommand(sout, sinput) ) {
+            return false;
+        }
+        uint64_t solvetime = 0;
+        int nsolutions = 0;
+        while( !!(sout >> solvetime >> nsolutions) ) {
+            statistics.Add(solvetime, nsolutions);
+        }
+        statistics.Finish();
+        return true;
+    }
+
+#ifdef OPENRAVE_RAPIDJSON
+    /// \brief compares the results to the ones of baselinefilename, returns the number of solvers that regressed
+    int _CompareToBaseline(const std::vector<IkBenchmarkResult>& vresults, const std::string& baselinefilename, dReal ftolerance)
+    {
+        ifstream baselinefile(baselinefilename.c_str());
+        std::stringstream ss;
+        ss << baselinefile.rdbuf();
+        rapidjson::Document baseline;
+        baseline.Parse(ss.str().c_str());
+        if( baseline.HasParseError() || !baseline.IsObject() || !baseline.HasMember("solvers") ) {
+            RAVELOG_WARN_FORMAT("failed to read the baseline %s", baselinefilename);
+            return 0;
+        }
+        const rapidjson::Value& baselinesolvers = baseline["solvers"];
+        int numregressions = 0;
+        for(size_t iresult = 0; iresult < vresults.size(); ++iresult) {
+            const IkBenchmarkResult& result = vresults[iresult];
+            if( !baselinesolvers.HasMember(result.solvername.c_str()) ) {
+                continue;
+            }
+            const rapidjson::Value& baselinesolver = baselinesolvers[result.solvername.c_str()];
+            bool bRegressed = _IsRegression(result.solvername, "raw", result.raw, baselinesolver, ftolerance);
+            bRegressed |= _IsRegression(result.solvername, "batch", result.batch, baselinesolver, ftolerance);
+            bRegressed |= _IsRegression(result.solvername, "filtered", result.filtered, baselinesolver, ftolerance);
+            if( bRegressed ) {
+                ++numregressions;
+            }
+        }
+        RAVELOG_INFO_FORMAT("%d solvers regressed compared to %s", numregressions%baselinefilename);
+        return numregressions;
+    }
+
+    bool _IsRegression(const std::string& solvername, const char* mode, const IkTimingStatistics& statistics, const rapidjson::Value& baselinesolver, dReal ftolerance)
+    {
+        if( !baselinesolver.HasMember(mode) ) {
+            return false;
+        }
+        const rapidjson::Value& baselinemode = baselinesolver[mode];
+        bool bRegressed = false;
+        if( baselinemode.HasMember("solvespersec") ) {
+            double fbaseline = baselinemode["solvespersec"].GetDouble();
+            if( statistics.GetSolvesPerSecond() < (1-ftolerance)*fbaseline ) {
+                RAVELOG_ERROR_FORMAT("%s %s: %f solves/s is slower than the baseline %f", solvername%mode%statistics.GetSolvesPerSecond()%fbaseline);
+                bRegressed = true;
+            }
+        }
+        if( baselinemode.HasMember("successrate") ) {
+            double fbaseline = baselinemode["successrate"].GetDouble();
+            if( statistics.GetSuccessRate() < fbaseline-ftolerance ) {
+                RAVELOG_ERROR_FORMAT("%s %s: success rate %f is lower than the baseline %f", solvername%mode%statistics.GetSuccessRate()%fbaseline);
+                bRegressed = true;
+            }
+        }
+        return bRegressed;
+    }
+#endif
+
+    int _numregressions;
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::IkFastBenchmarkExample example;
+    example.main(argc,argv);
+    return example.GetNumRegressions() > 0 ? 1 : 0;
+}
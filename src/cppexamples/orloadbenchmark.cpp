@@ -0,0 +1,131 @@
+/** \example orloadbenchmark.cpp
+
+    Measures the cold-start time of loading an OpenRAVE XML body that references many mesh files, once with the
+    meshes parsed one after another and once with the \b prefetchgeometries attribute that loads them in parallel
+    before the XML is parsed. Every load uses a fresh environment.
+
+    The mesh files and the XML file are generated in the current directory.
+
+    Usage:
+    \verbatim
+    orloadbenchmark [nummeshes] [numsubdivisions] [numtrials]
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <sstream>
+#include <fstream>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+class LoadBenchmarkExample : public OpenRAVEExample
+{
+public:
+    LoadBenchmarkExample() : OpenRAVEExample("") {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        int nummeshes = argc > 1 ? atoi(argv[1]) : 32;
+        int numsubdivisions = argc > 2 ? atoi(argv[2]) : 64;
+        int numtrials = argc > 3 ? atoi(argv[3]) : 3;
+        string bodyfilename = _WriteBody(nummeshes, numsubdivisions);
+
+        RAVELOG_INFO_FORMAT("loading %d meshes with %d triangles each, %d hardware threads", nummeshes%(2*numsubdivisions*numsubdivisions)%boost::thread::hardware_concurrency());
+        RAVELOG_INFO("trial sequential(ms) prefetch(ms)\n");
+        AttributesList atts;
+        atts.push_back(make_pair(string("prefetchgeometries"), string("0")));
+        for(int itrial = 0; itrial < numtrials; ++itrial) {
+            dReal fSequentialTime = _MeasureLoadTime(bodyfilename, AttributesList());
+            dReal fPrefetchTime = _MeasureLoadTime(bodyfilename, atts);
+            RAVELOG_INFO_FORMAT("%d %f %f", itrial%(fSequentialTime*1000)%(fPrefetchTime*1000));
+        }
+    }
+
+protected:
+    /// \brief writes nummeshes ascii stl spheres and a kinbody with one link per sphere, returns the kinbody filename
+    string _WriteBody(int nummeshes, int numsubdivisions)
+    {
+        string bodyfilename = "orloadbenchmark.kinbody.xml";
+        ofstream fbody(bodyfilename.c_str());
+        fbody << "<kinbody name=\"meshes\">" << endl;
+        for(int imesh = 0; imesh < nummeshes; ++imesh) {
+            string meshfilename = str(boost::format("orloadbenchmark%d.stl")%imesh);
+            _WriteSphere(meshfilename, numsubdivisions, 0.05+0.001*imesh);
+            fbody << "  <body name=\"link" << imesh << "\">" << endl;
+            fbody << "    <translation>" << 0.2*imesh << " 0 0</translation>" << endl;
+            fbody << "    <geom type=\"trimesh\">" << endl;
+            fbody << "      <data>" << meshfilename << "</data>" << endl;
+            fbody << "      <render>" << meshfilename << "</render>" << endl;
+            fbody << "    </geom>" << endl;
+            fbody << "  </body>" << endl;
+        }
+        fbody << "</kinbody>" << endl;
+        return bodyfilename;
+    }
+
+    void _WriteSphere(const string& filename, int numsubdivisions, dReal radius)
+    {
+        ofstream f(filename.c_str());
+        f << "solid sphere" << endl;
+        for(int i = 0; i < numsubdivisions; ++i) {
+            dReal theta0 = PI*i/numsubdivisions, theta1 = PI*(i+1)/numsubdivisions;
+            for(int j = 0; j < numsubdivisions; ++j) {
+                dReal phi0 = 2*PI*j/numsubdivisions, phi1 = 2*PI*(j+1)/numsubdivisions;
+                Vector v00 = _SpherePoint(radius, theta0, phi0), v01 = _SpherePoint(radius, theta0, phi1);
+                Vector v10 = _SpherePoint(radius, theta1, phi0), v11 = _SpherePoint(radius, theta1, phi1);
+                _WriteTriangle(f, v00, v10, v11);
+                _WriteTriangle(f, v00, v11, v01);
+            }
+        }
+        f << "endsolid sphere" << endl;
+    }
+
+    inline Vector _SpherePoint(dReal radius, dReal theta, dReal phi) {
+        return Vector(radius*RaveSin(theta)*RaveCos(phi), radius*RaveSin(theta)*RaveSin(phi), radius*RaveCos(theta));
+    }
+
+    void _WriteTriangle(ostream& f, const Vector& v0, const Vector& v1, const Vector& v2)
+    {
+        Vector vnormal = (v1-v0).cross(v2-v0);
+        dReal flength = RaveSqrt(vnormal.lengthsqr3());
+        if( flength > 0 ) {
+            vnormal /= flength;
+        }
+        f << "facet normal " << vnormal.x << " " << vnormal.y << " " << vnormal.z << endl;
+        f << "  outer loop" << endl;
+        f << "    vertex " << v0.x << " " << v0.y << " " << v0.z << endl;
+        f << "    vertex " << v1.x << " " << v1.y << " " << v1.z << endl;
+        f << "    vertex " << v2.x << " " << v2.y << " " << v2.z << endl;
+        f << "  endloop" << endl;
+        f << "endfacet" << endl;
+    }
+
+    /// \brief loads filename into a new environment and returns the time of the load in seconds
+    dReal _MeasureLoadTime(const string& filename, const AttributesList& atts)
+    {
+        EnvironmentBasePtr pnewenv = RaveCreateEnvironment();
+        uint64_t starttime = utils::GetMicroTime();
+        if( !pnewenv->Load(filename, atts) ) {
+            RAVELOG_WARN_FORMAT("failed to load %s", filename);
+        }
+        uint64_t elapsedtime = utils::GetMicroTime() - starttime;
+        pnewenv->Destroy();
+        return elapsedtime*1e-6;
+    }
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::LoadBenchmarkExample example;
+    return example.main(argc,argv);
+}
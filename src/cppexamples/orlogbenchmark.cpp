@@ -0,0 +1,108 @@
+/** \example orlogbenchmark.cpp
+
+    Measures the planner throughput with verbose logging, once with the \ref OpenRAVE::LB_Console log backend that
+    writes every message on the planning thread and once with the \ref OpenRAVE::LB_Asynchronous backend. Both runs
+    plan to the same random goals. Redirect stdout to a file or /dev/null, the results are printed at the end.
+
+    Usage:
+    \verbatim
+    orlogbenchmark [numplans] [scene] > /dev/null
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <sstream>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+class LogBenchmarkExample : public OpenRAVEExample
+{
+public:
+    LogBenchmarkExample() : OpenRAVEExample("") {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        int numplans = argc > 1 ? atoi(argv[1]) : 20;
+        string scenefilename = argc > 2 ? argv[2] : "data/lab1.env.xml";
+        penv->Load(scenefilename);
+
+        vector<RobotBasePtr> vrobots;
+        penv->GetRobots(vrobots);
+        RobotBasePtr probot = vrobots.at(0);
+        probot->SetActiveDOFs(probot->GetActiveManipulator()->GetArmIndices());
+        vector<vector<dReal> > vgoals = _SampleGoals(probot, numplans);
+
+        RaveSetDebugLevel(Level_Verbose);
+        RaveSetLogBackend(LB_Console);
+        dReal fConsoleTime = _MeasurePlanningTime(probot, vgoals);
+        RaveSetLogBackend(LB_Asynchronous);
+        dReal fAsynchronousTime = _MeasurePlanningTime(probot, vgoals);
+        RaveSetLogBackend(LB_Console);
+        RaveSetDebugLevel(Level_Info);
+
+        RAVELOG_INFO_FORMAT("%d plans at verbose log level, %d hardware threads", numplans%boost::thread::hardware_concurrency());
+        RAVELOG_INFO_FORMAT("console: %f plans/s", (numplans/fConsoleTime));
+        RAVELOG_INFO_FORMAT("asynchronous: %f plans/s, %d lines dropped", (numplans/fAsynchronousTime)%RaveGetNumDroppedLogMessages());
+    }
+
+protected:
+    /// \brief returns collision-free configurations of the active dofs
+    vector<vector<dReal> > _SampleGoals(RobotBasePtr probot, int numgoals)
+    {
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        RobotBase::RobotStateSaver saver(probot);
+        vector<dReal> vlower, vupper;
+        probot->GetActiveDOFLimits(vlower, vupper);
+        vector<vector<dReal> > vgoals;
+        vector<dReal> vgoal(probot->GetActiveDOF());
+        while((int)vgoals.size() < numgoals) {
+            for(size_t i = 0; i < vlower.size(); ++i) {
+                vgoal[i] = vlower[i] + (vupper[i]-vlower[i])*RaveRandomFloat();
+            }
+            probot->SetActiveDOFValues(vgoal);
+            if( !penv->CheckCollision(probot) && !probot->CheckSelfCollision() ) {
+                vgoals.push_back(vgoal);
+            }
+        }
+        return vgoals;
+    }
+
+    /// \brief plans from the current configuration to every goal and returns the total time in seconds, including the time to write the queued log messages
+    dReal _MeasurePlanningTime(RobotBasePtr probot, const vector<vector<dReal> >& vgoals)
+    {
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        RobotBase::RobotStateSaver saver(probot);
+        PlannerBasePtr planner = RaveCreatePlanner(penv, "birrt");
+        RaveInitRandomGeneration(0); // same random samples for both runs
+        uint64_t starttime = utils::GetMicroTime();
+        for(size_t igoal = 0; igoal < vgoals.size(); ++igoal) {
+            PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+            params->_nMaxIterations = 4000;
+            params->SetRobotActiveJoints(probot);
+            probot->GetActiveDOFValues(params->vinitialconfig);
+            params->vgoalconfig = vgoals[igoal];
+            TrajectoryBasePtr ptraj = RaveCreateTrajectory(penv, "");
+            if( planner->InitPlan(probot, params) ) {
+                planner->PlanPath(ptraj);
+            }
+        }
+        RaveFlushLog();
+        return (utils::GetMicroTime() - starttime)*1e-6;
+    }
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::LogBenchmarkExample example;
+    return example.main(argc,argv);
+}
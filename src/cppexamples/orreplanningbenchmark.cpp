@@ -0,0 +1,127 @@
+/** \example orreplanningbenchmark.cpp
+
+    Measures the replanning latency of a planner: every cycle creates new PlannerParameters for the arm of the robot,
+    initializes the planner with them and plans to a new goal. Planners copy the parameters into their own derived
+    parameter type inside InitPlan, so the InitPlan time is mostly the cost of that copy. The goals are sampled once
+    with a fixed seed, so every run plans the same queries. Prints the median, the mean and the maximum of the InitPlan
+    and of the whole cycle times and the number of cycles that found a path.
+
+    Usage:
+    \verbatim
+    orreplanningbenchmark [numcycles] [planner] [scene]
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+class ReplanningBenchmarkExample : public OpenRAVEExample
+{
+public:
+    ReplanningBenchmarkExample() : OpenRAVEExample("") {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        int numcycles = argc > 1 ? atoi(argv[1]) : 100;
+        string plannername = argc > 2 ? argv[2] : "birrt";
+        string scenefilename = argc > 3 ? argv[3] : "data/lab1.env.xml";
+        penv->Load(scenefilename);
+
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        std::vector<RobotBasePtr> vrobots;
+        penv->GetRobots(vrobots);
+        if( vrobots.size() == 0 ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("scene %s needs a robot", scenefilename, ORE_InvalidArguments);
+        }
+        RobotBasePtr probot = vrobots.at(0);
+        probot->SetActiveDOFs(probot->GetActiveManipulator()->GetArmIndices());
+        std::vector<dReal> vstart;
+        probot->GetActiveDOFValues(vstart);
+
+        std::vector< std::vector<dReal> > vgoals;
+        _SampleGoals(probot, numcycles, vgoals);
+        probot->SetActiveDOFValues(vstart);
+
+        PlannerBasePtr planner = RaveCreatePlanner(penv, plannername);
+        if( !planner ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("failed to create planner %s", plannername, ORE_InvalidArguments);
+        }
+        RAVELOG_INFO_FORMAT("%d cycles with planner %s and %d dof", numcycles%plannername%probot->GetActiveDOF());
+
+        std::vector<dReal> vinittimes, vcycletimes;
+        int numsuccesses = 0;
+        for(int icycle = 0; icycle < numcycles; ++icycle) {
+            uint64_t starttime = utils::GetMicroTime();
+            PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+            params->SetRobotActiveJoints(probot);
+            params->vinitialconfig = vstart;
+            params->vgoalconfig = vgoals.at(icycle);
+            params->_nMaxIterations = 4000;
+            params->_nRandomGeneratorSeed = icycle;
+            uint64_t initstarttime = utils::GetMicroTime();
+            bool bsuccess = planner->InitPlan(probot, params);
+            vinittimes.push_back(1e-6*(utils::GetMicroTime() - initstarttime));
+            if( bsuccess ) {
+                TrajectoryBasePtr ptraj = RaveCreateTrajectory(penv, "");
+                if( planner->PlanPath(ptraj).GetStatusCode() & PS_HasSolution ) {
+                    ++numsuccesses;
+                }
+            }
+            vcycletimes.push_back(1e-6*(utils::GetMicroTime() - starttime));
+            probot->SetActiveDOFValues(vstart);
+        }
+
+        RAVELOG_INFO("median(s) mean(s) max(s)\n");
+        _PrintTimes("InitPlan", vinittimes);
+        _PrintTimes("cycle", vcycletimes);
+        RAVELOG_INFO_FORMAT("%d/%d cycles found a path", numsuccesses%numcycles);
+    }
+
+protected:
+    /// \brief samples collision-free goals uniformly inside the limits of the active joints
+    void _SampleGoals(RobotBasePtr probot, int numgoals, std::vector< std::vector<dReal> >& vgoals)
+    {
+        RaveInitRandomGeneration(0);
+        std::vector<dReal> vlower, vupper, vgoal(probot->GetActiveDOF());
+        probot->GetActiveDOFLimits(vlower, vupper);
+        vgoals.resize(0);
+        while((int)vgoals.size() < numgoals) {
+            for(size_t i = 0; i < vgoal.size(); ++i) {
+                vgoal[i] = vlower[i] + (vupper[i]-vlower[i])*RaveRandomFloat();
+            }
+            probot->SetActiveDOFValues(vgoal);
+            if( !penv->CheckCollision(probot) && !probot->CheckSelfCollision() ) {
+                vgoals.push_back(vgoal);
+            }
+        }
+    }
+
+    void _PrintTimes(const char* name, std::vector<dReal> vtimes)
+    {
+        std::sort(vtimes.begin(), vtimes.end());
+        dReal fsum = 0;
+        for(size_t i = 0; i < vtimes.size(); ++i) {
+            fsum += vtimes[i];
+        }
+        RAVELOG_INFO_FORMAT("%s %f %f %f", name%vtimes.at(vtimes.size()/2)%(fsum/vtimes.size())%vtimes.back());
+    }
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::ReplanningBenchmarkExample example;
+    return example.main(argc,argv);
+}
@@ -0,0 +1,155 @@
+/** \example orsimulationbenchmark.cpp
+
+    Measures the time of EnvironmentBase::StepSimulation as the number of simulated sensors grows, once with
+    sensors that are stepped one after another and once with sensors whose type supports concurrent stepping
+    (SensorBase::IsSimulationStepConcurrent). The last column steps powered baselaser2d sensors, whose scans are
+    stepped concurrently.
+
+    Usage:
+    \verbatim
+    orsimulationbenchmark [maxsensors] [numsteps] [scene]
+    \endverbatim
+
+    <b>Full Example Code:</b>
+ */
+#include <openrave-core.h>
+#include <openrave/utils.h>
+#include <vector>
+#include <sstream>
+
+#include "orexample.h"
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace cppexamples {
+
+/// \brief measures the distance from the sensor to the bounding box center of every link in the scene.
+///
+/// Only reads link transforms and geometry, so its type can allow concurrent stepping.
+class LinkProximitySensor : public SensorBase
+{
+public:
+    LinkProximitySensor(EnvironmentBasePtr penv, bool bConcurrent) : SensorBase(penv), _bConcurrent(bConcurrent), _numsweeps(200), _fMinDistance(0) {
+        __description = "Computes the minimum distance to all links, used for benchmarking";
+    }
+
+    virtual bool SimulationStep(dReal fTimeElapsed)
+    {
+        std::vector<KinBodyPtr> vbodies;
+        GetEnv()->GetBodies(vbodies);
+        dReal fMinDistance = 1e30;
+        // each sweep perturbs the origin slightly to emulate the work of a scanning sensor
+        for(int isweep = 0; isweep < _numsweeps; ++isweep) {
+            Vector vorigin = _trans.trans + Vector(0.001*isweep, 0, 0);
+            for(size_t ibody = 0; ibody < vbodies.size(); ++ibody) {
+                const std::vector<KinBody::LinkPtr>& vlinks = vbodies[ibody]->GetLinks();
+                for(size_t ilink = 0; ilink < vlinks.size(); ++ilink) {
+                    AABB ab = vlinks[ilink]->ComputeAABB();
+                    dReal fDistance = RaveSqrt((ab.pos-vorigin).lengthsqr3());
+                    if( fMinDistance > fDistance ) {
+                        fMinDistance = fDistance;
+                    }
+                }
+            }
+        }
+        _fMinDistance = fMinDistance;
+        return true;
+    }
+
+    virtual bool IsSimulationStepConcurrent() const {
+        return _bConcurrent;
+    }
+
+    virtual int Configure(ConfigureCommand command, bool blocking) {
+        return 0;
+    }
+    virtual SensorGeometryConstPtr GetSensorGeometry(SensorType type) {
+        return SensorGeometryConstPtr();
+    }
+    virtual SensorDataPtr CreateSensorData(SensorType type) {
+        return SensorDataPtr();
+    }
+    virtual bool GetSensorData(SensorDataPtr psensordata) {
+        return false;
+    }
+    virtual bool Supports(SensorType type) {
+        return false;
+    }
+    virtual void SetTransform(const Transform& trans) {
+        _trans = trans;
+    }
+    virtual Transform GetTransform() {
+        return _trans;
+    }
+
+    static InterfaceBasePtr CreateSequential(EnvironmentBasePtr penv, std::istream& is) {
+        return InterfaceBasePtr(new LinkProximitySensor(penv, false));
+    }
+    static InterfaceBasePtr CreateConcurrent(EnvironmentBasePtr penv, std::istream& is) {
+        return InterfaceBasePtr(new LinkProximitySensor(penv, true));
+    }
+
+private:
+    bool _bConcurrent;
+    int _numsweeps;
+    Transform _trans;
+    dReal _fMinDistance;
+};
+
+class SimulationBenchmarkExample : public OpenRAVEExample
+{
+public:
+    SimulationBenchmarkExample() : OpenRAVEExample("") {
+    }
+
+    virtual void demothread(int argc, char ** argv) {
+        int maxsensors = argc > 1 ? atoi(argv[1]) : 16;
+        int numsteps = argc > 2 ? atoi(argv[2]) : 100;
+        string scenefilename = argc > 3 ? argv[3] : "data/lab1.env.xml";
+        UserDataPtr sequentialhandle = RaveRegisterInterface(PT_Sensor, "linkproximity", OPENRAVE_SENSOR_HASH, OPENRAVE_ENVIRONMENT_HASH, LinkProximitySensor::CreateSequential);
+        UserDataPtr concurrenthandle = RaveRegisterInterface(PT_Sensor, "linkproximityconcurrent", OPENRAVE_SENSOR_HASH, OPENRAVE_ENVIRONMENT_HASH, LinkProximitySensor::CreateConcurrent);
+        penv->Load(scenefilename);
+        penv->StopSimulation(); // step manually
+
+        RAVELOG_INFO_FORMAT("stepping %d times, %d hardware threads", numsteps%boost::thread::hardware_concurrency());
+        RAVELOG_INFO("numsensors sequential(ms/step) concurrent(ms/step) baselaser2d(ms/step)\n");
+        for(int numsensors = 1; numsensors <= maxsensors; numsensors *= 2) {
+            dReal fSequentialTime = _MeasureStepTime("linkproximity", numsensors, numsteps);
+            dReal fConcurrentTime = _MeasureStepTime("linkproximityconcurrent", numsensors, numsteps);
+            dReal fLaserTime = _MeasureStepTime("baselaser2d", numsensors, numsteps);
+            RAVELOG_INFO_FORMAT("%d %f %f %f", numsensors%(fSequentialTime*1000)%(fConcurrentTime*1000)%(fLaserTime*1000));
+        }
+    }
+
+protected:
+    /// \brief adds numsensors sensors of the given type and returns the average time of one StepSimulation call in seconds
+    dReal _MeasureStepTime(const std::string& sensortype, int numsensors, int numsteps)
+    {
+        std::vector<SensorBasePtr> vsensors;
+        for(int isensor = 0; isensor < numsensors; ++isensor) {
+            SensorBasePtr psensor = RaveCreateSensor(penv, sensortype);
+            psensor->SetName(str(boost::format("%s%d")%sensortype%isensor));
+            penv->Add(psensor, true);
+            psensor->Configure(SensorBase::CC_PowerOn);
+            vsensors.push_back(psensor);
+        }
+        uint64_t starttime = utils::GetMicroTime();
+        for(int istep = 0; istep < numsteps; ++istep) {
+            penv->StepSimulation(0.01);
+        }
+        uint64_t elapsedtime = utils::GetMicroTime() - starttime;
+        for(size_t isensor = 0; isensor < vsensors.size(); ++isensor) {
+            penv->Remove(vsensors[isensor]);
+        }
+        return elapsedtime*1e-6/numsteps;
+    }
+};
+
+} // end namespace cppexamples
+
+int main(int argc, char ** argv)
+{
+    cppexamples::SimulationBenchmarkExample example;
+    return example.main(argc,argv);
+}
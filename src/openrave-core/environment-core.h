@@ -225,6 +225,7 @@ public:
 
         RAVELOG_VERBOSE("Environment destructor\n");
         _StopSimulationThread();
+        _pSensorThreadPool.reset();
 
         // destroy the modules (their destructors could attempt to lock environment, so have to do it before global lock)
         // however, do not clear the _listModules yet
@@ -490,7 +491,7 @@ public:
             }
         }
         else {
-            if( _ParseXMLFile(OpenRAVEXMLParser::CreateInterfaceReader(shared_from_this(),atts,true), filename) ) {
+            if( _ParseXMLFile(OpenRAVEXMLParser::CreateInterfaceReader(shared_from_this(),atts,true), filename, atts) ) {
                 if( OpenRAVEXMLParser::GetXMLErrorCount() == 0 ) {
                     UpdatePublishedBodies();
                     return true;
@@ -1074,16 +1075,31 @@ public:
         }
 
         // simulate the sensors last (ie, they always reflect the most recent bodies
+        _vConcurrentSensors.resize(0);
         FOREACH(itsensor, listSensors) {
-            (*itsensor)->SimulationStep(fTimeStep);
+            _StepSensorSimulation(*itsensor, fTimeStep);
         }
         FOREACH(itrobot, vecrobots) {
             FOREACH(itsensor, (*itrobot)->GetAttachedSensors()) {
                 if( !!(*itsensor)->GetSensor() ) {
-                    (*itsensor)->GetSensor()->SimulationStep(fTimeStep);
+                    _StepSensorSimulation((*itsensor)->GetSensor(), fTimeStep);
                 }
             }
         }
+        if( _vConcurrentSensors.size() == 1 ) {
+            _vConcurrentSensors[0]->SimulationStep(fTimeStep);
+        }
+        else if( _vConcurrentSensors.size() > 1 ) {
+            if( !_pSensorThreadPool ) {
+                _pSensorThreadPool.reset(new utils::ThreadPool());
+            }
+            std::vector< boost::function<void()> > vtasks(_vConcurrentSensors.size());
+            for(size_t isensor = 0; isensor < _vConcurrentSensors.size(); ++isensor) {
+                vtasks[isensor] = boost::bind(&SensorBase::SimulationStep, _vConcurrentSensors[isensor], fTimeStep);
+            }
+            _pSensorThreadPool->RunTasks(vtasks);
+        }
+        _vConcurrentSensors.resize(0);
         _nCurSimTime += step;
     }
 
@@ -1091,6 +1107,17 @@ public:
         return _mutexEnvironment;
     }
 
+    /// \brief steps the sensor right away, or queues it into _vConcurrentSensors if its type allows concurrent stepping
+    inline void _StepSensorSimulation(SensorBasePtr psensor, dReal fTimeStep)
+    {
+        if( psensor->IsSimulationStepConcurrent() ) {
+            _vConcurrentSensors.push_back(psensor);
+        }
+        else {
+            psensor->SimulationStep(fTimeStep);
+        }
+    }
+
     virtual void GetBodies(std::vector<KinBodyPtr>& bodies, uint64_t timeout) const
     {
         if( timeout == 0 ) {
@@ -1277,7 +1304,7 @@ public:
             if( !preader ) {
                 return RobotBasePtr();
             }
-            bool bSuccess = _ParseXMLFile(preader, filename);
+            bool bSuccess = _ParseXMLFile(preader, filename, atts);
             preader->endElement("robot");     // have to end the tag!
             robot = RaveInterfaceCast<RobotBase>(pinterface);
             if( !bSuccess || !robot ) {
@@ -1418,7 +1445,7 @@ public:
             if( !preader ) {
                 return KinBodyPtr();
             }
-            bool bSuccess = _ParseXMLFile(preader, filename);
+            bool bSuccess = _ParseXMLFile(preader, filename, atts);
             preader->endElement("kinbody");     // have to end the tag!
             body = RaveInterfaceCast<KinBody>(pinterface);
             if( !bSuccess || !body ) {
@@ -1494,7 +1521,7 @@ public:
             if( !preader ) {
                 return InterfaceBasePtr();
             }
-            bool bSuccess = _ParseXMLFile(preader, filename);
+            bool bSuccess = _ParseXMLFile(preader, filename, atts);
             boost::shared_ptr<OpenRAVEXMLParser::InterfaceXMLReadable> preadable = boost::dynamic_pointer_cast<OpenRAVEXMLParser::InterfaceXMLReadable>(preader->GetReadable());
             if( !bSuccess || !preadable || !preadable->_pinterface) {
                 return InterfaceBasePtr();
@@ -1573,7 +1600,7 @@ public:
             BaseXMLReaderPtr preader = OpenRAVEXMLParser::CreateInterfaceReader(shared_from_this(), type, pinterface, RaveGetInterfaceName(type), atts);
             boost::shared_ptr<OpenRAVEXMLParser::InterfaceXMLReadable> preadable = boost::dynamic_pointer_cast<OpenRAVEXMLParser::InterfaceXMLReadable>(preader->GetReadable());
             if( !!preadable ) {
-                if( !_ParseXMLFile(preader, filename) ) {
+                if( !_ParseXMLFile(preader, filename, atts) ) {
                     return InterfaceBasePtr();
                 }
                 preader->endElement(RaveGetInterfaceName(pinterface->GetInterfaceType()));     // have to end the tag!
@@ -2128,9 +2155,11 @@ protected:
         }
     }
 
-    virtual bool _ParseXMLFile(BaseXMLReaderPtr preader, const std::string& filename)
+    /// \param atts if it has the prefetchgeometries attribute, loads the mesh files referenced by filename in parallel first
+    virtual bool _ParseXMLFile(BaseXMLReaderPtr preader, const std::string& filename, const AttributesList& atts=AttributesList())
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        boost::shared_ptr<OpenRAVEXMLParser::GeometryFilePrefetcher> pprefetcher = OpenRAVEXMLParser::CreateGeometryFilePrefetcher(filename, atts);
         return OpenRAVEXMLParser::ParseXMLFile(preader, filename);
     }
 
@@ -2798,6 +2827,8 @@ protected:
     std::map<int, KinBodyWeakPtr> _mapBodies;     ///< a map of all the bodies in the environment. Controlled through the KinBody constructor and destructors
 
     boost::shared_ptr<boost::thread> _threadSimulation;                      ///< main loop for environment simulation
+    boost::shared_ptr<utils::ThreadPool> _pSensorThreadPool; ///< steps the sensors that support concurrent stepping, created on first use
+    std::vector<SensorBasePtr> _vConcurrentSensors; ///< sensors collected by StepSimulation to be stepped concurrently
 
     mutable EnvironmentMutex _mutexEnvironment;          ///< protects internal data from multithreading issues
     mutable boost::mutex _mutexEnvironmentIds;      ///< protects _vecbodies/_vecrobots from multithreading issues
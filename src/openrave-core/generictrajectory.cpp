@@ -177,6 +177,7 @@ public:
 
     void Sample(std::vector<dReal>& data, dReal time) const
     {
+        OPENRAVE_PROFILE_SCOPE("GenericTrajectory::Sample");
         BOOST_ASSERT(_bInit);
         BOOST_ASSERT(_timeoffset>=0);
         BOOST_ASSERT(time >= 0);
@@ -221,6 +222,7 @@ public:
 
     void Sample(std::vector<dReal>& data, dReal time, const ConfigurationSpecification& spec, bool reintializeData) const
     {
+        OPENRAVE_PROFILE_SCOPE("GenericTrajectory::Sample");
         BOOST_ASSERT(_bInit);
         OPENRAVE_ASSERT_OP(_timeoffset,>=,0);
         OPENRAVE_ASSERT_OP(time, >=, -g_fEpsilon);
@@ -67,6 +67,8 @@
 
 #include <time.h>
 
+#include <boost/noncopyable.hpp>
+
 #ifdef _WIN32
 static const char s_filesep = '\\';
 #else
@@ -288,6 +290,27 @@ bool CreateTriMeshFromFile(EnvironmentBasePtr, const std::string& filename, cons
 bool CreateTriMeshFromData(const std::string& data, const std::string& formathint, const Vector &vscale, TriMesh& trimesh, RaveVector<float>&diffuseColor, RaveVector<float>&ambientColor, float &ftransparency);
 
 bool CreateGeometries(EnvironmentBasePtr penv, const std::string& filename, const Vector& vscale, std::list<KinBody::GeometryInfo>& listGeometries);
+
+/// \brief loads the mesh files referenced by the trimesh geometries of an XML file in parallel before the file is parsed.
+///
+/// The constructor collects the mesh files of filename and all its included XML files, and loads every distinct file once on
+/// a thread pool. While the object is alive, CreateGeometries returns the loaded meshes instead of reading the files again, so
+/// the geometries are still assembled in the order of the XML file. Files that fail to load are read again when parsing.
+/// Holds the XML parsing lock for its lifetime. Only created when built with assimp.
+class GeometryFilePrefetcher : private boost::noncopyable
+{
+public:
+    /// \param numthreads number of threads to load with. If 0, uses the number of hardware threads.
+    GeometryFilePrefetcher(const std::string& filename, int numthreads);
+    virtual ~GeometryFilePrefetcher();
+
+private:
+    boost::shared_ptr<EnvironmentMutex::scoped_lock> _plock;
+    bool _bInstalled;
+};
+
+/// \brief creates a GeometryFilePrefetcher if atts has the \b prefetchgeometries attribute, whose value is the number of threads
+boost::shared_ptr<GeometryFilePrefetcher> CreateGeometryFilePrefetcher(const std::string& filename, const AttributesList& atts);
 }
 
 #ifdef _WIN32
@@ -373,6 +373,40 @@ static bool _ParseSpecialSTLFile(EnvironmentBasePtr penv, const std::string& fil
 
 #endif
 
+/// \brief geometries of the files loaded by GeometryFilePrefetcher, with the full filename as key and meshes at unit scale
+typedef std::map<std::string, std::list<KinBody::GeometryInfo> > PrefetchedGeometryMap;
+
+/// \brief the prefetched geometries of the file currently parsing, protected by GetXMLMutex()
+boost::shared_ptr<PrefetchedGeometryMap>& GetPrefetchedGeometries() {
+    static boost::shared_ptr<PrefetchedGeometryMap> s; return s;
+}
+
+#ifdef OPENRAVE_ASSIMP
+/// \brief if filename was prefetched, appends its geometries scaled by vscale to listGeometries
+static bool _FindPrefetchedGeometries(const std::string& filename, const Vector& vscale, std::list<KinBody::GeometryInfo>& listGeometries)
+{
+    boost::shared_ptr<PrefetchedGeometryMap> pprefetched = GetPrefetchedGeometries();
+    if( !pprefetched ) {
+        return false;
+    }
+    PrefetchedGeometryMap::const_iterator itfile = pprefetched->find(filename);
+    if( itfile == pprefetched->end() ) {
+        return false;
+    }
+    FOREACHC(itgeom, itfile->second) {
+        listGeometries.push_back(*itgeom);
+        KinBody::GeometryInfo& g = listGeometries.back();
+        g._vRenderScale = vscale;
+        FOREACH(itvertex, g._meshcollision.vertices) {
+            itvertex->x *= vscale.x;
+            itvertex->y *= vscale.y;
+            itvertex->z *= vscale.z;
+        }
+    }
+    return true;
+}
+#endif
+
 bool CreateTriMeshFromFile(EnvironmentBasePtr penv, const std::string& filename, const Vector& vscale, TriMesh& trimesh, RaveVector<float>& diffuseColor, RaveVector<float>& ambientColor, float& ftransparency)
 {
     string extension;
@@ -779,6 +813,9 @@ public:
 #ifdef OPENRAVE_ASSIMP
         // assimp doesn't support vrml/iv, so don't waste time
         if( extension != "iv" && extension != "wrl" && extension != "vrml" ) {
+            if( _FindPrefetchedGeometries(filename, vscale, listGeometries) ) {
+                return true;
+            }
             //Assimp::DefaultLogger::get()->setLogSeverity(Assimp::Logger::Debugging);
             {
                 aiSceneManaged scene(filename);
@@ -3627,4 +3664,231 @@ BaseXMLReaderPtr CreateInterfaceReader(EnvironmentBasePtr penv, const Attributes
     return BaseXMLReaderPtr(new OpenRAVEXMLParser::GlobalInterfaceXMLReader(penv,atts,bAddToEnvironment));
 }
 
+/// \brief collects the mesh files of the trimesh geometries of a file and the files it includes without creating any interfaces
+///
+/// Only the files that the KinBody reader loads as collision meshes are collected: the data/collision file of a geometry,
+/// or its render file when it has no collision file.
+class GeometryFileCollector : public BaseXMLReader
+{
+public:
+    GeometryFileCollector(std::vector<std::string>& vfilenames, std::set<std::string>& setvisited) : _vfilenames(vfilenames), _setvisited(setvisited), _bInTriMesh(false) {
+    }
+
+    virtual ProcessElement startElement(const std::string& xmlname, const AttributesList& atts)
+    {
+        _ss.str("");
+        if( xmlname == "geom" || xmlname == "geometry" ) {
+            _collisionfilename.resize(0);
+            _renderfilename.resize(0);
+        }
+        FOREACHC(itatt, atts) {
+            if( itatt->first == "type" && (xmlname == "geom" || xmlname == "geometry") ) {
+                _bInTriMesh = _stricmp(itatt->second.c_str(), "trimesh") == 0;
+            }
+        }
+        FOREACHC(itatt, atts) {
+            if( itatt->first == "file" ) {
+                if( xmlname == "collision" ) {
+                    _collisionfilename = itatt->second;
+                }
+                else if( xmlname == "render" ) {
+                    _renderfilename = itatt->second;
+                }
+                else {
+                    _ParseIncludedFile(itatt->second);
+                }
+            }
+        }
+        return PE_Support;
+    }
+
+    virtual bool endElement(const std::string& xmlname)
+    {
+        if( xmlname == "modelsdir" ) {
+            _strModelsDir = _ss.str();
+            boost::trim(_strModelsDir);
+            _strModelsDir += "/";
+        }
+        else if( xmlname == "data" || xmlname == "collision" ) {
+            // like GeometryInfoReader, the first collision file of the geometry is used
+            if( _collisionfilename.size() == 0 ) {
+                _ss >> _collisionfilename;
+            }
+        }
+        else if( xmlname == "render" ) {
+            if( _renderfilename.size() == 0 ) {
+                _ss >> _renderfilename;
+            }
+        }
+        else if( xmlname == "geom" || xmlname == "geometry" ) {
+            if( _bInTriMesh ) {
+                // the render file is only loaded as collision mesh when there is no collision file
+                if( _collisionfilename.size() > 0 ) {
+                    _AddGeometryFile(_collisionfilename);
+                }
+                else if( _renderfilename.size() > 0 ) {
+                    _AddGeometryFile(_renderfilename);
+                }
+            }
+            _bInTriMesh = false;
+            _collisionfilename.resize(0);
+            _renderfilename.resize(0);
+        }
+        _ss.str("");
+        _ss.clear();
+        return false;
+    }
+
+    virtual void characters(const std::string& ch)
+    {
+        _ss.clear();
+        _ss << ch;
+    }
+
+protected:
+    /// \brief resolves filename the same way as KinBodyXMLReader::GetModelsDir
+    void _AddGeometryFile(const std::string& filename)
+    {
+        std::string fullfilename;
+#ifdef _WIN32
+        bool bAbsolute = filename.find_first_of(':') != string::npos;
+#else
+        bool bAbsolute = filename.size() > 0 && filename[0] == '/';
+#endif
+        if( bAbsolute ) {
+            fullfilename = filename;
+        }
+        else {
+            if( _strModelsDir.size() > 0 ) {
+                string s = GetParseDirectory();
+                if( s.size() > 0 ) {
+                    s += s_filesep;
+                }
+                s += _strModelsDir;
+                fullfilename = RaveFindLocalFile(filename, s);
+            }
+            if( fullfilename.size() == 0 ) {
+                fullfilename = RaveFindLocalFile(filename, GetParseDirectory());
+            }
+        }
+        if( fullfilename.size() > 0 && _setvisited.insert(fullfilename).second ) {
+            _vfilenames.push_back(fullfilename);
+        }
+    }
+
+    void _ParseIncludedFile(const std::string& filename)
+    {
+        string fullfilename = RaveFindLocalFile(filename, GetParseDirectory());
+        if( fullfilename.size() == 0 ) {
+            return;
+        }
+        string extension;
+        if( fullfilename.find_last_of('.') != string::npos ) {
+            extension = fullfilename.substr(fullfilename.find_last_of('.')+1);
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        }
+        if( extension != "xml" ) {
+            return;
+        }
+        if( _setvisited.insert(fullfilename).second ) {
+            ParseXMLFile(BaseXMLReaderPtr(new GeometryFileCollector(_vfilenames, _setvisited)), fullfilename);
+        }
+    }
+
+    std::vector<std::string>& _vfilenames; ///< in the order they are referenced
+    std::set<std::string>& _setvisited; ///< mesh and included files already collected
+    std::stringstream _ss;
+    std::string _strModelsDir;
+    std::string _collisionfilename, _renderfilename; ///< mesh files of the current geometry
+    bool _bInTriMesh;
+};
+
+/// \brief loads the meshes of filename at unit scale with assimp, sets bSuccess to 1 if successful
+static void _LoadPrefetchedGeometryFile(const std::string& filename, std::list<KinBody::GeometryInfo>& listGeometries, uint8_t& bSuccess)
+{
+    bSuccess = 0;
+#ifdef OPENRAVE_ASSIMP
+    string extension;
+    if( filename.find_last_of('.') != string::npos ) {
+        extension = filename.substr(filename.find_last_of('.')+1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    }
+    if( extension == "iv" || extension == "wrl" || extension == "vrml" ) {
+        return;
+    }
+    try {
+        aiSceneManaged scene(filename);
+        if( !!scene._scene && !!scene._scene->mRootNode && !!scene._scene->HasMeshes() ) {
+            if( _AssimpCreateGeometries(scene._scene,scene._scene->mRootNode, Vector(1,1,1), listGeometries) ) {
+                bSuccess = 1;
+            }
+        }
+    }
+    catch(const std::exception& ex) {
+        RAVELOG_WARN_FORMAT("failed to prefetch %s: %s", filename%ex.what());
+    }
+#endif
+}
+
+GeometryFilePrefetcher::GeometryFilePrefetcher(const std::string& filename, int numthreads) : _bInstalled(false)
+{
+    _plock.reset(new EnvironmentMutex::scoped_lock(*GetXMLMutex()));
+    if( !!GetPrefetchedGeometries() ) {
+        // already prefetching for a file that includes this one
+        return;
+    }
+    uint64_t starttime = utils::GetMicroTime();
+    std::vector<std::string> vfilenames;
+    std::set<std::string> setvisited;
+    ParseXMLFile(BaseXMLReaderPtr(new GeometryFileCollector(vfilenames, setvisited)), filename);
+
+    std::vector< std::list<KinBody::GeometryInfo> > vlistGeometries(vfilenames.size());
+    std::vector<uint8_t> vsuccess(vfilenames.size(), 0);
+    std::vector< boost::function<void()> > vtasks(vfilenames.size());
+    for(size_t ifile = 0; ifile < vfilenames.size(); ++ifile) {
+        vtasks[ifile] = boost::bind(_LoadPrefetchedGeometryFile, boost::cref(vfilenames[ifile]), boost::ref(vlistGeometries[ifile]), boost::ref(vsuccess[ifile]));
+    }
+    if( vtasks.size() > 0 ) {
+        utils::ThreadPool pool(numthreads);
+        pool.RunTasks(vtasks);
+    }
+
+    boost::shared_ptr<PrefetchedGeometryMap> pprefetched(new PrefetchedGeometryMap());
+    for(size_t ifile = 0; ifile < vfilenames.size(); ++ifile) {
+        if( vsuccess[ifile] ) {
+            (*pprefetched)[vfilenames[ifile]].swap(vlistGeometries[ifile]);
+        }
+    }
+    RAVELOG_DEBUG_FORMAT("prefetched %d/%d geometry files of %s in %fs", pprefetched->size()%vfilenames.size()%filename%((utils::GetMicroTime()-starttime)*1e-6));
+    GetPrefetchedGeometries() = pprefetched;
+    _bInstalled = true;
+}
+
+GeometryFilePrefetcher::~GeometryFilePrefetcher()
+{
+    if( _bInstalled ) {
+        GetPrefetchedGeometries().reset();
+    }
+}
+
+boost::shared_ptr<GeometryFilePrefetcher> CreateGeometryFilePrefetcher(const std::string& filename, const AttributesList& atts)
+{
+#ifdef OPENRAVE_ASSIMP
+    FOREACHC(itatt, atts) {
+        if( itatt->first == "prefetchgeometries" ) {
+            int numthreads = 0;
+            if( itatt->second.size() > 0 ) {
+                numthreads = boost::lexical_cast<int>(itatt->second);
+            }
+            if( numthreads < 0 ) {
+                return boost::shared_ptr<GeometryFilePrefetcher>();
+            }
+            return boost::shared_ptr<GeometryFilePrefetcher>(new GeometryFilePrefetcher(filename, numthreads));
+        }
+    }
+#endif
+    // without assimp, all meshes are loaded by modules that cannot be used from several threads
+    return boost::shared_ptr<GeometryFilePrefetcher>();
+}
+
 } // end namespace OpenRAVEXMLParser
@@ -68,21 +68,84 @@ public:
         dReal depth; ///< the penetration depth, positive means the surfaces are penetrating, negative means the surfaces are not colliding (used for distance queries)
     };
 
+    /// \brief a pair of colliding links stored as the environment ids of their bodies and their link indices
+    ///
+    /// Does not hold references to the links. A link that does not exist has body id 0 and link index -1.
+    class OPENRAVE_API LinkPairIndices
+    {
+public:
+        LinkPairIndices() : bodyid1(0), linkindex1(-1), bodyid2(0), linkindex2(-1) {
+        }
+        LinkPairIndices(int bodyid1, int linkindex1, int bodyid2, int linkindex2) : bodyid1(bodyid1), linkindex1(linkindex1), bodyid2(bodyid2), linkindex2(linkindex2) {
+        }
+
+        inline bool operator==(const LinkPairIndices& r) const {
+            return bodyid1 == r.bodyid1 && linkindex1 == r.linkindex1 && bodyid2 == r.bodyid2 && linkindex2 == r.linkindex2;
+        }
+        inline bool operator!=(const LinkPairIndices& r) const {
+            return !(*this == r);
+        }
+        inline bool operator<(const LinkPairIndices& r) const {
+            if( bodyid1 != r.bodyid1 ) {
+                return bodyid1 < r.bodyid1;
+            }
+            if( linkindex1 != r.linkindex1 ) {
+                return linkindex1 < r.linkindex1;
+            }
+            if( bodyid2 != r.bodyid2 ) {
+                return bodyid2 < r.bodyid2;
+            }
+            return linkindex2 < r.linkindex2;
+        }
+
+        int bodyid1, linkindex1; ///< environment id of the body of the first link and the index of the link
+        int bodyid2, linkindex2; ///< environment id of the body of the second link and the index of the link
+    };
+
     CollisionReport() {
         nKeepPrevious = 0;
+        bCompactLinkColliding = false;
         Reset();
     }
 
     /// \brief resets the report structure for the next collision call
     ///
-    /// depending on nKeepPrevious will keep previous data.
+    /// depending on nKeepPrevious will keep previous data. The capacity of contacts, vLinkColliding and vCompactLinkColliding is kept, so reusing the same report does not allocate.
     virtual void Reset(int coloptions = 0);
     virtual std::string __str__() const;
 
+    /// \brief adds a pair of colliding links if it is not already in the report
+    ///
+    /// If bCompactLinkColliding is set, only the indices of the links are inserted into vCompactLinkColliding, which is kept sorted. Otherwise the links are appended to vLinkColliding.
+    void AddLinkColliding(const KinBody::LinkConstPtr& plink1, const KinBody::LinkConstPtr& plink2);
+
+    /// \brief number of colliding link pairs, regardless of how they are stored
+    ///
+    /// The pairs are indexed as vCompactLinkColliding followed by vLinkColliding, usually only one of them is filled.
+    inline size_t GetNumLinkColliding() const {
+        return vCompactLinkColliding.size() + vLinkColliding.size();
+    }
+
+    /// \brief returns the body ids and link indices of a colliding pair without creating references to the links
+    ///
+    /// \param index in [0, GetNumLinkColliding())
+    LinkPairIndices GetLinkCollidingIndices(size_t index) const;
+
+    /// \brief returns the links of a colliding pair, looking up the compact pairs in penv
+    ///
+    /// \param index in [0, GetNumLinkColliding())
+    /// \return the links, empty if the corresponding bodies were removed from penv
+    std::pair<KinBody::LinkConstPtr, KinBody::LinkConstPtr> GetLinkColliding(EnvironmentBasePtr penv, size_t index) const;
+
     KinBody::LinkConstPtr plink1, plink2; ///< the colliding links if a collision involves a bodies. Collisions do not always occur with 2 bodies like ray collisions, so these fields can be empty.
 
     std::vector<std::pair<KinBody::LinkConstPtr, KinBody::LinkConstPtr> > vLinkColliding; ///< all link collision pairs. Set when CO_AllCollisions is enabled.
 
+    /// \brief all link collision pairs stored as indices. Set instead of vLinkColliding when CO_AllCollisions and bCompactLinkColliding are enabled and the checker supports it.
+    ///
+    /// Filling it does not touch the reference counts of the links, use GetLinkColliding to get the links of a pair.
+    std::vector<LinkPairIndices> vCompactLinkColliding;
+
     std::vector<CONTACT> contacts; ///< the convention is that the normal will be "out" of plink1's surface. Filled if CO_UseContacts option is set.
 
     int options; ///< the options that the CollisionReport was called with. It is overwritten by the options set on the collision checker writing the report
@@ -92,6 +155,8 @@ public:
 
     uint8_t nKeepPrevious; ///< if 1, will keep all previous data when resetting the collision checker. otherwise will reset
 
+    bool bCompactLinkColliding; ///< if true, checkers store the colliding link pairs in vCompactLinkColliding instead of vLinkColliding. Not changed by Reset. Only the fcl checker honors it, ode, pqp and bullet ignore it and fill vLinkColliding.
+
     //KinBody::Link::GeomConstPtr pgeom1, pgeom2; ///< the specified geometries hit for the given links
 };
 
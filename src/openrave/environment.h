@@ -213,6 +213,9 @@ public:
         \code
         DAE::getIOPlugin()->setOption(key,value).
         \endcode
+        For OpenRAVE XML files, the \b prefetchgeometries attribute loads all the mesh files referenced by the file in parallel
+        before it is parsed. Its value is the number of threads, 0 uses all hardware threads. Also used by \ref ReadRobotURI,
+        \ref ReadKinBodyURI, and \ref ReadInterfaceURI.
      */
     virtual bool Load(const std::string& filename, const AttributesList& atts = AttributesList()) = 0;
 
@@ -706,6 +709,79 @@ private:
     int __nUniqueId;         ///< \see RaveGetEnvironmentId
 };
 
+namespace utils {
+class ThreadPool;
+}
+
+/** \brief Steps a set of environments in deterministic lock-step batches on a fixed pool of worker threads. <b>[multi-thread safe]</b>
+
+    Every environment finishes step i before any environment starts step i+1, and there is no realtime sleeping
+    between steps, so a set of independent environments can be simulated at full CPU utilization. Environments added
+    to the scheduler have their internal simulation thread stopped since they are now stepped by the scheduler. If the
+    simulation thread of an environment is started again with EnvironmentBase::StartSimulation, the next Step stops it.
+
+    \code
+    SimulationScheduler scheduler(8);
+    for(size_t i = 0; i < venvs.size(); ++i) {
+        scheduler.AddEnvironment(venvs[i]);
+    }
+    scheduler.Step(0.001, 10000);
+    std::vector<SimulationScheduler::StepStatistics> vstats;
+    scheduler.GetStatistics(vstats);
+    \endcode
+ */
+class OPENRAVE_API SimulationScheduler
+{
+public:
+    /// \brief step time metrics of one environment
+    struct StepStatistics
+    {
+        StepStatistics() : numsteps(0), totalsteptime(0), maxsteptime(0) {
+        }
+        EnvironmentBaseWeakPtr penv;
+        uint64_t numsteps; ///< number of steps taken since the environment was added or the statistics were reset
+        uint64_t totalsteptime; ///< sum of the durations of all StepSimulation calls (ns)
+        uint64_t maxsteptime; ///< the longest StepSimulation call (ns)
+    };
+
+    /// \param numthreads number of threads stepping the environments, including the caller of Step. If <= 0, uses the number of hardware threads.
+    SimulationScheduler(int numthreads=0);
+    virtual ~SimulationScheduler();
+
+    /// \brief adds an environment to be stepped and stops its internal simulation thread. Adding the same environment twice has no effect.
+    virtual void AddEnvironment(EnvironmentBasePtr penv);
+
+    /// \return true if the environment was stepped by this scheduler
+    virtual bool RemoveEnvironment(EnvironmentBasePtr penv);
+
+    virtual void GetEnvironments(std::vector<EnvironmentBasePtr>& venvs) const;
+
+    /// \brief steps all environments numsteps times by fTimeStep, in the order they were added within each batch.
+    ///
+    /// Environments can be added, removed or queried from other threads between the batches. Calls to Step are serialized.
+    /// \throw the exception of the first environment that failed to step. The other environments of that batch are still stepped, the remaining batches are not.
+    virtual void Step(dReal fTimeStep, int numsteps=1);
+
+    /// \brief fills the step statistics of every environment in the order they were added
+    virtual void GetStatistics(std::vector<StepStatistics>& vstats) const;
+
+    virtual void ResetStatistics();
+
+    /// \brief the number of threads stepping the environments
+    virtual int GetNumThreads() const;
+
+private:
+    static void _StepEnvironment(EnvironmentBasePtr penv, dReal fTimeStep, uint64_t& steptime);
+
+    boost::mutex _mutexStep; ///< serializes Step
+    mutable boost::mutex _mutex; ///< protects _venvs and _vstats, only held by Step between batches
+    std::vector<EnvironmentBasePtr> _venvs;
+    std::vector<StepStatistics> _vstats; ///< one for each environment in _venvs
+    boost::shared_ptr<utils::ThreadPool> _pthreadpool;
+};
+
+typedef boost::shared_ptr<SimulationScheduler> SimulationSchedulerPtr;
+
 } // end namespace OpenRAVE
 
 #endif
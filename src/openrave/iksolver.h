@@ -153,6 +153,11 @@ public:
      */
     virtual UserDataPtr RegisterCustomFilter(int32_t priority, const IkFilterCallbackFn& filterfn);
 
+    /// \brief returns true if any filter registered with \ref RegisterCustomFilter is still alive
+    inline bool HasCustomFilters() const {
+        return _HasFilterInRange(IKSP_MinPriority, IKSP_MaxPriority);
+    }
+
     /** \brief sets a finish callback for every ik solution.
 
         Most useful when calling SolveAll in order to process notifications while the ik solver is still working.
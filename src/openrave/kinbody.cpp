@@ -1481,6 +1481,7 @@ void KinBody::SetDOFValues(const std::vector<dReal>& vJointValues, const Transfo
 
 void KinBody::SetDOFValues(const std::vector<dReal>& vJointValues, uint32_t checklimits, const std::vector<int>& dofindices)
 {
+    ProfileScope profilescope("KinBody::SetDOFValues", IsProfilingEnabled());
     CHECK_INTERNAL_COMPUTATION;
     if( vJointValues.size() == 0 || _veclinks.size() == 0) {
         return;
@@ -4412,6 +4413,148 @@ bool CompareNonAdjacentFarthest(int pair0, int pair1)
     return dist0 > dist1;
 }
 
+/// \brief non-adjacent link pairs computed in this process, shared by all environments
+static boost::mutex s_mutexNonAdjacentLinks;
+static std::map<std::string, std::vector<int> > s_mapNonAdjacentLinks; ///< key is from _GetNonAdjacentLinksKey
+
+/// \brief bodies with fewer link pairs to check are computed faster than their database file is looked up, so do not store them
+static const size_t s_nMinNonAdjacentLinkPairsDatabase = 256;
+
+/// \brief returns a hash of everything that the non-colliding link pairs at the initial transforms depend on
+///
+/// The transforms are relative to the first link so that the same body placed anywhere in the world shares the key.
+static std::string _GetNonAdjacentLinksKey(const KinBody& body, const std::vector<Transform>& vinitialtransforms, const std::set<int>& setadjacentlinks, CollisionCheckerBaseConstPtr collisionchecker)
+{
+    std::string geometrygroup;
+    try {
+        geometrygroup = collisionchecker->GetGeometryGroup();
+    }
+    catch(const openrave_exception&) {
+        // checker does not support geometry groups
+    }
+    std::stringstream ss;
+    ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+    ss << body.GetKinematicsGeometryHash() << " " << collisionchecker->GetXMLId() << " " << geometrygroup.size() << " " << geometrygroup << " " << setadjacentlinks.size() << " ";
+    FOREACHC(itadjacent, setadjacentlinks) {
+        ss << *itadjacent << " ";
+    }
+    if( vinitialtransforms.size() > 0 ) {
+        Transform tbaseinv = vinitialtransforms[0].inverse();
+        FOREACHC(ittrans, vinitialtransforms) {
+            ss << tbaseinv * *ittrans << " ";
+        }
+    }
+    FOREACHC(itlink, body.GetLinks()) {
+        ss << (*itlink)->IsEnabled();
+    }
+    return utils::GetMD5HashString(ss.str());
+}
+
+/// \brief returns the database file storing the non-adjacent links of the body, see RaveFindDatabaseFile
+static std::string _GetNonAdjacentLinksFilename(const KinBody& body, const std::string& key)
+{
+    return str(boost::format("kinbody.%s/nonadjacentlinks.%s.txt")%body.GetKinematicsGeometryHash()%key);
+}
+
+static bool _ReadNonAdjacentLinks(const std::string& filename, size_t numlinks, std::vector<int>& vnonadjacent)
+{
+    std::string fullfilename = RaveFindDatabaseFile(filename, true);
+    if( fullfilename.size() == 0 ) {
+        return false;
+    }
+    std::ifstream f(fullfilename.c_str());
+    size_t numpairs = 0;
+    f >> numpairs;
+    vnonadjacent.resize(numpairs);
+    FOREACH(itpair, vnonadjacent) {
+        f >> *itpair;
+    }
+    if( !f ) {
+        RAVELOG_WARN_FORMAT("failed to read non-adjacent links from %s", fullfilename);
+        return false;
+    }
+    FOREACHC(itpair, vnonadjacent) {
+        if( (size_t)(*itpair&0xffff) >= numlinks || (size_t)(*itpair>>16) >= numlinks ) {
+            RAVELOG_WARN_FORMAT("non-adjacent links in %s do not match the %d links", fullfilename%numlinks);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void _WriteNonAdjacentLinks(const std::string& filename, const std::vector<int>& vnonadjacent)
+{
+    std::string fullfilename = RaveFindDatabaseFile(filename, false);
+    if( fullfilename.size() == 0 ) {
+        return;
+    }
+    try {
+        // write to a temporary file first so that other processes never read a partial file
+        std::string tempfilename = str(boost::format("%s.%d")%fullfilename%RaveRandomInt());
+#ifdef HAVE_BOOST_FILESYSTEM
+        boost::filesystem::create_directories(boost::filesystem::path(fullfilename).parent_path());
+#endif
+        {
+            std::ofstream f(tempfilename.c_str());
+            f << vnonadjacent.size();
+            FOREACHC(itpair, vnonadjacent) {
+                f << " " << *itpair;
+            }
+            f << std::endl;
+            if( !f ) {
+                RAVELOG_DEBUG_FORMAT("failed to write non-adjacent links to %s", tempfilename);
+                return;
+            }
+        }
+        if( std::rename(tempfilename.c_str(), fullfilename.c_str()) != 0 ) {
+            std::remove(tempfilename.c_str());
+        }
+    }
+    catch(const std::exception& ex) {
+        RAVELOG_DEBUG_FORMAT("failed to write non-adjacent links to %s: %s", fullfilename%ex.what());
+    }
+}
+
+/// \brief checks the link pairs vpairs[i] with ithread == i%numthreads and sets vcolliding[i] to 1 if the pair collides
+static void _CheckLinkPairsThread(KinBodyPtr pbody, const std::vector<int>& vpairs, int ithread, int numthreads, std::vector<uint8_t>& vcolliding)
+{
+    CollisionCheckerBasePtr collisionchecker = !!pbody->GetSelfCollisionChecker() ? pbody->GetSelfCollisionChecker() : pbody->GetEnv()->GetCollisionChecker();
+    CollisionOptionsStateSaver colsaver(collisionchecker,0);
+    for(size_t i = ithread; i < vpairs.size(); i += numthreads) {
+        vcolliding[i] = collisionchecker->CheckCollision(KinBody::LinkConstPtr(pbody->GetLinks().at(vpairs[i]&0xffff)), KinBody::LinkConstPtr(pbody->GetLinks().at(vpairs[i]>>16)));
+    }
+}
+
+/// \brief checks the link pairs of the body at vinitialtransforms on cloned environments, one per thread
+static void _CheckLinkPairsParallel(KinBodyConstPtr pbody, const std::vector<Transform>& vinitialtransforms, const std::vector<int>& vpairs, int numthreads, std::vector<uint8_t>& vcolliding)
+{
+    vcolliding.resize(vpairs.size());
+    std::vector<EnvironmentBasePtr> vcloneenvs;
+    std::vector< boost::function<void()> > vtasks;
+    try {
+        for(int ithread = 0; ithread < numthreads; ++ithread) {
+            EnvironmentBasePtr pcloneenv = pbody->GetEnv()->CloneSelf(Clone_Bodies);
+            vcloneenvs.push_back(pcloneenv);
+            KinBodyPtr pclonebody = pcloneenv->GetKinBody(pbody->GetName());
+            pclonebody->SetLinkTransformations(vinitialtransforms);
+            vtasks.push_back(boost::bind(_CheckLinkPairsThread, pclonebody, boost::cref(vpairs), ithread, numthreads, boost::ref(vcolliding)));
+        }
+        utils::ThreadPool pool(numthreads);
+        pool.RunTasks(vtasks);
+    }
+    catch(...) {
+        vtasks.clear();
+        FOREACH(itenv, vcloneenvs) {
+            (*itenv)->Destroy();
+        }
+        throw;
+    }
+    vtasks.clear();
+    FOREACH(itenv, vcloneenvs) {
+        (*itenv)->Destroy();
+    }
+}
+
 const std::vector<int>& KinBody::GetNonAdjacentLinks(int adjacentoptions) const
 {
     class TransformsSaver
@@ -4439,24 +4582,73 @@ private:
     CHECK_INTERNAL_COMPUTATION;
     if( _nNonAdjacentLinkCache & 0x80000000 ) {
         // Check for colliding link pairs given the initial pose _vInitialLinkTransformations
-        // this is actually weird, we need to call the individual link collisions on a const body. in order to pull this off, we need to be very careful with the body state.
-        TransformsSaver saver(shared_kinbody_const());
+        // the result only depends on the geometry, the initial pose and the adjacent links, so look for it in the bodies computed before in this process and in the database first
         CollisionCheckerBasePtr collisionchecker = !!_selfcollisionchecker ? _selfcollisionchecker : GetEnv()->GetCollisionChecker();
-        CollisionOptionsStateSaver colsaver(collisionchecker,0); // have to reset the collision options
-        for(size_t i = 0; i < _veclinks.size(); ++i) {
-            boost::static_pointer_cast<Link>(_veclinks[i])->_info._t = _vInitialLinkTransformations.at(i);
+        std::string key = _GetNonAdjacentLinksKey(*this, _vInitialLinkTransformations, _setAdjacentLinks, collisionchecker);
+        bool bCached = false;
+        {
+            boost::mutex::scoped_lock lock(s_mutexNonAdjacentLinks);
+            std::map<std::string, std::vector<int> >::const_iterator itcached = s_mapNonAdjacentLinks.find(key);
+            if( itcached != s_mapNonAdjacentLinks.end() ) {
+                _vNonAdjacentLinks[0] = itcached->second;
+                bCached = true;
+            }
         }
-        _nUpdateStampId++; // because transforms were modified
-        _vNonAdjacentLinks[0].resize(0);
-        for(size_t i = 0; i < _veclinks.size(); ++i) {
-            for(size_t j = i+1; j < _veclinks.size(); ++j) {
-                if((_setAdjacentLinks.find(i|(j<<16)) == _setAdjacentLinks.end())&& !collisionchecker->CheckCollision(LinkConstPtr(_veclinks[i]), LinkConstPtr(_veclinks[j])) ) {
-                    _vNonAdjacentLinks[0].push_back(i|(j<<16));
+        if( !bCached ) {
+            std::string filename;
+            if( _veclinks.size()*(_veclinks.size()-1)/2 >= s_nMinNonAdjacentLinkPairsDatabase + _setAdjacentLinks.size() ) {
+                filename = _GetNonAdjacentLinksFilename(*this, key);
+            }
+            if( filename.size() > 0 && _ReadNonAdjacentLinks(filename, _veclinks.size(), _vNonAdjacentLinks[0]) ) {
+                RAVELOG_VERBOSE_FORMAT("env=%d, body %s read %d non-adjacent links from the database", GetEnv()->GetId()%GetName()%_vNonAdjacentLinks[0].size());
+            }
+            else {
+                std::vector<int> vpairs;
+                for(size_t i = 0; i < _veclinks.size(); ++i) {
+                    for(size_t j = i+1; j < _veclinks.size(); ++j) {
+                        if( _setAdjacentLinks.find(i|(j<<16)) == _setAdjacentLinks.end() ) {
+                            vpairs.push_back(i|(j<<16));
+                        }
+                    }
+                }
+
+                // cloning the environment for every thread only pays off for many pairs
+                int numthreads = std::min((int)boost::thread::hardware_concurrency(), (int)(vpairs.size()/256));
+                std::vector<uint8_t> vcolliding;
+                if( numthreads > 1 && GetEnvironmentId() != 0 ) {
+                    _CheckLinkPairsParallel(shared_kinbody_const(), _vInitialLinkTransformations, vpairs, numthreads, vcolliding);
+                }
+                else {
+                    {
+                        // this is actually weird, we need to call the individual link collisions on a const body. in order to pull this off, we need to be very careful with the body state.
+                        TransformsSaver saver(shared_kinbody_const());
+                        CollisionOptionsStateSaver colsaver(collisionchecker,0); // have to reset the collision options
+                        for(size_t i = 0; i < _veclinks.size(); ++i) {
+                            boost::static_pointer_cast<Link>(_veclinks[i])->_info._t = _vInitialLinkTransformations.at(i);
+                        }
+                        _nUpdateStampId++; // because transforms were modified
+                        vcolliding.resize(vpairs.size());
+                        for(size_t ipair = 0; ipair < vpairs.size(); ++ipair) {
+                            vcolliding[ipair] = collisionchecker->CheckCollision(LinkConstPtr(_veclinks.at(vpairs[ipair]&0xffff)), LinkConstPtr(_veclinks.at(vpairs[ipair]>>16)));
+                        }
+                    }
+                    _nUpdateStampId++; // because transforms were modified
+                }
+
+                _vNonAdjacentLinks[0].resize(0);
+                for(size_t ipair = 0; ipair < vpairs.size(); ++ipair) {
+                    if( !vcolliding[ipair] ) {
+                        _vNonAdjacentLinks[0].push_back(vpairs[ipair]);
+                    }
+                }
+                std::sort(_vNonAdjacentLinks[0].begin(), _vNonAdjacentLinks[0].end(), CompareNonAdjacentFarthest);
+                if( filename.size() > 0 ) {
+                    _WriteNonAdjacentLinks(filename, _vNonAdjacentLinks[0]);
                 }
             }
+            boost::mutex::scoped_lock lock(s_mutexNonAdjacentLinks);
+            s_mapNonAdjacentLinks[key] = _vNonAdjacentLinks[0];
         }
-        std::sort(_vNonAdjacentLinks[0].begin(), _vNonAdjacentLinks[0].end(), CompareNonAdjacentFarthest);
-        _nUpdateStampId++; // because transforms were modified
         _nNonAdjacentLinkCache = 0;
     }
     if( (_nNonAdjacentLinkCache&adjacentoptions) != adjacentoptions ) {
@@ -20,6 +20,7 @@ namespace OpenRAVE {
 
 bool KinBody::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
 {
+    OPENRAVE_PROFILE_SCOPE("KinBody::CheckSelfCollision");
     if( !collisionchecker ) {
         collisionchecker = _selfcollisionchecker;
         if( !collisionchecker ) {
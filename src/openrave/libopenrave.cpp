@@ -491,6 +491,11 @@ public:
             _defaultviewertype = std::string(pOPENRAVE_DEFAULT_VIEWER);
         }
 
+        const char* pOPENRAVE_PROFILING = std::getenv("OPENRAVE_PROFILING");
+        if( !!pOPENRAVE_PROFILING && atoi(pOPENRAVE_PROFILING) != 0 ) {
+            RaveSetProfilingEnabled(true);
+        }
+
         _UpdateDataDirs();
         return 0;
     }
@@ -1886,15 +1891,90 @@ void CollisionReport::Reset(int coloptions)
         numWithinTol = 0;
         contacts.resize(0);
         vLinkColliding.resize(0);
+        vCompactLinkColliding.resize(0);
         plink1.reset();
         plink2.reset();
     }
 }
 
+void CollisionReport::AddLinkColliding(const KinBody::LinkConstPtr& plink1, const KinBody::LinkConstPtr& plink2)
+{
+    if( bCompactLinkColliding ) {
+        LinkPairIndices linkpair;
+        if( !!plink1 ) {
+            linkpair.bodyid1 = plink1->GetParent()->GetEnvironmentId();
+            linkpair.linkindex1 = plink1->GetIndex();
+        }
+        if( !!plink2 ) {
+            linkpair.bodyid2 = plink2->GetParent()->GetEnvironmentId();
+            linkpair.linkindex2 = plink2->GetIndex();
+        }
+        std::vector<LinkPairIndices>::iterator it = std::lower_bound(vCompactLinkColliding.begin(), vCompactLinkColliding.end(), linkpair);
+        if( it == vCompactLinkColliding.end() || *it != linkpair ) {
+            vCompactLinkColliding.insert(it, linkpair);
+        }
+    }
+    else {
+        FOREACHC(itlinkpair, vLinkColliding) {
+            if( itlinkpair->first == plink1 && itlinkpair->second == plink2 ) {
+                return;
+            }
+        }
+        vLinkColliding.push_back(std::make_pair(plink1, plink2));
+    }
+}
+
+CollisionReport::LinkPairIndices CollisionReport::GetLinkCollidingIndices(size_t index) const
+{
+    if( index < vCompactLinkColliding.size() ) {
+        return vCompactLinkColliding[index];
+    }
+    const std::pair<KinBody::LinkConstPtr, KinBody::LinkConstPtr>& linkpair = vLinkColliding.at(index - vCompactLinkColliding.size());
+    LinkPairIndices indices;
+    if( !!linkpair.first ) {
+        indices.bodyid1 = linkpair.first->GetParent()->GetEnvironmentId();
+        indices.linkindex1 = linkpair.first->GetIndex();
+    }
+    if( !!linkpair.second ) {
+        indices.bodyid2 = linkpair.second->GetParent()->GetEnvironmentId();
+        indices.linkindex2 = linkpair.second->GetIndex();
+    }
+    return indices;
+}
+
+static KinBody::LinkConstPtr _GetLinkFromIndices(EnvironmentBasePtr penv, int bodyid, int linkindex)
+{
+    if( linkindex < 0 ) {
+        return KinBody::LinkConstPtr();
+    }
+    KinBodyPtr pbody = penv->GetBodyFromEnvironmentId(bodyid);
+    if( !pbody || linkindex >= (int)pbody->GetLinks().size() ) {
+        return KinBody::LinkConstPtr();
+    }
+    return pbody->GetLinks()[linkindex];
+}
+
+std::pair<KinBody::LinkConstPtr, KinBody::LinkConstPtr> CollisionReport::GetLinkColliding(EnvironmentBasePtr penv, size_t index) const
+{
+    if( index < vCompactLinkColliding.size() ) {
+        const LinkPairIndices& indices = vCompactLinkColliding[index];
+        return std::make_pair(_GetLinkFromIndices(penv, indices.bodyid1, indices.linkindex1), _GetLinkFromIndices(penv, indices.bodyid2, indices.linkindex2));
+    }
+    return vLinkColliding.at(index - vCompactLinkColliding.size());
+}
+
 std::string CollisionReport::__str__() const
 {
     stringstream s;
-    if( vLinkColliding.size() > 0 ) {
+    if( vCompactLinkColliding.size() > 0 ) {
+        s << "pairs=" << vCompactLinkColliding.size();
+        int index = 0;
+        FOREACHC(itlinkpair, vCompactLinkColliding) {
+            s << ", [" << index << "](" << itlinkpair->bodyid1 << ":" << itlinkpair->linkindex1 << ")x(" << itlinkpair->bodyid2 << ":" << itlinkpair->linkindex2 << ") ";
+            ++index;
+        }
+    }
+    else if( vLinkColliding.size() > 0 ) {
         s << "pairs=" << vLinkColliding.size();
         int index = 0;
         FOREACH(itlinkpair, vLinkColliding) {
@@ -50,6 +50,7 @@
 #include <set>
 #include <string>
 #include <algorithm>
+#include <atomic>
 #include <complex>
 
 #define FOREACH(it, v) for(typeof((v).begin())it = (v).begin(), __itend__=(v).end(); it != __itend__; (it)++)
@@ -286,6 +287,17 @@ void CallGetStateFns(const std::vector< std::pair<PlannerBase::PlannerParameters
 
 void subtractstates(std::vector<dReal>& q1, const std::vector<dReal>& q2);
 
+/// \brief flag of RaveIsProfilingEnabled, the hot paths of libopenrave check it through IsProfilingEnabled without a function call
+extern std::atomic<bool> g_bProfilingEnabled;
+
+inline bool IsProfilingEnabled()
+{
+    return g_bProfilingEnabled.load(std::memory_order_relaxed);
+}
+
+/// \brief called when a plugin library is closed, since the addresses of its event names can then hold other strings
+void InvalidateProfileNameCaches();
+
 /// \brief The information of a currently grabbed body.
 class Grabbed : public UserData, public boost::enable_shared_from_this<Grabbed>
 {
@@ -63,6 +63,160 @@ inline ModuleBasePtr GetModule(void* module)
     return RaveInterfaceCast<ModuleBase>(*static_cast<InterfaceBasePtr*>(module));
 }
 
+/// \brief checks the configurations [istart, iend) of pbody, the outputs are indexed by configuration like in ORCBodyCheckConfigurations
+///
+/// \return number of configurations in collision
+static int _CheckBodyConfigurations(KinBodyPtr pbody, const dReal* configurations, int istart, int iend, bool bCheckSelfCollision, int* collisions, dReal* distances, dReal* linkposes)
+{
+    EnvironmentBasePtr penv = pbody->GetEnv();
+    EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+    KinBody::KinBodyStateSaver saver(pbody);
+    int dof = pbody->GetDOF();
+    const std::vector<KinBody::LinkPtr>& vlinks = pbody->GetLinks();
+    bool bCheckCollision = !!collisions || !!distances;
+    bool bDistance = false;
+    CollisionReportPtr report;
+    boost::shared_ptr<CollisionOptionsStateSaver> optionssaver;
+    CollisionCheckerBasePtr pchecker = penv->GetCollisionChecker();
+    if( !!distances && !!pchecker ) {
+        optionssaver.reset(new CollisionOptionsStateSaver(pchecker, pchecker->GetCollisionOptions()|CO_Distance, false));
+        bDistance = !!(pchecker->GetCollisionOptions() & CO_Distance);
+        report.reset(new CollisionReport());
+    }
+
+    std::vector<dReal> vvalues(dof);
+    int numcollisions = 0;
+    for(int iconfig = istart; iconfig < iend; ++iconfig) {
+        if( dof > 0 ) {
+            std::copy(configurations+iconfig*dof, configurations+(iconfig+1)*dof, vvalues.begin());
+            pbody->SetDOFValues(vvalues);
+        }
+        if( bCheckCollision ) {
+            bool bCollision = penv->CheckCollision(KinBodyConstPtr(pbody), report);
+            if( !!distances ) {
+                distances[iconfig] = bDistance ? report->minDistance : dReal(-1);
+            }
+            if( !bCollision && bCheckSelfCollision ) {
+                bCollision = pbody->CheckSelfCollision();
+            }
+            if( !!collisions ) {
+                collisions[iconfig] = bCollision ? 1 : 0;
+            }
+            if( bCollision ) {
+                ++numcollisions;
+            }
+        }
+        if( !!linkposes ) {
+            dReal* pposes = linkposes + (size_t)iconfig*vlinks.size()*7;
+            FOREACHC(itlink, vlinks) {
+                const Transform& t = (*itlink)->GetTransform();
+                for(int i = 0; i < 4; ++i) {
+                    *pposes++ = t.rot[i];
+                }
+                for(int i = 0; i < 3; ++i) {
+                    *pposes++ = t.trans[i];
+                }
+            }
+        }
+    }
+    return numcollisions;
+}
+
+static void _CheckBodyConfigurationsThreadCB(KinBodyPtr pbody, const dReal* configurations, int istart, int iend, bool bCheckSelfCollision, int* collisions, dReal* distances, dReal* linkposes, int* pnumcollisions)
+{
+    *pnumcollisions = _CheckBodyConfigurations(pbody, configurations, istart, iend, bCheckSelfCollision, collisions, distances, linkposes);
+}
+
+/// \brief environments cloned by ORCBodyCheckConfigurations, kept between calls since cloning an environment is expensive
+///
+/// The clones of an environment are destroyed once it is gone, and all of them are released by RaveDestroy.
+class BodyConfigurationsCloneCache
+{
+public:
+    BodyConfigurationsCloneCache() : _bRegisteredDestroy(false) {
+    }
+
+    /// \brief returns numclones environments with the same bodies as penv, the caller has to lock penv
+    void Get(EnvironmentBasePtr penv, int numclones, std::vector<EnvironmentBasePtr>& vclones)
+    {
+        vclones.resize(0);
+        std::list<EnvironmentBasePtr> listexpired;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            if( !_bRegisteredDestroy ) {
+                RaveAddCallbackForDestroy(boost::bind(&BodyConfigurationsCloneCache::_Clear, this));
+                _bRegisteredDestroy = true;
+            }
+            std::list<CloneEntry>::iterator itentry = _listentries.begin();
+            while( itentry != _listentries.end() ) {
+                EnvironmentBasePtr psource = itentry->_psource.lock();
+                if( !psource ) {
+                    listexpired.insert(listexpired.end(), itentry->_vclones.begin(), itentry->_vclones.end());
+                    itentry = _listentries.erase(itentry);
+                    continue;
+                }
+                if( psource == penv ) {
+                    // take them out so that concurrent calls on the same environment do not share clones
+                    while( (int)vclones.size() < numclones && itentry->_vclones.size() > 0 ) {
+                        vclones.push_back(itentry->_vclones.back());
+                        itentry->_vclones.pop_back();
+                    }
+                }
+                ++itentry;
+            }
+        }
+        FOREACH(itenv, listexpired) {
+            (*itenv)->Destroy();
+        }
+        FOREACH(itclone, vclones) {
+            (*itclone)->Clone(penv, Clone_Bodies);
+        }
+        while( (int)vclones.size() < numclones ) {
+            vclones.push_back(penv->CloneSelf(Clone_Bodies));
+        }
+    }
+
+    /// \brief gives back the environments returned by Get so that the next calls on penv reuse them
+    void Release(EnvironmentBasePtr penv, const std::vector<EnvironmentBasePtr>& vclones)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        FOREACH(itentry, _listentries) {
+            if( itentry->_psource.lock() == penv ) {
+                itentry->_vclones.insert(itentry->_vclones.end(), vclones.begin(), vclones.end());
+                return;
+            }
+        }
+        _listentries.push_back(CloneEntry());
+        _listentries.back()._psource = penv;
+        _listentries.back()._vclones = vclones;
+    }
+
+private:
+    struct CloneEntry
+    {
+        EnvironmentBaseWeakPtr _psource;
+        std::vector<EnvironmentBasePtr> _vclones;
+    };
+
+    /// \brief called by RaveDestroy, which already destroyed all the environments
+    void _Clear()
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _listentries.clear();
+        _bRegisteredDestroy = false;
+    }
+
+    boost::mutex _mutex;
+    std::list<CloneEntry> _listentries;
+    bool _bRegisteredDestroy;
+};
+
+static BodyConfigurationsCloneCache& GetBodyConfigurationsCloneCache()
+{
+    static BodyConfigurationsCloneCache s_cache;
+    return s_cache;
+}
+
 }
 
 extern "C" {
@@ -153,6 +307,11 @@ int ORCEnvironmentLoad(void* env, const char* filename)
         return 0;
 }
 
+int ORCEnvironmentCheckCollision(void* env, void* body)
+{
+    return GetEnvironment(env)->CheckCollision(KinBodyConstPtr(GetBody(body))) ? 1 : 0;
+}
+
 void* ORCEnvironmentGetKinBody(void* env, const char* name)
 {
     KinBodyPtr pbody = GetEnvironment(env)->GetKinBody(name);
@@ -387,6 +546,50 @@ void ORCBodyGetTransformMatrix(void* body, dReal* matrix)
     }
 }
 
+int ORCBodyCheckConfigurations(void* body, const dReal* configurations, int numconfigurations, int checkselfcollision, int numthreads, int* collisions, dReal* distances, dReal* linkposes)
+{
+    KinBodyPtr pbody = GetBody(body);
+    if( numconfigurations <= 0 ) {
+        return 0;
+    }
+    numthreads = std::min(numthreads, numconfigurations);
+    std::vector<EnvironmentBasePtr> vcloneenvs;
+    try {
+        if( numthreads <= 1 ) {
+            return _CheckBodyConfigurations(pbody, configurations, 0, numconfigurations, checkselfcollision != 0, collisions, distances, linkposes);
+        }
+
+        // every thread checks a contiguous block of configurations with its own copy of the environment
+        std::vector<int> vnumcollisions(numthreads, 0);
+        std::vector< boost::function<void()> > vtasks(numthreads);
+        {
+            EnvironmentMutex::scoped_lock lock(pbody->GetEnv()->GetMutex());
+            GetBodyConfigurationsCloneCache().Get(pbody->GetEnv(), numthreads, vcloneenvs);
+            for(int ithread = 0; ithread < numthreads; ++ithread) {
+                KinBodyPtr pclonebody = vcloneenvs.at(ithread)->GetKinBody(pbody->GetName());
+                OPENRAVE_ASSERT_FORMAT(!!pclonebody, "cloned environment does not have body %s", pbody->GetName(), ORE_Failed);
+                int istart = (int)((int64_t)ithread*numconfigurations/numthreads), iend = (int)((int64_t)(ithread+1)*numconfigurations/numthreads);
+                vtasks[ithread] = boost::bind(_CheckBodyConfigurationsThreadCB, pclonebody, configurations, istart, iend, checkselfcollision != 0, collisions, distances, linkposes, &vnumcollisions[ithread]);
+            }
+        }
+        utils::ThreadPool pool(numthreads);
+        pool.RunTasks(vtasks);
+        GetBodyConfigurationsCloneCache().Release(pbody->GetEnv(), vcloneenvs);
+        int numcollisions = 0;
+        FOREACHC(itnumcollisions, vnumcollisions) {
+            numcollisions += *itnumcollisions;
+        }
+        return numcollisions;
+    }
+    catch(const std::exception& ex) {
+        RAVELOG_WARN_FORMAT("failed to check the configurations of body %s: %s", pbody->GetName()%ex.what());
+        FOREACH(itenv, vcloneenvs) {
+            (*itenv)->Destroy();
+        }
+        return -1;
+    }
+}
+
 int ORCBodyInitFromTrimesh(void* body, void* trimesh, int visible)
 {
     TriMesh* ptrimesh = static_cast<TriMesh*>(trimesh);
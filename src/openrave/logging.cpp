@@ -0,0 +1,876 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2016 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "libopenrave.h"
+
+#include <boost/thread/tss.hpp>
+#include <atomic>
+#include <cstdarg>
+
+namespace OpenRAVE {
+
+/// \brief length modifier of a printf conversion specification
+enum LogFormatLength
+{
+    LFL_None=0, LFL_hh, LFL_h, LFL_l, LFL_ll, LFL_j, LFL_z, LFL_t, LFL_L,
+};
+
+/// \brief a printf conversion specification, the ranges point into the format string
+struct LogFormatSpec
+{
+    const char* pflags;
+    size_t numflags;
+    const char* pwidth;
+    size_t numwidth;
+    bool bStarWidth;
+    bool bPrecision;
+    const char* pprecision;
+    size_t numprecision;
+    bool bStarPrecision;
+    int length; ///< \see LogFormatLength
+    char conversion;
+};
+
+/// \brief parses the conversion specification following a '%'
+///
+/// \return the character after the specification, or NULL if its arguments cannot be stored for formatting them later (%n, %m, positional and wide arguments)
+static const char* ParseLogFormatSpec(const char* p, LogFormatSpec& spec)
+{
+    spec.pflags = p;
+    while( *p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'' ) {
+        ++p;
+    }
+    spec.numflags = p - spec.pflags;
+    spec.pwidth = p;
+    spec.bStarWidth = *p == '*';
+    if( spec.bStarWidth ) {
+        ++p;
+    }
+    else {
+        while( *p >= '0' && *p <= '9' ) {
+            ++p;
+        }
+    }
+    spec.numwidth = p - spec.pwidth;
+    spec.bPrecision = *p == '.';
+    spec.pprecision = p;
+    spec.numprecision = 0;
+    spec.bStarPrecision = false;
+    if( spec.bPrecision ) {
+        spec.pprecision = ++p;
+        spec.bStarPrecision = *p == '*';
+        if( spec.bStarPrecision ) {
+            ++p;
+        }
+        else {
+            while( *p >= '0' && *p <= '9' ) {
+                ++p;
+            }
+        }
+        spec.numprecision = p - spec.pprecision;
+    }
+    if( *p == '$' || spec.numflags + spec.numwidth + spec.numprecision > 32 ) {
+        return NULL;
+    }
+    spec.length = LFL_None;
+    switch(*p) {
+    case 'h': ++p; spec.length = LFL_h; if( *p == 'h' ) { ++p; spec.length = LFL_hh; } break;
+    case 'l': ++p; spec.length = LFL_l; if( *p == 'l' ) { ++p; spec.length = LFL_ll; } break;
+    case 'q': ++p; spec.length = LFL_ll; break;
+    case 'j': ++p; spec.length = LFL_j; break;
+    case 'z': ++p; spec.length = LFL_z; break;
+    case 't': ++p; spec.length = LFL_t; break;
+    case 'L': ++p; spec.length = LFL_L; break;
+    }
+    spec.conversion = *p;
+    switch(spec.conversion) {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        return spec.length != LFL_L ? p+1 : NULL;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        return spec.length == LFL_None || spec.length == LFL_l || spec.length == LFL_L ? p+1 : NULL;
+    case 'c': case 's': case 'p': case '%':
+        return spec.length == LFL_None ? p+1 : NULL;
+    default:
+        return NULL;
+    }
+}
+
+template <typename T>
+inline void AppendLogValue(std::string& record, const T& value)
+{
+    record.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+inline T ReadLogValue(const char*& p)
+{
+    T value;
+    memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return value;
+}
+
+/// \brief stores the format string and the values of its arguments in record so that the message can be formatted by WriteLogFormatRecord on another thread
+///
+/// Strings are copied, integers are stored as long long after the conversion to the type of their length modifier.
+/// \param[out] bEndsLine true if the formatted message ends with a new line
+/// \return false if the format cannot be stored, then list was partially consumed
+static bool CaptureLogFormatRecord(const char* fmt, va_list list, std::string& record, bool& bEndsLine)
+{
+    size_t fmtlen = strlen(fmt);
+    AppendLogValue(record, (uint32_t)fmtlen);
+    record.append(fmt, fmtlen+1);
+    bEndsLine = fmtlen > 0 && fmt[fmtlen-1] == '\n';
+    const char* p = fmt;
+    while( (p = strchr(p, '%')) != NULL ) {
+        LogFormatSpec spec;
+        const char* pnext = ParseLogFormatSpec(p+1, spec);
+        if( !pnext ) {
+            return false;
+        }
+        if( spec.bStarWidth ) {
+            AppendLogValue(record, va_arg(list, int));
+        }
+        int precision = -1;
+        if( spec.bStarPrecision ) {
+            precision = va_arg(list, int);
+            AppendLogValue(record, precision);
+        }
+        else if( spec.bPrecision ) {
+            precision = 0;
+            for(size_t i = 0; i < spec.numprecision; ++i) {
+                precision = 10*precision + (spec.pprecision[i]-'0');
+            }
+        }
+        bool bLast = *pnext == 0 && spec.numwidth == 0;
+        switch(spec.conversion) {
+        case 'd': case 'i': {
+            long long value = 0;
+            switch(spec.length) {
+            case LFL_hh: value = (signed char)va_arg(list, int); break;
+            case LFL_h: value = (short)va_arg(list, int); break;
+            case LFL_l: value = va_arg(list, long); break;
+            case LFL_ll: value = va_arg(list, long long); break;
+            case LFL_j: value = va_arg(list, intmax_t); break;
+            case LFL_z: value = (std::make_signed<size_t>::type)va_arg(list, size_t); break;
+            case LFL_t: value = va_arg(list, ptrdiff_t); break;
+            default: value = va_arg(list, int); break;
+            }
+            AppendLogValue(record, value);
+            break;
+        }
+        case 'o': case 'u': case 'x': case 'X': {
+            unsigned long long value = 0;
+            switch(spec.length) {
+            case LFL_hh: value = (unsigned char)va_arg(list, unsigned int); break;
+            case LFL_h: value = (unsigned short)va_arg(list, unsigned int); break;
+            case LFL_l: value = va_arg(list, unsigned long); break;
+            case LFL_ll: value = va_arg(list, unsigned long long); break;
+            case LFL_j: value = va_arg(list, uintmax_t); break;
+            case LFL_z: value = va_arg(list, size_t); break;
+            case LFL_t: value = (std::make_unsigned<ptrdiff_t>::type)va_arg(list, ptrdiff_t); break;
+            default: value = va_arg(list, unsigned int); break;
+            }
+            AppendLogValue(record, value);
+            break;
+        }
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if( spec.length == LFL_L ) {
+                AppendLogValue(record, va_arg(list, long double));
+            }
+            else {
+                AppendLogValue(record, va_arg(list, double));
+            }
+            break;
+        case 'c': {
+            int value = va_arg(list, int);
+            AppendLogValue(record, value);
+            if( bLast ) {
+                bEndsLine = (char)value == '\n';
+            }
+            break;
+        }
+        case 's': {
+            const char* pstring = va_arg(list, const char*);
+            if( !pstring ) {
+                pstring = "(null)";
+            }
+            size_t len = precision >= 0 ? strnlen(pstring, precision) : strlen(pstring);
+            AppendLogValue(record, (uint32_t)len);
+            record.append(pstring, len);
+            record.push_back(0);
+            if( bLast ) {
+                bEndsLine = len > 0 && pstring[len-1] == '\n';
+            }
+            break;
+        }
+        case 'p':
+            AppendLogValue(record, va_arg(list, void*));
+            break;
+        }
+        p = pnext;
+    }
+    return true;
+}
+
+/// \brief formats a record of CaptureLogFormatRecord to f
+static void WriteLogFormatRecord(FILE* f, const char* precord)
+{
+    const char* p = precord;
+    uint32_t fmtlen = ReadLogValue<uint32_t>(p);
+    const char* fmt = p;
+    p += fmtlen+1;
+    char specbuffer[64];
+    const char* pliteral = fmt;
+    const char* pspec;
+    while( (pspec = strchr(pliteral, '%')) != NULL ) {
+        fwrite(pliteral, 1, pspec-pliteral, f);
+        LogFormatSpec spec;
+        pliteral = ParseLogFormatSpec(pspec+1, spec);
+        if( spec.conversion == '%' ) {
+            fputc('%', f);
+            continue;
+        }
+        if( spec.numflags == 0 && spec.numwidth == 0 && !spec.bPrecision ) {
+            // the plain conversions of most messages do not need printf
+            switch(spec.conversion) {
+            case 'd': case 'i': case 'u': {
+                unsigned long long value;
+                bool bNegative = false;
+                if( spec.conversion == 'u' ) {
+                    value = ReadLogValue<unsigned long long>(p);
+                }
+                else {
+                    long long signedvalue = ReadLogValue<long long>(p);
+                    bNegative = signedvalue < 0;
+                    value = bNegative ? 0ull-(unsigned long long)signedvalue : (unsigned long long)signedvalue;
+                }
+                char digits[24];
+                char* pdigit = digits + sizeof(digits);
+                do {
+                    *--pdigit = '0' + (char)(value % 10);
+                    value /= 10;
+                } while( value > 0 );
+                if( bNegative ) {
+                    *--pdigit = '-';
+                }
+                fwrite(pdigit, 1, digits + sizeof(digits) - pdigit, f);
+                continue;
+            }
+            case 'c':
+                fputc((unsigned char)ReadLogValue<int>(p), f);
+                continue;
+            case 's': {
+                uint32_t len = ReadLogValue<uint32_t>(p);
+                fwrite(p, 1, len, f);
+                p += len+1;
+                continue;
+            }
+            }
+        }
+        // rebuild the specification with the values of the stars and the length of the stored value
+        char* pout = specbuffer;
+        *pout++ = '%';
+        memcpy(pout, spec.pflags, spec.numflags);
+        pout += spec.numflags;
+        if( spec.bStarWidth ) {
+            pout += sprintf(pout, "%d", ReadLogValue<int>(p));
+        }
+        else {
+            memcpy(pout, spec.pwidth, spec.numwidth);
+            pout += spec.numwidth;
+        }
+        if( spec.bStarPrecision ) {
+            int precision = ReadLogValue<int>(p);
+            if( precision >= 0 ) {
+                pout += sprintf(pout, ".%d", precision);
+            }
+        }
+        else if( spec.bPrecision ) {
+            *pout++ = '.';
+            memcpy(pout, spec.pprecision, spec.numprecision);
+            pout += spec.numprecision;
+        }
+        switch(spec.conversion) {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            *pout++ = 'l';
+            *pout++ = 'l';
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if( spec.length == LFL_L ) {
+                *pout++ = 'L';
+            }
+            break;
+        }
+        *pout++ = spec.conversion;
+        *pout = 0;
+        switch(spec.conversion) {
+        case 'd': case 'i':
+            fprintf(f, specbuffer, ReadLogValue<long long>(p));
+            break;
+        case 'o': case 'u': case 'x': case 'X':
+            fprintf(f, specbuffer, ReadLogValue<unsigned long long>(p));
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if( spec.length == LFL_L ) {
+                fprintf(f, specbuffer, ReadLogValue<long double>(p));
+            }
+            else {
+                fprintf(f, specbuffer, ReadLogValue<double>(p));
+            }
+            break;
+        case 'c':
+            fprintf(f, specbuffer, ReadLogValue<int>(p));
+            break;
+        case 's': {
+            uint32_t len = ReadLogValue<uint32_t>(p);
+            fprintf(f, specbuffer, p);
+            p += len+1;
+            break;
+        }
+        case 'p':
+            fprintf(f, specbuffer, ReadLogValue<void*>(p));
+            break;
+        }
+    }
+    fputs(pliteral, f);
+}
+
+/// \brief lock-free ring buffer of log messages with one producer, its owning thread, and one consumer
+///
+/// Every message is either text or a printf record whose formatting is left to the consumer. Messages that do not end
+/// a line (like the [file:line] header of RAVELOG) are only written once the message completing their line is queued,
+/// so that lines of different threads never mix. Flushing can also write the incomplete line, then its remaining
+/// messages are written as a line of their own.
+class LogRingBuffer
+{
+public:
+    /// \brief precedes every message, messages start at multiples of sizeof(MessageHeader)
+    struct MessageHeader
+    {
+        uint32_t size; ///< number of bytes of the message, or s_nPadding if the messages continue at the start of the buffer
+        int16_t color; ///< terminal color, -1 for the default
+        uint8_t type; ///< \see MessageType
+        uint8_t bEndsLine; ///< 1 if the message ends its line
+    };
+
+    enum MessageType
+    {
+        MT_Text = 0, ///< characters written as they are
+        MT_Format = 1, ///< record of CaptureLogFormatRecord
+    };
+
+    LogRingBuffer(size_t capacity) : _bThreadExited(false), _vbuffer(capacity), _mask(capacity-1), _head(0), _tail(0), _numdropped(0), _numlines(0), _numdrainedlines(0), _bLineOpen(false), _bDroppingLine(false) {
+        BOOST_ASSERT((capacity & _mask) == 0);
+    }
+
+    /// \brief queues the text and appends a new line if requested, called only by the owning thread.
+    ///
+    /// \return false if the message had to be dropped because there is not enough space
+    bool PushText(int color, const char* pdata, size_t len, bool baddnewline)
+    {
+        bool bEndsLine = baddnewline || (len > 0 && pdata[len-1] == '\n');
+        if( len+1 > _GetMaxLineLength() ) {
+            len = _GetMaxLineLength()-1;
+            bEndsLine = baddnewline = true;
+        }
+        return _PushMessage(color, MT_Text, pdata, len, baddnewline, bEndsLine);
+    }
+
+    /// \brief queues a printf message whose formatting is deferred to the consumer, called only by the owning thread.
+    ///
+    /// Formats the message right away when its arguments cannot be stored.
+    /// \return false if the message had to be dropped because there is not enough space
+    bool PushFormat(int color, const char* fmt, va_list list)
+    {
+        _record.resize(0);
+        bool bEndsLine = false;
+        va_list listcopy;
+        va_copy(listcopy, list);
+        bool bCaptured = CaptureLogFormatRecord(fmt, listcopy, _record, bEndsLine) && _record.size() < _GetMaxLineLength();
+        va_end(listcopy);
+        if( bCaptured ) {
+            return _PushMessage(color, MT_Format, _record.c_str(), _record.size(), false, bEndsLine);
+        }
+
+        va_copy(listcopy, list);
+        int len = vsnprintf(NULL, 0, fmt, listcopy);
+        va_end(listcopy);
+        if( len < 0 ) {
+            return false;
+        }
+        _record.resize(len+1);
+        vsnprintf(&_record[0], _record.size(), fmt, list);
+        return PushText(color, _record.c_str(), len, false);
+    }
+
+    /// \brief writes the queued lines to f, called only by the consumer.
+    ///
+    /// \param bIncomplete if true, also writes the incomplete line at the end with a new line. Otherwise it is only written when it is longer than the maximum line length.
+    /// \return the number of lines written
+    size_t Drain(FILE* f, bool bIncomplete)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        size_t numwritten = 0;
+        // one lock for all the writes of the lines
+#ifdef _WIN32
+        _lock_file(f);
+#else
+        flockfile(f);
+#endif
+        while( head < tail ) {
+            // find the end of the line
+            size_t lineend = head, linesize = 0;
+            bool bComplete = false;
+            while( lineend < tail && !bComplete ) {
+                const MessageHeader* pheader = reinterpret_cast<const MessageHeader*>(&_vbuffer[lineend & _mask]);
+                if( pheader->size == s_nPadding ) {
+                    lineend += _vbuffer.size() - (lineend & _mask);
+                    continue;
+                }
+                lineend += _Align(sizeof(MessageHeader)+pheader->size);
+                linesize += pheader->size;
+                bComplete = pheader->bEndsLine != 0;
+            }
+            if( !bComplete && !bIncomplete && linesize < _GetMaxLineLength() ) {
+                break;
+            }
+
+            int color = -1;
+            bool bFirst = true;
+            while( head < lineend ) {
+                size_t pos = head & _mask;
+                const MessageHeader* pheader = reinterpret_cast<const MessageHeader*>(&_vbuffer[pos]);
+                if( pheader->size == s_nPadding ) {
+                    head += _vbuffer.size() - pos;
+                    continue;
+                }
+                if( bFirst ) {
+                    // the line has the color of its first message
+                    color = pheader->color;
+                    if( color >= 0 ) {
+                        fprintf(f, "%c[0;%d;%dm", 0x1B, color + 30, 8+40);
+                    }
+                    bFirst = false;
+                }
+                const char* pdata = &_vbuffer[pos+sizeof(MessageHeader)];
+                if( pheader->type == MT_Format ) {
+                    WriteLogFormatRecord(f, pdata);
+                }
+                else {
+                    fwrite(pdata, 1, pheader->size, f);
+                }
+                head += _Align(sizeof(MessageHeader)+pheader->size);
+            }
+            if( bComplete ) {
+                _numdrainedlines.store(_numdrainedlines.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+            }
+            else {
+                fputc('\n', f);
+            }
+            if( color >= 0 ) {
+                fprintf(f, "%c[m", 0x1B);
+            }
+            _head.store(head, std::memory_order_release);
+            ++numwritten;
+        }
+#ifdef _WIN32
+        _unlock_file(f);
+#else
+        funlockfile(f);
+#endif
+        return numwritten;
+    }
+
+    inline bool IsEmpty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    /// \brief true if a complete line is waiting to be written
+    inline bool HasCompleteLines() const {
+        return _numlines.load(std::memory_order_acquire) != _numdrainedlines.load(std::memory_order_relaxed);
+    }
+
+    /// \brief true if more than a quarter of the buffer is queued
+    inline bool IsFilling() const {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire) > _vbuffer.size()/4;
+    }
+
+    inline uint64_t GetNumDropped() const {
+        return _numdropped.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> _bThreadExited; ///< set when the owning thread exits, the buffer is removed once it is empty
+
+private:
+    static const uint32_t s_nPadding = 0xffffffff;
+    static const size_t s_nLineEndReserve = 4*sizeof(MessageHeader); ///< bytes of a line end message including the worst case padding
+
+    static inline size_t _Align(size_t size) {
+        return (size + sizeof(MessageHeader) - 1) & ~(sizeof(MessageHeader) - 1);
+    }
+
+    inline size_t _GetMaxLineLength() const {
+        return _vbuffer.size()/4;
+    }
+
+    /// \brief queues one message of a line, the rest of the line is dropped once one of its messages is dropped
+    bool _PushMessage(int color, uint8_t type, const char* pdata, size_t len, bool baddnewline, bool bEndsLine)
+    {
+        if( _bDroppingLine ) {
+            if( bEndsLine ) {
+                _bDroppingLine = false;
+                _EndOpenLine();
+            }
+            return false;
+        }
+        // a message that leaves its line open keeps the space to end the line, so the line never runs into the next one
+        if( !_Reserve(_Align(sizeof(MessageHeader)+len+(baddnewline ? 1 : 0)), bEndsLine ? 0 : s_nLineEndReserve) ) {
+            _numdropped.fetch_add(1, std::memory_order_relaxed);
+            if( bEndsLine ) {
+                _EndOpenLine();
+            }
+            else {
+                _bDroppingLine = true;
+            }
+            return false;
+        }
+        _WriteMessage(color, type, pdata, len, baddnewline, bEndsLine);
+        return true;
+    }
+
+    /// \brief ends the open line with a new line, its space is always reserved
+    void _EndOpenLine()
+    {
+        if( _bLineOpen ) {
+            _Reserve(_Align(sizeof(MessageHeader)+1), 0);
+            _WriteMessage(-1, MT_Text, NULL, 0, true, true);
+        }
+    }
+
+    /// \brief checks that total bytes plus reserve fit, and inserts the padding when the message has to wrap around
+    bool _Reserve(size_t total, size_t reserve)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_acquire);
+        size_t pos = tail & _mask;
+        size_t contiguous = _vbuffer.size() - pos;
+        size_t required = total <= contiguous ? total : contiguous + total;
+        if( tail + required + reserve - head > _vbuffer.size() ) {
+            return false;
+        }
+        if( total > contiguous ) {
+            reinterpret_cast<MessageHeader*>(&_vbuffer[pos])->size = s_nPadding;
+            _tail.store(tail+contiguous, std::memory_order_release);
+        }
+        return true;
+    }
+
+    void _WriteMessage(int color, uint8_t type, const char* pdata, size_t len, bool baddnewline, bool bEndsLine)
+    {
+        size_t totallen = len + (baddnewline ? 1 : 0);
+        size_t total = _Align(sizeof(MessageHeader)+totallen);
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t pos = tail & _mask;
+        MessageHeader* pheader = reinterpret_cast<MessageHeader*>(&_vbuffer[pos]);
+        pheader->size = totallen;
+        pheader->color = color;
+        pheader->type = type;
+        pheader->bEndsLine = bEndsLine;
+        char* ptext = &_vbuffer[pos+sizeof(MessageHeader)];
+        if( len > 0 ) {
+            memcpy(ptext, pdata, len);
+        }
+        if( baddnewline ) {
+            ptext[len] = '\n';
+        }
+        _tail.store(tail+total, std::memory_order_release);
+        if( bEndsLine ) {
+            _numlines.store(_numlines.load(std::memory_order_relaxed)+1, std::memory_order_release);
+        }
+        _bLineOpen = !bEndsLine;
+    }
+
+    std::vector<char> _vbuffer;
+    size_t _mask;
+    std::atomic<size_t> _head; ///< total number of bytes consumed, only written by the consumer
+    std::atomic<size_t> _tail; ///< total number of bytes produced, only written by the owning thread
+    std::atomic<uint64_t> _numdropped;
+    std::atomic<size_t> _numlines; ///< number of complete lines queued, only written by the owning thread
+    std::atomic<size_t> _numdrainedlines; ///< number of complete lines written, only written by the consumer
+    std::string _record; ///< scratch of the owning thread for the printf records
+    bool _bLineOpen; ///< true if the last queued message did not end its line, only used by the owning thread
+    bool _bDroppingLine; ///< true if a message of the current line was dropped, only used by the owning thread
+};
+
+typedef boost::shared_ptr<LogRingBuffer> LogRingBufferPtr;
+
+/// \brief the current LogBackend
+///
+/// Kept outside of AsyncLogger since it is constant initialized and never destroyed, so the RAVELOG macros can check
+/// it during the static destruction that follows the destruction of the logger.
+static std::atomic<int> s_logbackend(LB_Console);
+
+/// \brief owns the ring buffers of all the logging threads and the thread that writes them
+class AsyncLogger
+{
+public:
+    AsyncLogger() : _tssbuffer(&AsyncLogger::_OnThreadExit), _bStopFlushThread(false), _bFlushThreadWaiting(false), _numdroppedremoved(0), _numdroppedreported(0) {
+    }
+
+    ~AsyncLogger() {
+        // messages logged by the objects destroyed after the logger have to be printed directly
+        s_logbackend.store(LB_Console, std::memory_order_release);
+        _StopFlushThread();
+        Flush();
+    }
+
+    static inline LogBackend GetBackend() {
+        return (LogBackend)s_logbackend.load(std::memory_order_relaxed);
+    }
+
+    void SetBackend(LogBackend backend)
+    {
+        boost::mutex::scoped_lock lock(_mutexBackend);
+        if( backend == GetBackend() ) {
+            return;
+        }
+        if( backend == LB_Asynchronous ) {
+            _bStopFlushThread = false;
+            _threadFlush = boost::thread(boost::bind(&AsyncLogger::_FlushThread, this));
+            s_logbackend.store(backend, std::memory_order_release);
+        }
+        else {
+            s_logbackend.store(backend, std::memory_order_release);
+            _StopFlushThread();
+            _Drain(true);
+        }
+    }
+
+    bool PushText(int color, const char* pdata, size_t len, bool baddnewline)
+    {
+        LogRingBuffer* pbuffer = _GetThreadBuffer();
+        bool bPushed = pbuffer->PushText(color, pdata, len, baddnewline);
+        _NotifyPushed(pbuffer);
+        return bPushed;
+    }
+
+    bool PushFormat(int color, const char* fmt, va_list list)
+    {
+        LogRingBuffer* pbuffer = _GetThreadBuffer();
+        bool bPushed = pbuffer->PushFormat(color, fmt, list);
+        _NotifyPushed(pbuffer);
+        return bPushed;
+    }
+
+    /// \brief writes all the queued lines and the incomplete lines of all the threads, returns the number of lines written
+    size_t Flush()
+    {
+        return _Drain(true);
+    }
+
+    uint64_t GetNumDropped()
+    {
+        boost::mutex::scoped_lock lock(_mutexBuffers);
+        uint64_t numdropped = _numdroppedremoved;
+        FOREACHC(itbuffer, _vbuffers) {
+            numdropped += (*itbuffer)->GetNumDropped();
+        }
+        return numdropped;
+    }
+
+private:
+    static void _OnThreadExit(LogRingBuffer* pbuffer)
+    {
+        // the buffer is owned by _vbuffers, the flushing thread writes its remaining lines before releasing it
+        pbuffer->_bThreadExited = true;
+    }
+
+    LogRingBuffer* _GetThreadBuffer()
+    {
+        LogRingBuffer* pbuffer = _tssbuffer.get();
+        if( !pbuffer ) {
+            LogRingBufferPtr pnewbuffer(new LogRingBuffer(s_nBufferCapacity));
+            {
+                boost::mutex::scoped_lock lock(_mutexBuffers);
+                _vbuffers.push_back(pnewbuffer);
+            }
+            _tssbuffer.reset(pnewbuffer.get());
+            pbuffer = pnewbuffer.get();
+        }
+        return pbuffer;
+    }
+
+    /// \brief wakes up the flushing thread when the buffer is filling up, or writes the lines directly if the backend was switched while they were being logged
+    ///
+    /// Otherwise the lines are left to the periodic flushing, waking up a thread for every line costs more than queueing it.
+    void _NotifyPushed(LogRingBuffer* pbuffer)
+    {
+        if( GetBackend() != LB_Asynchronous ) {
+            // nothing else will write these lines, the incomplete line is written with the message that completes it
+            _Drain(false);
+            return;
+        }
+        if( !pbuffer->IsFilling() ) {
+            return;
+        }
+        // pairs with the fence in _FlushThread so that either the flushing thread sees the line or this thread sees it waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if( _bFlushThreadWaiting.load(std::memory_order_relaxed) ) {
+            boost::mutex::scoped_lock lock(_mutexWakeup);
+            _condWakeup.notify_one();
+        }
+    }
+
+    /// \brief true if a buffer that is filling up has lines to write, the other lines wait for the next period
+    bool _HasFillingBuffers()
+    {
+        boost::mutex::scoped_lock lock(_mutexBuffers);
+        FOREACHC(itbuffer, _vbuffers) {
+            if( (*itbuffer)->IsFilling() && (*itbuffer)->HasCompleteLines() ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \param bIncomplete if true, also writes the incomplete lines, otherwise only the incomplete lines of the threads that exited
+    size_t _Drain(bool bIncomplete)
+    {
+        boost::mutex::scoped_lock lockdrain(_mutexDrain);
+        std::vector<LogRingBufferPtr> vbuffers;
+        {
+            boost::mutex::scoped_lock lock(_mutexBuffers);
+            vbuffers = _vbuffers;
+        }
+        size_t numwritten = 0;
+        FOREACH(itbuffer, vbuffers) {
+            numwritten += (*itbuffer)->Drain(stdout, bIncomplete || (*itbuffer)->_bThreadExited);
+        }
+
+        {
+            boost::mutex::scoped_lock lock(_mutexBuffers);
+            uint64_t numdropped = _numdroppedremoved;
+            std::vector<LogRingBufferPtr>::iterator itbuffer = _vbuffers.begin();
+            while(itbuffer != _vbuffers.end()) {
+                numdropped += (*itbuffer)->GetNumDropped();
+                if( (*itbuffer)->_bThreadExited && (*itbuffer)->IsEmpty() ) {
+                    _numdroppedremoved += (*itbuffer)->GetNumDropped();
+                    itbuffer = _vbuffers.erase(itbuffer);
+                }
+                else {
+                    ++itbuffer;
+                }
+            }
+            if( numdropped > _numdroppedreported ) {
+                fprintf(stdout, "%c[0;%d;%dmlogging dropped %d lines because the ring buffers were full%c[m\n", 0x1B, OPENRAVECOLOR_WARNLEVEL + 30, 8+40, (int)(numdropped - _numdroppedreported), 0x1B);
+                _numdroppedreported = numdropped;
+            }
+        }
+        if( numwritten > 0 ) {
+            fflush(stdout);
+        }
+        return numwritten;
+    }
+
+    void _FlushThread()
+    {
+        while(!_bStopFlushThread) {
+            _Drain(false);
+            boost::mutex::scoped_lock lock(_mutexWakeup);
+            _bFlushThreadWaiting.store(true, std::memory_order_relaxed);
+            // pairs with the fence in _NotifyPushed, a buffer that filled up before it is seen by _HasFillingBuffers
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if( !_bStopFlushThread && !_HasFillingBuffers() ) {
+                _condWakeup.timed_wait(lock, boost::posix_time::milliseconds(s_nFlushPeriodMS));
+            }
+            _bFlushThreadWaiting.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void _StopFlushThread()
+    {
+        {
+            boost::mutex::scoped_lock lock(_mutexWakeup);
+            _bStopFlushThread = true;
+            _condWakeup.notify_one();
+        }
+        if( _threadFlush.joinable() ) {
+            _threadFlush.join();
+        }
+    }
+
+    static const size_t s_nBufferCapacity = 1<<18; ///< bytes of every ring buffer, has to be a power of 2
+    static const int s_nFlushPeriodMS = 10; ///< the queued lines are written at least this often
+
+    boost::mutex _mutexBackend; ///< protects switching the backend
+    boost::mutex _mutexBuffers; ///< protects _vbuffers and the drop counters
+    boost::mutex _mutexDrain; ///< only one thread drains at a time
+    std::vector<LogRingBufferPtr> _vbuffers;
+    boost::thread_specific_ptr<LogRingBuffer> _tssbuffer;
+    boost::thread _threadFlush;
+    boost::mutex _mutexWakeup; ///< protects waiting on _condWakeup
+    boost::condition_variable _condWakeup; ///< wakes up the flushing thread when a buffer is filling up or it has to stop
+    std::atomic<bool> _bStopFlushThread;
+    std::atomic<bool> _bFlushThreadWaiting; ///< true while the flushing thread waits on _condWakeup
+    uint64_t _numdroppedremoved; ///< dropped messages of the buffers that were removed
+    uint64_t _numdroppedreported;
+};
+
+const int AsyncLogger::s_nFlushPeriodMS;
+
+static AsyncLogger& GetAsyncLogger()
+{
+    static AsyncLogger s_logger;
+    return s_logger;
+}
+
+void RaveSetLogBackend(LogBackend backend)
+{
+    GetAsyncLogger().SetBackend(backend);
+}
+
+LogBackend RaveGetLogBackend()
+{
+    return AsyncLogger::GetBackend();
+}
+
+void RaveFlushLog()
+{
+    GetAsyncLogger().Flush();
+}
+
+uint64_t RaveGetNumDroppedLogMessages()
+{
+    return GetAsyncLogger().GetNumDropped();
+}
+
+int RaveLogAsynchronousV(int color, const char* fmt, va_list list)
+{
+    return GetAsyncLogger().PushFormat(color, fmt, list) ? 0 : -1;
+}
+
+int RaveLogAsynchronous(int color, const std::string& s)
+{
+    bool baddnewline = s.size() == 0 || s[s.size()-1] != '\n';
+    if( !GetAsyncLogger().PushText(color, s.c_str(), s.size(), baddnewline) ) {
+        return -1;
+    }
+    return s.size();
+}
+
+}
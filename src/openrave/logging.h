@@ -127,6 +127,36 @@ OPENRAVE_API void RaveSetDebugLevel(int level);
 /// Returns the openrave debug level
 OPENRAVE_API int RaveGetDebugLevel();
 
+/// \brief How the RAVELOG messages are written to the console
+enum LogBackend {
+    LB_Console=0, ///< write every message on the calling thread (default)
+    LB_Asynchronous=1, ///< copy the format string and arguments into a lock-free per-thread ring buffer, format and write them on a background thread. Messages are dropped when a ring buffer is full.
+};
+
+/// \brief Sets the backend of the console logging, see \ref LogBackend.
+///
+/// Switching to \ref LB_Console flushes all the queued messages of all the threads, including their incomplete lines. Has no effect when OpenRAVE logs through log4cxx.
+OPENRAVE_API void RaveSetLogBackend(LogBackend backend);
+
+/// \brief Returns the current \ref LogBackend
+OPENRAVE_API LogBackend RaveGetLogBackend();
+
+/// \brief Blocks until all the messages queued by the asynchronous backend are written, including the incomplete lines of all the threads.
+OPENRAVE_API void RaveFlushLog();
+
+/// \brief Returns the number of messages the asynchronous backend dropped because a ring buffer was full.
+OPENRAVE_API uint64_t RaveGetNumDroppedLogMessages();
+
+/// \brief Queues a printf style message in the ring buffer of the calling thread. Used by the RavePrintf functions.
+///
+/// The format string and the arguments are copied and formatted by the background thread. Formats with %n, %m, positional or wide character arguments are formatted on the calling thread instead.
+/// \param color terminal color of the message, -1 for the default color
+/// \return 0 if the message was queued, or -1 if it was dropped
+OPENRAVE_API int RaveLogAsynchronousV(int color, const char* fmt, va_list list);
+
+/// \brief Queues a message in the ring buffer of the calling thread, a new line is appended if s does not end with one.
+OPENRAVE_API int RaveLogAsynchronous(int color, const std::string& s);
+
 /// extracts only the filename
 inline const char* RaveGetSourceFilename(const char* pfilename)
 {
@@ -397,6 +427,9 @@ DefineRavePrintfA(_INFOLEVEL)
 // for them.
 inline int RavePrintfA_INFOLEVEL(const std::string& s)
 {
+    if( RaveGetLogBackend() == LB_Asynchronous ) {
+        return RaveLogAsynchronous(-1, s);
+    }
     if((s.size() == 0)||(s[s.size()-1] != '\n')) {     // automatically add a new line
         printf("%s\n", s.c_str());
     }
@@ -410,7 +443,7 @@ inline int RavePrintfA_INFOLEVEL(const char *fmt, ...)
 {
     va_list list;
     va_start(list,fmt);
-    int r = vprintf(fmt, list);
+    int r = RaveGetLogBackend() == LB_Asynchronous ? RaveLogAsynchronousV(-1, fmt, list) : vprintf(fmt, list);
     va_end(list);
     //if( fmt[0] != '\n' ) { printf("\n"); }
     return r;
@@ -419,6 +452,9 @@ inline int RavePrintfA_INFOLEVEL(const char *fmt, ...)
 #define DefineRavePrintfA(LEVEL) \
     inline int RavePrintfA ## LEVEL(const std::string& s) \
     { \
+        if( RaveGetLogBackend() == LB_Asynchronous ) { \
+            return RaveLogAsynchronous(OPENRAVECOLOR ## LEVEL, s); \
+        } \
         if((s.size() == 0)||(s[s.size()-1] != '\n')) { \
             printf ("%c[0;%d;%dm%s%c[m\n", 0x1B, OPENRAVECOLOR ## LEVEL + 30,8+40,s.c_str(),0x1B); \
         } \
@@ -432,6 +468,11 @@ inline int RavePrintfA_INFOLEVEL(const char *fmt, ...)
     { \
         va_list list; \
         va_start(list,fmt); \
+        if( RaveGetLogBackend() == LB_Asynchronous ) { \
+            int r = RaveLogAsynchronousV(OPENRAVECOLOR ## LEVEL, fmt, list); \
+            va_end(list); \
+            return r; \
+        } \
         int r = vprintf((ChangeTextColor(0, OPENRAVECOLOR ## LEVEL,8) + std::string(fmt) + ResetTextColor()).c_str(), list); \
         va_end(list); \
         /*if( fmt[0] != '\n' ) { printf("\n"); } */ \
@@ -448,6 +489,9 @@ inline int RavePrintfA(const std::string& s, uint32_t level)
         case Level_Error: color = OPENRAVECOLOR_ERRORLEVEL; break;
         case Level_Warn: color = OPENRAVECOLOR_WARNLEVEL; break;
         case Level_Info: // print regular
+            if( RaveGetLogBackend() == LB_Asynchronous ) {
+                return RaveLogAsynchronous(-1, s);
+            }
             if((s.size() == 0)||(s[s.size()-1] != '\n')) { // automatically add a new line
                 printf ("%s\n",s.c_str());
             }
@@ -458,6 +502,9 @@ inline int RavePrintfA(const std::string& s, uint32_t level)
         case Level_Debug: color = OPENRAVECOLOR_DEBUGLEVEL; break;
         case Level_Verbose: color = OPENRAVECOLOR_VERBOSELEVEL; break;
         }
+        if( RaveGetLogBackend() == LB_Asynchronous ) {
+            return RaveLogAsynchronous(color, s);
+        }
         if((s.size() == 0)||(s[s.size()-1] != '\n')) { // automatically add a new line
             printf ("%c[0;%d;%dm%s%c[0;38;48m\n", 0x1B, color + 30,8+40,s.c_str(),0x1B);
         }
@@ -55,6 +55,7 @@
 #include <set>
 #include <string>
 #include <exception>
+#include <typeinfo>
 
 #include <iomanip>
 #include <fstream>
@@ -100,6 +101,7 @@ namespace OpenRAVE {
 #endif
 
 #include <openrave/logging.h>
+#include <openrave/profiling.h>
 
 namespace OpenRAVE {
 
@@ -230,7 +230,7 @@ void PlannerParameters::StateSaver::_Restore()
     BOOST_ASSERT(ret==0);
 }
 
-PlannerParameters::PlannerParameters() : XMLReadable("plannerparameters"), _fStepLength(0.04f), _nMaxIterations(0), _nMaxPlanningTime(0), _sPostProcessingPlanner(s_linearsmoother), _nRandomGeneratorSeed(0)
+PlannerParameters::PlannerParameters() : XMLReadable("plannerparameters"), _bDefaultFunctions(false), _fStepLength(0.04f), _nMaxIterations(0), _nMaxPlanningTime(0), _sPostProcessingPlanner(s_linearsmoother), _nRandomGeneratorSeed(0)
 {
     _diffstatefn = SubtractStates;
     _neighstatefn = AddStates;
@@ -280,31 +280,27 @@ PlannerParameters& PlannerParameters::operator=(const PlannerParameters& r)
     _getstatefn = r._getstatefn;
     _diffstatefn = r._diffstatefn;
     _neighstatefn = r._neighstatefn;
+    _bDefaultFunctions = r._bDefaultFunctions;
     _listInternalSamplers = r._listInternalSamplers;
 
-    vinitialconfig.resize(0);
-    _vInitialConfigVelocities.resize(0);
-    _vGoalConfigVelocities.resize(0);
-    vgoalconfig.resize(0);
-    _configurationspecification = ConfigurationSpecification();
-    _vConfigLowerLimit.resize(0);
-    _vConfigUpperLimit.resize(0);
-    _vConfigResolution.resize(0);
-    _vConfigVelocityLimit.resize(0);
-    _vConfigAccelerationLimit.resize(0);
-    _sPostProcessingPlanner = "";
-    _sPostProcessingParameters.resize(0);
+    if( typeid(r) == typeid(*this) && _CopyParameters(r) == typeid(*this) ) {
+        return *this;
+    }
+
+    // the types differ or a derived class does not implement _CopyParameters, so copy the common parameters directly
+    // and only pass the parameters of the derived classes and the unknown extension tags through XML
+    PlannerParameters::_CopyParameters(r);
     _sExtraParameters.resize(0);
-    _nMaxIterations = 0;
-    _nMaxPlanningTime = 0;
-    _fStepLength = 0.04f;
-    _nRandomGeneratorSeed = 0;
-    _plannerparametersdepth = 0;
+    if( typeid(r) == typeid(PlannerParameters) && r._sExtraParameters.size() == 0 ) {
+        return *this;
+    }
 
     // transfer data
     std::stringstream ss;
     ss << std::setprecision(std::numeric_limits<dReal>::digits10+1); /// have to do this or otherwise precision gets lost and planners' initial conditions can vioalte constraints
-    ss << r;
+    ss << "<" << r.GetXMLId() << ">" << endl;
+    r.serialize(ss, 2);
+    ss << "</" << r.GetXMLId() << ">" << endl;
     ss >> *this;
     return *this;
 }
@@ -314,6 +310,29 @@ void PlannerParameters::copy(boost::shared_ptr<PlannerParameters const> r)
     *this = *r;
 }
 
+const std::type_info& PlannerParameters::_CopyParameters(const PlannerParameters& r)
+{
+    vinitialconfig = r.vinitialconfig;
+    _vInitialConfigVelocities = r._vInitialConfigVelocities;
+    _vGoalConfigVelocities = r._vGoalConfigVelocities;
+    vgoalconfig = r.vgoalconfig;
+    _configurationspecification = r._configurationspecification;
+    _vConfigLowerLimit = r._vConfigLowerLimit;
+    _vConfigUpperLimit = r._vConfigUpperLimit;
+    _vConfigResolution = r._vConfigResolution;
+    _vConfigVelocityLimit = r._vConfigVelocityLimit;
+    _vConfigAccelerationLimit = r._vConfigAccelerationLimit;
+    _sPostProcessingPlanner = r._sPostProcessingPlanner;
+    _sPostProcessingParameters = r._sPostProcessingParameters;
+    _sExtraParameters = r._sExtraParameters;
+    _nMaxIterations = r._nMaxIterations;
+    _nMaxPlanningTime = r._nMaxPlanningTime;
+    _fStepLength = r._fStepLength;
+    _nRandomGeneratorSeed = r._nRandomGeneratorSeed;
+    _plannerparametersdepth = 0;
+    return typeid(PlannerParameters);
+}
+
 int PlannerParameters::SetStateValues(const std::vector<dReal>& values, int options) const
 {
     if( !!_setstatevaluesfn ) {
@@ -324,6 +343,12 @@ int PlannerParameters::SetStateValues(const std::vector<dReal>& values, int opti
 
 bool PlannerParameters::serialize(std::ostream& O, int options) const
 {
+    if( options & 2 ) {
+        if( !(options & 1) ) {
+            O << _sExtraParameters << endl;
+        }
+        return !!O;
+    }
     O << _configurationspecification << endl;
     O << "<_vinitialconfig>";
     FOREACHC(it, vinitialconfig) {
@@ -551,6 +576,7 @@ int SetDOFVelocitiesIndicesParameters(KinBodyPtr pbody, const std::vector<dReal>
 
 void PlannerParameters::SetRobotActiveJoints(RobotBasePtr robot)
 {
+    _bDefaultFunctions = false;
     // check if any of the links affected by the dofs beside the base link are static
     FOREACHC(itlink, robot->GetLinks()) {
         if( (*itlink)->IsStatic() ) {
@@ -562,14 +588,15 @@ void PlannerParameters::SetRobotActiveJoints(RobotBasePtr robot)
     }
 
     using namespace planningutils;
-    _distmetricfn = boost::bind(&SimpleDistanceMetric::Eval,boost::shared_ptr<SimpleDistanceMetric>(new SimpleDistanceMetric(robot)),_1,_2);
     if( robot->GetActiveDOF() == (int)robot->GetActiveDOFIndices().size() ) {
         // only roobt joint indices, so use a more resiliant function
+        _distmetricfn = JointDistanceMetric(robot, robot->GetActiveDOFIndices());
         _getstatefn = boost::bind(&RobotBase::GetDOFValues,robot,_1,robot->GetActiveDOFIndices());
         _setstatevaluesfn = boost::bind(SetDOFValuesIndicesParameters,robot, _1, robot->GetActiveDOFIndices(), _2);
         _diffstatefn = boost::bind(&RobotBase::SubtractDOFValues,robot,_1,_2, robot->GetActiveDOFIndices());
     }
     else {
+        _distmetricfn = boost::bind(&SimpleDistanceMetric::Eval,boost::shared_ptr<SimpleDistanceMetric>(new SimpleDistanceMetric(robot)),_1,_2);
         _getstatefn = boost::bind(&RobotBase::GetActiveDOFValues,robot,_1);
         _setstatevaluesfn = boost::bind(SetActiveDOFValuesParameters,robot, _1, _2);
         _diffstatefn = boost::bind(&RobotBase::SubtractActiveDOFValues,robot,_1,_2);
@@ -597,6 +624,7 @@ void PlannerParameters::SetRobotActiveJoints(RobotBasePtr robot)
     std::list<KinBodyPtr> listCheckCollisions; listCheckCollisions.push_back(robot);
     boost::shared_ptr<DynamicsCollisionConstraint> pcollision(new DynamicsCollisionConstraint(shared_parameters(), listCheckCollisions,0xffffffff&~CFO_CheckTimeBasedConstraints));
     _checkpathvelocityconstraintsfn = boost::bind(&DynamicsCollisionConstraint::Check,pcollision,_1, _2, _3, _4, _5, _6, _7, _8);
+    _bDefaultFunctions = true;
 
 }
 
@@ -625,19 +653,6 @@ void _CallDiffStateFns(const std::vector< std::pair<PlannerParameters::DiffState
     }
 }
 
-/// \brief returns square root of joint distance * weights
-/// \param vweights2 squared weights
-dReal _EvalJointDOFDistanceMetric(const PlannerParameters::DiffStateFn& difffn, const std::vector<dReal>&c0, const std::vector<dReal>&c1, const std::vector<dReal>& vweights2)
-{
-    std::vector<dReal> c = c0;
-    difffn(c,c1);
-    dReal dist = 0;
-    for(size_t i=0; i < c.size(); i++) {
-        dist += vweights2.at(i)*c.at(i)*c.at(i);
-    }
-    return RaveSqrt(dist);
-}
-
 dReal _CallDistMetricFns(const std::vector< std::pair<PlannerParameters::DistMetricFn, int> >& vfunctions, int nDOF, int nMaxDOFForGroup, const std::vector<dReal>& v0, const std::vector<dReal>& v1)
 {
     if( vfunctions.size() == 1 ) {
@@ -786,6 +801,7 @@ int _CallNeighStateFns(const std::vector< std::pair<PlannerParameters::NeighStat
 
 void PlannerParameters::SetConfigurationSpecification(EnvironmentBasePtr penv, const ConfigurationSpecification& spec)
 {
+    _bDefaultFunctions = false;
     using namespace planningutils;
     spec.Validate();
     std::vector< std::pair<DiffStateFn, int> > diffstatefns(spec._vgroups.size());
@@ -824,14 +840,9 @@ void PlannerParameters::SetConfigurationSpecification(EnvironmentBasePtr penv, c
             if( dofindices.size() == 0 ) {
                 OPENRAVE_ASSERT_OP((int)dofindices.size(),==,pbody->GetDOF());
             }
-            std::vector<dReal> vweights2;
-            pbody->GetDOFWeights(vweights2, dofindices);
-            FOREACH(itf,vweights2) {
-                *itf *= *itf;
-            }
             diffstatefns[isavegroup].first = boost::bind(&KinBody::SubtractDOFValues, pbody, _1, _2, dofindices);
             diffstatefns[isavegroup].second = g.dof;
-            distmetricfns[isavegroup].first = boost::bind(_EvalJointDOFDistanceMetric, diffstatefns[isavegroup].first, _1, _2, vweights2);
+            distmetricfns[isavegroup].first = JointDistanceMetric(pbody, dofindices);
             distmetricfns[isavegroup].second = g.dof;
 
             SpaceSamplerBasePtr pconfigsampler = RaveCreateSpaceSampler(penv,str(boost::format("bodyconfiguration %s")%pbody->GetName()));
@@ -882,7 +893,13 @@ void PlannerParameters::SetConfigurationSpecification(EnvironmentBasePtr penv, c
         }
     }
     _diffstatefn = boost::bind(_CallDiffStateFns,diffstatefns, spec.GetDOF(), nMaxDOFForGroup, _1, _2);
-    _distmetricfn = boost::bind(_CallDistMetricFns,distmetricfns, spec.GetDOF(), nMaxDOFForGroup, _1, _2);
+    if( distmetricfns.size() == 1 ) {
+        // keep the metric directly so that planners can recognize it
+        _distmetricfn = distmetricfns[0].first;
+    }
+    else {
+        _distmetricfn = boost::bind(_CallDistMetricFns,distmetricfns, spec.GetDOF(), nMaxDOFForGroup, _1, _2);
+    }
     _samplefn = boost::bind(_CallSampleFns,samplefns, spec.GetDOF(), nMaxDOFForGroup, _1);
     _sampleneighfn = boost::bind(_CallSampleNeighFns,sampleneighfns, distmetricfns, spec.GetDOF(), nMaxDOFForGroup, _1, _2, _3);
     _setstatevaluesfn = boost::bind(CallSetStateValuesFns,setstatevaluesfns, spec.GetDOF(), nMaxDOFForGroup, _1, _2);
@@ -898,6 +915,12 @@ void PlannerParameters::SetConfigurationSpecification(EnvironmentBasePtr penv, c
     // have to do this last, disable timed constraints for default
     boost::shared_ptr<DynamicsCollisionConstraint> pcollision(new DynamicsCollisionConstraint(shared_parameters(), listCheckCollisions,0xffffffff&~CFO_CheckTimeBasedConstraints));
     _checkpathvelocityconstraintsfn = boost::bind(&DynamicsCollisionConstraint::Check,pcollision,_1, _2, _3, _4, _5, _6, _7, _8);
+    _bDefaultFunctions = true;
+}
+
+bool PlannerParameters::HasDefaultFunctions() const
+{
+    return _bDefaultFunctions && !!_setstatevaluesfn && !!_getstatefn && !!_diffstatefn && !!_distmetricfn && !!_neighstatefn && !!_checkpathvelocityconstraintsfn;
 }
 
 void PlannerParameters::Validate() const
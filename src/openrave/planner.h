@@ -157,8 +157,10 @@ private:
 
     /** \brief Attemps to copy data from one set of parameters to another in the safest manner.
 
-        First serializes the data of the right hand into a string, then initializes the current parameters via >>
-        pointers to functions are copied directly
+        Pointers to functions are copied directly. If r has the same type as this, the parameters are copied directly
+        with \ref _CopyParameters. Otherwise the parameters common to all types are copied directly, and only the parameters
+        of the derived class of r and its unknown extension tags are serialized into a string and read by the current
+        parameters via >>
      */
     virtual PlannerParameters& operator=(const PlannerParameters& r);
     virtual void copy(boost::shared_ptr<PlannerParameters const> r);
@@ -196,6 +198,13 @@ private:
      */
     virtual void SetConfigurationSpecification(EnvironmentBasePtr env, const ConfigurationSpecification& spec);
 
+    /** \brief returns true if the state, distance, neighbor and path constraint functions are all set and are the ones set up by \ref SetRobotActiveJoints or \ref SetConfigurationSpecification.
+
+        Planners that re-create the parameters on a cloned environment with \ref SetConfigurationSpecification can only do so when this is true, otherwise user functions would be lost.
+        Returns \ref _bDefaultFunctions, so code that replaces any of these functions afterwards has to clear it.
+     */
+    bool HasDefaultFunctions() const;
+
     /// \brief veriries that the configuration space and all parameters are consistent
     ///
     /// Assumes at minimum that  _setstatevaluesfn and _getstatefn are set. Correct environment should be
@@ -206,6 +215,9 @@ private:
     /// \brief the configuration specification in which the planner works in. This specification is passed to the trajecotry creation modules.
     ConfigurationSpecification _configurationspecification;
 
+    /// \brief set by \ref SetRobotActiveJoints and \ref SetConfigurationSpecification. Has to be cleared by code that replaces the state, distance, neighbor or path constraint functions afterwards, see \ref HasDefaultFunctions.
+    bool _bDefaultFunctions;
+
     /// \brief Cost function on the state pace (optional).
     ///
     /// cost = _costfn(config)
@@ -449,10 +461,22 @@ protected:
 
     /// \brief output the planner parameters in a string (in XML format)
     ///
-    /// \param options if 1 will skip writing the extra parameters
+    /// \param options if 1 will skip writing the extra parameters, if 2 will skip writing the parameters of PlannerParameters itself.
+    /// Derived classes call their parent with 1 set and write the extra parameters once themselves.
     /// don't use PlannerParameters as a tag!
     virtual bool serialize(std::ostream& O, int options=0) const;
 
+    /** \brief copies the parameters of r into this without going through XML. Called by operator= only when r has the same type as this.
+
+        Derived classes that add their own parameters should override this by calling the parent implementation and then
+        copying their own fields from r, and return typeid of their own class. operator= only uses the result if the
+        returned type is the type of this, otherwise it copies the PlannerParameters fields with the base implementation and
+        only serializes the fields of the derived classes of r. Unknown extension tags are kept in _sExtraParameters and are
+        copied as a string.
+        \return the type whose parameters were copied
+     */
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r);
+
     //@{ XML parsing functions, parses the default parameters
     virtual ProcessElement startElement(const std::string& name, const AttributesList& atts);
     virtual bool endElement(const std::string& name);
@@ -36,7 +36,7 @@ WorkspaceTrajectoryParameters::WorkspaceTrajectoryParameters(EnvironmentBasePtr
 // save the extra data to XML
 bool WorkspaceTrajectoryParameters::serialize(std::ostream& O, int options) const
 {
-    if( !PlannerParameters::serialize(O, options&~1) ) {
+    if( !PlannerParameters::serialize(O, options|1) ) {
         return false;
     }
     O << "<maxdeviationangle>" << maxdeviationangle << "</maxdeviationangle>" << std::endl;
@@ -57,6 +57,28 @@ bool WorkspaceTrajectoryParameters::serialize(std::ostream& O, int options) cons
     return !!O;
 }
 
+const std::type_info& WorkspaceTrajectoryParameters::_CopyParameters(const PlannerParameters& r)
+{
+    PlannerParameters::_CopyParameters(r);
+    const WorkspaceTrajectoryParameters& rworkspace = static_cast<const WorkspaceTrajectoryParameters&>(r);
+    maxdeviationangle = rworkspace.maxdeviationangle;
+    maintaintiming = rworkspace.maintaintiming;
+    greedysearch = rworkspace.greedysearch;
+    ignorefirstcollision = rworkspace.ignorefirstcollision;
+    ignorefirstcollisionee = rworkspace.ignorefirstcollisionee;
+    ignorelastcollisionee = rworkspace.ignorelastcollisionee;
+    minimumcompletetime = rworkspace.minimumcompletetime;
+    if( !!rworkspace.workspacetraj ) {
+        // the trajectory is owned by the parameters, so clone it into the environment of this structure
+        workspacetraj = RaveCreateTrajectory(_penv, rworkspace.workspacetraj->GetXMLId());
+        workspacetraj->Clone(rworkspace.workspacetraj, 0);
+    }
+    else {
+        workspacetraj.reset();
+    }
+    return typeid(WorkspaceTrajectoryParameters);
+}
+
 BaseXMLReader::ProcessElement WorkspaceTrajectoryParameters::startElement(const std::string& name, const AttributesList& atts)
 {
     if( _bProcessing ) {
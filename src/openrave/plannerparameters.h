@@ -40,7 +40,7 @@ protected:
     // save the extra data to XML
     virtual bool serialize(std::ostream& O, int options=0) const
     {
-        if( !PlannerParameters::serialize(O,options&~1) ) { // skip writing extra
+        if( !PlannerParameters::serialize(O, options|1) ) { // skip writing extra
             return false;
         }
         O << "<exploreprob>" << _fExploreProb << "</exploreprob>" << std::endl;
@@ -51,6 +51,15 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        PlannerParameters::_CopyParameters(r);
+        const ExplorationParameters& rexp = static_cast<const ExplorationParameters&>(r);
+        _fExploreProb = rexp._fExploreProb;
+        _nExpectedDataSize = rexp._nExpectedDataSize;
+        return typeid(ExplorationParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bProcessingExploration ) {
@@ -112,7 +121,7 @@ protected:
     bool _bProcessingRA;
     virtual bool serialize(std::ostream& O, int options) const
     {
-        if( !PlannerParameters::serialize(O,options&~1) ) {
+        if( !PlannerParameters::serialize(O, options|1) ) {
             return false;
         }
         O << "<radius>" << fRadius << "</radius>" << std::endl;
@@ -127,6 +136,18 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        PlannerParameters::_CopyParameters(r);
+        const RAStarParameters& rra = static_cast<const RAStarParameters&>(r);
+        fRadius = rra.fRadius;
+        fDistThresh = rra.fDistThresh;
+        fGoalCoeff = rra.fGoalCoeff;
+        nMaxChildren = rra.nMaxChildren;
+        nMaxSampleTries = rra.nMaxSampleTries;
+        return typeid(RAStarParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bProcessingRA ) {
@@ -191,7 +212,7 @@ protected:
     bool _bProcessingGS;
     virtual bool serialize(std::ostream& O, int options=0) const
     {
-        if( !PlannerParameters::serialize(O,options&~1) ) {
+        if( !PlannerParameters::serialize(O, options|1) ) {
             return false;
         }
         O << "<grasps>" << _vgrasps.size() << " ";
@@ -209,6 +230,19 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        PlannerParameters::_CopyParameters(r);
+        const GraspSetParameters& rgs = static_cast<const GraspSetParameters&>(r);
+        _vgrasps = rgs._vgrasps;
+        // target has to belong to the environment of this structure
+        _ptarget = (rgs._penv == _penv || !rgs._ptarget) ? rgs._ptarget : _penv->GetBodyFromEnvironmentId(rgs._ptarget->GetEnvironmentId());
+        _nGradientSamples = rgs._nGradientSamples;
+        _fVisibiltyGraspThresh = rgs._fVisibiltyGraspThresh;
+        _fGraspDistThresh = rgs._fGraspDistThresh;
+        return typeid(GraspSetParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bProcessingGS ) {
@@ -310,7 +344,7 @@ protected:
     // save the extra data to XML
     virtual bool serialize(std::ostream& O, int options=0) const
     {
-        if( !PlannerParameters::serialize(O, options&~1) ) {
+        if( !PlannerParameters::serialize(O, options|1) ) {
             return false;
         }
         O << "<fstandoff>" << fstandoff << "</fstandoff>" << std::endl;
@@ -340,6 +374,31 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        PlannerParameters::_CopyParameters(r);
+        const GraspParameters& rgrasp = static_cast<const GraspParameters&>(r);
+        fstandoff = rgrasp.fstandoff;
+        // target has to belong to the environment of this structure
+        targetbody = (rgrasp._penv == _penv || !rgrasp.targetbody) ? rgrasp.targetbody : _penv->GetBodyFromEnvironmentId(rgrasp.targetbody->GetEnvironmentId());
+        ftargetroll = rgrasp.ftargetroll;
+        vtargetdirection = rgrasp.vtargetdirection;
+        vtargetposition = rgrasp.vtargetposition;
+        vmanipulatordirection = rgrasp.vmanipulatordirection;
+        btransformrobot = rgrasp.btransformrobot;
+        breturntrajectory = rgrasp.breturntrajectory;
+        bonlycontacttarget = rgrasp.bonlycontacttarget;
+        btightgrasp = rgrasp.btightgrasp;
+        bavoidcontact = rgrasp.bavoidcontact;
+        vavoidlinkgeometry = rgrasp.vavoidlinkgeometry;
+        fcoarsestep = rgrasp.fcoarsestep;
+        ffinestep = rgrasp.ffinestep;
+        ftranslationstepmult = rgrasp.ftranslationstepmult;
+        fgraspingnoise = rgrasp.fgraspingnoise;
+        vintersectplane = rgrasp.vintersectplane;
+        return typeid(GraspParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bProcessingGrasp ) {
@@ -463,7 +522,7 @@ protected:
     bool _bProcessing;
     virtual bool serialize(std::ostream& O, int options=0) const
     {
-        if( !PlannerParameters::serialize(O, options&~1) ) {
+        if( !PlannerParameters::serialize(O, options|1) ) {
             return false;
         }
         O << "<interpolation>" << _interpolation << "</interpolation>" << std::endl;
@@ -480,6 +539,20 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        PlannerParameters::_CopyParameters(r);
+        const TrajectoryTimingParameters& rtiming = static_cast<const TrajectoryTimingParameters&>(r);
+        _interpolation = rtiming._interpolation;
+        _pointtolerance = rtiming._pointtolerance;
+        _hastimestamps = rtiming._hastimestamps;
+        _hasvelocities = rtiming._hasvelocities;
+        _outputaccelchanges = rtiming._outputaccelchanges;
+        _multidofinterp = rtiming._multidofinterp;
+        verifyinitialpath = rtiming.verifyinitialpath;
+        return typeid(TrajectoryTimingParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bProcessing ) {
@@ -537,7 +610,7 @@ typedef boost::shared_ptr<TrajectoryTimingParameters const> TrajectoryTimingPara
 class OPENRAVE_API ConstraintTrajectoryTimingParameters : public TrajectoryTimingParameters
 {
 public:
-    ConstraintTrajectoryTimingParameters() : TrajectoryTimingParameters(), maxlinkspeed(0), maxlinkaccel(0), maxmanipspeed(0), maxmanipaccel(0), vConstraintManipDir(0,0,1), vConstraintGlobalDir(0,0,1), fCosManipAngleThresh(-1), mingripperdistance(0), velocitydistancethresh(0), maxmergeiterations(1000), minswitchtime(0.2),nshortcutcycles(1), fSearchVelAccelMult(0.8), durationImprovementCutoffRatio(0.001), _bCProcessing(false) {
+    ConstraintTrajectoryTimingParameters() : TrajectoryTimingParameters(), maxlinkspeed(0), maxlinkaccel(0), maxmanipspeed(0), maxmanipaccel(0), vConstraintManipDir(0,0,1), vConstraintGlobalDir(0,0,1), fCosManipAngleThresh(-1), mingripperdistance(0), velocitydistancethresh(0), maxmergeiterations(1000), minswitchtime(0.2),nshortcutcycles(1), nshortcutthreads(0), fSearchVelAccelMult(0.8), durationImprovementCutoffRatio(0.001), _bCProcessing(false) {
         _vXMLParameters.push_back("maxlinkspeed");
         _vXMLParameters.push_back("maxlinkaccel");
         _vXMLParameters.push_back("manipname");
@@ -551,6 +624,7 @@ public:
         _vXMLParameters.push_back("maxmergeiterations");
         _vXMLParameters.push_back("minswitchtime");
         _vXMLParameters.push_back("nshortcutcycles");
+        _vXMLParameters.push_back("nshortcutthreads");
         _vXMLParameters.push_back("searchvelaccelmult");
         _vXMLParameters.push_back("durationimprovementcutoffratio");
     }
@@ -573,6 +647,7 @@ public:
     int maxmergeiterations; ///< when merging several ramps together, the order that they are merged in depends. This parameters pecifies how many permutations to test before giving up.
     dReal minswitchtime; ///< the minimum time between switching accelerations of any joint (waypoints).
     int nshortcutcycles; ///< the minimum number of times the shortcut cycle is repeated.
+    int nshortcutthreads; ///< if > 1, shortcut candidates are sampled in batches of nshortcutthreads and checked concurrently on cloned environments. 0 or 1 means sequential shortcutting.
 
     dReal fSearchVelAccelMult; ///< a number in [0.0001,0.99999] that is the multipler of the velocity/acceleration limits when time-based constraints are invalidated (manip speed and/or dynamics). The closer to 1 it is, the more optimal the trajectory will be, but it will take more time to compute. A value around 0.5-0.8 is best.
     dReal durationImprovementCutoffRatio; ///< Whenever shortcut is accepted, if change is less than diff/iterations, then do not do anymore shortcutting.
@@ -581,7 +656,7 @@ protected:
     bool _bCProcessing;
     virtual bool serialize(std::ostream& O, int options=0) const
     {
-        if( !TrajectoryTimingParameters::serialize(O, options&~1) ) {
+        if( !TrajectoryTimingParameters::serialize(O, options|1) ) {
             return false;
         }
         O << "<maxlinkspeed>" << maxlinkspeed << "</maxlinkspeed>" << std::endl;
@@ -597,6 +672,7 @@ protected:
         O << "<maxmergeiterations>" << maxmergeiterations << "</maxmergeiterations>" << std::endl;
         O << "<minswitchtime>" << minswitchtime << "</minswitchtime>" << std::endl;
         O << "<nshortcutcycles>" << nshortcutcycles << "</nshortcutcycles>" << std::endl;
+        O << "<nshortcutthreads>" << nshortcutthreads << "</nshortcutthreads>" << std::endl;
         O << "<searchvelaccelmult>" << fSearchVelAccelMult << "</searchvelaccelmult>" << std::endl;
         O << "<durationimprovementcutoffratio>" << durationImprovementCutoffRatio << "</durationimprovementcutoffratio>" << std::endl;
         if( !(options & 1) ) {
@@ -606,6 +682,29 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        TrajectoryTimingParameters::_CopyParameters(r);
+        const ConstraintTrajectoryTimingParameters& rconstraint = static_cast<const ConstraintTrajectoryTimingParameters&>(r);
+        maxlinkspeed = rconstraint.maxlinkspeed;
+        maxlinkaccel = rconstraint.maxlinkaccel;
+        manipname = rconstraint.manipname;
+        maxmanipspeed = rconstraint.maxmanipspeed;
+        maxmanipaccel = rconstraint.maxmanipaccel;
+        vConstraintManipDir = rconstraint.vConstraintManipDir;
+        vConstraintGlobalDir = rconstraint.vConstraintGlobalDir;
+        fCosManipAngleThresh = rconstraint.fCosManipAngleThresh;
+        mingripperdistance = rconstraint.mingripperdistance;
+        velocitydistancethresh = rconstraint.velocitydistancethresh;
+        maxmergeiterations = rconstraint.maxmergeiterations;
+        minswitchtime = rconstraint.minswitchtime;
+        nshortcutcycles = rconstraint.nshortcutcycles;
+        nshortcutthreads = rconstraint.nshortcutthreads;
+        fSearchVelAccelMult = rconstraint.fSearchVelAccelMult;
+        durationImprovementCutoffRatio = rconstraint.durationImprovementCutoffRatio;
+        return typeid(ConstraintTrajectoryTimingParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bCProcessing ) {
@@ -616,7 +715,7 @@ protected:
         case PE_Support: return PE_Support;
         case PE_Ignore: return PE_Ignore;
         }
-        _bCProcessing = name=="maxlinkspeed" || name =="maxlinkaccel" || name=="manipname" || name=="maxmanipspeed" || name =="maxmanipaccel" || name=="mingripperdistance" || name=="velocitydistancethresh" || name=="maxmergeiterations" || name=="minswitchtime"|| name=="nshortcutcycles" || name=="constraintmanipdir" || name=="constraintglobaldir" || name=="cosmanipanglethresh" || name=="searchvelaccelmult" || name=="durationimprovementcutoffratio";
+        _bCProcessing = name=="maxlinkspeed" || name =="maxlinkaccel" || name=="manipname" || name=="maxmanipspeed" || name =="maxmanipaccel" || name=="mingripperdistance" || name=="velocitydistancethresh" || name=="maxmergeiterations" || name=="minswitchtime"|| name=="nshortcutcycles" || name=="nshortcutthreads" || name=="constraintmanipdir" || name=="constraintglobaldir" || name=="cosmanipanglethresh" || name=="searchvelaccelmult" || name=="durationimprovementcutoffratio";
         return _bCProcessing ? PE_Support : PE_Pass;
     }
 
@@ -653,6 +752,9 @@ protected:
             else if( name == "nshortcutcycles") {
                 _ss >> nshortcutcycles;
             }
+            else if( name == "nshortcutthreads") {
+                _ss >> nshortcutthreads;
+            }
             else if( name == "searchvelaccelmult") {
                 _ss >> fSearchVelAccelMult;
             }
@@ -709,6 +811,7 @@ protected:
     virtual ProcessElement startElement(const std::string& name, const AttributesList& atts);
     virtual bool endElement(const std::string& name);
     virtual void characters(const std::string& ch);
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r);
 };
 
 typedef boost::shared_ptr<WorkspaceTrajectoryParameters> WorkspaceTrajectoryParametersPtr;
@@ -727,7 +830,7 @@ protected:
     bool _bProcessing;
     virtual bool serialize(std::ostream& O, int options=0) const
     {
-        if( !PlannerParameters::serialize(O, options&~1) ) {
+        if( !PlannerParameters::serialize(O, options|1) ) {
             return false;
         }
         O << "<minimumgoalpaths>" << _minimumgoalpaths << "</minimumgoalpaths>" << std::endl;
@@ -737,6 +840,13 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        PlannerParameters::_CopyParameters(r);
+        _minimumgoalpaths = static_cast<const RRTParameters&>(r)._minimumgoalpaths;
+        return typeid(RRTParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bProcessing ) {
@@ -789,7 +899,7 @@ protected:
     bool _bProcessingBasic;
     virtual bool serialize(std::ostream& O, int options=0) const
     {
-        if( !PlannerParameters::serialize(O, options&~1) ) {
+        if( !PlannerParameters::serialize(O, options|1) ) {
             return false;
         }
         O << "<goalbias>" << _fGoalBiasProb << "</goalbias>" << std::endl;
@@ -802,6 +912,16 @@ protected:
         return !!O;
     }
 
+    virtual const std::type_info& _CopyParameters(const PlannerParameters& r)
+    {
+        RRTParameters::_CopyParameters(r);
+        const BasicRRTParameters& rbasic = static_cast<const BasicRRTParameters&>(r);
+        _fGoalBiasProb = rbasic._fGoalBiasProb;
+        _nRRTExtentType = rbasic._nRRTExtentType;
+        _nMinIterations = rbasic._nMinIterations;
+        return typeid(BasicRRTParameters);
+    }
+
     ProcessElement startElement(const std::string& name, const AttributesList& atts)
     {
         if( _bProcessingBasic ) {
@@ -393,7 +393,7 @@ int JitterCurrentConfiguration(PlannerBase::PlannerParametersConstPtr parameters
 class TrajectoryVerifier
 {
 public:
-    TrajectoryVerifier(PlannerBase::PlannerParametersConstPtr parameters) : _parameters(parameters) {
+    TrajectoryVerifier(PlannerBase::PlannerParametersConstPtr parameters) : _parameters(parameters), _nEarliestFailedWindow(0) {
         VerifyParameters();
     }
 
@@ -404,7 +404,8 @@ public:
         OPENRAVE_ASSERT_OP_FORMAT0((int)_parameters->_vConfigResolution.size(), ==, _parameters->GetDOF(), "unexpected size",ORE_InvalidState);
     }
 
-    void VerifyTrajectory(TrajectoryBaseConstPtr trajectory, dReal samplingstep)
+    /// \param numthreads if > 1, checks the sampled segments in parallel on that many cloned environments
+    void VerifyTrajectory(TrajectoryBaseConstPtr trajectory, dReal samplingstep, int numthreads=1)
     {
         OPENRAVE_ASSERT_FORMAT0(!!trajectory,"need valid trajectory",ORE_InvalidArguments);
 
@@ -417,7 +418,6 @@ public:
         fresolutionmean /= _parameters->_vConfigResolution.size();
 
         dReal fthresh = 5e-5f;
-        vector<dReal> deltaq(_parameters->GetDOF(),0);
         std::vector<dReal> vdata, vdatavel, vdiff;
         for(size_t ipoint = 0; ipoint < trajectory->GetNumWaypoints(); ++ipoint) {
             trajectory->GetWaypoint(ipoint,vdata,_parameters->_configurationspecification);
@@ -491,59 +491,20 @@ public:
                 }
                 IntervalType interval = bHasAllLinearInterpolation ? (IntervalType)(IT_Closed | IT_AllLinear) : IT_Closed;
 
-                std::vector<dReal> vprevdata, vprevdatavel;
-                ConstraintFilterReturnPtr filterreturn(new ConstraintFilterReturn());
-                trajectory->Sample(vprevdata,0,_parameters->_configurationspecification);
-                trajectory->Sample(vprevdatavel,0,velspec);
-                std::vector<dReal>::iterator itprevtime = vsampletimes.begin();
+                // drop the samples that are too close to the previous one
+                std::vector<dReal> vchecktimes;
+                vchecktimes.reserve(vsampletimes.size());
+                vchecktimes.push_back(vsampletimes.at(0));
                 for(std::vector<dReal>::iterator itsampletime = vsampletimes.begin()+1; itsampletime != vsampletimes.end(); ++itsampletime) {
-                    if (*itsampletime < *itprevtime + 1e-5 ) {
-                        continue;
+                    if (*itsampletime >= vchecktimes.back() + 1e-5 ) {
+                        vchecktimes.push_back(*itsampletime);
                     }
-                    filterreturn->Clear();
-                    trajectory->Sample(vdata,*itsampletime,_parameters->_configurationspecification);
-                    trajectory->Sample(vdatavel,*itsampletime,velspec);
-                    dReal deltatime = *itsampletime - *itprevtime;
-                    vdiff = vdata;
-                    _parameters->_diffstatefn(vdiff,vprevdata);
-                    for(size_t i = 0; i < _parameters->_vConfigVelocityLimit.size(); ++i) {
-                        dReal velthresh = _parameters->_vConfigVelocityLimit.at(i)*deltatime+fthresh;
-                        OPENRAVE_ASSERT_OP_FORMAT(RaveFabs(vdiff.at(i)), <=, velthresh, "time %fs-%fs, dof %d traveled %f, but maxvelocity only allows %f, wrote trajectory to %s",*itprevtime%*itsampletime%i%RaveFabs(vdiff.at(i))%velthresh%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
-                    }
-                    if( _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, filterreturn) != 0 ) {
-                        if( IS_DEBUGLEVEL(Level_Verbose) ) {
-                            _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, filterreturn);
-                        }
-                        throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, CheckPathAllConstraints failed, wrote trajectory to %s"),*itprevtime%*itsampletime%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
-                    }
-                    OPENRAVE_ASSERT_OP(filterreturn->_configurations.size()%_parameters->GetDOF(),==,0);
-                    std::vector<dReal>::iterator itprevconfig = filterreturn->_configurations.begin();
-                    std::vector<dReal>::iterator itcurconfig = itprevconfig + _parameters->GetDOF();
-                    for(; itcurconfig != filterreturn->_configurations.end(); itcurconfig += _parameters->GetDOF()) {
-                        std::vector<dReal> vprevconfig(itprevconfig,itprevconfig+_parameters->GetDOF());
-                        std::vector<dReal> vcurconfig(itcurconfig,itcurconfig+_parameters->GetDOF());
-                        for(int i = 0; i < _parameters->GetDOF(); ++i) {
-                            deltaq.at(i) = vcurconfig.at(i) - vprevconfig.at(i);
-                        }
-                        if( _parameters->SetStateValues(vprevconfig, 0) != 0 ) {
-                            throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, failed to set state values"), *itprevtime%*itsampletime, ORE_InconsistentConstraints);
-                        }
-                        vector<dReal> vtemp = vprevconfig;
-                        if( _parameters->_neighstatefn(vtemp,deltaq,NSO_OnlyHardConstraints) == NSS_Failed ) {
-                            throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, neighstatefn is rejecting configurations from CheckPathAllConstraints, wrote trajectory to %s"),*itprevtime%*itsampletime%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
-                        }
-                        else {
-                            dReal fprevdist = _parameters->_distmetricfn(vprevconfig,vtemp);
-                            dReal fcurdist = _parameters->_distmetricfn(vcurconfig,vtemp);
-                            if( fprevdist > g_fEpsilonLinear ) {
-                                OPENRAVE_ASSERT_OP_FORMAT(fprevdist, >, fcurdist, "time %fs-%fs, neightstatefn returned a configuration closer to the previous configuration %f than the expected current %f, wrote trajectory to %s",*itprevtime%*itsampletime%fprevdist%fcurdist%DumpTrajectory(trajectory), ORE_InconsistentConstraints);
-                            }
-                        }
-                        itprevconfig=itcurconfig;
-                    }
-                    vprevdata.swap(vdata);
-                    vprevdatavel.swap(vdatavel);
-                    itprevtime = itsampletime;
+                }
+                if( numthreads > 1 && vchecktimes.size() > 2 ) {
+                    _VerifySegmentsParallel(trajectory, vchecktimes, interval, numthreads);
+                }
+                else {
+                    VerifySegments(trajectory, vchecktimes, 0, vchecktimes.size()-1, interval);
                 }
             }
             else {
@@ -557,6 +518,164 @@ public:
         }
     }
 
+    /// \brief checks the segments between consecutive times of vchecktimes from vchecktimes[istart] to vchecktimes[iend]
+    ///
+    /// \param stopfn if set, called before every segment. Returns true if the remaining segments do not need to be checked anymore.
+    void VerifySegments(TrajectoryBaseConstPtr trajectory, const std::vector<dReal>& vchecktimes, size_t istart, size_t iend, IntervalType interval, const boost::function<bool()>& stopfn=boost::function<bool()>())
+    {
+        ConfigurationSpecification velspec =  _parameters->_configurationspecification.ConvertToVelocitySpecification();
+        dReal fthresh = 5e-5f;
+        vector<dReal> deltaq(_parameters->GetDOF(),0);
+        std::vector<dReal> vdata, vdatavel, vdiff, vprevdata, vprevdatavel;
+        ConstraintFilterReturnPtr filterreturn(new ConstraintFilterReturn());
+        trajectory->Sample(vprevdata,vchecktimes.at(istart),_parameters->_configurationspecification);
+        trajectory->Sample(vprevdatavel,vchecktimes.at(istart),velspec);
+        for(size_t itime = istart+1; itime <= iend; ++itime) {
+            if( !!stopfn && stopfn() ) {
+                return;
+            }
+            dReal prevtime = vchecktimes[itime-1], sampletime = vchecktimes[itime];
+            filterreturn->Clear();
+            trajectory->Sample(vdata,sampletime,_parameters->_configurationspecification);
+            trajectory->Sample(vdatavel,sampletime,velspec);
+            dReal deltatime = sampletime - prevtime;
+            vdiff = vdata;
+            _parameters->_diffstatefn(vdiff,vprevdata);
+            for(size_t i = 0; i < _parameters->_vConfigVelocityLimit.size(); ++i) {
+                dReal velthresh = _parameters->_vConfigVelocityLimit.at(i)*deltatime+fthresh;
+                OPENRAVE_ASSERT_OP_FORMAT(RaveFabs(vdiff.at(i)), <=, velthresh, "time %fs-%fs, dof %d traveled %f, but maxvelocity only allows %f, wrote trajectory to %s",prevtime%sampletime%i%RaveFabs(vdiff.at(i))%velthresh%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
+            }
+            if( _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, filterreturn) != 0 ) {
+                if( IS_DEBUGLEVEL(Level_Verbose) ) {
+                    _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, filterreturn);
+                }
+                throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, CheckPathAllConstraints failed, wrote trajectory to %s"),prevtime%sampletime%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
+            }
+            OPENRAVE_ASSERT_OP(filterreturn->_configurations.size()%_parameters->GetDOF(),==,0);
+            std::vector<dReal>::iterator itprevconfig = filterreturn->_configurations.begin();
+            std::vector<dReal>::iterator itcurconfig = itprevconfig + _parameters->GetDOF();
+            for(; itcurconfig != filterreturn->_configurations.end(); itcurconfig += _parameters->GetDOF()) {
+                std::vector<dReal> vprevconfig(itprevconfig,itprevconfig+_parameters->GetDOF());
+                std::vector<dReal> vcurconfig(itcurconfig,itcurconfig+_parameters->GetDOF());
+                for(int i = 0; i < _parameters->GetDOF(); ++i) {
+                    deltaq.at(i) = vcurconfig.at(i) - vprevconfig.at(i);
+                }
+                if( _parameters->SetStateValues(vprevconfig, 0) != 0 ) {
+                    throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, failed to set state values"), prevtime%sampletime, ORE_InconsistentConstraints);
+                }
+                vector<dReal> vtemp = vprevconfig;
+                if( _parameters->_neighstatefn(vtemp,deltaq,NSO_OnlyHardConstraints) == NSS_Failed ) {
+                    throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, neighstatefn is rejecting configurations from CheckPathAllConstraints, wrote trajectory to %s"),prevtime%sampletime%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
+                }
+                else {
+                    dReal fprevdist = _parameters->_distmetricfn(vprevconfig,vtemp);
+                    dReal fcurdist = _parameters->_distmetricfn(vcurconfig,vtemp);
+                    if( fprevdist > g_fEpsilonLinear ) {
+                        OPENRAVE_ASSERT_OP_FORMAT(fprevdist, >, fcurdist, "time %fs-%fs, neightstatefn returned a configuration closer to the previous configuration %f than the expected current %f, wrote trajectory to %s",prevtime%sampletime%fprevdist%fcurdist%DumpTrajectory(trajectory), ORE_InconsistentConstraints);
+                    }
+                }
+                itprevconfig=itcurconfig;
+            }
+            vprevdata.swap(vdata);
+            vprevdatavel.swap(vdatavel);
+        }
+    }
+
+    /// \brief splits the segments of vchecktimes into windows and checks them on numthreads cloned environments.
+    ///
+    /// Each clone gets its own copy of the trajectory and parameters re-created with SetConfigurationSpecification, so
+    /// _parameters should only hold the default functions (PlannerParameters::HasDefaultFunctions).
+    /// If several windows fail, the failure with the earliest time is thrown.
+    void _VerifySegmentsParallel(TrajectoryBaseConstPtr trajectory, const std::vector<dReal>& vchecktimes, IntervalType interval, int numthreads)
+    {
+        size_t numsegments = vchecktimes.size()-1;
+        size_t numwindows = std::min(numsegments, (size_t)(4*numthreads));
+        std::vector<boost::shared_ptr<TrajectoryVerifier> > vverifiers;
+        std::vector<TrajectoryBasePtr> vtrajectories;
+        std::vector<EnvironmentBasePtr> vcloneenvs;
+        try {
+            for(int ithread = 0; ithread < numthreads; ++ithread) {
+                EnvironmentBasePtr pcloneenv = trajectory->GetEnv()->CloneSelf(Clone_Bodies);
+                vcloneenvs.push_back(pcloneenv);
+                EnvironmentMutex::scoped_lock lockclone(pcloneenv->GetMutex());
+                PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+                params->SetConfigurationSpecification(pcloneenv, _parameters->_configurationspecification);
+                // SetConfigurationSpecification resets the limits to those of the bodies, so restore the requested ones
+                params->_vConfigLowerLimit = _parameters->_vConfigLowerLimit;
+                params->_vConfigUpperLimit = _parameters->_vConfigUpperLimit;
+                params->_vConfigVelocityLimit = _parameters->_vConfigVelocityLimit;
+                params->_vConfigAccelerationLimit = _parameters->_vConfigAccelerationLimit;
+                params->_vConfigResolution = _parameters->_vConfigResolution;
+                vverifiers.push_back(boost::shared_ptr<TrajectoryVerifier>(new TrajectoryVerifier(params)));
+                TrajectoryBasePtr pclonetraj = RaveCreateTrajectory(pcloneenv, trajectory->GetXMLId());
+                pclonetraj->Clone(trajectory, 0);
+                vtrajectories.push_back(pclonetraj);
+            }
+
+            _vWindowErrors.resize(0);
+            _vWindowErrors.resize(numwindows);
+            _nEarliestFailedWindow = numwindows;
+            std::vector< boost::function<void()> > vtasks(numthreads);
+            for(int ithread = 0; ithread < numthreads; ++ithread) {
+                vtasks[ithread] = boost::bind(&TrajectoryVerifier::_VerifyWindowsThreadCB, this, vverifiers[ithread], vtrajectories[ithread], boost::ref(vchecktimes), interval, ithread, numthreads, numwindows);
+            }
+            utils::ThreadPool pool(numthreads);
+            pool.RunTasks(vtasks);
+        }
+        catch(...) {
+            vverifiers.clear();
+            vtrajectories.clear();
+            FOREACH(itenv, vcloneenvs) {
+                (*itenv)->Destroy();
+            }
+            throw;
+        }
+        vverifiers.clear();
+        vtrajectories.clear();
+        FOREACH(itenv, vcloneenvs) {
+            (*itenv)->Destroy();
+        }
+        if( _nEarliestFailedWindow < numwindows ) {
+            const std::pair<std::string, OpenRAVEErrorCode>& error = _vWindowErrors.at(_nEarliestFailedWindow);
+            throw openrave_exception(error.first, error.second);
+        }
+    }
+
+    /// \brief worker of _VerifySegmentsParallel, checks windows ithread, ithread+numthreads, ... with its own verifier
+    void _VerifyWindowsThreadCB(boost::shared_ptr<TrajectoryVerifier> pverifier, TrajectoryBasePtr ptrajectory, const std::vector<dReal>& vchecktimes, IntervalType interval, int ithread, int numthreads, size_t numwindows)
+    {
+        size_t numsegments = vchecktimes.size()-1;
+        EnvironmentMutex::scoped_lock lockclone(ptrajectory->GetEnv()->GetMutex());
+        for(size_t iwindow = ithread; iwindow < numwindows; iwindow += numthreads) {
+            if( _HasEarlierFailedWindow(iwindow) ) {
+                return;
+            }
+            size_t istart = iwindow*numsegments/numwindows, iend = (iwindow+1)*numsegments/numwindows;
+            try {
+                pverifier->VerifySegments(ptrajectory, vchecktimes, istart, iend, interval, boost::bind(&TrajectoryVerifier::_HasEarlierFailedWindow, this, iwindow));
+            }
+            catch(const openrave_exception& ex) {
+                boost::mutex::scoped_lock lock(_mutexWindowErrors);
+                _vWindowErrors.at(iwindow) = std::make_pair(std::string(ex.what()), ex.GetCode());
+                _nEarliestFailedWindow = std::min(_nEarliestFailedWindow, iwindow);
+                return;
+            }
+            catch(const std::exception& ex) {
+                boost::mutex::scoped_lock lock(_mutexWindowErrors);
+                _vWindowErrors.at(iwindow) = std::make_pair(std::string(ex.what()), ORE_InconsistentConstraints);
+                _nEarliestFailedWindow = std::min(_nEarliestFailedWindow, iwindow);
+                return;
+            }
+        }
+    }
+
+    /// \brief true if a window before iwindow already failed, in which case iwindow cannot be the reported failure anymore
+    bool _HasEarlierFailedWindow(size_t iwindow)
+    {
+        boost::mutex::scoped_lock lock(_mutexWindowErrors);
+        return iwindow > _nEarliestFailedWindow;
+    }
+
     string DumpTrajectory(TrajectoryBaseConstPtr trajectory)
     {
         string filename = str(boost::format("%s/failedtrajectory%d.xml")%RaveGetHomeDirectory()%(RaveRandomInt()%1000));
@@ -568,6 +687,10 @@ public:
 
 protected:
     PlannerBase::PlannerParametersConstPtr _parameters;
+
+    boost::mutex _mutexWindowErrors; ///< protects _vWindowErrors and _nEarliestFailedWindow
+    std::vector< std::pair<std::string, OpenRAVEErrorCode> > _vWindowErrors; ///< the failure of each window of _VerifySegmentsParallel
+    size_t _nEarliestFailedWindow;
 };
 
 void VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep)
@@ -582,6 +705,26 @@ void VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, Traject
     v.VerifyTrajectory(trajectory,samplingstep);
 }
 
+void VerifyTrajectoryParallel(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep, int numthreads)
+{
+    EnvironmentMutex::scoped_lock lockenv(trajectory->GetEnv()->GetMutex());
+    if( !parameters ) {
+        PlannerBase::PlannerParametersPtr newparams(new PlannerBase::PlannerParameters());
+        newparams->SetConfigurationSpecification(trajectory->GetEnv(), trajectory->GetConfigurationSpecification().GetTimeDerivativeSpecification(0));
+        parameters = newparams;
+    }
+    if( numthreads <= 0 ) {
+        numthreads = std::max(1, (int)boost::thread::hardware_concurrency());
+    }
+    if( numthreads > 1 && !parameters->HasDefaultFunctions() ) {
+        // the clones cannot reproduce custom constraint functions, so check everything on the calling thread
+        RAVELOG_DEBUG("parameters hold custom functions, so verifying the trajectory serially\n");
+        numthreads = 1;
+    }
+    TrajectoryVerifier v(parameters);
+    v.VerifyTrajectory(trajectory,samplingstep,numthreads);
+}
+
 PlannerStatus _PlanActiveDOFTrajectory(TrajectoryBasePtr traj, RobotBasePtr probot, bool hastimestamps, dReal fmaxvelmult, dReal fmaxaccelmult, const std::string& plannername, bool bsmooth, const std::string& plannerparameters)
 {
     if( traj->GetNumWaypoints() == 1 ) {
@@ -3340,6 +3483,32 @@ dReal SimpleDistanceMetric::Eval(const std::vector<dReal>& c0, const std::vector
     return RaveSqrt(dist);
 }
 
+JointDistanceMetric::JointDistanceMetric(KinBodyConstPtr pbody, const std::vector<int>& dofindices) : _pbody(pbody), _vdofindices(dofindices), _bHasCircularDOFs(false)
+{
+    pbody->GetDOFWeights(_vweights2, dofindices);
+    FOREACH(itf,_vweights2) {
+        *itf *= *itf;
+    }
+    for(int i = 0; i < (int)_vweights2.size(); ++i) {
+        int dofindex = dofindices.size() > 0 ? dofindices[i] : i;
+        KinBody::JointPtr pjoint = pbody->GetJointFromDOFIndex(dofindex);
+        if( pjoint->IsCircular(dofindex-pjoint->GetDOFIndex()) ) {
+            _bHasCircularDOFs = true;
+        }
+    }
+}
+
+dReal JointDistanceMetric::operator()(const std::vector<dReal>& c0, const std::vector<dReal>& c1) const
+{
+    std::vector<dReal> c = c0;
+    _pbody->SubtractDOFValues(c,c1,_vdofindices);
+    dReal dist = 0;
+    for(size_t i=0; i < c.size(); i++) {
+        dist += _vweights2.at(i)*c.at(i)*c.at(i);
+    }
+    return RaveSqrt(dist);
+}
+
 SimpleNeighborhoodSampler::SimpleNeighborhoodSampler(SpaceSamplerBasePtr psampler, const PlannerBase::PlannerParameters::DistMetricFn& distmetricfn, const PlannerBase::PlannerParameters::DiffStateFn& diffstatefn) : _psampler(psampler), _distmetricfn(distmetricfn), _diffstatefn(diffstatefn)
 {
 }
@@ -57,6 +57,18 @@ OPENRAVE_API int JitterCurrentConfiguration(PlannerBase::PlannerParametersConstP
  */
 OPENRAVE_API void VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep=0.002);
 
+/** \brief validates a trajectory like \ref VerifyTrajectory, but checks the sampled segments of time windows in parallel. <b>[multi-thread safe]</b>
+
+    The waypoints are checked sequentially. The sampled segments are split into time windows that are checked on numthreads
+    clones of the environment, each with its own copy of the trajectory. The parameters in the clones are re-created with
+    PlannerParameters::SetConfigurationSpecification and the limits of parameters. Because custom constraint functions cannot
+    be re-created in the clones, the trajectory is checked serially like \ref VerifyTrajectory when
+    PlannerParameters::HasDefaultFunctions is false. A window stops checking as soon as an earlier window has failed.
+    \param numthreads number of threads and cloned environments. If <= 0, uses the number of hardware threads.
+    \throw openrave_exception If the trajectory is invalid, will throw the failure with the earliest time.
+ */
+OPENRAVE_API void VerifyTrajectoryParallel(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep=0.002, int numthreads=0);
+
 /** \brief Extends the last ramp of the trajectory in order to reach a goal. THe configuration space matches the positional data of the trajectory.
 
     Useful when appending jittered points to the trajectory.
@@ -548,6 +560,35 @@ protected:
     std::vector<dReal> weights2;
 };
 
+/// \brief weighted euclidean distance between joint values of a body
+///
+/// Returns sqrt(sum_i weights2[i]*d[i]^2) where d is computed with KinBody::SubtractDOFValues for dofindices and weights2
+/// are the squared DOF weights. This is the distance metric set by PlannerParameters::SetRobotActiveJoints and
+/// PlannerParameters::SetConfigurationSpecification for joint values. Planners can detect it with
+/// PlannerParameters::_distmetricfn.target<JointDistanceMetric>() and evaluate it directly on raw arrays.
+class OPENRAVE_API JointDistanceMetric
+{
+public:
+    JointDistanceMetric(KinBodyConstPtr pbody, const std::vector<int>& dofindices);
+    dReal operator()(const std::vector<dReal>& c0, const std::vector<dReal>& c1) const;
+
+    /// \brief the squared weights of every DOF
+    inline const std::vector<dReal>& GetWeights2() const {
+        return _vweights2;
+    }
+
+    /// \brief true if any of the DOFs is circular, in which case the difference is not a plain subtraction
+    inline bool HasCircularDOFs() const {
+        return _bHasCircularDOFs;
+    }
+
+protected:
+    KinBodyConstPtr _pbody;
+    std::vector<int> _vdofindices;
+    std::vector<dReal> _vweights2;
+    bool _bHasCircularDOFs;
+};
+
 /// \brief samples the neighborhood of a configuration using the configuration space distance metric and sampler.
 class OPENRAVE_API SimpleNeighborhoodSampler
 {
@@ -1069,6 +1069,7 @@ protected:
         dlclose(lib);
         //signal(SIGSEGV,tprev);
 #endif
+        InvalidateProfileNameCaches();
     }
 
     void _QueueLibraryDestruction(void* lib)
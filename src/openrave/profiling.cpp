@@ -0,0 +1,511 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2016 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "libopenrave.h"
+
+#include <boost/thread/tss.hpp>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace OpenRAVE {
+
+std::atomic<bool> g_bProfilingEnabled(false);
+
+/// incremented when a plugin library is closed, the threads then drop the addresses of the event names they cached
+static std::atomic<uint32_t> s_nProfileNameGeneration(0);
+
+void InvalidateProfileNameCaches()
+{
+    s_nProfileNameGeneration.fetch_add(1, std::memory_order_release);
+}
+
+/// \brief aggregated durations in nanoseconds or counter values of one event name
+///
+/// Only written by one thread, so the fields are atomic only so that the exporting threads can read them at any time.
+class ProfileStatistics
+{
+public:
+    ProfileStatistics() : _bCounter(false), _count(0), _sum(0), _minvalue(std::numeric_limits<int64_t>::max()), _maxvalue(std::numeric_limits<int64_t>::min()) {
+        for(size_t ibucket = 0; ibucket < s_nNumBuckets; ++ibucket) {
+            _vbuckets[ibucket].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ProfileStatistics(const ProfileStatistics& r) : _bCounter(false), _count(0), _sum(0), _minvalue(std::numeric_limits<int64_t>::max()), _maxvalue(std::numeric_limits<int64_t>::min()) {
+        for(size_t ibucket = 0; ibucket < s_nNumBuckets; ++ibucket) {
+            _vbuckets[ibucket].store(0, std::memory_order_relaxed);
+        }
+        Merge(r);
+    }
+
+    /// \brief resets the statistics, called only by the owning thread
+    void Reset(bool bCounter)
+    {
+        _bCounter.store(bCounter, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _minvalue.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+        _maxvalue.store(std::numeric_limits<int64_t>::min(), std::memory_order_relaxed);
+        for(size_t ibucket = 0; ibucket < s_nNumBuckets; ++ibucket) {
+            _vbuckets[ibucket].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /// \brief adds a value, called only by the owning thread
+    inline void Add(int64_t value)
+    {
+        _count.store(_count.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+        _sum.store(_sum.load(std::memory_order_relaxed)+value, std::memory_order_relaxed);
+        if( value < _minvalue.load(std::memory_order_relaxed) ) {
+            _minvalue.store(value, std::memory_order_relaxed);
+        }
+        if( value > _maxvalue.load(std::memory_order_relaxed) ) {
+            _maxvalue.store(value, std::memory_order_relaxed);
+        }
+        if( !_bCounter.load(std::memory_order_relaxed) ) {
+            std::atomic<uint64_t>& bucket = _vbuckets[_GetBucketIndex(value)];
+            bucket.store(bucket.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+        }
+    }
+
+    void Merge(const ProfileStatistics& r)
+    {
+        _bCounter.store(r._bCounter.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _count.store(_count.load(std::memory_order_relaxed) + r._count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _sum.store(_sum.load(std::memory_order_relaxed) + r._sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _minvalue.store(std::min(_minvalue.load(std::memory_order_relaxed), r._minvalue.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+        _maxvalue.store(std::max(_maxvalue.load(std::memory_order_relaxed), r._maxvalue.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+        for(size_t ibucket = 0; ibucket < s_nNumBuckets; ++ibucket) {
+            _vbuckets[ibucket].store(_vbuckets[ibucket].load(std::memory_order_relaxed) + r._vbuckets[ibucket].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    void WriteJSON(std::ostream& O) const
+    {
+        uint64_t count = _count.load(std::memory_order_relaxed);
+        int64_t sum = _sum.load(std::memory_order_relaxed), minvalue = _minvalue.load(std::memory_order_relaxed), maxvalue = _maxvalue.load(std::memory_order_relaxed);
+        if( _bCounter.load(std::memory_order_relaxed) ) {
+            O << "{\"count\": " << count << ", \"sum\": " << sum << ", \"min\": " << minvalue << ", \"max\": " << maxvalue << "}";
+            return;
+        }
+        O << "{\"count\": " << count << ", \"total\": " << sum*1e-9 << ", \"min\": " << minvalue*1e-9 << ", \"max\": " << maxvalue*1e-9 << ", \"mean\": " << (count > 0 ? sum*1e-9/count : 0) << ", \"buckets\": [";
+        bool bFirst = true;
+        for(size_t ibucket = 0; ibucket < s_nNumBuckets; ++ibucket) {
+            uint64_t bucketcount = _vbuckets[ibucket].load(std::memory_order_relaxed);
+            if( bucketcount > 0 ) {
+                if( !bFirst ) {
+                    O << ", ";
+                }
+                bFirst = false;
+                O << "[" << std::ldexp(1.0, ibucket)*1e-9 << ", " << bucketcount << "]";
+            }
+        }
+        O << "]}";
+    }
+
+private:
+    ProfileStatistics& operator=(const ProfileStatistics&);
+
+    /// \brief bucket i holds the durations in [2^(i-1), 2^i) nanoseconds
+    static inline size_t _GetBucketIndex(int64_t value)
+    {
+        size_t index = 0;
+        uint64_t uvalue = value > 0 ? (uint64_t)value : 0;
+        while( uvalue > 0 && index+1 < s_nNumBuckets ) {
+            uvalue >>= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    static const size_t s_nNumBuckets = 48;
+
+    std::atomic<bool> _bCounter;
+    std::atomic<uint64_t> _count;
+    std::atomic<int64_t> _sum, _minvalue, _maxvalue;
+    boost::array<std::atomic<uint64_t>, s_nNumBuckets> _vbuckets;
+};
+
+/// \brief events and statistics recorded by one thread
+///
+/// Only the owning thread writes to it and it does not lock. The events and statistics are appended and published with
+/// atomic counts, so the exporting threads read them while the owning thread keeps recording. Clearing only bumps the
+/// generation of the profiler, the owning thread resets its buffer before recording its next event and until then the
+/// buffer is treated as empty.
+class ProfileThreadBuffer
+{
+public:
+    struct Event
+    {
+        const char* name; ///< interned by the profiler
+        uint64_t time; ///< start time of a duration, or the time of a counter value
+        int64_t value; ///< duration in nanoseconds or counter value
+        bool bCounter;
+    };
+
+    ProfileThreadBuffer(int threadid, uint32_t generation) : _bThreadExited(false), _threadid(threadid), _generation(generation), _numevents(0), _numstatistics(0), _numdropped(0), _namegeneration(s_nProfileNameGeneration.load(std::memory_order_acquire)) {
+        _vchunks.assign(NULL);
+        _vstatisticsnames.assign(NULL);
+    }
+
+    ~ProfileThreadBuffer() {
+        FOREACH(itchunk, _vchunks) {
+            delete[] *itchunk;
+        }
+    }
+
+    /// \brief called only by the owning thread, name is already interned
+    inline void Add(const char* name, uint64_t time, int64_t value, bool bCounter)
+    {
+        size_t numevents = _numevents.load(std::memory_order_relaxed);
+        if( numevents < s_nMaxEvents ) {
+            Event*& pchunk = _vchunks[numevents/s_nChunkSize];
+            if( !pchunk ) {
+                pchunk = new Event[s_nChunkSize];
+            }
+            Event& event = pchunk[numevents%s_nChunkSize];
+            event.name = name;
+            event.time = time;
+            event.value = value;
+            event.bCounter = bCounter;
+            _numevents.store(numevents+1, std::memory_order_release);
+        }
+        else {
+            _numdropped.store(_numdropped.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+        }
+        std::map<const char*, size_t>::iterator itstatistics = _mapstatisticsindices.find(name);
+        size_t index;
+        if( itstatistics != _mapstatisticsindices.end() ) {
+            index = itstatistics->second;
+        }
+        else {
+            index = _numstatistics.load(std::memory_order_relaxed);
+            if( index >= s_nMaxNames ) {
+                return;
+            }
+            _vstatistics[index].Reset(bCounter);
+            _vstatisticsnames[index] = name;
+            _mapstatisticsindices[name] = index;
+            _numstatistics.store(index+1, std::memory_order_release);
+        }
+        _vstatistics[index].Add(value);
+    }
+
+    /// \brief resets the buffer if the profiler was cleared since it was last used, called only by the owning thread
+    inline void Update(uint32_t generation)
+    {
+        if( generation != _generation.load(std::memory_order_relaxed) ) {
+            _numevents.store(0, std::memory_order_relaxed);
+            _numstatistics.store(0, std::memory_order_relaxed);
+            _numdropped.store(0, std::memory_order_relaxed);
+            _mapstatisticsindices.clear();
+            _generation.store(generation, std::memory_order_release);
+        }
+    }
+
+    /// \brief returns the interned name cached for the address name, or NULL. Called only by the owning thread.
+    inline const char* FindInternedName(const char* name)
+    {
+        uint32_t namegeneration = s_nProfileNameGeneration.load(std::memory_order_acquire);
+        if( namegeneration != _namegeneration ) {
+            // a library was closed, so an address can now hold a different name
+            _mapinternednames.clear();
+            _namegeneration = namegeneration;
+            return NULL;
+        }
+        std::map<const char*, const char*>::const_iterator itname = _mapinternednames.find(name);
+        return itname != _mapinternednames.end() ? itname->second : NULL;
+    }
+
+    inline void CacheInternedName(const char* name, const char* interned) {
+        _mapinternednames[name] = interned;
+    }
+
+    /// \brief true if the buffer has not been reset since the profiler was cleared, in which case it is treated as empty
+    inline bool IsStale(uint32_t generation) const {
+        return _generation.load(std::memory_order_acquire) != generation;
+    }
+
+    inline int GetThreadId() const {
+        return _threadid;
+    }
+
+    uint64_t GetNumDropped() const
+    {
+        return _numdropped.load(std::memory_order_relaxed);
+    }
+
+    void GetEvents(std::vector<Event>& vevents) const
+    {
+        size_t numevents = _numevents.load(std::memory_order_acquire);
+        vevents.resize(numevents);
+        for(size_t ievent = 0; ievent < numevents; ++ievent) {
+            vevents[ievent] = _vchunks[ievent/s_nChunkSize][ievent%s_nChunkSize];
+        }
+    }
+
+    /// \brief merges the statistics of this thread into mapstatistics
+    void MergeStatistics(std::map<std::string, ProfileStatistics>& mapstatistics) const
+    {
+        size_t numstatistics = _numstatistics.load(std::memory_order_acquire);
+        for(size_t index = 0; index < numstatistics; ++index) {
+            mapstatistics[_vstatisticsnames[index]].Merge(_vstatistics[index]);
+        }
+    }
+
+    std::atomic<bool> _bThreadExited;
+
+private:
+    static const size_t s_nChunkSize = 1<<12; ///< events are allocated in chunks so that their addresses never change
+    static const size_t s_nMaxEvents = 1<<18; ///< events kept for the trace, further events are only counted in the statistics
+    static const size_t s_nMaxNames = 256; ///< names with statistics, the events of further names are only kept for the trace
+
+    int _threadid;
+    std::atomic<uint32_t> _generation; ///< generation of the profiler the events belong to
+    boost::array<Event*, s_nMaxEvents/s_nChunkSize> _vchunks;
+    std::atomic<size_t> _numevents;
+    boost::array<ProfileStatistics, s_nMaxNames> _vstatistics;
+    boost::array<const char*, s_nMaxNames> _vstatisticsnames;
+    std::atomic<size_t> _numstatistics;
+    std::atomic<uint64_t> _numdropped;
+    std::map<const char*, size_t> _mapstatisticsindices; ///< index of the statistics of every interned name, only used by the owning thread
+    std::map<const char*, const char*> _mapinternednames; ///< interned name of every recorded name address, only used by the owning thread
+    uint32_t _namegeneration; ///< value of s_nProfileNameGeneration when _mapinternednames was last cleared
+};
+
+typedef boost::shared_ptr<ProfileThreadBuffer> ProfileThreadBufferPtr;
+
+/// \brief owns the buffers of all the threads that recorded profiling events and the names of the events
+class Profiler
+{
+public:
+    Profiler() : _tssbuffer(&Profiler::_OnThreadExit), _nextthreadid(0), _generation(0), _basetime(RaveGetProfilingTime()) {
+    }
+
+    inline void Add(const char* name, uint64_t time, int64_t value, bool bCounter)
+    {
+        ProfileThreadBuffer* pbuffer = _tssbuffer.get();
+        if( !pbuffer ) {
+            boost::mutex::scoped_lock lock(_mutexBuffers);
+            ProfileThreadBufferPtr pnewbuffer(new ProfileThreadBuffer(_nextthreadid++, _generation.load(std::memory_order_relaxed)));
+            _vbuffers.push_back(pnewbuffer);
+            _tssbuffer.reset(pnewbuffer.get());
+            pbuffer = pnewbuffer.get();
+        }
+        pbuffer->Update(_generation.load(std::memory_order_acquire));
+        const char* interned = pbuffer->FindInternedName(name);
+        if( !interned ) {
+            interned = _InternName(name);
+            pbuffer->CacheInternedName(name, interned);
+        }
+        pbuffer->Add(interned, time, value, bCounter);
+    }
+
+    void Clear()
+    {
+        boost::mutex::scoped_lock lock(_mutexBuffers);
+        std::vector<ProfileThreadBufferPtr>::iterator itbuffer = _vbuffers.begin();
+        while(itbuffer != _vbuffers.end()) {
+            if( (*itbuffer)->_bThreadExited ) {
+                itbuffer = _vbuffers.erase(itbuffer);
+            }
+            else {
+                ++itbuffer;
+            }
+        }
+        // the threads reset their own buffers when they record their next event
+        _generation.fetch_add(1, std::memory_order_release);
+        _basetime = RaveGetProfilingTime();
+    }
+
+    uint64_t GetNumDropped()
+    {
+        boost::mutex::scoped_lock lock(_mutexBuffers);
+        uint32_t generation = _generation.load(std::memory_order_relaxed);
+        uint64_t numdropped = 0;
+        FOREACHC(itbuffer, _vbuffers) {
+            if( !(*itbuffer)->IsStale(generation) ) {
+                numdropped += (*itbuffer)->GetNumDropped();
+            }
+        }
+        return numdropped;
+    }
+
+    void WriteChromeTrace(std::ostream& O)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        ss << "{\"traceEvents\": [";
+        bool bFirst = true;
+        std::vector<ProfileThreadBuffer::Event> vevents;
+        {
+            // held while reading so that the buffers cannot be cleared, the threads keep recording
+            boost::mutex::scoped_lock lock(_mutexBuffers);
+            uint32_t generation = _generation.load(std::memory_order_relaxed);
+            FOREACHC(itbuffer, _vbuffers) {
+                if( (*itbuffer)->IsStale(generation) ) {
+                    continue;
+                }
+                (*itbuffer)->GetEvents(vevents);
+                FOREACHC(itevent, vevents) {
+                    if( !bFirst ) {
+                        ss << ",";
+                    }
+                    bFirst = false;
+                    ss << "\n{\"name\": ";
+                    _WriteJSONString(ss, itevent->name);
+                    double ts = itevent->time >= _basetime ? (itevent->time - _basetime)*1e-3 : -((_basetime - itevent->time)*1e-3);
+                    if( itevent->bCounter ) {
+                        ss << ", \"ph\": \"C\", \"ts\": " << ts << ", \"pid\": 0, \"tid\": " << (*itbuffer)->GetThreadId() << ", \"args\": {\"value\": " << itevent->value << "}}";
+                    }
+                    else {
+                        ss << ", \"cat\": \"openrave\", \"ph\": \"X\", \"ts\": " << ts << ", \"dur\": " << itevent->value*1e-3 << ", \"pid\": 0, \"tid\": " << (*itbuffer)->GetThreadId() << "}";
+                    }
+                }
+            }
+        }
+        ss << "\n], \"displayTimeUnit\": \"ns\"}\n";
+        O << ss.rdbuf();
+    }
+
+    void WriteHistograms(std::ostream& O)
+    {
+        std::map<std::string, ProfileStatistics> mapstatistics;
+        {
+            boost::mutex::scoped_lock lock(_mutexBuffers);
+            uint32_t generation = _generation.load(std::memory_order_relaxed);
+            FOREACHC(itbuffer, _vbuffers) {
+                if( !(*itbuffer)->IsStale(generation) ) {
+                    (*itbuffer)->MergeStatistics(mapstatistics);
+                }
+            }
+        }
+        std::stringstream ss;
+        ss << std::setprecision(9);
+        ss << "{";
+        FOREACHC(itstatistics, mapstatistics) {
+            if( itstatistics != mapstatistics.begin() ) {
+                ss << ",";
+            }
+            ss << "\n";
+            _WriteJSONString(ss, itstatistics->first.c_str());
+            ss << ": ";
+            itstatistics->second.WriteJSON(ss);
+        }
+        ss << "\n}\n";
+        O << ss.rdbuf();
+    }
+
+private:
+    static void _OnThreadExit(ProfileThreadBuffer* pbuffer)
+    {
+        // the buffer is owned by _vbuffers, keep its events until they are cleared
+        pbuffer->_bThreadExited = true;
+    }
+
+    /// \brief returns the copy of name owned by the profiler, so that the events do not depend on the lifetime of name
+    const char* _InternName(const char* name)
+    {
+        boost::mutex::scoped_lock lock(_mutexNames);
+        return _setnames.insert(std::string(name)).first->c_str();
+    }
+
+    static void _WriteJSONString(std::ostream& O, const char* s)
+    {
+        O << "\"";
+        for(; *s != 0; ++s) {
+            if( *s == '"' || *s == '\\' ) {
+                O << '\\' << *s;
+            }
+            else if( (unsigned char)*s < 0x20 ) {
+                O << ' ';
+            }
+            else {
+                O << *s;
+            }
+        }
+        O << "\"";
+    }
+
+    boost::mutex _mutexBuffers; ///< protects _vbuffers, _nextthreadid and _basetime, and is held while the buffers are exported or cleared
+    std::vector<ProfileThreadBufferPtr> _vbuffers;
+    boost::thread_specific_ptr<ProfileThreadBuffer> _tssbuffer;
+    int _nextthreadid;
+    std::atomic<uint32_t> _generation; ///< incremented by Clear
+    uint64_t _basetime; ///< time of the trace origin
+    boost::mutex _mutexNames; ///< protects _setnames
+    std::set<std::string> _setnames; ///< interned event names, never removed so that the events can point to them
+};
+
+static Profiler& GetProfiler()
+{
+    static Profiler s_profiler;
+    return s_profiler;
+}
+
+void RaveSetProfilingEnabled(bool bEnable)
+{
+    GetProfiler(); // construct before the first event
+    g_bProfilingEnabled.store(bEnable, std::memory_order_relaxed);
+}
+
+bool RaveIsProfilingEnabled()
+{
+    return IsProfilingEnabled();
+}
+
+uint64_t RaveGetProfilingTime()
+{
+    // utils::GetNanoPerformanceTime falls back to gettimeofday when clock_gettime is not detected, which only has microsecond resolution
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RaveAddProfileEvent(const char* name, uint64_t starttime, uint64_t endtime)
+{
+    if( IsProfilingEnabled() ) {
+        GetProfiler().Add(name, starttime, endtime >= starttime ? (int64_t)(endtime - starttime) : 0, false);
+    }
+}
+
+void RaveAddProfileCounter(const char* name, int64_t value)
+{
+    if( IsProfilingEnabled() ) {
+        GetProfiler().Add(name, RaveGetProfilingTime(), value, true);
+    }
+}
+
+void RaveClearProfileEvents()
+{
+    GetProfiler().Clear();
+}
+
+uint64_t RaveGetNumDroppedProfileEvents()
+{
+    return GetProfiler().GetNumDropped();
+}
+
+void RaveWriteProfileChromeTrace(std::ostream& O)
+{
+    GetProfiler().WriteChromeTrace(O);
+}
+
+void RaveWriteProfileHistograms(std::ostream& O)
+{
+    GetProfiler().WriteHistograms(O);
+}
+
+}
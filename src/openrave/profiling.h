@@ -0,0 +1,119 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2016 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/** \file profiling.h
+    \brief Scoped timers and counters of the hot paths that can be turned on at runtime.
+
+    Automatically included with \ref openrave.h
+
+    When profiling is disabled, a \ref ProfileScope only checks a flag. When enabled, every thread records its events
+    into its own buffer, so the recording threads never wait on each other. The events can be exported as a Chrome trace
+    (load it in chrome://tracing or https://ui.perfetto.dev) or aggregated into histograms per event name.
+ */
+#ifndef OPENRAVE_PROFILING_H
+#define OPENRAVE_PROFILING_H
+
+namespace OpenRAVE {
+
+/// \brief Starts or stops recording profiling events. Disabled by default.
+///
+/// Can also be enabled by setting the OPENRAVE_PROFILING environment variable to 1 before \ref RaveInitialize.
+OPENRAVE_API void RaveSetProfilingEnabled(bool bEnable);
+
+/// \brief Returns true if profiling events are recorded.
+OPENRAVE_API bool RaveIsProfilingEnabled();
+
+/// \brief Returns the time in nanoseconds used for the profiling events.
+OPENRAVE_API uint64_t RaveGetProfilingTime();
+
+/// \brief Records a duration event of the calling thread, does nothing if profiling is disabled.
+///
+/// \param name name of the event. Its text is copied the first time the thread records it and then looked up by address, so
+/// the text at that address should not change while it is used, like a string literal. The recorded events do not depend
+/// on it anymore, so they stay valid after the plugin that owns the string is unloaded.
+/// \param starttime start of the event from \ref RaveGetProfilingTime
+/// \param endtime end of the event from \ref RaveGetProfilingTime
+OPENRAVE_API void RaveAddProfileEvent(const char* name, uint64_t starttime, uint64_t endtime);
+
+/// \brief Records the current value of a counter, does nothing if profiling is disabled.
+///
+/// \param name name of the counter, see \ref RaveAddProfileEvent
+OPENRAVE_API void RaveAddProfileCounter(const char* name, int64_t value);
+
+/// \brief Removes the recorded events and histograms of all threads.
+OPENRAVE_API void RaveClearProfileEvents();
+
+/// \brief Returns the number of events that were not kept for the trace because a thread buffer was full. They are still counted in the histograms.
+OPENRAVE_API uint64_t RaveGetNumDroppedProfileEvents();
+
+/// \brief Writes the recorded events in the Chrome trace event JSON format.
+///
+/// Durations are complete events (ph X) and counters are counter events (ph C), times are in microseconds.
+OPENRAVE_API void RaveWriteProfileChromeTrace(std::ostream& O);
+
+/// \brief Writes the statistics of every event name of all threads as a JSON object.
+///
+/// For durations: count, total, min, max and mean in seconds, and buckets, a list of [upper bound in seconds, count]
+/// of the non-empty power of 2 buckets. For counters: count, sum, min, max of the values.
+OPENRAVE_API void RaveWriteProfileHistograms(std::ostream& O);
+
+/// \brief Records the time between its construction and its destruction as a profiling event of the calling thread.
+///
+/// Use through \ref OPENRAVE_PROFILE_SCOPE
+class ProfileScope
+{
+public:
+    /// \param name has to be a string literal, see \ref RaveAddProfileEvent
+    ProfileScope(const char* name) : _name(NULL), _starttime(0) {
+        if( RaveIsProfilingEnabled() ) {
+            _name = name;
+            _starttime = RaveGetProfilingTime();
+        }
+    }
+
+    /// \param bEnabled the value of \ref RaveIsProfilingEnabled, for callers that can check it without a function call
+    ProfileScope(const char* name, bool bEnabled) : _name(NULL), _starttime(0) {
+        if( bEnabled ) {
+            _name = name;
+            _starttime = RaveGetProfilingTime();
+        }
+    }
+    ~ProfileScope() {
+        if( !!_name ) {
+            RaveAddProfileEvent(_name, _starttime, RaveGetProfilingTime());
+        }
+    }
+
+private:
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+
+    const char* _name;
+    uint64_t _starttime;
+};
+
+#define OPENRAVE_PROFILE_CONCAT2(a, b) a ## b
+#define OPENRAVE_PROFILE_CONCAT(a, b) OPENRAVE_PROFILE_CONCAT2(a, b)
+
+/// \brief times the rest of the enclosing scope under name
+#define OPENRAVE_PROFILE_SCOPE(name) OpenRAVE::ProfileScope OPENRAVE_PROFILE_CONCAT(__openraveprofilescope, __LINE__)(name)
+
+/// \brief records the value of a counter if profiling is enabled
+#define OPENRAVE_PROFILE_COUNTER(name, value) do { if( OpenRAVE::RaveIsProfilingEnabled() ) { OpenRAVE::RaveAddProfileCounter(name, value); } } while(false)
+
+} // end namespace OpenRAVE
+
+#endif
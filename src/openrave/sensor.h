@@ -370,6 +370,17 @@ public:
     /// Only valid if this sensor is simulation based. A sensor hooked up to a real device can ignore this call
     virtual bool SimulationStep(dReal fTimeElapsed) OPENRAVE_DUMMY_IMPLEMENTATION;
 
+    /// \brief returns true if SimulationStep can run concurrently with the SimulationStep of other sensors.
+    ///
+    /// Sensor types that only read the scene (link transforms, geometry) and keep their own state can return true. The
+    /// environment then steps them on worker threads after all bodies and modules have been stepped. The environment
+    /// mutex stays locked by the simulation thread during that time, so SimulationStep must not lock it, modify the
+    /// environment, use the environment collision checker, or request viewer images. Plotting through the environment
+    /// is allowed. Called before every step, so a sensor can opt out of the steps that need the environment. By default returns false.
+    virtual bool IsSimulationStepConcurrent() const {
+        return false;
+    }
+
     /// \brief Returns the sensor geometry. This method is thread safe.
     ///
     /// \param type the requested sensor type to create. A sensor can support many types. If type is ST_Invalid, then returns any structure that represents the geometry.
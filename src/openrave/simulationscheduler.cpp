@@ -0,0 +1,134 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2014 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "libopenrave.h"
+#include <openrave/utils.h>
+
+namespace OpenRAVE {
+
+SimulationScheduler::SimulationScheduler(int numthreads) : _pthreadpool(new utils::ThreadPool(numthreads))
+{
+}
+
+SimulationScheduler::~SimulationScheduler()
+{
+}
+
+void SimulationScheduler::AddEnvironment(EnvironmentBasePtr penv)
+{
+    if( !penv ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0(_("need a valid environment"), ORE_InvalidArguments);
+    }
+    boost::mutex::scoped_lock lock(_mutex);
+    if( find(_venvs.begin(), _venvs.end(), penv) != _venvs.end() ) {
+        return;
+    }
+    // the scheduler is the only one stepping the environment now
+    penv->StopSimulation();
+    _venvs.push_back(penv);
+    _vstats.push_back(StepStatistics());
+    _vstats.back().penv = penv;
+}
+
+bool SimulationScheduler::RemoveEnvironment(EnvironmentBasePtr penv)
+{
+    boost::mutex::scoped_lock lock(_mutex);
+    std::vector<EnvironmentBasePtr>::iterator itenv = find(_venvs.begin(), _venvs.end(), penv);
+    if( itenv == _venvs.end() ) {
+        return false;
+    }
+    _vstats.erase(_vstats.begin() + (itenv - _venvs.begin()));
+    _venvs.erase(itenv);
+    return true;
+}
+
+void SimulationScheduler::GetEnvironments(std::vector<EnvironmentBasePtr>& venvs) const
+{
+    boost::mutex::scoped_lock lock(_mutex);
+    venvs = _venvs;
+}
+
+void SimulationScheduler::Step(dReal fTimeStep, int numsteps)
+{
+    boost::mutex::scoped_lock steplock(_mutexStep);
+    std::vector<EnvironmentBasePtr> venvs;
+    std::vector<uint64_t> vsteptimes;
+    std::vector< boost::function<void()> > vtasks;
+    for(int istep = 0; istep < numsteps; ++istep) {
+        {
+            // environments can be added or removed between steps
+            boost::mutex::scoped_lock lock(_mutex);
+            venvs = _venvs;
+        }
+        FOREACHC(itenv, venvs) {
+            if( (*itenv)->IsSimulationRunning() ) {
+                RAVELOG_WARN_FORMAT("env=%d, simulation thread was started while being stepped by the scheduler, so stopping it", (*itenv)->GetId());
+                (*itenv)->StopSimulation();
+            }
+        }
+        vsteptimes.resize(venvs.size());
+        vtasks.resize(venvs.size());
+        for(size_t ienv = 0; ienv < venvs.size(); ++ienv) {
+            vtasks[ienv] = boost::bind(&SimulationScheduler::_StepEnvironment, venvs[ienv], fTimeStep, boost::ref(vsteptimes[ienv]));
+        }
+        // returns only after every environment has taken this step
+        _pthreadpool->RunTasks(vtasks);
+
+        boost::mutex::scoped_lock lock(_mutex);
+        for(size_t ienv = 0; ienv < venvs.size(); ++ienv) {
+            std::vector<EnvironmentBasePtr>::iterator itenv = find(_venvs.begin(), _venvs.end(), venvs[ienv]);
+            if( itenv == _venvs.end() ) {
+                continue; // removed during the step
+            }
+            StepStatistics& stats = _vstats.at(itenv - _venvs.begin());
+            stats.numsteps += 1;
+            stats.totalsteptime += vsteptimes[ienv];
+            if( stats.maxsteptime < vsteptimes[ienv] ) {
+                stats.maxsteptime = vsteptimes[ienv];
+            }
+        }
+    }
+}
+
+void SimulationScheduler::GetStatistics(std::vector<StepStatistics>& vstats) const
+{
+    boost::mutex::scoped_lock lock(_mutex);
+    vstats = _vstats;
+}
+
+void SimulationScheduler::ResetStatistics()
+{
+    boost::mutex::scoped_lock lock(_mutex);
+    for(size_t ienv = 0; ienv < _vstats.size(); ++ienv) {
+        _vstats[ienv].numsteps = 0;
+        _vstats[ienv].totalsteptime = 0;
+        _vstats[ienv].maxsteptime = 0;
+    }
+}
+
+int SimulationScheduler::GetNumThreads() const
+{
+    return _pthreadpool->GetNumThreads();
+}
+
+void SimulationScheduler::_StepEnvironment(EnvironmentBasePtr penv, dReal fTimeStep, uint64_t& steptime)
+{
+    uint64_t starttime = utils::GetNanoPerformanceTime();
+    penv->StepSimulation(fTimeStep);
+    steptime = utils::GetNanoPerformanceTime() - starttime;
+}
+
+} // end namespace OpenRAVE
@@ -16,6 +16,9 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "libopenrave.h"
 #include <openrave/utils.h>
+#include <boost/make_shared.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <exception>
 
 #include "md5.h"
 
@@ -121,5 +124,126 @@ std::string GetFilenameUntilSeparator(std::istream& sinput, char separator)
     return filename.substr( startpos, endpos-startpos+1 );
 }
 
+class ThreadPool::Impl
+{
+public:
+    Impl(int numthreads) : _pvtasks(NULL), _numtasks(0), _nextindex(0), _numfinished(0), _bShutdown(false)
+    {
+        if( numthreads <= 0 ) {
+            numthreads = std::max(1, (int)boost::thread::hardware_concurrency());
+        }
+        _numthreads = numthreads;
+        for(int ithread = 1; ithread < numthreads; ++ithread) {
+            _vthreads.push_back(boost::make_shared<boost::thread>(boost::bind(&Impl::_WorkerThread, this)));
+        }
+    }
+
+    ~Impl()
+    {
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            _bShutdown = true;
+            _condWork.notify_all();
+        }
+        FOREACH(itthread, _vthreads) {
+            (*itthread)->join();
+        }
+    }
+
+    void RunTasks(const std::vector< boost::function<void()> >& vtasks)
+    {
+        if( vtasks.size() == 0 ) {
+            return;
+        }
+        boost::mutex::scoped_lock runlock(_mutexRun);
+        boost::mutex::scoped_lock lock(_mutex);
+        _pvtasks = &vtasks;
+        _numtasks = vtasks.size();
+        _nextindex = 0;
+        _numfinished = 0;
+        _exception = std::exception_ptr();
+        _condWork.notify_all();
+        _RunAvailableTasks(lock);
+        while( _numfinished < _numtasks ) {
+            _condDone.wait(lock);
+        }
+        _pvtasks = NULL;
+        _numtasks = 0;
+        _nextindex = 0;
+        if( !!_exception ) {
+            std::exception_ptr exception = _exception;
+            _exception = std::exception_ptr();
+            std::rethrow_exception(exception);
+        }
+    }
+
+    int _numthreads;
+
+private:
+    /// \brief executes tasks until none are left to start. lock has to be held when called
+    void _RunAvailableTasks(boost::mutex::scoped_lock& lock)
+    {
+        while( _nextindex < _numtasks ) {
+            size_t index = _nextindex++;
+            const std::vector< boost::function<void()> >& vtasks = *_pvtasks;
+            lock.unlock();
+            std::exception_ptr exception;
+            try {
+                vtasks[index]();
+            }
+            catch(...) {
+                exception = std::current_exception();
+            }
+            lock.lock();
+            if( !!exception && !_exception ) {
+                _exception = exception;
+            }
+            if( ++_numfinished == _numtasks ) {
+                _condDone.notify_all();
+            }
+        }
+    }
+
+    void _WorkerThread()
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        while( !_bShutdown ) {
+            if( _nextindex < _numtasks ) {
+                _RunAvailableTasks(lock);
+            }
+            else {
+                _condWork.wait(lock);
+            }
+        }
+    }
+
+    std::vector< boost::shared_ptr<boost::thread> > _vthreads;
+    boost::mutex _mutexRun; ///< serializes calls to RunTasks
+    boost::mutex _mutex; ///< protects all the members below
+    boost::condition_variable _condWork, _condDone;
+    const std::vector< boost::function<void()> >* _pvtasks; ///< the current batch
+    size_t _numtasks, _nextindex, _numfinished;
+    std::exception_ptr _exception; ///< the first exception thrown by a task of the current batch
+    bool _bShutdown;
+};
+
+ThreadPool::ThreadPool(int numthreads) : _pimpl(new Impl(numthreads))
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+}
+
+int ThreadPool::GetNumThreads() const
+{
+    return _pimpl->_numthreads;
+}
+
+void ThreadPool::RunTasks(const std::vector< boost::function<void()> >& vtasks)
+{
+    _pimpl->RunTasks(vtasks);
+}
+
 } // utils
 } // OpenRAVE
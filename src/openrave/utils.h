@@ -350,6 +350,32 @@ inline std::string ConvertToOpenRAVEName(const std::string& name)
     return newname;
 }
 
+/** \brief A fixed set of worker threads that run batches of independent tasks.
+
+    RunTasks blocks until every task of the batch has finished. The calling thread also executes tasks, so
+    numthreads-1 background threads are created. Calls to RunTasks from different threads are serialized, so
+    a task must not call RunTasks on the pool that is running it.
+ */
+class OPENRAVE_API ThreadPool
+{
+public:
+    /// \param numthreads total number of threads executing tasks including the caller. If <= 0, uses the number of hardware threads.
+    ThreadPool(int numthreads=0);
+    virtual ~ThreadPool();
+
+    /// \brief the number of threads executing tasks including the caller of RunTasks
+    int GetNumThreads() const;
+
+    /// \brief runs all tasks and returns once all of them have finished.
+    ///
+    /// \throw if any of the tasks threw, rethrows the first exception unchanged (e.g. an openrave_exception keeps its code) after the remaining tasks have run.
+    void RunTasks(const std::vector< boost::function<void()> >& vtasks);
+
+private:
+    class Impl;
+    boost::shared_ptr<Impl> _pimpl;
+};
+
 } // utils
 } // OpenRAVE
 
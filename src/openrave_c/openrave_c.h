@@ -139,6 +139,11 @@ OPENRAVE_C_API void ORCEnvironmentUnlock(void* env);
 /// \brief Starts a viewer thread for the current environment
 OPENRAVE_C_API int ORCEnvironmentSetViewer(void* env, const char* viewername);
 
+/// \brief Calls \ref EnvironmentBase::CheckCollision with the body and the rest of the environment
+///
+/// \return 1 if the body is in collision, 0 otherwise
+OPENRAVE_C_API int ORCEnvironmentCheckCollision(void* env, void* body);
+
 //@}
 
 /// \name \ref InterfaceBase methods
@@ -206,6 +211,20 @@ OPENRAVE_C_API void ORCBodyGetTransform(void* body, OpenRAVEReal* pose);
 /// \param[out] matrix column-order, row-major 3x4 matrix of the body world transform
 OPENRAVE_C_API void ORCBodyGetTransformMatrix(void* body, OpenRAVEReal* matrix);
 
+/// \brief Sets every configuration of the body in turn and queries its collisions and link transforms in one call.
+///
+/// Replaces numconfigurations calls of \ref ORCBodySetDOFValues followed by collision and transform queries. The
+/// environment lock is acquired inside and the body state is restored afterwards. Collisions are only checked if
+/// collisions or distances is not NULL.
+/// \param configurations numconfigurations*dof values of the DOFs, dof from \ref ORCBodyGetDOF
+/// \param checkselfcollision if not 0, a configuration is also in collision when the body collides with itself
+/// \param numthreads if greater than 1, the configurations are split among that many cloned environments that are checked in parallel. The clones are kept for the next calls on the same environment and only updated with its bodies, they are released when the environment is destroyed or by \ref ORCDestroy.
+/// \param[out] collisions if not NULL, numconfigurations values set to 1 if the configuration is in collision, 0 otherwise
+/// \param[out] distances if not NULL, numconfigurations minimum distances between the body and the environment, -1 if the collision checker does not support distance queries
+/// \param[out] linkposes if not NULL, numconfigurations*numlinks*7 values of the quaternion (4) and translation (3) of the world pose of every link
+/// \return number of configurations in collision, or -1 if the configurations could not be checked
+OPENRAVE_C_API int ORCBodyCheckConfigurations(void* body, const OpenRAVEReal* configurations, int numconfigurations, int checkselfcollision, int numthreads, int* collisions, OpenRAVEReal* distances, OpenRAVEReal* linkposes);
+
 /// \brief Calls \ref KinBody::InitFromTrimesh
 ///
 /// \param trimesh returned from ORCTriMeshCreate()
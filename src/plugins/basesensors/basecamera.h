@@ -300,6 +300,12 @@ public:
         return true;
     }
 
+    /// \brief the images come from the viewer, which has to lock the environment to publish the bodies, so only the
+    /// steps that cannot take an image run concurrently.
+    virtual bool IsSimulationStepConcurrent() const {
+        return !_bPower || _pgeom->width <= 0 || _pgeom->height <= 0 || !GetEnv()->GetViewer();
+    }
+
     virtual SensorGeometryConstPtr GetSensorGeometry(SensorType type)
     {
         if(( type == ST_Invalid) ||( type == ST_Camera) ) {
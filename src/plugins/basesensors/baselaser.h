@@ -17,6 +17,9 @@
 #define OPENRAVE_BASELASER_H
 
 /// Laser rotates around the zaxis and it's 0 angle is pointed toward the xaxis.
+///
+/// The beams are intersected with the collision meshes of the enabled links instead of going through the environment
+/// collision checker, so the laser only reads the scene and can be stepped concurrently with the other sensors.
 class BaseLaser2DSensor : public SensorBase
 {
 protected:
@@ -144,7 +147,6 @@ public:
         _pgeom->max_range = 100;
         _fTimeToScan = 0;
         _vColor = RaveVector<float>(0.5f,0.5f,1,1);
-        _report.reset(new CollisionReport());
         _bPower = false;
         _bRenderData = false;
         _bRenderGeometry = true;
@@ -199,8 +201,7 @@ public:
             _fTimeToScan = _pgeom->time_scan;
             Vector rotaxis(0,0,1);
             RAY r;
-
-            GetEnv()->GetCollisionChecker()->SetCollisionOptions(CO_Distance);
+            _GatherRayLinks();
             Transform t;
 
             {
@@ -219,14 +220,13 @@ public:
                     r.pos = t.trans+_pgeom->min_range*vdir;
                     r.dir = (_pgeom->max_range-_pgeom->min_range)*vdir;
 
-                    if( GetEnv()->CheckCollision(r, _report)) {
-                        _pdata->ranges[index] = vdir*(_report->minDistance+_pgeom->min_range);
+                    dReal fDistance = 0;
+                    KinBody::LinkConstPtr plink;
+                    if( _CastRay(r, fDistance, plink) ) {
+                        _pdata->ranges[index] = vdir*(fDistance+_pgeom->min_range);
                         _pdata->intensity[index] = 1;
                         // store the colliding bodies
-                        KinBody::LinkConstPtr plink = !!_report->plink1 ? _report->plink1 : _report->plink2;
-                        if( !!plink ) {
-                            _databodyids[index] = plink->GetParent()->GetEnvironmentId();
-                        }
+                        _databodyids[index] = plink->GetParent()->GetEnvironmentId();
                     }
                     else {
                         _databodyids[index] = 0;
@@ -235,8 +235,8 @@ public:
                     }
                 }
             }
-
-            GetEnv()->GetCollisionChecker()->SetCollisionOptions(0);
+            // do not keep the links alive
+            _vraylinks.resize(0);
 
             if( _bRenderData ) {
                 // If can render, check if some time passed before last update
@@ -279,13 +279,16 @@ public:
             else {
                 _listGraphicsHandles.clear();
             }
-
-            _report->Reset();
         }
 
         return true;
     }
 
+    /// \brief only reads the link transforms and collision meshes, the plots go through the thread safe viewer calls
+    virtual bool IsSimulationStepConcurrent() const {
+        return true;
+    }
+
     virtual SensorGeometryConstPtr GetSensorGeometry(SensorType type)
     {
         if( type == ST_Invalid || type == ST_Laser ) {
@@ -363,11 +366,119 @@ public:
     }
 
 protected:
+    /// \brief a link that the beams of one scan are intersected with
+    struct RayLink
+    {
+        KinBody::LinkConstPtr plink;
+        Transform tinv; ///< inverse of the link transform at the time of the scan
+        AABB ab; ///< bounding box of the link collision mesh in the link frame
+    };
 
     virtual Transform GetLaserPlaneTransform() {
         return _trans;
     }
 
+    /// \brief stores the enabled links of the enabled bodies that have collision meshes
+    void _GatherRayLinks()
+    {
+        std::vector<KinBodyPtr> vbodies;
+        GetEnv()->GetBodies(vbodies);
+        _vraylinks.resize(0);
+        FOREACHC(itbody, vbodies) {
+            if( !(*itbody)->IsEnabled() ) {
+                continue;
+            }
+            FOREACHC(itlink, (*itbody)->GetLinks()) {
+                if( !(*itlink)->IsEnabled() || (*itlink)->GetCollisionData().indices.size() == 0 ) {
+                    continue;
+                }
+                RayLink raylink;
+                raylink.plink = *itlink;
+                raylink.tinv = (*itlink)->GetTransform().inverse();
+                raylink.ab = (*itlink)->ComputeLocalAABB();
+                _vraylinks.push_back(raylink);
+            }
+        }
+    }
+
+    /// \brief intersects the segment r.pos to r.pos+r.dir with the links of _GatherRayLinks
+    ///
+    /// \param[out] fDistance distance from r.pos to the closest hit
+    /// \param[out] plinkhit the link of the closest hit
+    /// \return true if the segment hits a link
+    bool _CastRay(const RAY& r, dReal& fDistance, KinBody::LinkConstPtr& plinkhit) const
+    {
+        dReal fBest = 1; // closest hit as a fraction of r.dir
+        FOREACHC(itraylink, _vraylinks) {
+            Vector vpos = itraylink->tinv*r.pos, vdir = itraylink->tinv.rotate(r.dir);
+            if( !_IntersectsAABB(vpos, vdir, itraylink->ab, fBest) ) {
+                continue;
+            }
+            const TriMesh& mesh = itraylink->plink->GetCollisionData();
+            for(size_t i = 0; i+2 < mesh.indices.size(); i += 3) {
+                dReal f;
+                if( _IntersectTriangle(vpos, vdir, mesh.vertices[mesh.indices[i]], mesh.vertices[mesh.indices[i+1]], mesh.vertices[mesh.indices[i+2]], f) && f < fBest ) {
+                    fBest = f;
+                    plinkhit = itraylink->plink;
+                }
+            }
+        }
+        if( !plinkhit ) {
+            return false;
+        }
+        fDistance = fBest*RaveSqrt(r.dir.lengthsqr3());
+        return true;
+    }
+
+    /// \brief true if the segment vpos to vpos+fMax*vdir touches the box
+    static bool _IntersectsAABB(const Vector& vpos, const Vector& vdir, const AABB& ab, dReal fMax)
+    {
+        dReal fMin = 0;
+        for(int i = 0; i < 3; ++i) {
+            dReal flower = ab.pos[i]-ab.extents[i]-vpos[i], fupper = ab.pos[i]+ab.extents[i]-vpos[i];
+            if( RaveFabs(vdir[i]) <= g_fEpsilon ) {
+                if( flower > 0 || fupper < 0 ) {
+                    return false;
+                }
+                continue;
+            }
+            dReal f0 = flower/vdir[i], f1 = fupper/vdir[i];
+            if( f0 > f1 ) {
+                std::swap(f0, f1);
+            }
+            fMin = max(fMin, f0);
+            fMax = min(fMax, f1);
+            if( fMin > fMax ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief intersects the line vpos+f*vdir with both sides of a triangle (Moller-Trumbore), f is only valid in [0,1]
+    static bool _IntersectTriangle(const Vector& vpos, const Vector& vdir, const Vector& v0, const Vector& v1, const Vector& v2, dReal& f)
+    {
+        Vector e1 = v1-v0, e2 = v2-v0;
+        Vector p = vdir.cross(e2);
+        dReal det = e1.dot3(p);
+        if( RaveFabs(det) <= g_fEpsilon*g_fEpsilon ) {
+            return false;
+        }
+        dReal invdet = 1/det;
+        Vector s = vpos-v0;
+        dReal u = s.dot3(p)*invdet;
+        if( u < 0 || u > 1 ) {
+            return false;
+        }
+        Vector q = s.cross(e1);
+        dReal v = vdir.dot3(q)*invdet;
+        if( v < 0 || u+v > 1 ) {
+            return false;
+        }
+        f = e2.dot3(q)*invdet;
+        return f >= 0 && f <= 1;
+    }
+
     virtual void _Reset()
     {
         boost::mutex::scoped_lock lock(_mutexdata);
@@ -432,7 +543,7 @@ protected:
     boost::shared_ptr<LaserGeomData> _pgeom;
     boost::shared_ptr<LaserSensorData> _pdata;
     vector<int> _databodyids;     ///< if non 0, for each point in _data, specifies the body that was hit
-    CollisionReportPtr _report;
+    std::vector<RayLink> _vraylinks; ///< links of the current scan
 
     // more geom stuff
     RaveVector<float> _vColor;
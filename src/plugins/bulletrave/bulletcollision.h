@@ -464,6 +464,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Body/Env");
         if(( pbody->GetLinks().size() == 0) || !pbody->IsEnabled() ) {
             RAVELOG_WARN(str(boost::format("body %s not valid\n")%pbody->GetName()));
             return false;
@@ -480,6 +481,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Body/Body");
         if(( pbody1->GetLinks().size() == 0) || !pbody1->IsEnabled() ) {
             RAVELOG_WARN(str(boost::format("body1 %s not valid\n")%pbody1->GetName()));
             return false;
@@ -500,6 +502,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Link/Env");
         if( !plink->IsEnabled() ) {
             RAVELOG_VERBOSE(str(boost::format("calling collision on disabled link %s\n")%plink->GetName()));
             return false;
@@ -514,6 +517,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink1, KinBody::LinkConstPtr plink2, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Link/Link");
         if( !plink1->IsEnabled() ) {
             RAVELOG_VERBOSE(str(boost::format("calling collision on disabled link1 %s\n")%plink1->GetName()));
             return false;
@@ -531,6 +535,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Link/Body");
         if(( pbody->GetLinks().size() == 0) || !pbody->IsEnabled() ) {    //
             //RAVELOG_WARN(str(boost::format("body %s not valid\n")%pbody->GetName()));
             return false;
@@ -551,6 +556,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Link/Env excluded");
         RAVELOG_FATAL("This type of collision checking is not yet implemented in the Bullet collision checker.\n");
         BOOST_ASSERT(0);
         bulletspace->Synchronize();
@@ -559,6 +565,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Body/Env excluded");
         if(( vbodyexcluded.size() == 0) &&( vlinkexcluded.size() == 0) )
             return CheckCollision(pbody, report);
 
@@ -575,6 +582,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Ray/Link");
         if( !plink->IsEnabled() ) {
             //RAVELOG_VERBOSE(str(boost::format("calling collision on disabled link %s\n")%plink->GetName()));
             return false;
@@ -636,6 +644,7 @@ public:
     }
     virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Ray/Body");
         if(( pbody->GetLinks().size() == 0) || !pbody->IsEnabled() ) {
             //RAVELOG_WARN(str(boost::format("body %s not valid\n")%pbody->GetName()));
             return false;
@@ -706,6 +715,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckCollision Ray/Env");
         if( !!report ) {
             report->Reset();
         }
@@ -770,6 +780,7 @@ public:
 
     virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckStandaloneSelfCollision Body");
         if(( pbody->GetLinks().size() == 0) || !pbody->IsEnabled() ) {
             //RAVELOG_WARN(str(boost::format("body %s not valid\n")%pbody->GetName()));
             return false;
@@ -788,6 +799,7 @@ public:
 
     virtual bool CheckStandaloneSelfCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("bullet CheckStandaloneSelfCollision Link");
         // dummy
         return CheckStandaloneSelfCollision(plink->GetParent(), report);
     }
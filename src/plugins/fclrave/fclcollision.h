@@ -125,7 +125,8 @@ public:
         SETUP_STATISTICS(_statistics, _userdatakey, GetEnv()->GetId());
 
         // TODO : Consider removing these which could be more harmful than anything else
-        RegisterCommand("SetBroadphaseAlgorithm", boost::bind(&FCLCollisionChecker::SetBroadphaseAlgorithmCommand, this, _1, _2), "sets the broadphase algorithm (Naive, SaP, SSaP, IntervalTree, DynamicAABBTree, DynamicAABBTree_Array)");
+        RegisterCommand("SetBroadphaseAlgorithm", boost::bind(&FCLCollisionChecker::SetBroadphaseAlgorithmCommand, this, _1, _2), "sets the broadphase algorithm (Naive, SaP, SSaP, IntervalTree, DynamicAABBTree, DynamicAABBTree_Array, SpatialHashing, Auto)");
+        RegisterCommand("GetBroadphaseStatistics", boost::bind(&FCLCollisionChecker::GetBroadphaseStatisticsCommand, this, _1, _2), "returns one line per cached broadphase manager: type(body/env) algorithm numobjects numqueries numsynchronizations numupdatedobjects elapsedms cellsize minx miny minz maxx maxy maxz, where the spatial hashing cell size and scene limits are 0 for other algorithms");
         RegisterCommand("SetBVHRepresentation", boost::bind(&FCLCollisionChecker::_SetBVHRepresentation, this, _1, _2), "sets the Bouding Volume Hierarchy representation for meshes (AABB, OBB, OBBRSS, RSS, kIDS)");
 
         RAVELOG_VERBOSE_FORMAT("FCLCollisionChecker %s created in env %d", _userdatakey%penv->GetId());
@@ -234,7 +235,9 @@ public:
 
 
     /// Sets the broadphase algorithm for collision checking
-    /// The input algorithm can be one of : Naive, SaP, SSaP, IntervalTree, DynamicAABBTree{,1,2,3}, DynamicAABBTree_Array{,1,2,3}, SpatialHashing
+    /// The input algorithm can be one of : Naive, SaP, SSaP, IntervalTree, DynamicAABBTree{,1,2,3}, DynamicAABBTree_Array{,1,2,3}, SpatialHashing, Auto
+    /// SpatialHashing sizes its cells and scene limits from the AABBs of the objects of each manager.
+    /// Auto chooses the algorithm of each manager from its number of objects and how often they are updated, see _ChooseBroadphaseAlgorithm.
     /// e.g. "SetBroadPhaseAlgorithm DynamicAABBTree"
     bool SetBroadphaseAlgorithmCommand(ostream& sout, istream& sinput)
     {
@@ -260,6 +263,18 @@ public:
         return _broadPhaseCollisionManagerAlgorithm;
     }
 
+    bool GetBroadphaseStatisticsCommand(ostream& sout, istream& sinput)
+    {
+        uint32_t curtime = OpenRAVE::utils::GetMilliTime();
+        FOREACHC(it, _bodymanagers) {
+            _WriteBroadphaseStatistics(sout, "body", *it->second, curtime);
+        }
+        FOREACHC(it, _envmanagers) {
+            _WriteBroadphaseStatistics(sout, "env", *it->second, curtime);
+        }
+        return true;
+    }
+
     // TODO : This is becoming really stupid, I should just add optional additional data for DynamicAABBTree
     BroadPhaseCollisionManagerPtr _CreateManagerFromBroadphaseAlgorithm(std::string const &algorithm)
     {
@@ -270,7 +285,7 @@ public:
         } else if(algorithm == "SSaP") {
             return boost::make_shared<fcl::SSaPCollisionManager>();
         } else if(algorithm == "SpatialHashing") {
-            throw OPENRAVE_EXCEPTION_FORMAT0("No spatial data provided, spatial hashing needs to be set up  with SetSpatialHashingBroadPhaseAlgorithm", OpenRAVE::ORE_InvalidArguments);
+            throw OPENRAVE_EXCEPTION_FORMAT0("No spatial data provided, spatial hashing managers need to be created with _ReplaceWithSpatialHashingManager", OpenRAVE::ORE_InvalidArguments);
         } else if(algorithm == "IntervalTree") {
             return boost::make_shared<fcl::IntervalTreeCollisionManager>();
         } else if(algorithm == "DynamicAABBTree") {
@@ -364,6 +379,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody1, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Body/Env");
         START_TIMING_OPT(_statistics, "Body/Env",_options,pbody1->IsRobot());
         // TODO : tailor this case when stuff become stable enough
         return CheckCollision(pbody1, std::vector<KinBodyConstPtr>(), std::vector<LinkConstPtr>(), report);
@@ -371,6 +387,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Body/Body");
         START_TIMING_OPT(_statistics, "Body/Body",_options,(pbody1->IsRobot() || pbody2->IsRobot()));
         if( !!report ) {
             report->Reset(_options);
@@ -407,13 +424,14 @@ public:
             const std::vector<LinkConstPtr> vlinkexcluded;
             CollisionCallbackData query(shared_checker(), report, vbodyexcluded, vlinkexcluded);
             ADD_TIMING(_statistics);
-            body1Manager.GetManager()->collide(body2Manager.GetManager().get(), &query, &FCLCollisionChecker::CheckNarrowPhaseCollision);
+            _CollideManagers(body1Manager, body2Manager, query);
             return query._bCollision;
         }
     }
 
     virtual bool CheckCollision(LinkConstPtr plink,CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Link/Env");
         START_TIMING_OPT(_statistics, "Link/Env",_options,false);
         // TODO : tailor this case when stuff become stable enough
         return CheckCollision(plink, std::vector<KinBodyConstPtr>(), std::vector<LinkConstPtr>(), report);
@@ -421,6 +439,7 @@ public:
 
     virtual bool CheckCollision(LinkConstPtr plink1, LinkConstPtr plink2, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Link/Link");
         START_TIMING_OPT(_statistics, "Link/Link",_options,false);
         if( !!report ) {
             report->Reset(_options);
@@ -469,6 +488,7 @@ public:
 
     virtual bool CheckCollision(LinkConstPtr plink, KinBodyConstPtr pbody,CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Link/Body");
         START_TIMING_OPT(_statistics, "Link/Body",_options,pbody->IsRobot());
 
         if( !!report ) {
@@ -523,6 +543,7 @@ public:
 
     virtual bool CheckCollision(LinkConstPtr plink, std::vector<KinBodyConstPtr> const &vbodyexcluded, std::vector<LinkConstPtr> const &vlinkexcluded, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Link/Env excluded");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -558,6 +579,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody, std::vector<KinBodyConstPtr> const &vbodyexcluded, std::vector<LinkConstPtr> const &vlinkexcluded, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Body/Env excluded");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -594,31 +616,35 @@ public:
 #ifdef FCLRAVE_CHECKPARENTLESS
             boost::shared_ptr<void> onexit((void*) 0, boost::bind(&FCLCollisionChecker::_PrintCollisionManagerInstanceBE, this, boost::ref(*pbody), boost::ref(bodyManager), boost::ref(envManager)));
 #endif
-            envManager.GetManager()->collide(bodyManager.GetManager().get(), &query, &FCLCollisionChecker::CheckNarrowPhaseCollision);
+            _CollideManagers(envManager, bodyManager, query);
             return query._bCollision;
         }
     }
 
     virtual bool CheckCollision(const RAY& ray, LinkConstPtr plink,CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Ray/Link");
         RAVELOG_WARN("fcl doesn't support Ray collisions\n");
         return false; //TODO
     }
 
     virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Ray/Body");
         RAVELOG_WARN("fcl doesn't support Ray collisions\n");
         return false; //TODO
     }
 
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision Ray/Env");
         RAVELOG_WARN("fcl doesn't support Ray collisions\n");
         return false; //TODO
     }
 
     virtual bool CheckCollision(const OpenRAVE::TriMesh& trimesh, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) override
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision TriMesh/Body");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -666,6 +692,7 @@ public:
 
     virtual bool CheckCollision(const OpenRAVE::TriMesh& trimesh, CollisionReportPtr report = CollisionReportPtr()) override
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision TriMesh/Env");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -710,6 +737,7 @@ public:
     
     virtual bool CheckCollision(const OpenRAVE::AABB& ab, const OpenRAVE::Transform& aabbPose, CollisionReportPtr report = CollisionReportPtr()) override
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision AABB/Env");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -743,6 +771,7 @@ public:
 
     virtual bool CheckCollision(const OpenRAVE::AABB& ab, const OpenRAVE::Transform& aabbPose, const std::vector<OpenRAVE::KinBodyConstPtr>& vIncludedBodies, OpenRAVE::CollisionReportPtr report) override
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckCollision AABB/Bodies");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -781,6 +810,7 @@ public:
     
     virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckStandaloneSelfCollision Body");
         START_TIMING_OPT(_statistics, "BodySelf",_options,pbody->IsRobot());
         if( !!report ) {
             report->Reset(_options);
@@ -839,6 +869,7 @@ public:
 
     virtual bool CheckStandaloneSelfCollision(LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("fcl CheckStandaloneSelfCollision Link");
         START_TIMING_OPT(_statistics, "LinkSelf",_options,false);
         if( !!report ) {
             report->Reset(_options);
@@ -1091,7 +1122,16 @@ private:
                     copy(_reportcache.contacts.begin(),_reportcache.contacts.end(), back_inserter(pcb->_report->contacts));
                 }
 
-                if( _options & OpenRAVE::CO_AllLinkCollisions ) {
+                if( (_options & OpenRAVE::CO_AllLinkCollisions) && pcb->_report->bCompactLinkColliding ) {
+                    // same order as MakeLinkPair without copying the links
+                    if( plink1.get() < plink2.get() ) {
+                        pcb->_report->AddLinkColliding(plink1, plink2);
+                    }
+                    else {
+                        pcb->_report->AddLinkColliding(plink2, plink1);
+                    }
+                }
+                else if( _options & OpenRAVE::CO_AllLinkCollisions ) {
                     // We maintain vLinkColliding ordered
                     LinkPair linkPair = MakeLinkPair(plink1, plink2);
                     typedef std::vector< std::pair< LinkConstPtr, LinkConstPtr > >::iterator PairIterator;
@@ -1163,17 +1203,164 @@ private:
         return _CreateManagerFromBroadphaseAlgorithm(_broadPhaseCollisionManagerAlgorithm);
     }
 
+    /// \brief true if the algorithm of each manager is decided from its objects, which is the case for SpatialHashing and Auto
+    inline bool _IsAdaptiveBroadphase() const {
+        return _broadPhaseCollisionManagerAlgorithm == "Auto" || _broadPhaseCollisionManagerAlgorithm == "SpatialHashing";
+    }
+
+    /// \brief creates an empty manager instance
+    ///
+    /// For adaptive algorithms the manager starts as DynamicAABBTree2 since nothing is known about its objects yet
+    FCLCollisionManagerInstancePtr _CreateManagerInstance()
+    {
+        if( _IsAdaptiveBroadphase() ) {
+            return FCLCollisionManagerInstancePtr(new FCLCollisionManagerInstance(*_fclspace, _CreateManagerFromBroadphaseAlgorithm("DynamicAABBTree2"), "DynamicAABBTree2"));
+        }
+        return FCLCollisionManagerInstancePtr(new FCLCollisionManagerInstance(*_fclspace, _CreateManager(), _broadPhaseCollisionManagerAlgorithm));
+    }
+
+    /// \brief rebuilds the manager with spatial hashing whose cells are the size of the average object and whose scene limits contain all the objects
+    void _ReplaceWithSpatialHashingManager(FCLCollisionManagerInstance& manager, const fcl::AABB& bounds, fcl::FCL_REAL fmeanextent, size_t numobjects)
+    {
+        fcl::FCL_REAL fcellsize = std::max(fmeanextent, (fcl::FCL_REAL)s_fSpatialHashingMinCellSize);
+        fcl::Vec3f vpadding(fcellsize, fcellsize, fcellsize);
+        fcl::AABB limits(bounds.min_ - vpadding, bounds.max_ + vpadding);
+        unsigned int tablesize = std::max((unsigned int)1000, (unsigned int)(2*numobjects));
+        manager.ReplaceManager(boost::make_shared< fcl::SpatialHashingCollisionManager<> >(fcellsize, limits.min_, limits.max_, tablesize), "SpatialHashing");
+        manager.SetSpatialHashingParameters(limits, fcellsize);
+    }
+
+    /// \brief true if the objects of a spatial hashing manager left its scene limits or their mean extent drifted away from its cell size
+    ///
+    /// fcl tests the objects outside of the scene limits against all the others and cells much smaller or larger than the objects defeat the hashing.
+    bool _IsSpatialHashingOutdated(const FCLCollisionManagerInstance& manager, const fcl::AABB& bounds, fcl::FCL_REAL fmeanextent) const
+    {
+        if( !manager.GetSpatialHashingLimits().contain(bounds) ) {
+            return true;
+        }
+        fcl::FCL_REAL fcellsize = std::max(fmeanextent, (fcl::FCL_REAL)s_fSpatialHashingMinCellSize);
+        fcl::FCL_REAL fratio = fcellsize/manager.GetSpatialHashingCellSize();
+        return fratio > s_fSpatialHashingMaxCellSizeDrift || fratio*s_fSpatialHashingMaxCellSizeDrift < 1;
+    }
+
+    /// \brief chooses the broadphase algorithm of a manager from its statistics
+    ///
+    /// - few objects: Naive, building any structure costs more than testing all the pairs
+    /// - many objects of similar size that rarely move (bin items): SpatialHashing
+    /// - otherwise DynamicAABBTree2, which handles frequent updates well
+    /// \param fmeanextent mean of the largest AABB side of the objects
+    /// \param fmaxextent largest AABB side of all the objects
+    std::string _ChooseBroadphaseAlgorithm(const FCLCollisionManagerInstance::BroadphaseStatistics& stats, size_t numobjects, fcl::FCL_REAL fmeanextent, fcl::FCL_REAL fmaxextent) const
+    {
+        if( _broadPhaseCollisionManagerAlgorithm != "Auto" ) {
+            return _broadPhaseCollisionManagerAlgorithm;
+        }
+        if( numobjects <= s_nAutoNaiveMaxObjects ) {
+            return "Naive";
+        }
+        if( numobjects >= s_nAutoSpatialHashingMinObjects && stats.numqueries > 0 ) {
+            // fraction of the objects that are updated for every query
+            fcl::FCL_REAL fupdateratio = fcl::FCL_REAL(stats.numupdatedobjects)/(fcl::FCL_REAL(stats.numqueries)*numobjects);
+            // large objects like floors would be inserted into too many cells
+            fcl::FCL_REAL fcellsize = std::max(fmeanextent, (fcl::FCL_REAL)s_fSpatialHashingMinCellSize);
+            if( fupdateratio < s_fAutoSpatialHashingMaxUpdateRatio && fmaxextent <= s_fAutoSpatialHashingMaxCellsPerObject*fcellsize ) {
+                return "SpatialHashing";
+            }
+        }
+        return "DynamicAABBTree2";
+    }
+
+    /// \brief records a query on the manager and if the broadphase is adaptive, rebuilds it with another algorithm when its statistics call for it
+    ///
+    /// Spatial hashing managers are also rebuilt when their objects do not fit their scene limits and cell size anymore.
+    void _UpdateManagerBroadphase(FCLCollisionManagerInstance& manager)
+    {
+        manager.NotifyQuery();
+        if( !_IsAdaptiveBroadphase() ) {
+            return;
+        }
+
+        const FCLCollisionManagerInstance::BroadphaseStatistics& stats = manager.GetStatistics();
+        if( _broadPhaseCollisionManagerAlgorithm == "SpatialHashing" && manager.GetBroadphaseAlgorithm() != "SpatialHashing" ) {
+            // build as soon as the cells can be sized
+            if( manager.GetManager()->size() == 0 ) {
+                return;
+            }
+        }
+        else if( stats.numqueries < s_nAutoMinQueries || (stats.numqueries < s_nAutoMaxQueries && OpenRAVE::utils::GetMilliTime() - stats.starttime < s_nAutoWindowMS) ) {
+            return;
+        }
+
+        fcl::AABB bounds;
+        fcl::FCL_REAL fmeanextent = 0, fmaxextent = 0;
+        size_t numobjects = manager.GetObjectsAABB(bounds, fmeanextent, fmaxextent);
+        std::string algorithm = _ChooseBroadphaseAlgorithm(stats, numobjects, fmeanextent, fmaxextent);
+        if( algorithm != manager.GetBroadphaseAlgorithm() ) {
+            RAVELOG_VERBOSE_FORMAT("env=%d, rebuilding broadphase manager %x from %s to %s, numobjects=%d, queries=%d, updatedobjects=%d", GetEnv()->GetId()%(&manager)%manager.GetBroadphaseAlgorithm()%algorithm%numobjects%stats.numqueries%stats.numupdatedobjects);
+            if( algorithm == "SpatialHashing" ) {
+                _ReplaceWithSpatialHashingManager(manager, bounds, fmeanextent, numobjects);
+            }
+            else {
+                manager.ReplaceManager(_CreateManagerFromBroadphaseAlgorithm(algorithm), algorithm);
+            }
+        }
+        else if( algorithm == "SpatialHashing" && numobjects > 0 && _IsSpatialHashingOutdated(manager, bounds, fmeanextent) ) {
+            RAVELOG_VERBOSE_FORMAT("env=%d, resizing spatial hashing manager %x, numobjects=%d, cellsize=%f, meanextent=%f", GetEnv()->GetId()%(&manager)%numobjects%manager.GetSpatialHashingCellSize()%fmeanextent);
+            _ReplaceWithSpatialHashingManager(manager, bounds, fmeanextent, numobjects);
+        }
+        manager.ResetStatistics();
+    }
+
+    /// \brief collides all the objects of two managers
+    ///
+    /// fcl managers can only be collided against managers of their own type, so when the algorithms differ the objects of the smaller manager are queried one by one
+    void _CollideManagers(FCLCollisionManagerInstance& manager1, FCLCollisionManagerInstance& manager2, CollisionCallbackData& query)
+    {
+        if( manager1.GetBroadphaseAlgorithm() == manager2.GetBroadphaseAlgorithm() ) {
+            manager1.GetManager()->collide(manager2.GetManager().get(), &query, &FCLCollisionChecker::CheckNarrowPhaseCollision);
+            return;
+        }
+
+        BroadPhaseCollisionManagerPtr psmallmanager = manager1.GetManager(), plargemanager = manager2.GetManager();
+        if( psmallmanager->size() > plargemanager->size() ) {
+            std::swap(psmallmanager, plargemanager);
+        }
+        _vCachedManagerObjects.resize(0);
+        psmallmanager->getObjects(_vCachedManagerObjects);
+        FOREACH(itobj, _vCachedManagerObjects) {
+            plargemanager->collide(*itobj, &query, &FCLCollisionChecker::CheckNarrowPhaseCollision);
+            if( query._bStopChecking ) {
+                break;
+            }
+        }
+    }
+
+    void _WriteBroadphaseStatistics(ostream& sout, const char* type, const FCLCollisionManagerInstance& manager, uint32_t curtime) const
+    {
+        const FCLCollisionManagerInstance::BroadphaseStatistics& stats = manager.GetStatistics();
+        sout << type << " " << manager.GetBroadphaseAlgorithm() << " " << manager.GetManager()->size() << " " << stats.numqueries << " " << stats.numsynchronizations << " " << stats.numupdatedobjects << " " << (curtime - stats.starttime);
+        if( manager.GetSpatialHashingCellSize() > 0 ) {
+            const fcl::AABB& limits = manager.GetSpatialHashingLimits();
+            sout << " " << manager.GetSpatialHashingCellSize() << " " << limits.min_[0] << " " << limits.min_[1] << " " << limits.min_[2] << " " << limits.max_[0] << " " << limits.max_[1] << " " << limits.max_[2];
+        }
+        else {
+            sout << " 0 0 0 0 0 0 0";
+        }
+        sout << std::endl;
+    }
+
     FCLCollisionManagerInstance& _GetBodyManager(KinBodyConstPtr pbody, bool bactiveDOFs)
     {
         _bParentlessCollisionObject = false;
         BODYMANAGERSMAP::iterator it = _bodymanagers.find(std::make_pair(pbody.get(), (int)bactiveDOFs));
         if( it == _bodymanagers.end() ) {
-            FCLCollisionManagerInstancePtr p(new FCLCollisionManagerInstance(*_fclspace, _CreateManager()));
+            FCLCollisionManagerInstancePtr p = _CreateManagerInstance();
             p->InitBodyManager(pbody, bactiveDOFs);
             it = _bodymanagers.insert(BODYMANAGERSMAP::value_type(std::make_pair(pbody.get(), (int)bactiveDOFs), p)).first;
         }
 
         it->second->Synchronize();
+        _UpdateManagerBroadphase(*it->second);
         //RAVELOG_VERBOSE_FORMAT("env=%d, returning body manager cache %x (self=%d)", GetEnv()->GetId()%it->second.get()%_bIsSelfCollisionChecker);
         //it->second->PrintStatus(OpenRAVE::Level_Info);
         return *it->second;
@@ -1205,12 +1392,13 @@ private:
 
         std::map<std::set<int>, FCLCollisionManagerInstancePtr>::iterator it = _envmanagers.find(setExcludeBodyIds);
         if( it == _envmanagers.end() ) {
-            FCLCollisionManagerInstancePtr p(new FCLCollisionManagerInstance(*_fclspace, _CreateManager()));
+            FCLCollisionManagerInstancePtr p = _CreateManagerInstance();
             p->InitEnvironment(excludedbodies);
             it = _envmanagers.insert(std::map<std::set<int>, FCLCollisionManagerInstancePtr>::value_type(setExcludeBodyIds, p)).first;
         }
         it->second->EnsureBodies(_fclspace->GetEnvBodies());
         it->second->Synchronize();
+        _UpdateManagerBroadphase(*it->second);
         //it->second->PrintStatus(OpenRAVE::Level_Info);
         //RAVELOG_VERBOSE_FORMAT("env=%d, returning env manager cache %x (self=%d)", GetEnv()->GetId()%it->second.get()%_bIsSelfCollisionChecker);
         return *it->second;
@@ -1291,6 +1479,18 @@ private:
     BODYMANAGERSMAP _bodymanagers; ///< managers for each of the individual bodies. each manager should be called with InitBodyManager. Cannot use KinBodyPtr here since that will maintain a reference to the body!
     std::map< std::set<int>, FCLCollisionManagerInstancePtr> _envmanagers;
     int _nGetEnvManagerCacheClearCount; ///< count down until cache can be cleared
+    CollisionGroup _vCachedManagerObjects; ///< cache for _CollideManagers
+
+    // parameters of the adaptive broadphase selection
+    static const size_t s_nAutoNaiveMaxObjects = 12; ///< managers with at most this many objects use Naive
+    static const size_t s_nAutoSpatialHashingMinObjects = 500; ///< managers need at least this many objects to use SpatialHashing
+    static const uint32_t s_nAutoMinQueries = 32; ///< minimum number of queries before the algorithm of a manager is re-evaluated
+    static const uint32_t s_nAutoMaxQueries = 4096; ///< re-evaluate after this many queries even if s_nAutoWindowMS has not elapsed
+    static const uint32_t s_nAutoWindowMS = 1000; ///< time window (ms) of the statistics used for re-evaluating
+    static constexpr fcl::FCL_REAL s_fAutoSpatialHashingMaxUpdateRatio = 0.05; ///< SpatialHashing is only used if fewer than this fraction of the objects are updated per query
+    static constexpr fcl::FCL_REAL s_fAutoSpatialHashingMaxCellsPerObject = 16; ///< SpatialHashing is not used if an object spans more cells than this along one axis
+    static constexpr fcl::FCL_REAL s_fSpatialHashingMinCellSize = 0.001; ///< lower bound of the spatial hashing cell size
+    static constexpr fcl::FCL_REAL s_fSpatialHashingMaxCellSizeDrift = 2; ///< spatial hashing managers are rebuilt when the mean object extent grows or shrinks by more than this factor from their cell size
 
 #ifdef FCLRAVE_COLLISION_OBJECTS_STATISTICS
     std::map<fcl::CollisionObject*, int> _currentlyused;
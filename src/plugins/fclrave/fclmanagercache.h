@@ -95,8 +95,20 @@ class FCLCollisionManagerInstance : public boost::enable_shared_from_this<FCLCol
     };
 
 public:
-    FCLCollisionManagerInstance(FCLSpace& fclspace, BroadPhaseCollisionManagerPtr pmanager) : _fclspace(fclspace), pmanager(pmanager) {
+    /// \brief usage statistics of the manager, used to choose its broadphase algorithm
+    struct BroadphaseStatistics
+    {
+        BroadphaseStatistics() : numqueries(0), numsynchronizations(0), numupdatedobjects(0), starttime(0) {
+        }
+        uint32_t numqueries; ///< number of times the manager was requested for a collision query
+        uint32_t numsynchronizations; ///< number of synchronizations that had to change the manager
+        uint32_t numupdatedobjects; ///< number of collision objects that were registered or updated by the synchronizations
+        uint32_t starttime; ///< timestamp (ms) when the statistics were reset
+    };
+
+    FCLCollisionManagerInstance(FCLSpace& fclspace, BroadPhaseCollisionManagerPtr pmanager, const std::string& broadphasealgorithm) : _fclspace(fclspace), pmanager(pmanager), _broadphasealgorithm(broadphasealgorithm), _fSpatialHashingCellSize(0) {
         _lastSyncTimeStamp = OpenRAVE::utils::GetMilliTime();
+        _statistics.starttime = _lastSyncTimeStamp;
     }
     ~FCLCollisionManagerInstance() {
         if( _tmpbuffer.size() > 0 ) {
@@ -301,6 +313,7 @@ public:
         _tmpbuffer.resize(0);
         _lastSyncTimeStamp = OpenRAVE::utils::GetMilliTime();
         bool bcallsetup = false;
+        uint32_t numupdatedobjects = 0;
         bool bAttachedBodiesChanged = false;
         KinBodyConstPtr ptrackingbody = _ptrackingbody.lock();
         if( !!ptrackingbody && _bTrackActiveDOF ) {
@@ -613,6 +626,7 @@ public:
                             }
 
                             bcallsetup = true;
+                            ++numupdatedobjects;
                             itcache->second.vcolobjs.at(ilink) = pcolobj;
                         }
                         else {
@@ -692,16 +706,110 @@ public:
             SaveCollisionObjectDebugInfos();
 #endif
             pmanager->registerObjects(_tmpbuffer); // bulk update
+            numupdatedobjects += _tmpbuffer.size();
         }
         if( bcallsetup ) {
             pmanager->setup();
         }
+        if( bcallsetup || numupdatedobjects > 0 ) {
+            _statistics.numsynchronizations++;
+            _statistics.numupdatedobjects += numupdatedobjects;
+        }
     }
 
     inline BroadPhaseCollisionManagerPtr GetManager() const {
         return pmanager;
     }
 
+    /// \brief name of the broadphase algorithm the current manager was created with
+    inline const std::string& GetBroadphaseAlgorithm() const {
+        return _broadphasealgorithm;
+    }
+
+    /// \brief replaces the broadphase manager with pnewmanager, moving all the registered collision objects into it
+    ///
+    /// The cached bodies stay valid since they only refer to the collision objects.
+    void ReplaceManager(BroadPhaseCollisionManagerPtr pnewmanager, const std::string& broadphasealgorithm)
+    {
+        CollisionGroup vobjects;
+        pmanager->getObjects(vobjects);
+        pmanager->clear();
+        pmanager = pnewmanager;
+        pmanager->clear();
+        if( vobjects.size() > 0 ) {
+            pmanager->registerObjects(vobjects);
+        }
+        pmanager->setup();
+        _broadphasealgorithm = broadphasealgorithm;
+        _spatialHashingLimits = fcl::AABB();
+        _fSpatialHashingCellSize = 0;
+    }
+
+    /// \brief records the scene limits and cell size the current spatial hashing manager was created with
+    inline void SetSpatialHashingParameters(const fcl::AABB& limits, fcl::FCL_REAL fcellsize) {
+        _spatialHashingLimits = limits;
+        _fSpatialHashingCellSize = fcellsize;
+    }
+
+    /// \brief scene limits of the current spatial hashing manager, objects outside of them are tested against everything
+    inline const fcl::AABB& GetSpatialHashingLimits() const {
+        return _spatialHashingLimits;
+    }
+
+    /// \brief cell size of the current spatial hashing manager, 0 if it is not a spatial hashing manager
+    inline fcl::FCL_REAL GetSpatialHashingCellSize() const {
+        return _fSpatialHashingCellSize;
+    }
+
+    /// \brief computes the bounding box of all the objects registered in the manager and their mean extent
+    ///
+    /// \param fmeanextent the mean over the objects of the largest side of their AABB
+    /// \param fmaxextent the largest side of the AABBs of all the objects
+    /// \return the number of registered objects
+    size_t GetObjectsAABB(fcl::AABB& bounds, fcl::FCL_REAL& fmeanextent, fcl::FCL_REAL& fmaxextent) const
+    {
+        CollisionGroup vobjects;
+        pmanager->getObjects(vobjects);
+        bounds = fcl::AABB();
+        fmeanextent = 0;
+        fmaxextent = 0;
+        size_t numobjects = 0;
+        FOREACHC(itobj, vobjects) {
+            if( !*itobj ) {
+                continue;
+            }
+            const fcl::AABB& ab = (*itobj)->getAABB();
+            if( numobjects == 0 ) {
+                bounds = ab;
+            }
+            else {
+                bounds += ab;
+            }
+            fcl::FCL_REAL fextent = std::max(ab.width(), std::max(ab.height(), ab.depth()));
+            fmeanextent += fextent;
+            fmaxextent = std::max(fmaxextent, fextent);
+            ++numobjects;
+        }
+        if( numobjects > 0 ) {
+            fmeanextent /= numobjects;
+        }
+        return numobjects;
+    }
+
+    /// \brief called every time the manager is used for a collision query
+    inline void NotifyQuery() {
+        _statistics.numqueries++;
+    }
+
+    inline const BroadphaseStatistics& GetStatistics() const {
+        return _statistics;
+    }
+
+    inline void ResetStatistics() {
+        _statistics = BroadphaseStatistics();
+        _statistics.starttime = OpenRAVE::utils::GetMilliTime();
+    }
+
     inline uint32_t GetLastSyncTimeStamp() const {
         return _lastSyncTimeStamp;
     }
@@ -813,6 +921,11 @@ private:
 
     bool _bTrackActiveDOF; ///< if true and _ptrackingbody is valid, then should be tracking the active dof of the _ptrackingbody
 
+    std::string _broadphasealgorithm; ///< broadphase algorithm pmanager was created with
+    BroadphaseStatistics _statistics; ///< usage statistics since the last reset
+    fcl::AABB _spatialHashingLimits; ///< scene limits pmanager was created with if it is a spatial hashing manager
+    fcl::FCL_REAL _fSpatialHashingCellSize; ///< cell size pmanager was created with if it is a spatial hashing manager, otherwise 0
+
 #ifdef FCLRAVE_DEBUG_COLLISION_OBJECTS
     void SaveCollisionObjectDebugInfos() {
         FOREACH(itpcollobj, _tmpbuffer) {
@@ -102,6 +102,7 @@ using OpenRAVE::AttributesList;
 #include <fcl/collision.h>
 #include <fcl/BVH/BVH_model.h>
 #include <fcl/broadphase/broadphase.h>
+#include <fcl/broadphase/broadphase_spatialhash.h>
 #include <fcl/shape/geometric_shapes.h>
 
 #endif
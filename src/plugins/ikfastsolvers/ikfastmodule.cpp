@@ -21,6 +21,7 @@
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/version.hpp>
+#include <boost/atomic.hpp>
 
 // used for inverse jacobian computation
 #include <boost/numeric/ublas/vector.hpp>
@@ -320,6 +321,9 @@ private:
 public:
     IkFastModule(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
     {
+#ifdef Boost_IOSTREAMS_FOUND
+        _bDestroyed = false;
+#endif
         __description = ":Interface Author: Rosen Diankov\n\nAllows dynamic loading and registering of ikfast shared objects to openrave plugins.\nAlso contains several test routines for inverse kinematics.";
         RegisterCommand("AddIkLibrary",boost::bind(&IkFastModule::AddIkLibrary,this,_1,_2),
                         "Dynamically adds an ik solver to openrave by loading a shared object (based on ikfast code generation).\n"
@@ -333,8 +337,12 @@ public:
 
         RegisterCommand("LoadIKFastSolver",boost::bind(&IkFastModule::LoadIKFastSolver,this,_1,_2),
                         "Dynamically calls the inversekinematics.py script to generate an ik solver for a robot, or to load an existing one\n"
-                        "Usage::\n\n  LoadIKFastSolver robotname iktype_id [free increment]\n\n"
+                        "Usage::\n\n  LoadIKFastSolver robotname iktype_id [forceik] [nonblocking]\n\n"
+                        "If nonblocking is 1 and the solver has to be generated, generates it in the background and sets a numerical damped least squares solver on the manipulator meanwhile. The generated solver replaces it once loaded, see GetIKFastGenerationStatus.\n"
                         "return nothing, but does call the SetIKSolver for the robot");
+        RegisterCommand("GetIKFastGenerationStatus",boost::bind(&IkFastModule::_GetIKFastGenerationStatusCommand,this,_1,_2),
+                        "Reports the ikfast generations started by LoadIKFastSolver with nonblocking set.\n"
+                        "return a line for every generation: robotname manipname iktype status elapsedtime lastoutputline. status is 0 while running, 1 when the solver was loaded and 2 if the generation failed.");
 #endif
         RegisterCommand("PerfTiming",boost::bind(&IkFastModule::PerfTiming,this,_1,_2),
                         "Times the ik call of a given library.\n"
@@ -342,6 +350,13 @@ public:
                         "return the set of time measurements made in nano-seconds");
         RegisterCommand("IKTest",boost::bind(&IkFastModule::IKtest,this,_1,_2),
                         "Tests for an IK solution if active manipulation has an IK solver attached");
+        RegisterCommand("ComputeReachability",boost::bind(&IkFastModule::ComputeReachability,this,_1,_2),
+                        "Computes the ik reachability of end effector poses made of every point combined with every rotation, solving blocks of points in parallel on cloned environments.\n"
+                        "Usage::\n\n  ComputeReachability robot name [manip name] [numthreads N] [blocksize B] [filteroptions F] [usefreespace 0|1] [statsfile filename] rotations R qw qx qy qz ... points P x y z ...\n\n"
+                        "The points are world positions of the end effector and the rotations are quaternions. The current state of the environment is used.\n"
+                        "usefreespace counts all the ik solutions of a pose instead of only checking if one exists.\n"
+                        "If statsfile is set, writes a row of quaternion (4), translation (3) and number of solutions for every reachable pose, as little-endian float64 in the order of the points.\n\n"
+                        "return for every point the number of ik solutions over all the rotations and the number of rotations that have a solution");
         RegisterCommand("DebugIK",boost::bind(&IkFastModule::DebugIK,this,_1,_2),
                         "Function used for debugging and testing an IK solver. Input parameters are:\n\n\
 * string readfile - file containing joint values to read, starts with number of entries.\n\n\
@@ -352,6 +367,9 @@ public:
     }
 
     virtual ~IkFastModule() {
+#ifdef Boost_IOSTREAMS_FOUND
+        _bDestroyed = true;
+#endif
     }
 
     int main(const string& cmd)
@@ -378,6 +396,9 @@ public:
 
     virtual void Destroy()
     {
+#ifdef Boost_IOSTREAMS_FOUND
+        _bDestroyed = true;
+#endif
     }
 
     bool AddIkLibrary(ostream& sout, istream& sinput)
@@ -529,13 +550,14 @@ public:
         EnvironmentMutex::scoped_lock envlock(GetEnv()->GetMutex());
         string robotname;
         string striktype;
-        bool bForceIK = false;
+        bool bForceIK = false, bNonBlocking = false;
         sinput >> robotname;
         sinput >> striktype;
         if( !sinput ) {
             return false;
         }
         sinput >> bForceIK;     // optional
+        sinput >> bNonBlocking; // optional
         RobotBasePtr probot = GetEnv()->GetRobot(robotname);
         if( !probot || !probot->GetActiveManipulator() ) {
             return false;
@@ -567,67 +589,18 @@ public:
 
         string ikfilename;
         for(int iter = 0; iter < 2; ++iter) {
-            string ikfilenamefound;
-            // check if exists and is loadable, if not, regenerate the IK.
-            std::string ikfilenameprefix = str(boost::format("kinematics.%s/ikfast%s.%s.%s.")%pmanip->GetInverseKinematicsStructureHash(iktype)%_ikfastversion%striktype%_platform);
-            int ikdof = IkParameterization::GetDOF(iktype);
-            if( ikdof > pmanip->GetArmDOF() ) {
-                RAVELOG_WARN(str(boost::format("not enough joints (%d) for ik %s")%pmanip->GetArmIndices().size()%striktype));
-            }
-            if( ikdof < pmanip->GetArmDOF() ) {
-                std::vector<int> vindices = pmanip->GetArmIndices();
-                std::vector<int> vsolveindices(ikdof), vfreeindices(vindices.size()-ikdof);
-                do {
-                    std::copy(vindices.begin(),vindices.begin()+ikdof,vsolveindices.begin());
-                    sort(vsolveindices.begin(),vsolveindices.end());
-                    std::copy(vindices.begin()+ikdof,vindices.end(),vfreeindices.begin());
-                    sort(vfreeindices.begin(),vfreeindices.end());
-                    ikfilename=ikfilenameprefix;
-                    for(size_t i = 0; i < vsolveindices.size(); ++i) {
-                        ikfilename += boost::lexical_cast<std::string>(vsolveindices[i]);
-                        ikfilename += '_';
-                    }
-                    ikfilename += "f";
-                    for(size_t i = 0; i < vfreeindices.size(); ++i) {
-                        if( i > 0 ) {
-                            ikfilename += '_';
-                        }
-                        ikfilename += boost::lexical_cast<std::string>(vfreeindices[i]);
-                    }
-                    ikfilename += PLUGIN_EXT;
-                    ikfilenamefound = RaveFindDatabaseFile(ikfilename);
-                    if (ikfilenamefound.size() > 0 ) {
-                        break;
-                    }
-                } while (next_combination(&vindices[0], &vindices[ikdof], &vindices[vindices.size()]));
-            }
-            else {
-                ikfilename=ikfilenameprefix;
-                for(size_t i = 0; i < pmanip->GetArmIndices().size(); ++i) {
-                    if( i > 0 ) {
-                        ikfilename += '_';
-                    }
-                    ikfilename += boost::lexical_cast<std::string>(pmanip->GetArmIndices().at(i));
-                }
-                ikfilename += PLUGIN_EXT;
-                ikfilenamefound = RaveFindDatabaseFile(ikfilename);
-            }
-
+            string ikfilenamefound = _FindIkFastLibrary(pmanip, iktype, striktype, ikfilename);
             if( ikfilenamefound.size() == 0 ) {
                 if( iter > 0 ) {
                     RAVELOG_WARN(str(boost::format("failed to find ikfile: %s")%ikfilename));
                     return false;
                 }
 
-                // create a temporary file and store COLLADA kinematics representation
-                AttributesList atts;
-                atts.emplace_back("skipwrite", "visual readable sensors physics");
-                atts.emplace_back("target",  probot->GetName());
-                string tempfilename = RaveGetHomeDirectory() + str(boost::format("/testikfastrobot%d.dae")%(RaveRandomInt()%1000));
-                // file not found, so create
-                RAVELOG_INFO(str(boost::format("Generating inverse kinematics %s for manip %s:%s, hash=%s, saving intermediate data to %s, will take several minutes...\n")%striktype%probot->GetName()%pmanip->GetName()%pmanip->GetInverseKinematicsStructureHash(iktype)%tempfilename));
-                GetEnv()->Save(tempfilename,EnvironmentBase::SO_Body,atts);
-                string cmdgen = str(boost::format("openrave.py --database inversekinematics --usecached --robot=\"%s\" --manipname=%s --iktype=%s")%tempfilename%pmanip->GetName()%striktype);
+                string logfilename;
+                string cmdgen = _PrepareIkFastGeneration(probot, pmanip, iktype, striktype, logfilename);
+                if( bNonBlocking ) {
+                    return _StartIkFastGeneration(probot, pmanip, iktype, striktype, cmdgen, logfilename);
+                }
                 // use raw system call, popen causes weird crash in the inversekinematics compiler
                 int generateexit = system(cmdgen.c_str());
                 //FILE* pipe = MYPOPEN(cmdgen.c_str(), "r");
@@ -645,35 +618,246 @@ public:
                 return false;
             }
 
-            string ikfastname = str(boost::format("ikfast.%s.%s.%s")%pmanip->GetInverseKinematicsStructureHash(iktype)%striktype%pmanip->GetName());
-            boost::shared_ptr<IkLibrary> lib = _AddIkLibrary(ikfastname,ikfilenamefound);
-            bool bsuccess = true;
-            if( !lib ) {
-                bsuccess = false;
+            IkSolverBasePtr iksolver = _CreateIkFastSolver(pmanip, iktype, striktype, ikfilenamefound);
+            bool bsuccess = !!iksolver && pmanip->SetIkSolver(iksolver);
+            // if not forcing the ik, then return true as long as a valid ik solver is set
+            if( bForceIK && !bsuccess ) {
+                return false;
             }
-            else {
-                if( lib->GetIKType() != (int)iktype ) {
-                    bsuccess = false;
+            return !!pmanip->GetIkSolver() && pmanip->GetIkSolver()->Supports(iktype);
+        }
+
+        return false;
+    }
+
+    /// \brief searches the database for a compiled ikfast library of the manipulator
+    ///
+    /// \param[out] ikfilename the last file name that was searched for
+    /// \return the full path of the library, empty if none was found
+    string _FindIkFastLibrary(RobotBase::ManipulatorPtr pmanip, IkParameterizationType iktype, const string& striktype, string& ikfilename)
+    {
+        string ikfilenamefound;
+        // check if exists and is loadable, if not, regenerate the IK.
+        std::string ikfilenameprefix = str(boost::format("kinematics.%s/ikfast%s.%s.%s.")%pmanip->GetInverseKinematicsStructureHash(iktype)%_ikfastversion%striktype%_platform);
+        int ikdof = IkParameterization::GetDOF(iktype);
+        if( ikdof > pmanip->GetArmDOF() ) {
+            RAVELOG_WARN(str(boost::format("not enough joints (%d) for ik %s")%pmanip->GetArmIndices().size()%striktype));
+        }
+        if( ikdof < pmanip->GetArmDOF() ) {
+            std::vector<int> vindices = pmanip->GetArmIndices();
+            std::vector<int> vsolveindices(ikdof), vfreeindices(vindices.size()-ikdof);
+            do {
+                std::copy(vindices.begin(),vindices.begin()+ikdof,vsolveindices.begin());
+                sort(vsolveindices.begin(),vsolveindices.end());
+                std::copy(vindices.begin()+ikdof,vindices.end(),vfreeindices.begin());
+                sort(vfreeindices.begin(),vfreeindices.end());
+                ikfilename=ikfilenameprefix;
+                for(size_t i = 0; i < vsolveindices.size(); ++i) {
+                    ikfilename += boost::lexical_cast<std::string>(vsolveindices[i]);
+                    ikfilename += '_';
                 }
-                else {
-                    IkSolverBasePtr iksolver = RaveCreateIkSolver(GetEnv(),string("ikfast ")+ikfastname);
-                    if( !iksolver ) {
-                        RAVELOG_WARN(str(boost::format("failed to create ik solver %s!")%ikfastname));
-                        bsuccess = false;
+                ikfilename += "f";
+                for(size_t i = 0; i < vfreeindices.size(); ++i) {
+                    if( i > 0 ) {
+                        ikfilename += '_';
                     }
-                    else {
-                        bsuccess = pmanip->SetIkSolver(iksolver);
+                    ikfilename += boost::lexical_cast<std::string>(vfreeindices[i]);
+                }
+                ikfilename += PLUGIN_EXT;
+                ikfilenamefound = RaveFindDatabaseFile(ikfilename);
+                if (ikfilenamefound.size() > 0 ) {
+                    break;
+                }
+            } while (next_combination(&vindices[0], &vindices[ikdof], &vindices[vindices.size()]));
+        }
+        else {
+            ikfilename=ikfilenameprefix;
+            for(size_t i = 0; i < pmanip->GetArmIndices().size(); ++i) {
+                if( i > 0 ) {
+                    ikfilename += '_';
+                }
+                ikfilename += boost::lexical_cast<std::string>(pmanip->GetArmIndices().at(i));
+            }
+            ikfilename += PLUGIN_EXT;
+            ikfilenamefound = RaveFindDatabaseFile(ikfilename);
+        }
+        return ikfilenamefound;
+    }
+
+    /// \brief loads the library and creates its solver, returns an empty pointer if the library does not solve iktype
+    IkSolverBasePtr _CreateIkFastSolver(RobotBase::ManipulatorPtr pmanip, IkParameterizationType iktype, const string& striktype, const string& ikfilenamefound)
+    {
+        string ikfastname = str(boost::format("ikfast.%s.%s.%s")%pmanip->GetInverseKinematicsStructureHash(iktype)%striktype%pmanip->GetName());
+        boost::shared_ptr<IkLibrary> lib = _AddIkLibrary(ikfastname,ikfilenamefound);
+        if( !lib || lib->GetIKType() != (int)iktype ) {
+            return IkSolverBasePtr();
+        }
+        IkSolverBasePtr iksolver = RaveCreateIkSolver(GetEnv(),string("ikfast ")+ikfastname);
+        if( !iksolver ) {
+            RAVELOG_WARN(str(boost::format("failed to create ik solver %s!")%ikfastname));
+        }
+        return iksolver;
+    }
+
+    /// \brief saves the COLLADA kinematics of the robot to a temporary file and returns the command that generates the ik from it
+    ///
+    /// \param[out] logfilename the file the output of the command should be redirected to
+    string _PrepareIkFastGeneration(RobotBasePtr probot, RobotBase::ManipulatorPtr pmanip, IkParameterizationType iktype, const string& striktype, string& logfilename)
+    {
+        // create a temporary file and store COLLADA kinematics representation
+        AttributesList atts;
+        atts.emplace_back("skipwrite", "visual readable sensors physics");
+        atts.emplace_back("target",  probot->GetName());
+        string tempfilename = RaveGetHomeDirectory() + str(boost::format("/testikfastrobot%d.dae")%(RaveRandomInt()%1000));
+        logfilename = tempfilename + ".log";
+        // file not found, so create
+        RAVELOG_INFO(str(boost::format("Generating inverse kinematics %s for manip %s:%s, hash=%s, saving intermediate data to %s, will take several minutes...\n")%striktype%probot->GetName()%pmanip->GetName()%pmanip->GetInverseKinematicsStructureHash(iktype)%tempfilename));
+        GetEnv()->Save(tempfilename,EnvironmentBase::SO_Body,atts);
+        return str(boost::format("openrave.py --database inversekinematics --usecached --robot=\"%s\" --manipname=%s --iktype=%s")%tempfilename%pmanip->GetName()%striktype);
+    }
+
+    /// \brief an ikfast generation running in the background
+    class IkFastGeneration
+    {
+public:
+        IkFastGeneration() : iktype(IKP_None), starttime(0), status(GS_Running) {
+        }
+
+        enum GenerationStatus
+        {
+            GS_Running = 0,
+            GS_Loaded = 1, ///< the compiled solver was loaded
+            GS_Failed = 2,
+        };
+
+        string robotname, manipname, striktype;
+        IkParameterizationType iktype;
+        string logfilename; ///< holds the output of the generation
+        uint32_t starttime; ///< ms
+        IkSolverBasePtr pfallbacksolver; ///< the numerical solver set on the manipulator while generating, replaced once the compiled solver is loaded
+        GenerationStatus status; ///< protected by _mutexGenerations
+    };
+    typedef boost::shared_ptr<IkFastGeneration> IkFastGenerationPtr;
+
+    /// \brief runs cmdgen in a background thread and sets a numerical solver on the manipulator until it finishes
+    ///
+    /// If a generation of the same ik is already running, only sets the numerical solver.
+    /// \return true if the manipulator has a solver supporting iktype
+    bool _StartIkFastGeneration(RobotBasePtr probot, RobotBase::ManipulatorPtr pmanip, IkParameterizationType iktype, const string& striktype, const string& cmdgen, const string& logfilename)
+    {
+        IkFastGenerationPtr generation;
+        {
+            boost::mutex::scoped_lock lock(_mutexGenerations);
+            FOREACH(itgeneration, _listGenerations) {
+                if( (*itgeneration)->status == IkFastGeneration::GS_Running && (*itgeneration)->robotname == probot->GetName() && (*itgeneration)->manipname == pmanip->GetName() && (*itgeneration)->iktype == iktype ) {
+                    generation = *itgeneration;
+                    break;
+                }
+            }
+            if( !generation ) {
+                generation.reset(new IkFastGeneration());
+                generation->robotname = probot->GetName();
+                generation->manipname = pmanip->GetName();
+                generation->striktype = striktype;
+                generation->iktype = iktype;
+                generation->logfilename = logfilename;
+                generation->starttime = utils::GetMilliTime();
+                _listGenerations.push_back(generation);
+                // the thread is detached and only holds a weak pointer so that destroying the module does not wait for the generation
+                boost::thread(boost::bind(&IkFastModule::_GenerateIkFastThread, boost::weak_ptr<IkFastModule>(shared_problem()), generation, cmdgen + str(boost::format(" > \"%s\" 2>&1")%logfilename)));
+            }
+        }
+
+        if( !pmanip->GetIkSolver() || !pmanip->GetIkSolver()->Supports(iktype) ) {
+            IkSolverBasePtr pfallbacksolver = RaveCreateIkSolver(GetEnv(), "numericalik");
+            if( !!pfallbacksolver && pmanip->SetIkSolver(pfallbacksolver) ) {
+                if( pfallbacksolver->Supports(iktype) ) {
+                    RAVELOG_INFO_FORMAT("env=%d, using numerical ik for %s:%s until the ikfast generation finishes", GetEnv()->GetId()%probot->GetName()%pmanip->GetName());
+                }
+                boost::mutex::scoped_lock lock(_mutexGenerations);
+                generation->pfallbacksolver = pfallbacksolver;
+            }
+        }
+        return !!pmanip->GetIkSolver() && pmanip->GetIkSolver()->Supports(iktype);
+    }
+
+    static void _GenerateIkFastThread(boost::weak_ptr<IkFastModule> pweakmodule, IkFastGenerationPtr generation, string cmdgen)
+    {
+        // use raw system call, popen causes weird crash in the inversekinematics compiler
+        int generateexit = system(cmdgen.c_str());
+        boost::shared_ptr<IkFastModule> pmodule = pweakmodule.lock();
+        if( !!pmodule ) {
+            pmodule->_FinishIkFastGeneration(generation, generateexit);
+        }
+    }
+
+    /// \brief loads the generated solver and replaces the numerical solver with it
+    void _FinishIkFastGeneration(IkFastGenerationPtr generation, int generateexit)
+    {
+        IkFastGeneration::GenerationStatus status = IkFastGeneration::GS_Failed;
+        if( !_bDestroyed ) {
+            // EnvironmentBase::Destroy destroys the modules before it locks the environment, so once the lock is
+            // acquired _bDestroyed tells if the environment is going away and the solver should not be loaded
+            EnvironmentMutex::scoped_lock envlock(GetEnv()->GetMutex());
+            if( _bDestroyed ) {
+                boost::mutex::scoped_lock lock(_mutexGenerations);
+                generation->status = status;
+                generation->pfallbacksolver.reset();
+                return;
+            }
+            RobotBasePtr probot = GetEnv()->GetRobot(generation->robotname);
+            RobotBase::ManipulatorPtr pmanip;
+            if( !!probot ) {
+                pmanip = probot->GetManipulator(generation->manipname);
+            }
+            string ikfilename, ikfilenamefound;
+            if( !!pmanip ) {
+                ikfilenamefound = _FindIkFastLibrary(pmanip, generation->iktype, generation->striktype, ikfilename);
+            }
+            IkSolverBasePtr iksolver;
+            if( ikfilenamefound.size() > 0 ) {
+                iksolver = _CreateIkFastSolver(pmanip, generation->iktype, generation->striktype, ikfilenamefound);
+            }
+            if( !!iksolver ) {
+                // the user might have set another solver in the meantime
+                if( !pmanip->GetIkSolver() || pmanip->GetIkSolver() == generation->pfallbacksolver ) {
+                    if( pmanip->SetIkSolver(iksolver) ) {
+                        status = IkFastGeneration::GS_Loaded;
                     }
                 }
+                else {
+                    status = IkFastGeneration::GS_Loaded;
+                }
             }
-            // if not forcing the ik, then return true as long as a valid ik solver is set
-            if( bForceIK && !bsuccess ) {
-                return false;
+            if( status == IkFastGeneration::GS_Loaded ) {
+                RAVELOG_INFO_FORMAT("env=%d, loaded the generated ikfast %s for %s:%s after %fs", GetEnv()->GetId()%generation->striktype%generation->robotname%generation->manipname%(0.001*(utils::GetMilliTime()-generation->starttime)));
+            }
+            else {
+                RAVELOG_WARN_FORMAT("env=%d, ikfast generation of %s for %s:%s failed with exit code %d, see %s", GetEnv()->GetId()%generation->striktype%generation->robotname%generation->manipname%generateexit%generation->logfilename);
             }
-            return !!pmanip->GetIkSolver() && pmanip->GetIkSolver()->Supports(iktype);
         }
+        boost::mutex::scoped_lock lock(_mutexGenerations);
+        generation->status = status;
+        generation->pfallbacksolver.reset();
+    }
 
-        return false;
+    bool _GetIKFastGenerationStatusCommand(ostream& sout, istream& sinput)
+    {
+        boost::mutex::scoped_lock lock(_mutexGenerations);
+        FOREACHC(itgeneration, _listGenerations) {
+            const IkFastGeneration& generation = **itgeneration;
+            // the last line of the output shows how far the generation is
+            string line, lastline;
+            ifstream logfile(generation.logfilename.c_str());
+            while( !!getline(logfile, line) ) {
+                boost::trim(line);
+                if( line.size() > 0 ) {
+                    lastline = line;
+                }
+            }
+            sout << generation.robotname << " " << generation.manipname << " " << generation.striktype << " " << (int)generation.status << " " << (0.001*(utils::GetMilliTime()-generation.starttime)) << " " << lastline << endl;
+        }
+        return true;
     }
 
     /// \brief makes sure ikfast version is already retrieved
@@ -895,6 +1079,230 @@ public:
         return true;
     }
 
+    /// \brief shared state of the threads of ComputeReachability
+    struct ReachabilityContext
+    {
+        ReachabilityContext() : filteroptions(0), bUseFreeSpace(false), blocksize(16), nextblock(0), nextblocktowrite(0), pstatsfile(NULL) {
+        }
+
+        std::vector<Vector> vpoints;
+        std::vector<Vector> vrotations; ///< quaternions
+        int filteroptions;
+        bool bUseFreeSpace;
+        size_t blocksize; ///< number of points a thread takes at a time
+
+        std::vector<int> vnumsolutions, vnumrotations; ///< results of every point, every point is written by one thread only
+        boost::mutex mutex; ///< protects nextblock and the writing of the stats
+        size_t nextblock;
+        size_t nextblocktowrite;
+        std::map<size_t, std::vector<double> > mapblockstats; ///< finished blocks waiting for the previous blocks to be written
+        std::ostream* pstatsfile;
+    };
+
+    bool ComputeReachability(ostream& sout, istream& sinput)
+    {
+        EnvironmentMutex::scoped_lock lock(GetEnv()->GetMutex());
+        ReachabilityContext context;
+        RobotBasePtr robot;
+        RobotBase::ManipulatorPtr pmanip;
+        int numthreads = 0;
+        string cmd, statsfilename;
+        while(!sinput.eof()) {
+            sinput >> cmd;
+            if( !sinput ) {
+                break;
+            }
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+            if( cmd == "robot" ) {
+                string name;
+                sinput >> name;
+                robot = GetEnv()->GetRobot(name);
+                if( !robot ) {
+                    RAVELOG_WARN_FORMAT("robot %s not found", name);
+                    return false;
+                }
+                pmanip = robot->GetActiveManipulator();
+            }
+            else if( cmd == "manip" ) {
+                string name;
+                sinput >> name;
+                if( !!robot ) {
+                    pmanip = robot->GetManipulator(name);
+                }
+            }
+            else if( cmd == "numthreads" ) {
+                sinput >> numthreads;
+            }
+            else if( cmd == "blocksize" ) {
+                sinput >> context.blocksize;
+            }
+            else if( cmd == "filteroptions" ) {
+                sinput >> context.filteroptions;
+            }
+            else if( cmd == "usefreespace" ) {
+                sinput >> context.bUseFreeSpace;
+            }
+            else if( cmd == "statsfile" ) {
+                sinput >> statsfilename;
+            }
+            else if( cmd == "rotations" ) {
+                size_t numrotations = 0;
+                sinput >> numrotations;
+                context.vrotations.resize(numrotations);
+                FOREACH(itrotation, context.vrotations) {
+                    sinput >> itrotation->x >> itrotation->y >> itrotation->z >> itrotation->w;
+                }
+            }
+            else if( cmd == "points" ) {
+                size_t numpoints = 0;
+                sinput >> numpoints;
+                context.vpoints.resize(numpoints);
+                FOREACH(itpoint, context.vpoints) {
+                    sinput >> itpoint->x >> itpoint->y >> itpoint->z;
+                }
+            }
+            else {
+                RAVELOG_WARN(str(boost::format("unrecognized command: %s\n")%cmd));
+                return false;
+            }
+
+            if( !sinput ) {
+                RAVELOG_ERROR(str(boost::format("failed processing command %s\n")%cmd));
+                return false;
+            }
+        }
+
+        if( !pmanip || !pmanip->GetIkSolver() || context.vrotations.size() == 0 ) {
+            RAVELOG_WARN("ComputeReachability needs a manipulator with an ik solver and at least one rotation\n");
+            return false;
+        }
+        if( numthreads <= 0 ) {
+            numthreads = std::max(1, (int)boost::thread::hardware_concurrency());
+        }
+        context.blocksize = std::max(context.blocksize, (size_t)1);
+        size_t numblocks = (context.vpoints.size()+context.blocksize-1)/context.blocksize;
+        numthreads = (int)std::min((size_t)numthreads, std::max(numblocks, (size_t)1));
+        context.vnumsolutions.resize(context.vpoints.size(), 0);
+        context.vnumrotations.resize(context.vpoints.size(), 0);
+
+        std::ofstream statsfile;
+        if( statsfilename.size() > 0 ) {
+            statsfile.open(statsfilename.c_str(), std::ios::out|std::ios::binary|std::ios::trunc);
+            if( !statsfile ) {
+                RAVELOG_WARN_FORMAT("failed to open %s", statsfilename);
+                return false;
+            }
+            context.pstatsfile = &statsfile;
+        }
+
+        RAVELOG_DEBUG_FORMAT("env=%d, computing reachability of %d points with %d rotations on %d threads", GetEnv()->GetId()%context.vpoints.size()%context.vrotations.size()%numthreads);
+        if( numthreads <= 1 ) {
+            RobotBase::RobotStateSaver saver(robot);
+            _ComputeReachabilityThread(boost::ref(context), pmanip);
+        }
+        else {
+            // every thread solves on its own copy of the environment with its own ik solver
+            std::vector<EnvironmentBasePtr> vcloneenvs;
+            std::vector< boost::function<void()> > vtasks;
+            IkSolverBasePtr psolver = pmanip->GetIkSolver();
+            try {
+                for(int ithread = 0; ithread < numthreads; ++ithread) {
+                    EnvironmentBasePtr pcloneenv = GetEnv()->CloneSelf(Clone_Bodies);
+                    vcloneenvs.push_back(pcloneenv);
+                    RobotBase::ManipulatorPtr pclonemanip = pcloneenv->GetRobot(robot->GetName())->GetManipulator(pmanip->GetName());
+                    IkSolverBasePtr pclonesolver = RaveCreateIkSolver(pcloneenv, psolver->GetXMLId());
+                    pclonesolver->Clone(psolver, 0);
+                    pclonemanip->SetIkSolver(pclonesolver);
+                    vtasks.push_back(boost::bind(&IkFastModule::_ComputeReachabilityThread, this, boost::ref(context), pclonemanip));
+                }
+                utils::ThreadPool pool(numthreads);
+                pool.RunTasks(vtasks);
+            }
+            catch(...) {
+                vtasks.clear();
+                FOREACH(itenv, vcloneenvs) {
+                    (*itenv)->Destroy();
+                }
+                throw;
+            }
+            vtasks.clear();
+            FOREACH(itenv, vcloneenvs) {
+                (*itenv)->Destroy();
+            }
+        }
+
+        for(size_t ipoint = 0; ipoint < context.vpoints.size(); ++ipoint) {
+            sout << context.vnumsolutions[ipoint] << " " << context.vnumrotations[ipoint] << " ";
+        }
+        return true;
+    }
+
+    /// \brief solves blocks of points of context until all are taken, writes the stats of the finished blocks in order
+    void _ComputeReachabilityThread(ReachabilityContext& context, RobotBase::ManipulatorPtr pmanip)
+    {
+        EnvironmentMutex::scoped_lock lock(pmanip->GetRobot()->GetEnv()->GetMutex());
+        std::vector<dReal> vsolution;
+        std::vector< std::vector<dReal> > vsolutions;
+        std::vector<double> vstats;
+        while(1) {
+            size_t iblock;
+            {
+                boost::mutex::scoped_lock lockcontext(context.mutex);
+                iblock = context.nextblock++;
+            }
+            size_t istart = iblock*context.blocksize;
+            if( istart >= context.vpoints.size() ) {
+                break;
+            }
+            size_t iend = std::min(istart+context.blocksize, context.vpoints.size());
+            vstats.resize(0);
+            for(size_t ipoint = istart; ipoint < iend; ++ipoint) {
+                int numsolutions = 0, numrotations = 0;
+                FOREACHC(itrotation, context.vrotations) {
+                    Transform t(*itrotation, context.vpoints[ipoint]);
+                    IkParameterization ikparam(t, IKP_Transform6D);
+                    int numposesolutions = 0;
+                    if( context.bUseFreeSpace ) {
+                        if( pmanip->FindIKSolutions(ikparam, vsolutions, context.filteroptions) ) {
+                            numposesolutions = (int)vsolutions.size();
+                        }
+                    }
+                    else if( pmanip->FindIKSolution(ikparam, vsolution, context.filteroptions) ) {
+                        numposesolutions = 1;
+                    }
+                    if( numposesolutions > 0 ) {
+                        numsolutions += numposesolutions;
+                        ++numrotations;
+                        if( !!context.pstatsfile ) {
+                            for(int i = 0; i < 4; ++i) {
+                                vstats.push_back(t.rot[i]);
+                            }
+                            for(int i = 0; i < 3; ++i) {
+                                vstats.push_back(t.trans[i]);
+                            }
+                            vstats.push_back(numposesolutions);
+                        }
+                    }
+                }
+                context.vnumsolutions[ipoint] = numsolutions;
+                context.vnumrotations[ipoint] = numrotations;
+            }
+
+            if( !!context.pstatsfile ) {
+                boost::mutex::scoped_lock lockcontext(context.mutex);
+                context.mapblockstats[iblock].swap(vstats);
+                while( context.mapblockstats.size() > 0 && context.mapblockstats.begin()->first == context.nextblocktowrite ) {
+                    const std::vector<double>& vblockstats = context.mapblockstats.begin()->second;
+                    if( vblockstats.size() > 0 ) {
+                        context.pstatsfile->write(reinterpret_cast<const char*>(&vblockstats[0]), vblockstats.size()*sizeof(double));
+                    }
+                    context.mapblockstats.erase(context.mapblockstats.begin());
+                    ++context.nextblocktowrite;
+                }
+            }
+        }
+    }
+
     bool DebugIKFindSolution(RobotBase::ManipulatorPtr pmanip, const IkParameterization& twrist, std::vector<dReal>& viksolution, int filteroptions, std::vector<dReal>& parameters, int paramindex, dReal deltafree)
     {
         // ignore boundary cases since next to limits and can fail due to limit errosr
@@ -1564,6 +1972,12 @@ public:
 
     string _ikfastversion; ///< current ikfast version (assuming doesn't change during process lifetime)
     string _platform; ///<  current platform architecture. ie x86-64
+
+#ifdef Boost_IOSTREAMS_FOUND
+    std::list<IkFastGenerationPtr> _listGenerations; ///< generations started by LoadIKFastSolver with nonblocking
+    boost::mutex _mutexGenerations;
+    boost::atomic<bool> _bDestroyed; ///< stops the generation threads from loading the solvers, set without any lock
+#endif
 };
 
 ModuleBasePtr CreateIkFastModule(EnvironmentBasePtr penv, std::istream& sinput)
@@ -22,6 +22,7 @@
 #ifdef OPENRAVE_HAS_LAPACK
 #include "jacobianinverse.h"
 #endif
+#include "iksolutioncache.h"
 
 template <typename IkReal>
 class IkFastSolver : public IkSolverBase
@@ -36,7 +37,7 @@ public:
     };
 
 public:
-    IkFastSolver(EnvironmentBasePtr penv, std::istream& sinput, boost::shared_ptr<ikfast::IkFastFunctions<IkReal> > ikfunctions, const vector<dReal>& vfreeinc, dReal ikthreshold=1e-4) : IkSolverBase(penv), _ikfunctions(ikfunctions), _vFreeInc(vfreeinc), _ikthreshold(ikthreshold) {
+    IkFastSolver(EnvironmentBasePtr penv, std::istream& sinput, boost::shared_ptr<ikfast::IkFastFunctions<IkReal> > ikfunctions, const vector<dReal>& vfreeinc, dReal ikthreshold=1e-4) : IkSolverBase(penv), _ikfunctions(ikfunctions), _vFreeInc(vfreeinc), _ikthreshold(ikthreshold), _fIkCacheQuantization(1e-6), _nIkCacheSceneStamp(0) {
         OPENRAVE_ASSERT_OP(ikfunctions->_GetIkRealSize(),==,sizeof(IkReal));
 
         _bEmptyTransform6D = false;
@@ -79,6 +80,19 @@ public:
         RegisterCommand("SetBackTraceSelfCollisionLinks",boost::bind(&IkFastSolver<IkReal>::_SetBackTraceSelfCollisionLinksCommand,this,_1,_2),
                         "format: int int\n\n\
 for numBacktraceLinksForSelfCollisionWithNonMoving numBacktraceLinksForSelfCollisionWithFree, when pruning self collisions, the number of links to look at. If the tip of the manip self collides with the base, then can safely quit the IK.");
+        RegisterCommand("SetIkCache",boost::bind(&IkFastSolver<IkReal>::_SetIkCacheCommand,this,_1,_2),
+                        "format: int [dReal]\n\n\
+maxentries quantization, enables the least recently used caches of the ik results with maxentries each (0 disables them). The raw ikfast solutions are cached by the exact ik parameterization and free values, and are reused when the scene changes. The results of SolveAll are cached by the exact ik parameterization and free values, the filter options and the scene state, and are only used when no custom filters are run. The robot transform and the joint values outside of the arm are rounded to multiples of quantization (default 1e-6) to make the keys.");
+        RegisterCommand("GetIkCacheStatistics",boost::bind(&IkFastSolver<IkReal>::_GetIkCacheStatisticsCommand,this,_1,_2),
+                        "returns the hits, misses, and entries of the raw solution cache followed by the same for the filtered solution cache.");
+        RegisterCommand("ResetIkCache",boost::bind(&IkFastSolver<IkReal>::_ResetIkCacheCommand,this,_1,_2),
+                        "removes all the entries of the ik caches and resets their statistics.");
+        RegisterCommand("PerfTiming",boost::bind(&IkFastSolver<IkReal>::_PerfTimingCommand,this,_1,_2),
+                        "format: int [int] [int]\n\n\
+numsamples seed batchsize, times the raw ikfast ComputeIk without any filters on the end effector poses of numsamples joint values. The joint values are sampled uniformly inside the joint limits (in [-pi, pi] for joints that have a larger range) by a mt19937 sampler with the given seed (default 0). If batchsize is positive, the poses are solved batchsize at a time from one contiguous pose layout and every pose gets the time of its batch divided by the number of poses. Returns the time in nano-seconds and the number of solutions of every sample.");
+        RegisterCommand("ComputeIkBatch",boost::bind(&IkFastSolver<IkReal>::_ComputeIkBatchCommand,this,_1,_2),
+                        "format: int IkParameterization... [int]\n\n\
+numposes ikparams batch, computes the raw ik solutions of the ik parameterizations in the manipulator base coordinate system without any filters. The free joints keep their current values. If batch is 1 (default), all the parameterizations are packed into one contiguous pose layout and solved together, otherwise they are solved one at a time through the same path as Solve. Returns the number of solutions of every parameterization followed by the joint values of its solutions.");
         _numBacktraceLinksForSelfCollisionWithNonMoving = 2;
         _numBacktraceLinksForSelfCollisionWithFree = 0;
     }
@@ -200,6 +214,195 @@ for numBacktraceLinksForSelfCollisionWithNonMoving numBacktraceLinksForSelfColli
         return true;
     }
 
+    bool _SetIkCacheCommand(ostream& sout, istream& sinput)
+    {
+        int maxentries = 0;
+        sinput >> maxentries;
+        if( !sinput || maxentries < 0 ) {
+            return false;
+        }
+        dReal fquantization = _fIkCacheQuantization;
+        sinput >> fquantization;
+        if( !!sinput ) {
+            if( fquantization <= 0 ) {
+                return false;
+            }
+            if( fquantization != _fIkCacheQuantization ) {
+                // old keys were made with a different quantization
+                _rawikcache.Clear();
+                _filteredikcache.Clear();
+                _fIkCacheQuantization = fquantization;
+            }
+        }
+        _rawikcache.SetMaxSize(maxentries);
+        _filteredikcache.SetMaxSize(maxentries);
+        if( maxentries == 0 ) {
+            _ResetIkCacheSceneCallbacks();
+        }
+        return true;
+    }
+
+    bool _GetIkCacheStatisticsCommand(ostream& sout, istream& sinput)
+    {
+        sout << _rawikcache.GetNumHits() << " " << _rawikcache.GetNumMisses() << " " << _rawikcache.GetSize() << " ";
+        sout << _filteredikcache.GetNumHits() << " " << _filteredikcache.GetNumMisses() << " " << _filteredikcache.GetSize();
+        return true;
+    }
+
+    bool _ResetIkCacheCommand(ostream& sout, istream& sinput)
+    {
+        _rawikcache.Clear();
+        _rawikcache.ResetStatistics();
+        _filteredikcache.Clear();
+        _filteredikcache.ResetStatistics();
+        return true;
+    }
+
+    bool _PerfTimingCommand(ostream& sout, istream& sinput)
+    {
+        int numsamples = 0, batchsize = 0;
+        uint32_t seed = 0;
+        sinput >> numsamples;
+        if( !sinput || numsamples < 0 ) {
+            return false;
+        }
+        sinput >> seed;
+        if( !sinput ) {
+            seed = 0;
+        }
+        else {
+            sinput >> batchsize;
+            if( !sinput ) {
+                batchsize = 0;
+            }
+        }
+        SpaceSamplerBasePtr psampler = RaveCreateSpaceSampler(GetEnv(), "mt19937");
+        if( !psampler ) {
+            return false;
+        }
+        psampler->SetSeed(seed);
+
+        std::vector<dReal> vsample;
+        std::vector<IkReal> vjoints(_nTotalDOF);
+        if( batchsize > 0 ) {
+            const int numfree = _vfreeparams.size();
+            std::vector<IkReal> veetrans(3*batchsize), veerot(9*batchsize), vfree(numfree*batchsize);
+            std::vector<ikfast::IkSolutionList<IkReal> > vsolutions(batchsize);
+            std::vector<ikfast::IkSolutionListBase<IkReal>*> vpsolutions(batchsize);
+            for(int ibatch = 0; ibatch < batchsize; ++ibatch) {
+                vpsolutions[ibatch] = &vsolutions[ibatch];
+            }
+            for(int isample = 0; isample < numsamples; isample += batchsize) {
+                int numposes = min(batchsize, numsamples-isample);
+                for(int ipose = 0; ipose < numposes; ++ipose) {
+                    _SamplePerfTimingJointValues(psampler, vsample, vjoints);
+                    for(int j = 0; j < numfree; ++j) {
+                        vfree[numfree*ipose+j] = vjoints[_vfreeparams[j]];
+                    }
+                    _ikfunctions->_ComputeFk(&vjoints[0], &veetrans[3*ipose], &veerot[9*ipose]);
+                }
+                uint64_t starttime = utils::GetNanoPerformanceTime();
+                _CallIkBatch(numposes, &veetrans[0], &veerot[0], numfree > 0 ? &vfree[0] : NULL, &vpsolutions[0], NULL);
+                uint64_t elapsedtime = utils::GetNanoPerformanceTime() - starttime;
+                // the time of the batch is shared among its poses
+                for(int ipose = 0; ipose < numposes; ++ipose) {
+                    sout << elapsedtime/numposes << " " << vsolutions[ipose].GetNumSolutions() << " ";
+                }
+            }
+            return true;
+        }
+
+        std::vector<IkReal> vfree(_vfreeparams.size());
+        IkReal eerot[9], eetrans[3];
+        ikfast::IkSolutionList<IkReal> solutions;
+        for(int isample = 0; isample < numsamples; ++isample) {
+            _SamplePerfTimingJointValues(psampler, vsample, vjoints);
+            for(size_t j = 0; j < vfree.size(); ++j) {
+                vfree[j] = vjoints[_vfreeparams[j]];
+            }
+            _ikfunctions->_ComputeFk(&vjoints[0], eetrans, eerot);
+            solutions.Clear();
+            uint64_t starttime = utils::GetNanoPerformanceTime();
+            if( !!_ikfunctions->_ComputeIk2 ) {
+                _ikfunctions->_ComputeIk2(eetrans, eerot, vfree.size() > 0 ? &vfree[0] : NULL, solutions, NULL);
+            }
+            else {
+                _ikfunctions->_ComputeIk(eetrans, eerot, vfree.size() > 0 ? &vfree[0] : NULL, solutions);
+            }
+            uint64_t elapsedtime = utils::GetNanoPerformanceTime() - starttime;
+            sout << elapsedtime << " " << solutions.GetNumSolutions() << " ";
+        }
+        return true;
+    }
+
+    bool _ComputeIkBatchCommand(ostream& sout, istream& sinput)
+    {
+        int numposes = 0;
+        sinput >> numposes;
+        if( !sinput || numposes < 0 ) {
+            return false;
+        }
+        std::vector<IkParameterization> vparams(numposes);
+        FOREACH(itparam, vparams) {
+            sinput >> *itparam;
+        }
+        if( !sinput ) {
+            return false;
+        }
+        int bbatch = 1;
+        sinput >> bbatch;
+        if( !sinput ) {
+            bbatch = 1;
+        }
+
+        RobotBase::ManipulatorPtr pmanip(_pmanip);
+        std::vector<dReal> varmvalues;
+        pmanip->GetRobot()->GetDOFValues(varmvalues, pmanip->GetArmIndices());
+        std::vector<IkReal> vfree(_vfreeparams.size());
+        for(size_t j = 0; j < vfree.size(); ++j) {
+            vfree[j] = varmvalues.at(_vfreeparams[j]);
+        }
+        std::vector<ikfast::IkSolutionList<IkReal> > vsolutions;
+        if( bbatch ) {
+            ComputeIkBatch(vparams, vfree, vsolutions);
+        }
+        else {
+            Transform tLocalTool = pmanip->GetLocalToolTransform();
+            vsolutions.resize(vparams.size());
+            for(size_t i = 0; i < vparams.size(); ++i) {
+                _CallIk(vparams[i], vfree, tLocalTool, vsolutions[i]);
+            }
+        }
+
+        sout << std::setprecision(std::numeric_limits<IkReal>::digits10+1);
+        std::vector<IkReal> vsolution;
+        FOREACHC(itsolutions, vsolutions) {
+            sout << itsolutions->GetNumSolutions() << " ";
+            for(size_t isolution = 0; isolution < itsolutions->GetNumSolutions(); ++isolution) {
+                itsolutions->GetSolution(isolution).GetSolution(vsolution, vfree);
+                FOREACHC(itvalue, vsolution) {
+                    sout << *itvalue << " ";
+                }
+            }
+        }
+        return true;
+    }
+
+    /// \brief samples joint values inside the joint limits for timing
+    void _SamplePerfTimingJointValues(SpaceSamplerBasePtr psampler, std::vector<dReal>& vsample, std::vector<IkReal>& vjoints)
+    {
+        psampler->SampleSequence(vsample, _nTotalDOF, IT_Closed);
+        for(int j = 0; j < _nTotalDOF; ++j) {
+            // the limits are only set once the solver is initialized with a manipulator
+            if( j < (int)_qlower.size() && _qupper[j]-_qlower[j] <= 2*PI ) {
+                vjoints[j] = _qlower[j] + vsample[j]*(_qupper[j]-_qlower[j]);
+            }
+            else {
+                vjoints[j] = -PI + vsample[j]*2*PI;
+            }
+        }
+    }
+
     virtual IkReturnAction CallFilters(const IkParameterization& param, IkReturnPtr ikreturn, int minpriority, int maxpriority) {
         // have to convert to the manipulator's base coordinate system
         RobotBase::ManipulatorPtr pmanip(_pmanip);
@@ -227,6 +430,7 @@ for numBacktraceLinksForSelfCollisionWithNonMoving numBacktraceLinksForSelfColli
         RobotBase::RobotStateSaver saver(probot);
         probot->SetActiveDOFs(pmanip->GetArmIndices());
         probot->GetActiveDOFLimits(_qlower,_qupper);
+        _filteredikcache.Clear(); // cached results were filtered with the old limits
         _qmid.resize(_qlower.size());
         _qbigrangeindices.resize(0);
         _qbigrangemaxsols.resize(0);
@@ -282,6 +486,9 @@ for numBacktraceLinksForSelfCollisionWithNonMoving numBacktraceLinksForSelfColli
         }
 
         _cblimits = probot->RegisterChangeCallback(KinBody::Prop_JointLimits,boost::bind(&IkFastSolver<IkReal>::SetJointLimits,boost::bind(&utils::sptr_from<IkFastSolver<IkReal> >, weak_solver())));
+        _rawikcache.Clear();
+        _filteredikcache.Clear();
+        _ResetIkCacheSceneCallbacks();
 
         if( _nTotalDOF != (int)pmanip->GetArmIndices().size() ) {
             RAVELOG_ERROR(str(boost::format("ik %s configured with different number of joints than robot manipulator (%d!=%d)\n")%GetXMLId()%pmanip->GetArmIndices().size()%_nTotalDOF));
@@ -593,6 +800,7 @@ protected:
 
     virtual bool Solve(const IkParameterization& rawparam, const std::vector<dReal>& q0, int filteroptions, boost::shared_ptr< std::vector<dReal> > result)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast Solve");
         std::vector<dReal> q0local = q0; // copy in case result points to q0
         if( !!result ) {
             result->resize(0);
@@ -610,6 +818,7 @@ protected:
 
     virtual bool SolveAll(const IkParameterization& rawparam, int filteroptions, std::vector< std::vector<dReal> >& qSolutions)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast SolveAll");
         std::vector<IkReturnPtr> vikreturns;
         qSolutions.resize(0);
         if( !SolveAll(rawparam,filteroptions,vikreturns) ) {
@@ -624,6 +833,7 @@ protected:
 
     virtual bool Solve(const IkParameterization& param, const std::vector<dReal>& q0, const std::vector<dReal>& vFreeParameters, int filteroptions, boost::shared_ptr< std::vector<dReal> > result)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast Solve");
         std::vector<dReal> q0local = q0; // copy in case result points to q0
         if( !!result ) {
             result->resize(0);
@@ -641,6 +851,7 @@ protected:
 
     virtual bool SolveAll(const IkParameterization& param, const std::vector<dReal>& vFreeParameters, int filteroptions, std::vector< std::vector<dReal> >& qSolutions)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast SolveAll");
         std::vector<IkReturnPtr> vikreturns;
         qSolutions.resize(0);
         if( !SolveAll(param,vFreeParameters,filteroptions,vikreturns) ) {
@@ -655,6 +866,7 @@ protected:
 
     virtual bool Solve(const IkParameterization& rawparam, const std::vector<dReal>& q0, int filteroptions, IkReturnPtr ikreturn)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast Solve");
         IkParameterization ikparamdummy;
         const IkParameterization& param = _ConvertIkParameterization(rawparam, ikparamdummy);
         if( !!ikreturn ) {
@@ -676,9 +888,19 @@ protected:
 
     virtual bool SolveAll(const IkParameterization& rawparam, int filteroptions, std::vector<IkReturnPtr>& vikreturns)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast SolveAll");
         vikreturns.resize(0);
         IkParameterization ikparamdummy;
         const IkParameterization& param = _ConvertIkParameterization(rawparam, ikparamdummy);
+        ikfastsolvers::IkCacheKey filteredkey;
+        bool bUseFilteredCache = _GetFilteredIkCacheKey(param, std::vector<dReal>(), filteroptions, filteredkey);
+        if( bUseFilteredCache ) {
+            const std::pair<bool, std::vector<IkReturn> >* pcached = _filteredikcache.Find(filteredkey);
+            if( !!pcached ) {
+                _CopyCachedIkReturns(pcached->second, vikreturns);
+                return pcached->first;
+            }
+        }
         RobotBase::ManipulatorPtr pmanip(_pmanip);
         RobotBasePtr probot = pmanip->GetRobot();
         RobotBase::RobotStateSaver saver(probot);
@@ -687,15 +909,20 @@ protected:
         StateCheckEndEffector stateCheck(probot,_vchildlinks,_vindependentlinks,filteroptions);
         CollisionOptionsStateSaver optionstate(GetEnv()->GetCollisionChecker(),GetEnv()->GetCollisionChecker()->GetCollisionOptions()|CO_ActiveDOFs,false);
         IkReturnAction retaction = ComposeSolution(_vfreeparams, vfree, 0, vector<dReal>(), boost::bind(&IkFastSolver::_SolveAll,shared_solver(), param,boost::ref(vfree),filteroptions,boost::ref(vikreturns), boost::ref(stateCheck)), _vFreeInc);
-        if( retaction & IKRA_Quit ) {
-            return false;
+        bool bsuccess = false;
+        if( !(retaction & IKRA_Quit) ) {
+            _SortSolutions(probot, vikreturns);
+            bsuccess = vikreturns.size()>0;
+        }
+        if( bUseFilteredCache ) {
+            _InsertFilteredIkCache(filteredkey, bsuccess, vikreturns);
         }
-        _SortSolutions(probot, vikreturns);
-        return vikreturns.size()>0;
+        return bsuccess;
     }
 
     virtual bool Solve(const IkParameterization& rawparam, const std::vector<dReal>& q0, const std::vector<dReal>& vFreeParameters, int filteroptions, IkReturnPtr ikreturn)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast Solve");
         IkParameterization ikparamdummy;
         const IkParameterization& param = _ConvertIkParameterization(rawparam, ikparamdummy);
         if( vFreeParameters.size() != _vfreeparams.size() ) {
@@ -723,12 +950,22 @@ protected:
 
     virtual bool SolveAll(const IkParameterization& rawparam, const std::vector<dReal>& vFreeParameters, int filteroptions, std::vector<IkReturnPtr>& vikreturns)
     {
+        OPENRAVE_PROFILE_SCOPE("ikfast SolveAll");
         vikreturns.resize(0);
         IkParameterization ikparamdummy;
         const IkParameterization& param = _ConvertIkParameterization(rawparam, ikparamdummy);
         if( vFreeParameters.size() != _vfreeparams.size() ) {
             throw openrave_exception(_("free parameters not equal"),ORE_InvalidArguments);
         }
+        ikfastsolvers::IkCacheKey filteredkey;
+        bool bUseFilteredCache = _GetFilteredIkCacheKey(param, vFreeParameters, filteroptions, filteredkey);
+        if( bUseFilteredCache ) {
+            const std::pair<bool, std::vector<IkReturn> >* pcached = _filteredikcache.Find(filteredkey);
+            if( !!pcached ) {
+                _CopyCachedIkReturns(pcached->second, vikreturns);
+                return pcached->first;
+            }
+        }
         RobotBase::ManipulatorPtr pmanip(_pmanip);
         RobotBasePtr probot = pmanip->GetRobot();
         RobotBase::RobotStateSaver saver(probot);
@@ -740,11 +977,15 @@ protected:
         StateCheckEndEffector stateCheck(probot,_vchildlinks,_vindependentlinks,filteroptions);
         CollisionOptionsStateSaver optionstate(GetEnv()->GetCollisionChecker(),GetEnv()->GetCollisionChecker()->GetCollisionOptions()|CO_ActiveDOFs,false);
         IkReturnAction retaction = _SolveAll(param,vfree,filteroptions,vikreturns, stateCheck);
-        if( retaction & IKRA_Quit ) {
-            return false;
+        bool bsuccess = false;
+        if( !(retaction & IKRA_Quit) ) {
+            _SortSolutions(probot, vikreturns);
+            bsuccess = vikreturns.size()>0;
         }
-        _SortSolutions(probot, vikreturns);
-        return vikreturns.size()>0;
+        if( bUseFilteredCache ) {
+            _InsertFilteredIkCache(filteredkey, bsuccess, vikreturns);
+        }
+        return bsuccess;
     }
 
     virtual int GetNumFreeParameters() const
@@ -783,6 +1024,7 @@ protected:
 
         _pmanip.reset();
         _cblimits.reset();
+        _ResetIkCacheSceneCallbacks();
         _vchildlinks.resize(0);
         _vchildlinkindices.resize(0);
         _vindependentlinks.resize(0);
@@ -825,6 +1067,11 @@ protected:
         _numBacktraceLinksForSelfCollisionWithNonMoving = r->_numBacktraceLinksForSelfCollisionWithNonMoving;
         _numBacktraceLinksForSelfCollisionWithFree = r->_numBacktraceLinksForSelfCollisionWithFree;
         _ikthreshold = r->_ikthreshold;
+        _rawikcache.Clear();
+        _rawikcache.SetMaxSize(r->_rawikcache.GetMaxSize());
+        _filteredikcache.Clear();
+        _filteredikcache.SetMaxSize(r->_filteredikcache.GetMaxSize());
+        _fIkCacheQuantization = r->_fIkCacheQuantization;
 #ifdef OPENRAVE_HAS_LAPACK
         _SetJacobianRefine(r->_fRefineWithJacobianInverseAllowedError, r->_jacobinvsolver._nMaxIterations);
 #endif
@@ -832,7 +1079,92 @@ protected:
         _bEmptyTransform6D = r->_bEmptyTransform6D;
     }
 
+    /// \brief computes the raw ik solutions of many parameterizations with one contiguous pose layout
+    ///
+    /// The solutions are neither filtered nor checked against the joint limits, and the raw ik cache is not used for the batch.
+    /// Parameterizations that are not Transform6D are solved one at a time.
+    /// \param vfree the free joint values used for every parameterization
+    /// \param vsolutions resized to vparams.size(), vsolutions[i] holds the solutions of vparams[i]
+    /// \return the number of parameterizations that have at least one solution
+    int ComputeIkBatch(const std::vector<IkParameterization>& vparams, const std::vector<IkReal>& vfree, std::vector<ikfast::IkSolutionList<IkReal> >& vsolutions)
+    {
+        RobotBase::ManipulatorPtr pmanip(_pmanip);
+        Transform tLocalTool = pmanip->GetLocalToolTransform();
+        vsolutions.resize(vparams.size());
+        int numsolved = 0;
+        std::vector<size_t> vbatchindices;
+        vbatchindices.reserve(vparams.size());
+        for(size_t i = 0; i < vparams.size(); ++i) {
+            if( vparams[i].GetType() == IKP_Transform6D ) {
+                vbatchindices.push_back(i);
+            }
+            else {
+                vsolutions[i].Clear();
+                if( _CallIk(vparams[i], vfree, tLocalTool, vsolutions[i]) ) {
+                    ++numsolved;
+                }
+            }
+        }
+        if( vbatchindices.size() == 0 ) {
+            return numsolved;
+        }
+
+        std::vector<IkReal> veetrans(3*vbatchindices.size()), veerot(9*vbatchindices.size()), vbatchfree(vfree.size()*vbatchindices.size());
+        std::vector<ikfast::IkSolutionListBase<IkReal>*> vpsolutions(vbatchindices.size());
+        for(size_t ibatch = 0; ibatch < vbatchindices.size(); ++ibatch) {
+            TransformMatrix t = vparams[vbatchindices[ibatch]].GetTransform6D();
+            if( _bEmptyTransform6D ) {
+                t = t * tLocalTool.inverse();
+            }
+            IkReal* peetrans = &veetrans[3*ibatch];
+            IkReal* peerot = &veerot[9*ibatch];
+            peetrans[0] = t.trans.x; peetrans[1] = t.trans.y; peetrans[2] = t.trans.z;
+            peerot[0] = t.m[0]; peerot[1] = t.m[1]; peerot[2] = t.m[2];
+            peerot[3] = t.m[4]; peerot[4] = t.m[5]; peerot[5] = t.m[6];
+            peerot[6] = t.m[8]; peerot[7] = t.m[9]; peerot[8] = t.m[10];
+            std::copy(vfree.begin(), vfree.end(), vbatchfree.begin()+vfree.size()*ibatch);
+            vpsolutions[ibatch] = &vsolutions[vbatchindices[ibatch]];
+        }
+        numsolved += _CallIkBatch(vbatchindices.size(), &veetrans[0], &veerot[0], vbatchfree.size() > 0 ? &vbatchfree[0] : NULL, &vpsolutions[0], &pmanip);
+#ifdef OPENRAVE_HAS_LAPACK
+        if( _fRefineWithJacobianInverseAllowedError > 0 ) {
+            // the single calls retry failed poses with a slight jitter since the solutions will be refined
+            FOREACHC(itindex, vbatchindices) {
+                if( vsolutions[*itindex].GetNumSolutions() == 0 && _CallIk(vparams[*itindex], vfree, tLocalTool, vsolutions[*itindex]) ) {
+                    ++numsolved;
+                }
+            }
+        }
+#endif
+        return numsolved;
+    }
+
 protected:
+    /// \brief calls the generated ComputeIk2 or ComputeIk on every pose of a contiguous pose layout
+    ///
+    /// The generated solve trees branch per pose, so there is no cross pose entry point in the generated libraries.
+    int _CallIkBatch(int numposes, const IkReal* eetrans, const IkReal* eerot, const IkReal* pfree, ikfast::IkSolutionListBase<IkReal>* const* psolutions, void* pOpenRAVEManip)
+    {
+        const int numfree = _vfreeparams.size();
+        int numsolved = 0;
+        for(int ipose = 0; ipose < numposes; ++ipose) {
+            const IkReal* peetrans = eetrans != NULL ? eetrans+3*ipose : NULL;
+            const IkReal* peerot = eerot != NULL ? eerot+9*ipose : NULL;
+            const IkReal* pposefree = pfree != NULL ? pfree+numfree*ipose : NULL;
+            bool bsuccess = false;
+            if( !!_ikfunctions->_ComputeIk2 ) {
+                bsuccess = _ikfunctions->_ComputeIk2(peetrans, peerot, pposefree, *psolutions[ipose], pOpenRAVEManip);
+            }
+            else {
+                bsuccess = _ikfunctions->_ComputeIk(peetrans, peerot, pposefree, *psolutions[ipose]);
+            }
+            if( bsuccess ) {
+                ++numsolved;
+            }
+        }
+        return numsolved;
+    }
+
     IkReturnAction ComposeSolution(const std::vector<int>& vfreeparams, vector<IkReal>& vfree, int freeindex, const vector<dReal>& q0, const boost::function<IkReturnAction()>& fn, const std::vector<dReal>& vFreeInc)
     {
         if( freeindex >= (int)vfreeparams.size()) {
@@ -924,6 +1256,20 @@ protected:
     /// \param tLocalTool _pmanip->GetLocalToolTransform()
     inline bool _CallIk(const IkParameterization& param, const vector<IkReal>& vfree, const Transform& tLocalTool, ikfast::IkSolutionList<IkReal>& solutions)
     {
+        ikfastsolvers::IkCacheKey key;
+        if( _rawikcache.GetMaxSize() > 0 ) {
+            // exact values since the solutions of a nearby query do not reach param
+            key.AddIkParameterization(param);
+            FOREACHC(itfree, vfree) {
+                key.AddExactValue(*itfree);
+            }
+            key.AddExactTransform(tLocalTool);
+            const std::pair<bool, ikfast::IkSolutionList<IkReal> >* pcached = _rawikcache.Find(key);
+            if( !!pcached ) {
+                solutions = pcached->second;
+                return pcached->first;
+            }
+        }
         bool bsuccess = false;
         if( !!_ikfunctions->_ComputeIk2 ) {
             bsuccess = _CallIk2(param, vfree, tLocalTool, solutions);
@@ -931,9 +1277,137 @@ protected:
         else {
             bsuccess = _CallIk1(param, vfree, tLocalTool, solutions);
         }
+        if( _rawikcache.GetMaxSize() > 0 ) {
+            _rawikcache.Insert(key, std::make_pair(bsuccess, solutions));
+        }
         return bsuccess;
     }
 
+    /// \brief computes the key of the filtered cache from the query and the scene state.
+    ///
+    /// The robot contributes its transform and the values of the joints outside of the arm. Everything else that the filters
+    /// check is summarized by _nIkCacheSceneStamp, which the callbacks of _InitIkCacheSceneCallbacks increment when bodies are
+    /// added or removed, when the other bodies move, and when the geometry or enabled links of any body or the grabbed bodies of
+    /// the robot change. The robot and its grabbed bodies move with the arm, so their transforms do not change the stamp. The
+    /// geometry group of the collision checker selects the geometry that the filters check.
+    /// \return false if the results of this query cannot be cached, for example when custom filters will be run
+    bool _GetFilteredIkCacheKey(const IkParameterization& param, const std::vector<dReal>& vFreeParameters, int filteroptions, ikfastsolvers::IkCacheKey& key)
+    {
+        if( _filteredikcache.GetMaxSize() == 0 ) {
+            return false;
+        }
+        if( !(filteroptions & IKFO_IgnoreCustomFilters) && _HasFilterInRange(IKSP_MinPriority, IKSP_MaxPriority) ) {
+            return false;
+        }
+        RobotBase::ManipulatorPtr pmanip(_pmanip);
+        RobotBasePtr probot = pmanip->GetRobot();
+        _InitIkCacheSceneCallbacks(probot);
+        key.Clear();
+        key.AddInt(_nIkCacheSceneStamp);
+        key.AddIkParameterization(param);
+        key.AddInt(filteroptions);
+        key.AddInt(vFreeParameters.size());
+        FOREACHC(itfree, vFreeParameters) {
+            key.AddExactValue(*itfree);
+        }
+        CollisionCheckerBasePtr pchecker = GetEnv()->GetCollisionChecker();
+        key.AddInt(pchecker->GetCollisionOptions());
+        try {
+            key.AddString(pchecker->GetGeometryGroup());
+        }
+        catch(const openrave_exception&) {
+            // checker does not support geometry groups
+            key.AddString(std::string());
+        }
+        key.AddTransform(probot->GetTransform(), _fIkCacheQuantization);
+        key.AddExactTransform(pmanip->GetLocalToolTransform());
+        probot->GetDOFValues(_vIkCacheDOFValues);
+        FOREACHC(itindex, pmanip->GetArmIndices()) {
+            _vIkCacheDOFValues.at(*itindex) = 0;
+        }
+        FOREACHC(itvalue, _vIkCacheDOFValues) {
+            key.AddValue(*itvalue, _fIkCacheQuantization);
+        }
+        return true;
+    }
+
+    /// \brief registers the callbacks that keep _nIkCacheSceneStamp up to date, if not registered yet
+    void _InitIkCacheSceneCallbacks(RobotBasePtr probot)
+    {
+        if( !!_cbikcachebodies ) {
+            return;
+        }
+        ++_nIkCacheSceneStamp;
+        _cbikcacherobot = probot->RegisterChangeCallback(KinBody::Prop_LinkGeometry|KinBody::Prop_LinkGeometryGroup|KinBody::Prop_LinkEnable|KinBody::Prop_RobotGrabbed, boost::bind(&IkFastSolver<IkReal>::_IncrementIkCacheSceneStamp, boost::bind(&utils::sptr_from<IkFastSolver<IkReal> >, weak_solver())));
+        _cbikcachebodies = GetEnv()->RegisterBodyCallback(boost::bind(&IkFastSolver<IkReal>::_UpdateIkCacheBodyCallbacks, boost::bind(&utils::sptr_from<IkFastSolver<IkReal> >, weak_solver()), _1, _2));
+        std::vector<KinBodyPtr> vbodies;
+        GetEnv()->GetBodies(vbodies);
+        FOREACHC(itbody, vbodies) {
+            _UpdateIkCacheBodyCallbacks(*itbody, 1);
+        }
+    }
+
+    void _ResetIkCacheSceneCallbacks()
+    {
+        _cbikcachebodies.reset();
+        _cbikcacherobot.reset();
+        _mapIkCacheBodyCallbacks.clear();
+    }
+
+    /// \brief environment body callback, tracks the changes of the bodies other than the robot
+    void _UpdateIkCacheBodyCallbacks(KinBodyPtr pbody, int action)
+    {
+        ++_nIkCacheSceneStamp;
+        RobotBase::ManipulatorPtr pmanip = _pmanip.lock();
+        if( !pmanip || pbody == pmanip->GetRobot() ) {
+            return;
+        }
+        if( action == 0 ) {
+            _mapIkCacheBodyCallbacks.erase(pbody.get());
+        }
+        else {
+            std::pair<UserDataPtr, UserDataPtr>& callbacks = _mapIkCacheBodyCallbacks[pbody.get()];
+            callbacks.first = pbody->RegisterChangeCallback(KinBody::Prop_LinkGeometry|KinBody::Prop_LinkGeometryGroup|KinBody::Prop_LinkEnable, boost::bind(&IkFastSolver<IkReal>::_IncrementIkCacheSceneStamp, boost::bind(&utils::sptr_from<IkFastSolver<IkReal> >, weak_solver())));
+            callbacks.second = pbody->RegisterChangeCallback(KinBody::Prop_LinkTransforms, boost::bind(&IkFastSolver<IkReal>::_UpdateIkCacheBodyTransform, boost::bind(&utils::sptr_from<IkFastSolver<IkReal> >, weak_solver()), KinBodyWeakPtr(pbody)));
+        }
+    }
+
+    void _UpdateIkCacheBodyTransform(KinBodyWeakPtr pweakbody)
+    {
+        // grabbed bodies move with the arm while filtering, their placement is tracked by Prop_RobotGrabbed of the robot
+        KinBodyPtr pbody = pweakbody.lock();
+        RobotBase::ManipulatorPtr pmanip = _pmanip.lock();
+        if( !!pbody && !!pmanip && !!pmanip->GetRobot()->IsGrabbing(*pbody) ) {
+            return;
+        }
+        ++_nIkCacheSceneStamp;
+    }
+
+    void _IncrementIkCacheSceneStamp()
+    {
+        ++_nIkCacheSceneStamp;
+    }
+
+    /// \brief copies the cached filtered results to vikreturns so that callers cannot modify the cache
+    static void _CopyCachedIkReturns(const std::vector<IkReturn>& vcached, std::vector<IkReturnPtr>& vikreturns)
+    {
+        vikreturns.resize(vcached.size());
+        for(size_t i = 0; i < vcached.size(); ++i) {
+            vikreturns[i].reset(new IkReturn(vcached[i]));
+        }
+    }
+
+    void _InsertFilteredIkCache(const ikfastsolvers::IkCacheKey& key, bool bsuccess, const std::vector<IkReturnPtr>& vikreturns)
+    {
+        std::pair<bool, std::vector<IkReturn> > value;
+        value.first = bsuccess;
+        value.second.reserve(vikreturns.size());
+        FOREACHC(itikreturn, vikreturns) {
+            value.second.push_back(**itikreturn);
+        }
+        _filteredikcache.Insert(key, value);
+    }
+
     bool _CallIk1(const IkParameterization& param, const vector<IkReal>& vfree, const Transform& tLocalTool, ikfast::IkSolutionList<IkReal>& solutions)
     {
         try {
@@ -1541,6 +2015,7 @@ protected:
         }
 
         CollisionReport report;
+        report.bCompactLinkColliding = true; // only the link indices of the colliding pairs are used
         CollisionReportPtr ptempreport;
         if( !(filteroptions&IKFO_IgnoreSelfCollisions) || IS_DEBUGLEVEL(Level_Verbose) || paramnewglobal.GetType() == IKP_TranslationDirection5D ) { // 5D is necessary for tracking end effector collisions
             ptempreport = boost::shared_ptr<CollisionReport>(&report,utils::null_deleter());
@@ -1659,15 +2134,17 @@ protected:
                 if( paramnewglobal.GetType() == IKP_TranslationDirection5D ) {
                     // colliding and 5d,so check if colliding with end effector. If yes, then register as part of the stateCheck
                     bool bIsEndEffectorCollision = false;
-                    FOREACHC(itcollidingpairs, ptempreport->vLinkColliding) {
-                        if( itcollidingpairs->first->GetParent() == probot ) {
-                            if( find(_vchildlinkindices.begin(), _vchildlinkindices.end(), itcollidingpairs->first->GetIndex()) != _vchildlinkindices.end() ) {
+                    int robotid = probot->GetEnvironmentId();
+                    for(size_t ipair = 0; ipair < ptempreport->GetNumLinkColliding(); ++ipair) {
+                        CollisionReport::LinkPairIndices collidingpair = ptempreport->GetLinkCollidingIndices(ipair);
+                        if( collidingpair.bodyid1 == robotid ) {
+                            if( find(_vchildlinkindices.begin(), _vchildlinkindices.end(), collidingpair.linkindex1) != _vchildlinkindices.end() ) {
                                 bIsEndEffectorCollision = true;
                                 break;
                             }
                         }
-                        if( itcollidingpairs->second->GetParent() == probot ) {
-                            if( find(_vchildlinkindices.begin(), _vchildlinkindices.end(), itcollidingpairs->second->GetIndex()) != _vchildlinkindices.end() ) {
+                        if( collidingpair.bodyid2 == robotid ) {
+                            if( find(_vchildlinkindices.begin(), _vchildlinkindices.end(), collidingpair.linkindex2) != _vchildlinkindices.end() ) {
                                 bIsEndEffectorCollision = true;
                                 break;
                             }
@@ -2432,6 +2909,17 @@ protected:
 
     bool _bEmptyTransform6D; ///< if true, then the iksolver has been built with identity of the manipulator transform. Only valid for Transform6D IKs.
 
+    //@{
+    // opt-in caches enabled with the SetIkCache command
+    ikfastsolvers::IkLRUCache< std::pair<bool, ikfast::IkSolutionList<IkReal> > > _rawikcache; ///< results of _CallIk, independent of the scene so they are reused when collisions change
+    ikfastsolvers::IkLRUCache< std::pair<bool, std::vector<IkReturn> > > _filteredikcache; ///< results of SolveAll, keyed with the scene state from _GetFilteredIkCacheKey
+    dReal _fIkCacheQuantization; ///< scene values of the cache keys are rounded to multiples of this
+    int _nIkCacheSceneStamp; ///< incremented whenever the scene that the filters check changes, see _GetFilteredIkCacheKey
+    UserDataPtr _cbikcachebodies, _cbikcacherobot; ///< registered while the filtered cache is used
+    std::map<KinBody*, std::pair<UserDataPtr, UserDataPtr> > _mapIkCacheBodyCallbacks; ///< geometry and transform callbacks of the bodies other than the robot
+    std::vector<dReal> _vIkCacheDOFValues; ///< cache for _GetFilteredIkCacheKey
+    //@}
+
 };
 
 #ifdef OPENRAVE_IKFAST_FLOAT32
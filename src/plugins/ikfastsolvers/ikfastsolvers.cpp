@@ -38,7 +38,10 @@ InterfaceBasePtr CreateInterfaceValidated(InterfaceType type, const std::string&
 {    
     switch(type) {
     case PT_IkSolver: {
-        if( interfacename == "ikfast" ) {
+        if( interfacename == "numericalik" ) {
+            return CreateNumericalIkSolver(penv, sinput);
+        }
+        else if( interfacename == "ikfast" ) {
             string ikfastname;
             sinput >> ikfastname;
             if( !!sinput ) {
@@ -124,6 +127,7 @@ void GetPluginAttributesValidated(PLUGININFO& info)
 {
     info.interfacenames[PT_Module].push_back("ikfast");
     info.interfacenames[PT_IkSolver].push_back("ikfast");
+    info.interfacenames[PT_IkSolver].push_back("numericalik");
     info.interfacenames[PT_IkSolver].push_back("wam7ikfast");
     info.interfacenames[PT_IkSolver].push_back("pa10ikfast");
     info.interfacenames[PT_IkSolver].push_back("pumaikfast");
@@ -0,0 +1,179 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2016 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef OPENRAVE_IKSOLUTIONCACHE_H
+#define OPENRAVE_IKSOLUTIONCACHE_H
+
+#include "plugindefs.h"
+
+namespace ikfastsolvers {
+
+/// \brief key of the ik caches. The query values are stored exactly since nearby queries have different solutions, the scene
+/// values can be quantized so that nearly identical states map to the same key
+class IkCacheKey
+{
+public:
+    IkCacheKey() {
+    }
+
+    inline void Clear() {
+        _vvalues.resize(0);
+    }
+
+    inline void AddInt(int64_t value) {
+        _vvalues.push_back(value);
+    }
+
+    /// \brief adds value rounded to a multiple of fquantization
+    inline void AddValue(dReal value, dReal fquantization) {
+        _vvalues.push_back((int64_t)floor(value/fquantization+0.5));
+    }
+
+    /// \brief adds the bit pattern of value, so only identical values give the same key
+    inline void AddExactValue(dReal value) {
+        if( value == 0 ) {
+            value = 0; // -0 and 0 give the same solutions
+        }
+        int64_t bits = 0;
+        memcpy(&bits, &value, sizeof(value));
+        _vvalues.push_back(bits);
+    }
+
+    inline void AddString(const std::string& value) {
+        AddInt(value.size());
+        FOREACHC(itchar, value) {
+            AddInt(*itchar);
+        }
+    }
+
+    inline void AddIkParameterization(const IkParameterization& param) {
+        AddInt(param.GetType());
+        std::vector<dReal> vvalues(param.GetNumberOfValues());
+        param.GetValues(vvalues.begin());
+        FOREACHC(itvalue, vvalues) {
+            AddExactValue(*itvalue);
+        }
+    }
+
+    inline void AddTransform(const Transform& t, dReal fquantization) {
+        for(int i = 0; i < 4; ++i) {
+            AddValue(t.rot[i], fquantization);
+        }
+        for(int i = 0; i < 3; ++i) {
+            AddValue(t.trans[i], fquantization);
+        }
+    }
+
+    inline void AddExactTransform(const Transform& t) {
+        for(int i = 0; i < 4; ++i) {
+            AddExactValue(t.rot[i]);
+        }
+        for(int i = 0; i < 3; ++i) {
+            AddExactValue(t.trans[i]);
+        }
+    }
+
+    inline bool operator<(const IkCacheKey& r) const {
+        return _vvalues < r._vvalues;
+    }
+
+    std::vector<int64_t> _vvalues;
+};
+
+/// \brief least recently used cache with a fixed number of entries that counts its hits and misses
+template <typename T>
+class IkLRUCache
+{
+    typedef std::list< std::pair<IkCacheKey, T> > EntryList;
+public:
+    IkLRUCache() : _maxsize(0), _numhits(0), _nummisses(0) {
+    }
+
+    /// \brief sets the maximum number of entries, 0 disables the cache
+    void SetMaxSize(size_t maxsize) {
+        _maxsize = maxsize;
+        while( _listentries.size() > _maxsize ) {
+            _mapentries.erase(_listentries.back().first);
+            _listentries.pop_back();
+        }
+    }
+
+    inline size_t GetMaxSize() const {
+        return _maxsize;
+    }
+
+    inline size_t GetSize() const {
+        return _listentries.size();
+    }
+
+    /// \brief returns the cached value of key and marks it as most recently used, or NULL if key is not in the cache
+    const T* Find(const IkCacheKey& key) {
+        typename std::map<IkCacheKey, typename EntryList::iterator>::iterator itentry = _mapentries.find(key);
+        if( itentry == _mapentries.end() ) {
+            ++_nummisses;
+            return NULL;
+        }
+        ++_numhits;
+        _listentries.splice(_listentries.begin(), _listentries, itentry->second);
+        return &itentry->second->second;
+    }
+
+    /// \brief inserts value as the most recently used entry, evicting the least recently used one if full
+    void Insert(const IkCacheKey& key, const T& value) {
+        if( _maxsize == 0 ) {
+            return;
+        }
+        typename std::map<IkCacheKey, typename EntryList::iterator>::iterator itentry = _mapentries.find(key);
+        if( itentry != _mapentries.end() ) {
+            itentry->second->second = value;
+            _listentries.splice(_listentries.begin(), _listentries, itentry->second);
+            return;
+        }
+        if( _listentries.size() >= _maxsize ) {
+            _mapentries.erase(_listentries.back().first);
+            _listentries.pop_back();
+        }
+        _listentries.push_front(std::make_pair(key, value));
+        _mapentries[key] = _listentries.begin();
+    }
+
+    /// \brief removes all entries, keeps the statistics
+    void Clear() {
+        _listentries.clear();
+        _mapentries.clear();
+    }
+
+    void ResetStatistics() {
+        _numhits = 0;
+        _nummisses = 0;
+    }
+
+    inline uint64_t GetNumHits() const {
+        return _numhits;
+    }
+    inline uint64_t GetNumMisses() const {
+        return _nummisses;
+    }
+
+private:
+    size_t _maxsize;
+    EntryList _listentries; ///< most recently used first
+    std::map<IkCacheKey, typename EntryList::iterator> _mapentries;
+    uint64_t _numhits, _nummisses;
+};
+
+} // end namespace ikfastsolvers
+
+#endif
@@ -50,6 +50,7 @@ private:
 public:
     JacobianInverseSolver() {
         _errorthresh2 = 1e-12;
+        _lambda2 = 1e-12;
         _lastiter = -1;
         _nMaxIterations = 100;
     }
@@ -90,6 +91,14 @@ public:
         _nMaxIterations = nMaxIterations;
     }
 
+    /// \brief sets the damping lambda of the least squares step J^t (J J^t + lambda^2 I)^-1
+    ///
+    /// The default is 1e-6, which barely damps and converges fast close to the goal. Larger values are more stable near singularities.
+    void SetDampingFactor(T lambda)
+    {
+        _lambda2 = lambda*lambda;
+    }
+
     T GetErrorThresh() const
     {
         return RaveSqrt(_errorthresh2);
@@ -127,7 +136,7 @@ public:
             return -1;
         }
 
-        const T lambda2 = 1e-12;         // normalization constant, changes the rate of convergence, but also improves convergence stability
+        const T lambda2 = _lambda2;
         using namespace boost::numeric::ublas;
 
         T firsterror2 = totalerror2;
@@ -325,7 +334,7 @@ public:
             return -1;
         }
 
-        const T lambda2 = 1e-12;         // normalization constant, changes the rate of convergence, but also improves convergence stability
+        const T lambda2 = _lambda2;
         using namespace boost::numeric::ublas;
 
         T firsterror2 = totalerror2;
@@ -571,6 +580,7 @@ protected:
     Vector _vGoalQuat, _vGoalAxisAngle, _vGoalPosition;
     std::vector<dReal> _viweights, _vcachevalues;
     T _errorthresh2;
+    T _lambda2; ///< normalization constant, changes the rate of convergence, but also improves convergence stability
     std::vector<dReal> _vjacobian;
     boost::numeric::ublas::matrix<T> _J, _Jt, _invJJt, _invJ, _error, _qdelta;
 
@@ -0,0 +1,325 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2016 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+
+#ifdef OPENRAVE_HAS_LAPACK
+
+#include <boost/bind.hpp>
+
+#include "jacobianinverse.h"
+
+/// \brief solves the inverse kinematics with damped least squares iterations of \ref ikfastsolvers::JacobianInverseSolver
+///
+/// Used while the ikfast solver of a manipulator is being generated. The iterations start from q0, the current
+/// configuration and then random configurations inside the joint limits, so unlike ikfast there is no guarantee
+/// that all the solutions are found.
+class NumericalIkSolver : public IkSolverBase
+{
+public:
+    NumericalIkSolver(EnvironmentBasePtr penv, std::istream& sinput) : IkSolverBase(penv), _numrestarts(20), _fDampingFactor(1e-3), _fErrorThresh(1e-5), _nMaxIterations(200), _ikthreshold(1e-4)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nNumerical inverse kinematics with damped least squares for Transform6D and Translation3D, used as a fallback while ikfast solvers are generated.";
+        RegisterCommand("SetSolverParameters",boost::bind(&NumericalIkSolver::_SetSolverParametersCommand,this,_1,_2),
+                        "format: int [dReal] [dReal] [int]\n\n\
+numrestarts damping errorthresh maxiterations, the number of random configurations the iterations restart from when q0 and the current configuration fail (default 20), the damping lambda of the least squares step (default 1e-3), the allowed workspace error (default 1e-5) and the max iterations of every restart (default 200).");
+        _psampler = RaveCreateSpaceSampler(penv, "mt19937");
+        if( !!_psampler ) {
+            _psampler->SetSeed(0);
+        }
+        _UpdateJacobianSolver();
+    }
+
+    virtual bool Init(RobotBase::ManipulatorConstPtr pmanip)
+    {
+        _pmanip.reset();
+        _kinematicshash.clear();
+        if( !pmanip ) {
+            return false;
+        }
+        RobotBase::ManipulatorPtr pmanipnonconst = pmanip->GetRobot()->GetManipulator(pmanip->GetName());
+        if( !pmanipnonconst ) {
+            return false;
+        }
+        RobotBasePtr probot = pmanipnonconst->GetRobot();
+        RobotBase::RobotStateSaver saver(probot);
+        probot->SetActiveDOFs(pmanipnonconst->GetArmIndices());
+        _jacobinvsolver.Init(*pmanipnonconst);
+        probot->GetDOFLimits(_vlower, _vupper, pmanipnonconst->GetArmIndices());
+        _kinematicshash = pmanipnonconst->GetInverseKinematicsStructureHash(IKP_Transform6D);
+        _pmanip = pmanipnonconst;
+        return true;
+    }
+
+    virtual RobotBase::ManipulatorPtr GetManipulator() const {
+        return _pmanip.lock();
+    }
+
+    virtual bool Supports(IkParameterizationType iktype) const
+    {
+        RobotBase::ManipulatorPtr pmanip = _pmanip.lock();
+        if( !pmanip ) {
+            return false;
+        }
+        if( iktype == IKP_Transform6D ) {
+            return pmanip->GetArmDOF() >= 6;
+        }
+        if( iktype == IKP_Translation3D ) {
+            return pmanip->GetArmDOF() >= 3;
+        }
+        return false;
+    }
+
+    /// \brief the iterations move all the joints, so there are no free parameters
+    virtual int GetNumFreeParameters() const {
+        return 0;
+    }
+
+    virtual bool GetFreeParameters(std::vector<dReal>& vFreeParameters) const {
+        vFreeParameters.resize(0);
+        return true;
+    }
+
+    virtual bool GetFreeIndices(std::vector<int>& vFreeIndices) const {
+        vFreeIndices.resize(0);
+        return true;
+    }
+
+    virtual const std::string& GetKinematicsStructureHash() const {
+        return _kinematicshash;
+    }
+
+    virtual bool Solve(const IkParameterization& param, const std::vector<dReal>& q0, int filteroptions, boost::shared_ptr< std::vector<dReal> > result)
+    {
+        std::vector< std::vector<dReal> > vsolutions;
+        _SolveFromSeeds(param, q0, filteroptions, 1, vsolutions);
+        if( vsolutions.size() == 0 ) {
+            return false;
+        }
+        if( !!result ) {
+            *result = vsolutions[0];
+        }
+        IkReturnPtr ikreturn(new IkReturn(IKRA_Success));
+        ikreturn->_vsolution = vsolutions[0];
+        _CallFinishCallbacks(ikreturn, RobotBase::ManipulatorConstPtr(_pmanip.lock()), param);
+        return true;
+    }
+
+    virtual bool SolveAll(const IkParameterization& param, int filteroptions, std::vector< std::vector<dReal> >& qSolutions)
+    {
+        _SolveFromSeeds(param, std::vector<dReal>(), filteroptions, std::numeric_limits<size_t>::max(), qSolutions);
+        return qSolutions.size() > 0;
+    }
+
+    /// \brief there are no free parameters, so vFreeParameters is ignored
+    virtual bool Solve(const IkParameterization& param, const std::vector<dReal>& q0, const std::vector<dReal>& vFreeParameters, int filteroptions, boost::shared_ptr< std::vector<dReal> > result)
+    {
+        return Solve(param, q0, filteroptions, result);
+    }
+
+    /// \brief there are no free parameters, so vFreeParameters is ignored
+    virtual bool SolveAll(const IkParameterization& param, const std::vector<dReal>& vFreeParameters, int filteroptions, std::vector< std::vector<dReal> >& qSolutions)
+    {
+        return SolveAll(param, filteroptions, qSolutions);
+    }
+
+    virtual void Clone(InterfaceBaseConstPtr preference, int cloningoptions)
+    {
+        IkSolverBase::Clone(preference,cloningoptions);
+        boost::shared_ptr<NumericalIkSolver const> r = boost::dynamic_pointer_cast<NumericalIkSolver const>(preference);
+        _numrestarts = r->_numrestarts;
+        _fDampingFactor = r->_fDampingFactor;
+        _fErrorThresh = r->_fErrorThresh;
+        _nMaxIterations = r->_nMaxIterations;
+        _ikthreshold = r->_ikthreshold;
+        _UpdateJacobianSolver();
+    }
+
+protected:
+    bool _SetSolverParametersCommand(ostream& sout, istream& sinput)
+    {
+        int numrestarts = 0;
+        sinput >> numrestarts;
+        if( !sinput || numrestarts < 0 ) {
+            return false;
+        }
+        _numrestarts = numrestarts;
+        dReal fDampingFactor = 0, fErrorThresh = 0;
+        int nMaxIterations = 0;
+        if( !!(sinput >> fDampingFactor) ) {
+            _fDampingFactor = fDampingFactor;
+            if( !!(sinput >> fErrorThresh) ) {
+                _fErrorThresh = fErrorThresh;
+                if( !!(sinput >> nMaxIterations) ) {
+                    _nMaxIterations = nMaxIterations;
+                }
+            }
+        }
+        _UpdateJacobianSolver();
+        return true;
+    }
+
+    void _UpdateJacobianSolver()
+    {
+        _jacobinvsolver.SetDampingFactor(_fDampingFactor);
+        _jacobinvsolver.SetErrorThresh(_fErrorThresh);
+        _jacobinvsolver.SetMaxIterations(_nMaxIterations);
+    }
+
+    /// \brief iterates from q0, the current configuration and random configurations, and adds the solutions that pass the filters
+    ///
+    /// \param param the goal in the manipulator's base frame
+    /// \param nmaxsolutions stop after this many solutions are found
+    void _SolveFromSeeds(const IkParameterization& param, const std::vector<dReal>& q0, int filteroptions, size_t nmaxsolutions, std::vector< std::vector<dReal> >& vsolutions)
+    {
+        vsolutions.resize(0);
+        RobotBase::ManipulatorPtr pmanip(_pmanip);
+        if( param.GetType() != IKP_Transform6D && param.GetType() != IKP_Translation3D ) {
+            RAVELOG_WARN_FORMAT("env=%d, numerical ik does not support %s", GetEnv()->GetId()%param.GetType());
+            return;
+        }
+        RobotBasePtr probot = pmanip->GetRobot();
+        RobotBase::RobotStateSaver saver(probot);
+        probot->SetActiveDOFs(pmanip->GetArmIndices());
+        const bool bIgnoreJointLimits = !!(filteroptions & IKFO_IgnoreJointLimits);
+        Transform tgoal;
+        if( param.GetType() == IKP_Transform6D ) {
+            tgoal = param.GetTransform6D();
+        }
+        else {
+            tgoal.trans = param.GetTranslation3D();
+        }
+
+        std::vector<KinBody::LinkPtr> vchildlinks;
+        pmanip->GetChildLinks(vchildlinks);
+        std::vector<dReal> vseed, vsolution, vsample;
+        probot->GetActiveDOFValues(vseed);
+        const std::vector<dReal> vinitialvalues = vseed;
+        int numseeds = _numrestarts + 1 + (q0.size() == vseed.size() ? 1 : 0);
+        for(int iseed = 0; iseed < numseeds && vsolutions.size() < nmaxsolutions; ++iseed) {
+            if( iseed == 0 && q0.size() == vseed.size() ) {
+                vseed = q0;
+            }
+            else if( iseed <= (q0.size() == vseed.size() ? 1 : 0) ) {
+                vseed = vinitialvalues;
+            }
+            else {
+                if( !_psampler ) {
+                    break;
+                }
+                _psampler->SampleSequence(vsample, vseed.size(), IT_Closed);
+                for(size_t j = 0; j < vseed.size(); ++j) {
+                    if( _vupper[j]-_vlower[j] <= 2*PI ) {
+                        vseed[j] = _vlower[j] + vsample[j]*(_vupper[j]-_vlower[j]);
+                    }
+                    else {
+                        vseed[j] = -PI + vsample[j]*2*PI;
+                    }
+                }
+            }
+            probot->SetActiveDOFValues(vseed, bIgnoreJointLimits ? KinBody::CLA_Nothing : KinBody::CLA_CheckLimitsSilent);
+            probot->GetActiveDOFValues(vsolution);
+            int ret = 0;
+            if( param.GetType() == IKP_Transform6D ) {
+                ret = _jacobinvsolver.ComputeSolution(tgoal, *pmanip, vsolution, bIgnoreJointLimits);
+            }
+            else {
+                ret = _jacobinvsolver.ComputeSolutionTranslation(tgoal, *pmanip, vsolution, bIgnoreJointLimits);
+            }
+            if( ret != 1 && ret != -1 ) {
+                continue;
+            }
+
+            probot->SetActiveDOFValues(vsolution, KinBody::CLA_Nothing);
+            if( pmanip->GetIkParameterization(param.GetType(), false).ComputeDistanceSqr(param) > _ikthreshold ) {
+                continue;
+            }
+            if( _IsDuplicate(vsolution, vsolutions) ) {
+                continue;
+            }
+            IkReturnAction action = _CheckSolution(param, pmanip, vchildlinks, filteroptions, vsolution);
+            if( action & IKRA_Quit ) {
+                break;
+            }
+            if( action == IKRA_Success ) {
+                vsolutions.push_back(vsolution);
+            }
+        }
+    }
+
+    /// \brief checks the collisions and calls the custom filters, the robot is at the solution
+    IkReturnAction _CheckSolution(const IkParameterization& param, RobotBase::ManipulatorPtr pmanip, const std::vector<KinBody::LinkPtr>& vchildlinks, int filteroptions, std::vector<dReal>& vsolution)
+    {
+        RobotBasePtr probot = pmanip->GetRobot();
+        if( !(filteroptions & IKFO_IgnoreSelfCollisions) && probot->CheckSelfCollision() ) {
+            return IKRA_RejectSelfCollision;
+        }
+        if( filteroptions & IKFO_CheckEnvCollisions ) {
+            if( filteroptions & IKFO_IgnoreEndEffectorEnvCollisions ) {
+                FOREACHC(itlink, probot->GetLinks()) {
+                    if( (*itlink)->IsEnabled() && find(vchildlinks.begin(), vchildlinks.end(), *itlink) == vchildlinks.end() && GetEnv()->CheckCollision(KinBody::LinkConstPtr(*itlink)) ) {
+                        return IKRA_RejectEnvCollision;
+                    }
+                }
+            }
+            else if( GetEnv()->CheckCollision(KinBodyConstPtr(probot)) ) {
+                return IKRA_RejectEnvCollision;
+            }
+        }
+        if( !(filteroptions & IKFO_IgnoreCustomFilters) ) {
+            return _CallFilters(vsolution, pmanip, param);
+        }
+        return IKRA_Success;
+    }
+
+    bool _IsDuplicate(const std::vector<dReal>& vsolution, const std::vector< std::vector<dReal> >& vsolutions) const
+    {
+        FOREACHC(itsolution, vsolutions) {
+            dReal fmaxdiff = 0;
+            for(size_t j = 0; j < vsolution.size(); ++j) {
+                fmaxdiff = max(fmaxdiff, RaveFabs(vsolution[j]-itsolution->at(j)));
+            }
+            if( fmaxdiff <= 1e-3 ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    RobotBase::ManipulatorWeakPtr _pmanip;
+    ikfastsolvers::JacobianInverseSolver<dReal> _jacobinvsolver;
+    SpaceSamplerBasePtr _psampler; ///< samples the restart configurations with a fixed seed so that results are repeatable
+    std::vector<dReal> _vlower, _vupper; ///< joint limits of the arm
+    std::string _kinematicshash;
+    int _numrestarts;
+    dReal _fDampingFactor, _fErrorThresh;
+    int _nMaxIterations;
+    dReal _ikthreshold; ///< squared workspace distance that the converged solutions have to be under
+};
+
+IkSolverBasePtr CreateNumericalIkSolver(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return IkSolverBasePtr(new NumericalIkSolver(penv, sinput));
+}
+
+#else
+
+IkSolverBasePtr CreateNumericalIkSolver(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    RAVELOG_WARN("numerical ik needs lapack\n");
+    return IkSolverBasePtr();
+}
+
+#endif
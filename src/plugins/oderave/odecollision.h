@@ -220,6 +220,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Body/Env");
         CollisionCallbackData cb(shared_checker(),report,pbody,KinBody::LinkConstPtr());
         if(( pbody->GetLinks().size() == 0) || !pbody->IsEnabled() ) {
             return false;
@@ -239,6 +240,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Body/Body");
         CollisionCallbackData cb(shared_checker(),report,pbody1,KinBody::LinkConstPtr());
         if(( pbody1->GetLinks().size() == 0) || !pbody1->IsEnabled() ) {
             return false;
@@ -278,6 +280,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Link/Env");
         CollisionCallbackData cb(shared_checker(),report,KinBodyPtr(),plink);
         if( !plink->IsEnabled() ) {
             RAVELOG_VERBOSE("calling collision on disabled link %s\n", plink->GetName().c_str());
@@ -326,6 +329,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink1, KinBody::LinkConstPtr plink2, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Link/Link");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -443,6 +447,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Link/Body");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -492,6 +497,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Link/Env excluded");
         if(( vlinkexcluded.size() == 0) &&( vbodyexcluded.size() == 0) ) {
             return CheckCollision(plink,report);
         }
@@ -504,6 +510,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Body/Env excluded");
         CollisionCallbackData cb(shared_checker(),report,pbody,KinBody::LinkConstPtr());
         if(( pbody->GetLinks().size() == 0) || !pbody->IsEnabled() ) {
             return false;
@@ -529,6 +536,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Ray/Link");
         if( !!report ) {
             report->Reset(_options);
         }
@@ -650,6 +658,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Ray/Body");
         CollisionCallbackData cb(shared_checker(),report,pbody,KinBody::LinkConstPtr());
         if(( pbody->GetLinks().size() == 0) || !pbody->IsEnabled() ) {
             return false;
@@ -677,6 +686,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision Ray/Env");
         CollisionCallbackData cb(shared_checker(),report,KinBodyPtr(),KinBody::LinkConstPtr());
         cb.fraymaxdist = OpenRAVE::RaveSqrt(ray.dir.lengthsqr3());
 
@@ -709,12 +719,14 @@ public:
 
     virtual bool CheckCollision(const OpenRAVE::TriMesh& trimesh, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckCollision TriMesh/Body");
         RAVELOG_WARN("ODE doesn't support trimesh/body collision call");
         return false; //TODO
     }
 
     virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckStandaloneSelfCollision Body");
         if( _options & OpenRAVE::CO_Distance ) {
             RAVELOG_WARN("ode doesn't support CO_Distance\n");
             return false;
@@ -771,6 +783,7 @@ public:
 
     virtual bool CheckStandaloneSelfCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("ode CheckStandaloneSelfCollision Link");
         if( _options & OpenRAVE::CO_Distance ) {
             RAVELOG_WARN("ode doesn't support CO_Distance\n");
             return false;
@@ -171,6 +171,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody1, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Body/Env");
         if(!!report) {
             report->Reset(_options);
         }
@@ -182,6 +183,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Body/Body");
         if(!!report) {
             report->Reset(_options);
         }
@@ -202,12 +204,14 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Link/Env");
         _pactiverobot.reset();
         return CheckCollision(plink, vector<KinBodyConstPtr>(), vector<KinBody::LinkConstPtr>(),report);
     }
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink1, KinBody::LinkConstPtr plink2, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Link/Link");
         if(!!report) {
             report->Reset(_options);
         }
@@ -222,6 +226,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Link/Body");
         if(!!report ) {
             report->Reset(_options);
         }
@@ -241,6 +246,7 @@ public:
 
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Link/Env excluded");
         if(!!report) {
             report->Reset(_options);
         }
@@ -313,6 +319,7 @@ public:
 
     virtual bool CheckCollision(KinBodyConstPtr pbody, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Body/Env excluded");
         if(!!report ) {
             report->Reset(_options);
         }
@@ -330,6 +337,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Ray/Link");
         if(!!report ) {
             report->Reset(_options);
         }
@@ -339,6 +347,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Ray/Body");
         if(!!report ) {
             report->Reset(_options);
         }
@@ -348,6 +357,7 @@ public:
 
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision Ray/Env");
         if(!!report ) {
             report->Reset(_options);
         }
@@ -357,12 +367,14 @@ public:
 
     virtual bool CheckCollision(const TriMesh& trimesh, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr())
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckCollision TriMesh/Body");
         RAVELOG_WARN("pqp does not support trimesh/body check\n");
         return false;
     }
 
     virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckStandaloneSelfCollision Body");
         if( pbody->GetLinks().size() <= 1 ) {
             return false;
         }
@@ -387,6 +399,7 @@ public:
 
     virtual bool CheckStandaloneSelfCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_SCOPE("pqp CheckStandaloneSelfCollision Link");
         KinBodyPtr pbody = plink->GetParent();
         if( pbody->GetLinks().size() <= 1 ) {
             return false;
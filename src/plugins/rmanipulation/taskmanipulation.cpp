@@ -74,6 +74,10 @@ Task-based manipulation planning involving target objects. A lot of the algorith
 * savepreshapetraj\n\
 * grasptranslationstepmult\n\
 * graspfinestep\n\
+* numthreads\n\
+* maxfeasiblegrasps\n\
+\n\
+If numthreads is greater than 1, the grasps are evaluated in batches on that many cloned environments before they are planned. A batch goes through the grasps in order until maxfeasiblegrasps (default seedgrasps) of them are feasible. The grasps are evaluated serially if the ik solver has custom filters, since the clones cannot call them.\n\
 ");
         RegisterCommand("CloseFingers",boost::bind(&TaskManipulation::ChuckFingers,this,_1,_2),
                         "Chucks the active manipulator fingers using the grasp planner along manip->GetChuckingDirection().");
@@ -355,6 +359,78 @@ protected:
         bool _bPadded;
     };
 
+    /// \brief the grasp table and the options of GraspPlanning that the evaluation of one grasp depends on
+    struct GraspEvaluationOptions
+    {
+        const dReal* pgrasps;
+        int nGraspDim;
+        int iGraspDir, iGraspPos, iGraspRoll, iGraspPreshape, iGraspStandoff, imanipulatordirection, iGraspTranslationOffset, iGraspTransform, iGraspTransformNoCol;
+        dReal fApproachOffset;
+        int nMobileAffine;
+        int nMaxSeedDests;
+        Transform transTarg; ///< original transform of the target
+        std::vector<int> vgripperindices;
+        std::vector<dReal> vCurRobotValues, vHandLowerLimits, vHandUpperLimits;
+        std::vector<Transform> vObjDestinations;
+    };
+
+    /// \brief the robot, target and grasper planner that grasps are evaluated with.
+    ///
+    /// The parallel evaluation gives every thread its own evaluator on a cloned environment.
+    struct GraspEvaluator
+    {
+        EnvironmentBasePtr penv;
+        RobotBasePtr probot;
+        RobotBase::ManipulatorConstPtr pmanip;
+        KinBodyPtr ptarget;
+        PlannerBasePtr pgrasperplanner;
+        TrajectoryBasePtr phandtraj;
+        boost::shared_ptr<GraspParameters> graspparams;
+        std::vector<KinBody::LinkPtr> vmanipchildlinks;
+        IkReturnPtr ikreturn;
+        CollisionReportPtr report;
+        std::vector<dReal> vtrajdata, vikgoal;
+    };
+
+    /// \brief the result of evaluating one grasp
+    struct GraspCandidate
+    {
+        GraspCandidate() : bEvaluated(false), bFeasible(false) {
+        }
+        bool bEvaluated;
+        bool bFeasible; ///< true if the grasp and its approach have collision-free ik solutions and the target can be put at a destination
+        std::vector<dReal> vgoalpreshape;
+        std::vector<int> vdestpermutation; ///< order the destinations are tried in, set before evaluating
+        IkParameterization tApproachEndEffector;
+        std::vector<dReal> viksolution;
+        std::list<IkParameterization> listDests;
+    };
+
+    /// \brief the range of candidates of a parallel evaluation batch that the threads take from
+    struct GraspEvaluationQueue
+    {
+        boost::mutex mutex;
+        int next, end;
+    };
+
+    /// \brief destroys the cloned environments of the grasp evaluators
+    class GraspEvaluatorsDestroyer
+    {
+public:
+        GraspEvaluatorsDestroyer(std::vector<GraspEvaluator>& vevaluators) : _vevaluators(vevaluators) {
+        }
+        ~GraspEvaluatorsDestroyer() {
+            FOREACH(itevaluator, _vevaluators) {
+                if( !!itevaluator->penv ) {
+                    itevaluator->penv->Destroy();
+                }
+            }
+            _vevaluators.clear();
+        }
+protected:
+        std::vector<GraspEvaluator>& _vevaluators;
+    };
+
     bool GraspPlanning(ostream& sout, istream& sinput)
     {
         RobotBase::ManipulatorConstPtr pmanip = _robot->GetActiveManipulator();
@@ -387,6 +463,8 @@ protected:
         int iGraspTransform = -1;     // if >= 0, use the grasp transform to check for collisions
         int iGraspTransformNoCol = -1;
         int iStartCountdown = 40;
+        int numthreads = 1; // if > 1, evaluates the grasps in parallel on cloned environments before planning them
+        int nMaxFeasibleGrasps = 0; // number of feasible grasps every parallel evaluation looks for, if <= 0 uses nMaxSeedGrasps
         string cmd;
         CollisionReportPtr report(new CollisionReport);
         Vector vLocalGraspTranslationOffset;
@@ -509,6 +587,12 @@ protected:
             else if( cmd == "graspfinestep" ) {
                 sinput >> graspparams->ffinestep;
             }
+            else if( cmd == "numthreads" ) {
+                sinput >> numthreads;
+            }
+            else if( cmd == "maxfeasiblegrasps" ) {
+                sinput >> nMaxFeasibleGrasps;
+            }
             else {
                 RAVELOG_WARN(str(boost::format("unrecognized command: %s\n")%cmd));
                 break;
@@ -577,9 +661,7 @@ protected:
 
         string strResponse;
         Transform transTarg = ptarget->GetTransform();
-        Transform transInvTarget = transTarg.inverse();
         Transform transDummy(Vector(1,0,0,0), Vector(100,0,0));
-        vector<dReal> viksolution, vikgoal, vFinalGripperValues;
 
         PRESHAPETRAJMAP mapPreshapeTrajectories;
         {
@@ -592,11 +674,11 @@ protected:
             mapPreshapeTrajectories[vCurHandValues] = pstarttraj;
         }
 
-        IkReturnPtr ikreturn(new IkReturn(IKRA_Success));
         TrajectoryBasePtr ptraj;
         GRASPGOAL goalFound;
         int iCountdown = 0;
-        uint64_t nSearchTime = 0;
+        uint64_t nSearchTime = 0, nEvaluationTime = 0;
+        uint64_t nStartTime = utils::GetMicroTime();
 
         list<GRASPGOAL> listGraspGoals;
 
@@ -620,10 +702,12 @@ protected:
                 RAVELOG_ERROR("grasp indices not all initialized\n");
                 return false;
             }
+            if( !pmanip->GetIkSolver()->Supports(IKP_Transform6D) ) {
+                RAVELOG_ERROR("grasper problem not valid, the grasper planner needs a transform6d ik solver\n");
+                return false;
+            }
         }
 
-        _phandtraj.reset();
-
         vector<dReal> vtrajdata;
         UserDataPtr ikfilter;
         if( pmanip->GetIkSolver()->Supports(IKP_TranslationDirection5D) ) {
@@ -632,6 +716,63 @@ protected:
             //fApproachOffset = 0; // cannot approach?
         }
 
+        GraspEvaluationOptions options;
+        options.pgrasps = vgrasps.size() > 0 ? &vgrasps[0] : NULL;
+        options.nGraspDim = nGraspDim;
+        options.iGraspDir = iGraspDir;
+        options.iGraspPos = iGraspPos;
+        options.iGraspRoll = iGraspRoll;
+        options.iGraspPreshape = iGraspPreshape;
+        options.iGraspStandoff = iGraspStandoff;
+        options.imanipulatordirection = imanipulatordirection;
+        options.iGraspTranslationOffset = iGraspTranslationOffset;
+        options.iGraspTransform = iGraspTransform;
+        options.iGraspTransformNoCol = iGraspTransformNoCol;
+        options.fApproachOffset = fApproachOffset;
+        options.nMobileAffine = nMobileAffine;
+        options.nMaxSeedDests = nMaxSeedDests;
+        options.transTarg = transTarg;
+        options.vgripperindices = pmanip->GetGripperIndices();
+        options.vCurRobotValues = vCurRobotValues;
+        options.vHandLowerLimits = vHandLowerLimits;
+        options.vHandUpperLimits = vHandUpperLimits;
+        options.vObjDestinations = vObjDestinations;
+
+        GraspEvaluator evaluator;
+        evaluator.penv = GetEnv();
+        evaluator.probot = _robot;
+        evaluator.pmanip = pmanip;
+        evaluator.ptarget = ptarget;
+        evaluator.pgrasperplanner = _pGrasperPlanner;
+        evaluator.graspparams = graspparams;
+        evaluator.vmanipchildlinks = vmanipchildlinks;
+        evaluator.ikreturn.reset(new IkReturn(IKRA_Success));
+        evaluator.report = report;
+        GraspCandidate serialcandidate;
+
+        // if numthreads > 1, the grasps are evaluated in batches on cloned environments ahead of the planning
+        std::vector<GraspEvaluator> vevaluators;
+        GraspEvaluatorsDestroyer evaluatorsdestroyer(vevaluators);
+        boost::shared_ptr<utils::ThreadPool> pthreadpool;
+        std::vector<GraspCandidate> vcandidates;
+        int numcandidates = 0; // number of grasps in vgrasppermuation that the parallel evaluation has gone through
+        if( numthreads > 1 ) {
+            if( pmanip->GetIkSolver()->HasCustomFilters() ) {
+                // the filters are bound to the state of their owners and are not copied by IkSolverBase::Clone, this includes the filter of translationdirection5d grasping
+                RAVELOG_WARN("the ik solver has custom filters that cannot be used on other threads, so evaluating the grasps serially\n");
+            }
+            else {
+                // the clones have to have the regular models
+                geometrypadder.SwitchRegular();
+                _InitGraspEvaluators(numthreads, evaluator, vevaluators);
+                pthreadpool.reset(new utils::ThreadPool(numthreads));
+                vcandidates.resize(vgrasppermuation.size());
+                if( nMaxFeasibleGrasps <= 0 ) {
+                    nMaxFeasibleGrasps = nMaxSeedGrasps;
+                }
+            }
+        }
+
         for(int igraspperm = 0; igraspperm < (int)vgrasppermuation.size(); ++igraspperm) {
             int igrasp = vgrasppermuation[igraspperm];
             dReal* pgrasp = &vgrasps[igrasp*nGraspDim];
@@ -650,26 +791,23 @@ protected:
                 }
             }
 
-            vector<dReal> vgoalpreshape(vCurHandValues.size());
-            if( iGraspPreshape >= 0 ) {
-                bool badpreshape = false;
-                for(size_t j = 0; j < vCurHandValues.size(); ++j) {
-                    vgoalpreshape[j] = pgrasp[iGraspPreshape+j];
-                    if( vHandLowerLimits.at(j) > vgoalpreshape[j]+0.001 || vHandUpperLimits.at(j) < vgoalpreshape[j]-0.001 ) {
-                        RAVELOG_WARN(str(boost::format("bad preshape index %d (%f)!")%j%vgoalpreshape[j]));
-                        badpreshape = true;
-                        break;
-                    }
+            GraspCandidate* pcandidate = &serialcandidate;
+            vector<dReal> vgoalpreshape;
+            if( vevaluators.size() > 0 ) {
+                if( igraspperm >= numcandidates ) {
+                    geometrypadder.SwitchRegular();
+                    uint64_t basestart = utils::GetMicroTime();
+                    numcandidates = _EvaluateGraspsParallel(*pthreadpool, vevaluators, options, vgrasppermuation, igraspperm, nMaxFeasibleGrasps, bRandomDests, vcandidates);
+                    nEvaluationTime += utils::GetMicroTime() - basestart;
                 }
-                if( badpreshape ) {
+                pcandidate = &vcandidates[igraspperm];
+                if( !pcandidate->bFeasible ) {
                     continue;
                 }
+                vgoalpreshape = pcandidate->vgoalpreshape;
             }
-            else {
-                vgoalpreshape.resize(pmanip->GetGripperIndices().size());
-                for(size_t j = 0; j < pmanip->GetGripperIndices().size(); ++j) {
-                    vgoalpreshape[j] = vCurRobotValues[pmanip->GetGripperIndices()[j]];
-                }
+            else if( !_GetGraspPreshape(options, igrasp, vgoalpreshape) ) {
+                continue;
             }
 
             PRESHAPETRAJMAP::iterator itpreshapetraj = mapPreshapeTrajectories.find(vgoalpreshape);
@@ -679,283 +817,19 @@ protected:
                 continue;
             }
 
-            // reset the padded models since will be solving for IK and checking grasps
-            geometrypadder.SwitchRegular();
-
-            IkParameterization tGoalEndEffector;
-            // set the goal preshape
-            _robot->SetActiveDOFs(pmanip->GetGripperIndices(), DOF_NoTransform);
-            _robot->SetActiveDOFValues(vgoalpreshape,true);
-
-            dReal fGraspApproachOffset = fApproachOffset;
-
-            if( !!_pGrasperPlanner && pmanip->GetIkSolver()->Supports(IKP_Transform6D) ) {
-                _robot->SetActiveDOFs(pmanip->GetGripperIndices(), DOF_X|DOF_Y|DOF_Z);
-                if( !_phandtraj ) {
-                    _phandtraj = RaveCreateTrajectory(GetEnv(),"");
-                }
-                _phandtraj->Init(_robot->GetActiveConfigurationSpecification());
-                graspparams->fstandoff = pgrasp[iGraspStandoff];
-                graspparams->targetbody = ptarget;
-                graspparams->ftargetroll = pgrasp[iGraspRoll];
-                graspparams->vtargetdirection = Vector(pgrasp[iGraspDir], pgrasp[iGraspDir+1], pgrasp[iGraspDir+2]);
-                graspparams->vtargetposition = Vector(pgrasp[iGraspPos], pgrasp[iGraspPos+1], pgrasp[iGraspPos+2]);
-                if( imanipulatordirection >= 0 ) {
-                    graspparams->vmanipulatordirection = Vector(pgrasp[imanipulatordirection], pgrasp[imanipulatordirection+1], pgrasp[imanipulatordirection+2]);
-                }
-                else {
-                    graspparams->vmanipulatordirection = pmanip->GetLocalToolDirection();
-                }
-                if( iGraspTranslationOffset >= 0 ) {
-                    RAVELOG_WARN("igrasptranslationoffset not supported yet\n");
-                }
-                graspparams->btransformrobot = true;
-                graspparams->breturntrajectory = false;
-                graspparams->bonlycontacttarget = true;
-                graspparams->btightgrasp = false;
-                graspparams->bavoidcontact = true;
-                // TODO: in order to reproduce the same exact conditions as the original grasp, have to also transfer the step sizes
-
-                KinBody::KinBodyStateSaver robotlinksaver(_robot, KinBody::Save_LinkEnable);
-                
-                // disable all links not children to the manipulator
-                FOREACHC(itlink,_robot->GetLinks()) {
-                    if( std::find(vmanipchildlinks.begin(),vmanipchildlinks.end(),*itlink) == vmanipchildlinks.end() ) {
-                        (*itlink)->Enable(false);
-                    }
-                }
-                
-                if( !_pGrasperPlanner->InitPlan(_robot,graspparams) ) {
-                    RAVELOG_DEBUG("grasper planner failed: %d\n", igrasp);
-                    continue;
-                }
-                
-                if( !_pGrasperPlanner->PlanPath(_phandtraj).GetStatusCode() ) {
-                    RAVELOG_DEBUG("grasper planner failed: %d\n", igrasp);
-                    continue;
-                }
-
-                BOOST_ASSERT(_phandtraj->GetNumWaypoints()>0);
-                _phandtraj->GetWaypoint(-1,vtrajdata);
-                Transform t = _robot->GetTransform();
-                _phandtraj->GetConfigurationSpecification().ExtractTransform(t,vtrajdata.begin(),_robot);
-
-                Vector vglobalpalmdir;
-                if( iGraspDir >= 0 ) {
-                    vglobalpalmdir = transTarg.rotate(Vector(pgrasp[iGraspDir], pgrasp[iGraspDir+1], pgrasp[iGraspDir+2]));
-                }
-                else {
-                    vglobalpalmdir = pmanip->GetTransform().rotate(pmanip->GetLocalToolDirection());
-                }
-
-                // move back a little if robot/target in collision
-                if( !!ptarget ) {
-                    RobotBase::RobotStateSaver saverlocal(_robot);
-                    _robot->SetTransform(t);
-                    dReal fstep=0;
-                    dReal fstepbacksize = 0.001f;
-                    while(GetEnv()->CheckCollision(KinBodyConstPtr(_robot),KinBodyConstPtr(ptarget))) {
-                        t.trans -= vglobalpalmdir*fstepbacksize;
-                        fGraspApproachOffset -= fstepbacksize;
-                        fstep += fstepbacksize;
-                        _robot->SetTransform(t);
-                    }
-                    if( fstep > 0 ) {
-                        RAVELOG_DEBUG(str(boost::format("grasp %d: moved %f along direction=[%f,%f,%f]")%igrasp%fstep% -vglobalpalmdir.x% -vglobalpalmdir.y% -vglobalpalmdir.z));
-                    }
-                }
-
-                // find the end effector transform
-                tGoalEndEffector.SetTransform6D(t * _robot->GetTransform().inverse() * pmanip->GetTransform());
-
-                if( iGraspTransform >= 0 ) {
-                    // use the grasp transform to figure out how much backing to compensate for, this is just a sanity check
-                    dReal* pm = pgrasp+iGraspTransform;
-                    TransformMatrix tmexpected;
-                    tmexpected.m[0] = pm[0]; tmexpected.m[1] = pm[3]; tmexpected.m[2] = pm[6]; tmexpected.trans.x = pm[9];
-                    tmexpected.m[4] = pm[1]; tmexpected.m[5] = pm[4]; tmexpected.m[6] = pm[7]; tmexpected.trans.y = pm[10];
-                    tmexpected.m[8] = pm[2]; tmexpected.m[9] = pm[5]; tmexpected.m[10] = pm[8]; tmexpected.trans.z = pm[11];
-                    Transform texpectedglobal = ptarget->GetTransform() * Transform(tmexpected);
-                    dReal dist = vglobalpalmdir.dot3(tGoalEndEffector.GetTransform6D().trans-texpectedglobal.trans);
-                    fGraspApproachOffset = fApproachOffset+dist;
-                }
-
-                if( fGraspApproachOffset < 0 ) {
-                    RAVELOG_WARN(str(boost::format("grasp %d: moved too far back to avoid collision, approach offset is now negative (%f) and cannot recover. Should increase approachoffset")%igrasp%fGraspApproachOffset));
-                }
-
-                vFinalGripperValues.resize(pmanip->GetGripperIndices().size(),0);
-                _phandtraj->GetConfigurationSpecification().ExtractJointValues(vFinalGripperValues.begin(),vtrajdata.begin(),_robot,pmanip->GetGripperIndices());
-            }
-            else if( iGraspTransformNoCol >= 0 ) {
-                vFinalGripperValues.resize(0);
-
-                // use the grasp transform
-                dReal* pm = pgrasp+iGraspTransformNoCol;
-                TransformMatrix tm, tgoal;
-                tm.m[0] = pm[0]; tm.m[1] = pm[3]; tm.m[2] = pm[6]; tm.trans.x = pm[9];
-                tm.m[4] = pm[1]; tm.m[5] = pm[4]; tm.m[6] = pm[7]; tm.trans.y = pm[10];
-                tm.m[8] = pm[2]; tm.m[9] = pm[5]; tm.m[10] = pm[8]; tm.trans.z = pm[11];
-                if( !ptarget ) {
-                    tgoal = tm;
-                }
-                else {
-                    tgoal = ptarget->GetTransform() * Transform(tm);
-                }
-
-                if( pmanip->GetIkSolver()->Supports(IKP_TranslationDirection5D) ) {
-                    // get a valid transformation
-                    tGoalEndEffector.SetTranslationDirection5D(RAY(tgoal.trans,tgoal.rotate(pmanip->GetLocalToolDirection())));
-                    if( !pmanip->FindIKSolution(tGoalEndEffector,IKFO_CheckEnvCollisions, ikreturn) ) {
-                        RAVELOG_DEBUG(str(boost::format("grasp %d: ik 5d failed reason 0x%x")%igrasp%ikreturn->_action));
-                        continue; // failed
-                    }
-                    vFinalGripperValues = _vFinalGripperValues;
-                }
-                else if( pmanip->GetIkSolver()->Supports(IKP_Transform6D) ) {
-                    tGoalEndEffector.SetTransform6D(tgoal);
-                    KinBody::KinBodyStateSaver saver(ptarget,KinBody::Save_LinkEnable);
-                    ptarget->Enable(false);
-                    if( pmanip->CheckEndEffectorCollision(tgoal,report) ) {
-                        RAVELOG_DEBUG(str(boost::format("grasp %d: in collision (%s)\n")%igrasp%report->__str__()));
-                        continue;
-                    }
-                }
-                else {
-                    throw OPENRAVE_EXCEPTION_FORMAT("manipulator %s does not support ik types transform6d or translationdirection5d necessing for grasp planning\n", pmanip->GetName(), ORE_InvalidArguments);
-                }
-            }
-            else {
-                RAVELOG_ERROR(str(boost::format("grasp %d: grasper problem not valid")%igrasp));
-                return false;
-            }
-
-            // set the initial hand joints
-            _robot->SetActiveDOFs(pmanip->GetGripperIndices());
-            if( pmanip->GetGripperIndices().size() > 0 && iGraspPreshape >= 0 ) {
-                _robot->SetActiveDOFValues(vector<dReal>(pgrasp+iGraspPreshape,pgrasp+iGraspPreshape+_robot->GetActiveDOF()),true);
-            }
-
-            IkParameterization tApproachEndEffector = tGoalEndEffector;
-            if( !nMobileAffine ) {
-                // check ik
-                Vector vglobalpalmdir;
-                if( iGraspDir >= 0 ) {
-                    vglobalpalmdir = transTarg.rotate(Vector(pgrasp[iGraspDir], pgrasp[iGraspDir+1], pgrasp[iGraspDir+2]));
-                }
-                else {
-                    if( tApproachEndEffector.GetType() == IKP_Transform6D ) {
-                        vglobalpalmdir = tApproachEndEffector.GetTransform6D().rotate(pmanip->GetLocalToolDirection());
-                    }
-                    else {
-                        vglobalpalmdir = tApproachEndEffector.GetTranslationDirection5D().dir;
-                    }
-                }
-
-                // first test the IK solution at the destination tGoalEndEffector
-                if( !pmanip->FindIKSolution(tApproachEndEffector, viksolution, IKFO_CheckEnvCollisions) ) {
-                    RAVELOG_DEBUG("grasp %d: No IK solution found (final)\n", igrasp);
-                    continue;
-                }
-
-                // switch to reguar models?
+            if( vevaluators.size() == 0 ) {
+                // reset the padded models since will be solving for IK and checking grasps
                 geometrypadder.SwitchRegular();
-
-                if( fGraspApproachOffset > 0 ) {
-                    Transform tsmalloffset;
-                    // now test at the approach point (with offset)
-                    tsmalloffset.trans = -fGraspApproachOffset * vglobalpalmdir;
-                    tApproachEndEffector = tsmalloffset*tApproachEndEffector;
-
-                    // set the previous robot ik configuration to get the closest configuration!!
-                    _robot->SetActiveDOFs(pmanip->GetArmIndices());
-                    _robot->SetActiveDOFValues(viksolution);
-                    if( !pmanip->FindIKSolution(tApproachEndEffector, viksolution, IKFO_CheckEnvCollisions) ) {
-                        _robot->SetDOFValues(vCurRobotValues);     // reset robot to original position
-                        RAVELOG_DEBUG("grasp %d: No IK solution found (approach)\n", igrasp);
-                        continue;
-                    }
-                    else {
-                        stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
-                        ss << "ikfound = [";
-                        FOREACH(it, viksolution) {
-                            ss << *it << ", ";
-                        }
-                        ss << "]" << endl;
-                        RAVELOG_DEBUG(ss.str());
-                    }
+                if( bRandomDests ) {
+                    PermutateRandomly(vdestpermuation);
                 }
-            }
-
-            // set the joints that the grasper plugin calculated
-            _robot->SetActiveDOFs(pmanip->GetGripperIndices());
-            if( vFinalGripperValues.size() > 0 ) {
-                _robot->SetActiveDOFValues(vFinalGripperValues, true);
-            }
-
-            // should test destination with original models
-            geometrypadder.SwitchRegular();
-
-            list< IkParameterization > listDests;
-            if( bRandomDests ) {
-                PermutateRandomly(vdestpermuation);
-            }
-
-            for(int idestperm = 0; idestperm < (int)vdestpermuation.size(); ++idestperm) {
-                Transform& transDestTarget = vObjDestinations[vdestpermuation[idestperm]];
-                IkParameterization tDestEndEffector = (transDestTarget * transInvTarget) * tGoalEndEffector;
-                ptarget->SetTransform(transDestTarget);
-                bool bTargetCollision;
-                {
-                    RobotBase::RobotStateSaver linksaver(_robot,KinBody::Save_LinkEnable);
-                    _robot->Enable(false);     // remove robot from target collisions
-                    bTargetCollision = GetEnv()->CheckCollision(KinBodyConstPtr(ptarget),report);
-                }
-
-                ptarget->SetTransform(transTarg);
-                if( bTargetCollision ) {
-                    if( IS_DEBUGLEVEL(Level_Verbose) ) {
-                        std::stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
-                        ss << str(boost::format("target collision at dest %d, %s, pose=")%vdestpermuation[idestperm]%report->__str__());
-                        ss << transDestTarget;
-                        ss << std::endl;
-                        RAVELOG_VERBOSE(ss.str());
-                    }
+                serialcandidate.vdestpermutation = vdestpermuation;
+                uint64_t basestart = utils::GetMicroTime();
+                bool bFeasible = _EvaluateGrasp(evaluator, options, igrasp, vgoalpreshape, serialcandidate);
+                nEvaluationTime += utils::GetMicroTime() - basestart;
+                if( !bFeasible ) {
                     continue;
                 }
-
-                if( !nMobileAffine ) {
-                    bool bSuccess = pmanip->FindIKSolution(tDestEndEffector, vikgoal, IKFO_CheckEnvCollisions);
-                    if( bSuccess ) {
-                        listDests.push_back(tDestEndEffector);
-                    }
-                    if( IS_DEBUGLEVEL(Level_Verbose) ) {
-                        std::stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
-                        if( bSuccess ) {
-                            ss << "succeeded ";
-                        }
-                        else {
-                            ss << "failed ";
-                        }
-                        ss << "dest IkParameterization('" << tDestEndEffector << "')";
-                        RAVELOG_VERBOSE(ss.str());
-
-                    }
-                }
-                else {
-                    listDests.push_back(tDestEndEffector);
-                }
-
-                if( (int)listDests.size() >= nMaxSeedDests ) {
-                    break;
-                }
-            }
-
-            _robot->SetDOFValues(vCurRobotValues);     // reset robot to original position
-
-            if(( vObjDestinations.size() > 0) &&( listDests.size() == 0) ) {
-                RAVELOG_WARN("grasp %d: could not find destination\n", igrasp);
-                continue;
             }
 
             // finally start planning
@@ -965,6 +839,7 @@ protected:
                 // not present in map, so look for correct one
                 // initial joint is far from desired preshape, have to plan to get to it
                 // note that this changes trajectory of robot!
+                _robot->SetActiveDOFs(pmanip->GetGripperIndices());
                 _robot->SetActiveDOFValues(vCurHandValues, true);
 
                 _robot->SetActiveDOFs(pmanip->GetArmIndices());
@@ -1001,9 +876,9 @@ protected:
             listGraspGoals.push_back(GRASPGOAL());
             GRASPGOAL& goal = listGraspGoals.back();
             goal.graspindex = igrasp;
-            goal.tgrasp = tApproachEndEffector;
-            goal.viksolution = viksolution;
-            goal.listDests.swap(listDests);
+            goal.tgrasp = pcandidate->tApproachEndEffector;
+            goal.viksolution = pcandidate->viksolution;
+            goal.listDests.swap(pcandidate->listDests);
             goal.vpreshape.resize(pmanip->GetGripperIndices().size());
             if( iGraspPreshape >= 0 ) {
                 for(int j = 0; j < (int)goal.vpreshape.size(); ++j) {
@@ -1042,6 +917,7 @@ protected:
         // turn off padding since will be performing the final trajectory stiching
         geometrypadder.SwitchRegular();
 
+        RAVELOG_DEBUG_FORMAT("env=%d, grasp planning took %fs, evaluating grasps %fs on %d threads, planning %fs, success=%d", GetEnv()->GetId()%(1e-6*(utils::GetMicroTime()-nStartTime))%(1e-6*nEvaluationTime)%std::max((int)vevaluators.size(), 1)%(1e-6*nSearchTime)%(!!ptraj));
         if( !ptraj ) {
             return false;     // couldn't not find any grasps
         }
@@ -1761,6 +1637,421 @@ protected:
         return ptraj;
     }
 
+    /// \brief gets the preshape of grasp igrasp, returns false if it is out of the hand limits
+    bool _GetGraspPreshape(const GraspEvaluationOptions& options, int igrasp, std::vector<dReal>& vgoalpreshape)
+    {
+        const dReal* pgrasp = options.pgrasps + igrasp*options.nGraspDim;
+        vgoalpreshape.resize(options.vgripperindices.size());
+        if( options.iGraspPreshape >= 0 ) {
+            for(size_t j = 0; j < vgoalpreshape.size(); ++j) {
+                vgoalpreshape[j] = pgrasp[options.iGraspPreshape+j];
+                if( options.vHandLowerLimits.at(j) > vgoalpreshape[j]+0.001 || options.vHandUpperLimits.at(j) < vgoalpreshape[j]-0.001 ) {
+                    RAVELOG_WARN(str(boost::format("bad preshape index %d (%f)!")%j%vgoalpreshape[j]));
+                    return false;
+                }
+            }
+        }
+        else {
+            for(size_t j = 0; j < options.vgripperindices.size(); ++j) {
+                vgoalpreshape[j] = options.vCurRobotValues[options.vgripperindices[j]];
+            }
+        }
+        return true;
+    }
+
+    /// \brief checks if the robot of the evaluator can reach grasp igrasp with collision-free ik solutions and put the target at one of the destinations
+    ///
+    /// The environment of the evaluator has to be locked and the robot has to have the regular models.
+    /// \param candidate the destinations are tried in candidate.vdestpermutation, gets filled with the grasp goal
+    /// \return true if the grasp is feasible
+    bool _EvaluateGrasp(GraspEvaluator& evaluator, const GraspEvaluationOptions& options, int igrasp, const std::vector<dReal>& vgoalpreshape, GraspCandidate& candidate)
+    {
+        candidate.bEvaluated = true;
+        candidate.bFeasible = false;
+        candidate.viksolution.resize(0);
+        candidate.listDests.clear();
+
+        EnvironmentBasePtr penv = evaluator.penv;
+        RobotBasePtr probot = evaluator.probot;
+        RobotBase::ManipulatorConstPtr pmanip = evaluator.pmanip;
+        KinBodyPtr ptarget = evaluator.ptarget;
+        boost::shared_ptr<GraspParameters> graspparams = evaluator.graspparams;
+        const dReal* pgrasp = options.pgrasps + igrasp*options.nGraspDim;
+        const Transform& transTarg = options.transTarg;
+        std::vector<dReal>& vtrajdata = evaluator.vtrajdata;
+        std::vector<dReal>& viksolution = candidate.viksolution;
+        std::vector<dReal> vFinalGripperValues;
+
+        IkParameterization tGoalEndEffector;
+        // set the goal preshape
+        probot->SetActiveDOFs(pmanip->GetGripperIndices(), DOF_NoTransform);
+        probot->SetActiveDOFValues(vgoalpreshape,true);
+
+        dReal fGraspApproachOffset = options.fApproachOffset;
+
+        if( !!evaluator.pgrasperplanner && pmanip->GetIkSolver()->Supports(IKP_Transform6D) ) {
+            probot->SetActiveDOFs(pmanip->GetGripperIndices(), DOF_X|DOF_Y|DOF_Z);
+            if( !evaluator.phandtraj ) {
+                evaluator.phandtraj = RaveCreateTrajectory(penv,"");
+            }
+            evaluator.phandtraj->Init(probot->GetActiveConfigurationSpecification());
+            graspparams->fstandoff = pgrasp[options.iGraspStandoff];
+            graspparams->targetbody = ptarget;
+            graspparams->ftargetroll = pgrasp[options.iGraspRoll];
+            graspparams->vtargetdirection = Vector(pgrasp[options.iGraspDir], pgrasp[options.iGraspDir+1], pgrasp[options.iGraspDir+2]);
+            graspparams->vtargetposition = Vector(pgrasp[options.iGraspPos], pgrasp[options.iGraspPos+1], pgrasp[options.iGraspPos+2]);
+            if( options.imanipulatordirection >= 0 ) {
+                graspparams->vmanipulatordirection = Vector(pgrasp[options.imanipulatordirection], pgrasp[options.imanipulatordirection+1], pgrasp[options.imanipulatordirection+2]);
+            }
+            else {
+                graspparams->vmanipulatordirection = pmanip->GetLocalToolDirection();
+            }
+            if( options.iGraspTranslationOffset >= 0 ) {
+                RAVELOG_WARN("igrasptranslationoffset not supported yet\n");
+            }
+            graspparams->btransformrobot = true;
+            graspparams->breturntrajectory = false;
+            graspparams->bonlycontacttarget = true;
+            graspparams->btightgrasp = false;
+            graspparams->bavoidcontact = true;
+            // TODO: in order to reproduce the same exact conditions as the original grasp, have to also transfer the step sizes
+
+            KinBody::KinBodyStateSaver robotlinksaver(probot, KinBody::Save_LinkEnable);
+
+            // disable all links not children to the manipulator
+            FOREACHC(itlink,probot->GetLinks()) {
+                if( std::find(evaluator.vmanipchildlinks.begin(),evaluator.vmanipchildlinks.end(),*itlink) == evaluator.vmanipchildlinks.end() ) {
+                    (*itlink)->Enable(false);
+                }
+            }
+
+            if( !evaluator.pgrasperplanner->InitPlan(probot,graspparams) ) {
+                RAVELOG_DEBUG("grasper planner failed: %d\n", igrasp);
+                return false;
+            }
+
+            if( !evaluator.pgrasperplanner->PlanPath(evaluator.phandtraj).GetStatusCode() ) {
+                RAVELOG_DEBUG("grasper planner failed: %d\n", igrasp);
+                return false;
+            }
+
+            BOOST_ASSERT(evaluator.phandtraj->GetNumWaypoints()>0);
+            evaluator.phandtraj->GetWaypoint(-1,vtrajdata);
+            Transform t = probot->GetTransform();
+            evaluator.phandtraj->GetConfigurationSpecification().ExtractTransform(t,vtrajdata.begin(),probot);
+
+            Vector vglobalpalmdir;
+            if( options.iGraspDir >= 0 ) {
+                vglobalpalmdir = transTarg.rotate(Vector(pgrasp[options.iGraspDir], pgrasp[options.iGraspDir+1], pgrasp[options.iGraspDir+2]));
+            }
+            else {
+                vglobalpalmdir = pmanip->GetTransform().rotate(pmanip->GetLocalToolDirection());
+            }
+
+            // move back a little if robot/target in collision
+            if( !!ptarget ) {
+                RobotBase::RobotStateSaver saverlocal(probot);
+                probot->SetTransform(t);
+                dReal fstep=0;
+                dReal fstepbacksize = 0.001f;
+                while(penv->CheckCollision(KinBodyConstPtr(probot),KinBodyConstPtr(ptarget))) {
+                    t.trans -= vglobalpalmdir*fstepbacksize;
+                    fGraspApproachOffset -= fstepbacksize;
+                    fstep += fstepbacksize;
+                    probot->SetTransform(t);
+                }
+                if( fstep > 0 ) {
+                    RAVELOG_DEBUG(str(boost::format("grasp %d: moved %f along direction=[%f,%f,%f]")%igrasp%fstep% -vglobalpalmdir.x% -vglobalpalmdir.y% -vglobalpalmdir.z));
+                }
+            }
+
+            // find the end effector transform
+            tGoalEndEffector.SetTransform6D(t * probot->GetTransform().inverse() * pmanip->GetTransform());
+
+            if( options.iGraspTransform >= 0 ) {
+                // use the grasp transform to figure out how much backing to compensate for, this is just a sanity check
+                const dReal* pm = pgrasp+options.iGraspTransform;
+                TransformMatrix tmexpected;
+                tmexpected.m[0] = pm[0]; tmexpected.m[1] = pm[3]; tmexpected.m[2] = pm[6]; tmexpected.trans.x = pm[9];
+                tmexpected.m[4] = pm[1]; tmexpected.m[5] = pm[4]; tmexpected.m[6] = pm[7]; tmexpected.trans.y = pm[10];
+                tmexpected.m[8] = pm[2]; tmexpected.m[9] = pm[5]; tmexpected.m[10] = pm[8]; tmexpected.trans.z = pm[11];
+                Transform texpectedglobal = ptarget->GetTransform() * Transform(tmexpected);
+                dReal dist = vglobalpalmdir.dot3(tGoalEndEffector.GetTransform6D().trans-texpectedglobal.trans);
+                fGraspApproachOffset = options.fApproachOffset+dist;
+            }
+
+            if( fGraspApproachOffset < 0 ) {
+                RAVELOG_WARN(str(boost::format("grasp %d: moved too far back to avoid collision, approach offset is now negative (%f) and cannot recover. Should increase approachoffset")%igrasp%fGraspApproachOffset));
+            }
+
+            vFinalGripperValues.resize(pmanip->GetGripperIndices().size(),0);
+            evaluator.phandtraj->GetConfigurationSpecification().ExtractJointValues(vFinalGripperValues.begin(),vtrajdata.begin(),probot,pmanip->GetGripperIndices());
+        }
+        else {
+            // use the grasp transform
+            const dReal* pm = pgrasp+options.iGraspTransformNoCol;
+            TransformMatrix tm, tgoal;
+            tm.m[0] = pm[0]; tm.m[1] = pm[3]; tm.m[2] = pm[6]; tm.trans.x = pm[9];
+            tm.m[4] = pm[1]; tm.m[5] = pm[4]; tm.m[6] = pm[7]; tm.trans.y = pm[10];
+            tm.m[8] = pm[2]; tm.m[9] = pm[5]; tm.m[10] = pm[8]; tm.trans.z = pm[11];
+            if( !ptarget ) {
+                tgoal = tm;
+            }
+            else {
+                tgoal = ptarget->GetTransform() * Transform(tm);
+            }
+
+            if( pmanip->GetIkSolver()->Supports(IKP_TranslationDirection5D) ) {
+                // get a valid transformation
+                tGoalEndEffector.SetTranslationDirection5D(RAY(tgoal.trans,tgoal.rotate(pmanip->GetLocalToolDirection())));
+                if( !pmanip->FindIKSolution(tGoalEndEffector,IKFO_CheckEnvCollisions, evaluator.ikreturn) ) {
+                    RAVELOG_DEBUG(str(boost::format("grasp %d: ik 5d failed reason 0x%x")%igrasp%evaluator.ikreturn->_action));
+                    return false; // failed
+                }
+                // set by _FilterIkForGrasping, which is only registered on the environment of the module
+                vFinalGripperValues = _vFinalGripperValues;
+            }
+            else if( pmanip->GetIkSolver()->Supports(IKP_Transform6D) ) {
+                tGoalEndEffector.SetTransform6D(tgoal);
+                KinBody::KinBodyStateSaver saver(ptarget,KinBody::Save_LinkEnable);
+                ptarget->Enable(false);
+                if( pmanip->CheckEndEffectorCollision(tgoal,evaluator.report) ) {
+                    RAVELOG_DEBUG(str(boost::format("grasp %d: in collision (%s)\n")%igrasp%evaluator.report->__str__()));
+                    return false;
+                }
+            }
+            else {
+                throw OPENRAVE_EXCEPTION_FORMAT("manipulator %s does not support ik types transform6d or translationdirection5d necessing for grasp planning\n", pmanip->GetName(), ORE_InvalidArguments);
+            }
+        }
+
+        // set the initial hand joints
+        probot->SetActiveDOFs(pmanip->GetGripperIndices());
+        if( pmanip->GetGripperIndices().size() > 0 && options.iGraspPreshape >= 0 ) {
+            probot->SetActiveDOFValues(vector<dReal>(pgrasp+options.iGraspPreshape,pgrasp+options.iGraspPreshape+probot->GetActiveDOF()),true);
+        }
+
+        IkParameterization tApproachEndEffector = tGoalEndEffector;
+        if( !options.nMobileAffine ) {
+            // check ik
+            Vector vglobalpalmdir;
+            if( options.iGraspDir >= 0 ) {
+                vglobalpalmdir = transTarg.rotate(Vector(pgrasp[options.iGraspDir], pgrasp[options.iGraspDir+1], pgrasp[options.iGraspDir+2]));
+            }
+            else {
+                if( tApproachEndEffector.GetType() == IKP_Transform6D ) {
+                    vglobalpalmdir = tApproachEndEffector.GetTransform6D().rotate(pmanip->GetLocalToolDirection());
+                }
+                else {
+                    vglobalpalmdir = tApproachEndEffector.GetTranslationDirection5D().dir;
+                }
+            }
+
+            // first test the IK solution at the destination tGoalEndEffector
+            if( !pmanip->FindIKSolution(tApproachEndEffector, viksolution, IKFO_CheckEnvCollisions) ) {
+                RAVELOG_DEBUG("grasp %d: No IK solution found (final)\n", igrasp);
+                return false;
+            }
+
+            if( fGraspApproachOffset > 0 ) {
+                Transform tsmalloffset;
+                // now test at the approach point (with offset)
+                tsmalloffset.trans = -fGraspApproachOffset * vglobalpalmdir;
+                tApproachEndEffector = tsmalloffset*tApproachEndEffector;
+
+                // set the previous robot ik configuration to get the closest configuration!!
+                probot->SetActiveDOFs(pmanip->GetArmIndices());
+                probot->SetActiveDOFValues(viksolution);
+                if( !pmanip->FindIKSolution(tApproachEndEffector, viksolution, IKFO_CheckEnvCollisions) ) {
+                    probot->SetDOFValues(options.vCurRobotValues);     // reset robot to original position
+                    RAVELOG_DEBUG("grasp %d: No IK solution found (approach)\n", igrasp);
+                    return false;
+                }
+                else {
+                    stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+                    ss << "ikfound = [";
+                    FOREACH(it, viksolution) {
+                        ss << *it << ", ";
+                    }
+                    ss << "]" << endl;
+                    RAVELOG_DEBUG(ss.str());
+                }
+            }
+        }
+
+        // set the joints that the grasper plugin calculated
+        probot->SetActiveDOFs(pmanip->GetGripperIndices());
+        if( vFinalGripperValues.size() > 0 ) {
+            probot->SetActiveDOFValues(vFinalGripperValues, true);
+        }
+
+        // should test destination with original models
+        Transform transInvTarget = transTarg.inverse();
+        for(int idestperm = 0; idestperm < (int)candidate.vdestpermutation.size(); ++idestperm) {
+            const Transform& transDestTarget = options.vObjDestinations[candidate.vdestpermutation[idestperm]];
+            IkParameterization tDestEndEffector = (transDestTarget * transInvTarget) * tGoalEndEffector;
+            ptarget->SetTransform(transDestTarget);
+            bool bTargetCollision;
+            {
+                RobotBase::RobotStateSaver linksaver(probot,KinBody::Save_LinkEnable);
+                probot->Enable(false);     // remove robot from target collisions
+                bTargetCollision = penv->CheckCollision(KinBodyConstPtr(ptarget),evaluator.report);
+            }
+
+            ptarget->SetTransform(transTarg);
+            if( bTargetCollision ) {
+                if( IS_DEBUGLEVEL(Level_Verbose) ) {
+                    std::stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+                    ss << str(boost::format("target collision at dest %d, %s, pose=")%candidate.vdestpermutation[idestperm]%evaluator.report->__str__());
+                    ss << transDestTarget;
+                    ss << std::endl;
+                    RAVELOG_VERBOSE(ss.str());
+                }
+                continue;
+            }
+
+            if( !options.nMobileAffine ) {
+                bool bSuccess = pmanip->FindIKSolution(tDestEndEffector, evaluator.vikgoal, IKFO_CheckEnvCollisions);
+                if( bSuccess ) {
+                    candidate.listDests.push_back(tDestEndEffector);
+                }
+                if( IS_DEBUGLEVEL(Level_Verbose) ) {
+                    std::stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+                    if( bSuccess ) {
+                        ss << "succeeded ";
+                    }
+                    else {
+                        ss << "failed ";
+                    }
+                    ss << "dest IkParameterization('" << tDestEndEffector << "')";
+                    RAVELOG_VERBOSE(ss.str());
+
+                }
+            }
+            else {
+                candidate.listDests.push_back(tDestEndEffector);
+            }
+
+            if( (int)candidate.listDests.size() >= options.nMaxSeedDests ) {
+                break;
+            }
+        }
+
+        probot->SetDOFValues(options.vCurRobotValues);     // reset robot to original position
+
+        if(( options.vObjDestinations.size() > 0) &&( candidate.listDests.size() == 0) ) {
+            RAVELOG_WARN("grasp %d: could not find destination\n", igrasp);
+            return false;
+        }
+
+        candidate.tApproachEndEffector = tApproachEndEffector;
+        candidate.bFeasible = true;
+        return true;
+    }
+
+    /// \brief creates numthreads evaluators on clones of the environment from the evaluator of the module
+    void _InitGraspEvaluators(int numthreads, const GraspEvaluator& evaluator, std::vector<GraspEvaluator>& vevaluators)
+    {
+        IkSolverBasePtr psolver = evaluator.pmanip->GetIkSolver();
+        int collisionoptions = GetEnv()->GetCollisionChecker()->GetCollisionOptions();
+        vevaluators.resize(numthreads);
+        FOREACH(itevaluator, vevaluators) {
+            EnvironmentBasePtr pcloneenv = GetEnv()->CloneSelf(Clone_Bodies);
+            itevaluator->penv = pcloneenv;
+            pcloneenv->GetCollisionChecker()->SetCollisionOptions(collisionoptions);
+            itevaluator->probot = pcloneenv->GetRobot(evaluator.probot->GetName());
+            RobotBase::ManipulatorPtr pclonemanip = itevaluator->probot->SetActiveManipulator(evaluator.pmanip->GetName());
+            IkSolverBasePtr pclonesolver = RaveCreateIkSolver(pcloneenv, psolver->GetXMLId());
+            pclonesolver->Clone(psolver, 0);
+            pclonemanip->SetIkSolver(pclonesolver);
+            itevaluator->pmanip = pclonemanip;
+            pclonemanip->GetChildLinks(itevaluator->vmanipchildlinks);
+            itevaluator->ptarget = pcloneenv->GetKinBody(evaluator.ptarget->GetName());
+            if( !!evaluator.pgrasperplanner ) {
+                itevaluator->pgrasperplanner = RaveCreatePlanner(pcloneenv, evaluator.pgrasperplanner->GetXMLId());
+            }
+            itevaluator->graspparams.reset(new GraspParameters(pcloneenv));
+            itevaluator->graspparams->ftranslationstepmult = evaluator.graspparams->ftranslationstepmult;
+            itevaluator->graspparams->ffinestep = evaluator.graspparams->ffinestep;
+            itevaluator->ikreturn.reset(new IkReturn(IKRA_Success));
+            itevaluator->report.reset(new CollisionReport());
+        }
+    }
+
+    /// \brief evaluates the grasps of vgrasppermutation from istart on all evaluators in batches until nMaxFeasibleGrasps of them are feasible
+    ///
+    /// The candidates that have already been evaluated are not evaluated again.
+    /// \return the index into vgrasppermutation after the last feasible grasp that was counted, or the number of grasps if there are not enough feasible grasps
+    int _EvaluateGraspsParallel(utils::ThreadPool& pool, std::vector<GraspEvaluator>& vevaluators, const GraspEvaluationOptions& options, const std::vector<int>& vgrasppermutation, int istart, int nMaxFeasibleGrasps, bool bRandomDests, std::vector<GraspCandidate>& vcandidates)
+    {
+        int numgrasps = (int)vgrasppermutation.size();
+        int numfeasible = 0;
+        int iend = istart;
+        std::vector<int> vdestpermutation(options.vObjDestinations.size());
+        for(int i = 0; i < (int)vdestpermutation.size(); ++i) {
+            vdestpermutation[i] = i;
+        }
+        GraspEvaluationQueue queue;
+        std::vector< boost::function<void()> > vtasks;
+        while( iend < numgrasps ) {
+            queue.next = iend;
+            queue.end = std::min(numgrasps, iend + std::max(nMaxFeasibleGrasps-numfeasible, 2*(int)vevaluators.size()));
+            // the preshapes and destination orders are set here since PermutateRandomly is not thread safe
+            for(int igraspperm = queue.next; igraspperm < queue.end; ++igraspperm) {
+                GraspCandidate& candidate = vcandidates[igraspperm];
+                if( candidate.bEvaluated ) {
+                    continue;
+                }
+                if( !_GetGraspPreshape(options, vgrasppermutation[igraspperm], candidate.vgoalpreshape) ) {
+                    candidate.bEvaluated = true;
+                    continue;
+                }
+                if( bRandomDests ) {
+                    PermutateRandomly(vdestpermutation);
+                }
+                candidate.vdestpermutation = vdestpermutation;
+            }
+
+            vtasks.resize(0);
+            FOREACH(itevaluator, vevaluators) {
+                vtasks.push_back(boost::bind(&TaskManipulation::_EvaluateGraspsThread, this, boost::ref(*itevaluator), boost::cref(options), boost::cref(vgrasppermutation), boost::ref(queue), boost::ref(vcandidates)));
+            }
+            pool.RunTasks(vtasks);
+
+            int ibatchend = queue.end;
+            while( iend < ibatchend ) {
+                if( vcandidates[iend++].bFeasible ) {
+                    if( ++numfeasible >= nMaxFeasibleGrasps ) {
+                        RAVELOG_DEBUG_FORMAT("env=%d, evaluated grasps [%d, %d), %d are feasible", GetEnv()->GetId()%istart%iend%numfeasible);
+                        return iend;
+                    }
+                }
+            }
+        }
+        RAVELOG_DEBUG_FORMAT("env=%d, evaluated grasps [%d, %d), %d are feasible", GetEnv()->GetId()%istart%iend%numfeasible);
+        return iend;
+    }
+
+    /// \brief evaluates the candidates of the queue until all are taken
+    void _EvaluateGraspsThread(GraspEvaluator& evaluator, const GraspEvaluationOptions& options, const std::vector<int>& vgrasppermutation, GraspEvaluationQueue& queue, std::vector<GraspCandidate>& vcandidates)
+    {
+        EnvironmentMutex::scoped_lock lock(evaluator.penv->GetMutex());
+        while(1) {
+            int igraspperm;
+            {
+                boost::mutex::scoped_lock lockqueue(queue.mutex);
+                if( queue.next >= queue.end ) {
+                    break;
+                }
+                igraspperm = queue.next++;
+            }
+            GraspCandidate& candidate = vcandidates[igraspperm];
+            if( !candidate.bEvaluated ) {
+                _EvaluateGrasp(evaluator, options, vgrasppermutation[igraspperm], candidate.vgoalpreshape, candidate);
+            }
+        }
+    }
+
     IkReturn _FilterIkForGrasping(std::vector<dReal>& vsolution, RobotBase::ManipulatorConstPtr pmanip, const IkParameterization &ikparam, KinBodyPtr ptarget)
     {
         if( _robot->IsGrabbing(*ptarget) ) {
@@ -133,6 +133,208 @@ bool SampleProjectedOBBWithTest(const OBB& obb, dReal delta, const boost::functi
     return true;
 }
 
+/// \brief depth buffer of the triangles in front of a camera, used to test the visibility of the target without shooting a ray per sample
+///
+/// Every pixel stores the camera z of the closest triangle and the index of the link that the triangle belongs to.
+class VisibilityDepthBuffer
+{
+public:
+    VisibilityDepthBuffer() : _width(0), _height(0), _fnear(0), _dirtyxmin(0), _dirtyxmax(-1), _dirtyymin(0), _dirtyymax(-1) {
+    }
+
+    /// \brief sets the image size and clears the buffer
+    ///
+    /// \param fscale scales the resolution of the camera, for example 0.5 uses a quarter of the pixels
+    /// \param fnear triangles closer to the camera than this are clipped
+    void Init(const SensorBase::CameraIntrinsics& KK, int width, int height, dReal fscale, dReal fnear)
+    {
+        _fx = KK.fx*fscale; _fy = KK.fy*fscale;
+        _cx = KK.cx*fscale; _cy = KK.cy*fscale;
+        _fnear = fnear;
+        int newwidth = std::max(1, (int)(width*fscale)), newheight = std::max(1, (int)(height*fscale));
+        if( newwidth != _width || newheight != _height ) {
+            _width = newwidth;
+            _height = newheight;
+            _vdepth.resize(0);
+            _vdepth.resize(_width*_height, std::numeric_limits<float>::infinity());
+            _vlinkindices.resize(0);
+            _vlinkindices.resize(_width*_height, -1);
+            _dirtyxmin = _dirtyymin = 0;
+            _dirtyxmax = _dirtyymax = -1;
+        }
+        Clear();
+    }
+
+    /// \brief removes all the triangles, only resets the pixels that were rasterized since the last clear
+    void Clear()
+    {
+        for(int y = _dirtyymin; y <= _dirtyymax; ++y) {
+            std::fill(_vdepth.begin()+y*_width+_dirtyxmin, _vdepth.begin()+y*_width+_dirtyxmax+1, std::numeric_limits<float>::infinity());
+            std::fill(_vlinkindices.begin()+y*_width+_dirtyxmin, _vlinkindices.begin()+y*_width+_dirtyxmax+1, -1);
+        }
+        _dirtyxmin = _width; _dirtyxmax = -1;
+        _dirtyymin = _height; _dirtyymax = -1;
+        _vlinknames.resize(0);
+    }
+
+    /// \brief rasterizes all the geometries of the link except pignoregeom
+    ///
+    /// \param tcamerainv the inverse of the camera transform in the world
+    void AddLink(KinBody::LinkConstPtr plink, const Transform& tcamerainv, KinBody::Link::GeometryConstPtr pignoregeom=KinBody::Link::GeometryConstPtr())
+    {
+        int linkindex = (int)_vlinknames.size();
+        _vlinknames.push_back(plink->GetParent()->GetName() + "/" + plink->GetName());
+        Transform tlinkincamera = tcamerainv*plink->GetTransform();
+        FOREACHC(itgeom, plink->GetGeometries()) {
+            if( *itgeom == pignoregeom ) {
+                continue;
+            }
+            const TriMesh& trimesh = (*itgeom)->GetCollisionMesh();
+            Transform t = tlinkincamera*(*itgeom)->GetTransform();
+            _vcameravertices.resize(trimesh.vertices.size());
+            for(size_t i = 0; i < trimesh.vertices.size(); ++i) {
+                _vcameravertices[i] = t*trimesh.vertices[i];
+            }
+            for(size_t i = 0; i+2 < trimesh.indices.size(); i += 3) {
+                _AddTriangle(_vcameravertices.at(trimesh.indices[i]), _vcameravertices.at(trimesh.indices[i+1]), _vcameravertices.at(trimesh.indices[i+2]), linkindex);
+            }
+        }
+    }
+
+    /// \brief returns the depth at a point of the z=1 plane of the camera, infinity if nothing was rasterized there or the point is outside of the image
+    ///
+    /// \param linkindex set to the index of the closest link, or -1
+    inline dReal GetDepth(const Vector& v, int& linkindex) const
+    {
+        int x = (int)std::floor(_fx*v.x + _cx), y = (int)std::floor(_fy*v.y + _cy);
+        if( x < 0 || y < 0 || x >= _width || y >= _height ) {
+            linkindex = -1;
+            return std::numeric_limits<dReal>::infinity();
+        }
+        linkindex = _vlinkindices[y*_width+x];
+        return _vdepth[y*_width+x];
+    }
+
+    inline const std::string& GetLinkName(int linkindex) const {
+        return _vlinknames.at(linkindex);
+    }
+
+private:
+    /// \brief clips the triangle with the near plane and rasterizes the remaining polygon
+    void _AddTriangle(const Vector& v0, const Vector& v1, const Vector& v2, int linkindex)
+    {
+        const Vector* vinput[3] = { &v0, &v1, &v2};
+        Vector vclipped[4];
+        int numclipped = 0;
+        for(int i = 0; i < 3; ++i) {
+            const Vector& vcur = *vinput[i];
+            const Vector& vnext = *vinput[(i+1)%3];
+            bool bcurinside = vcur.z >= _fnear, bnextinside = vnext.z >= _fnear;
+            if( bcurinside ) {
+                vclipped[numclipped++] = vcur;
+            }
+            if( bcurinside != bnextinside ) {
+                dReal f = (_fnear - vcur.z)/(vnext.z - vcur.z);
+                vclipped[numclipped++] = vcur + (vnext-vcur)*f;
+            }
+        }
+        for(int i = 2; i < numclipped; ++i) {
+            _RasterizeTriangle(vclipped[0], vclipped[i-1], vclipped[i], linkindex);
+        }
+    }
+
+    /// \brief rasterizes a triangle whose vertices are all in front of the near plane, the depth is interpolated as 1/z which is linear in the image
+    void _RasterizeTriangle(const Vector& v0, const Vector& v1, const Vector& v2, int linkindex)
+    {
+        dReal finvz0 = 1/v0.z, finvz1 = 1/v1.z, finvz2 = 1/v2.z;
+        dReal x0 = _fx*v0.x*finvz0 + _cx, y0 = _fy*v0.y*finvz0 + _cy;
+        dReal x1 = _fx*v1.x*finvz1 + _cx, y1 = _fy*v1.y*finvz1 + _cy;
+        dReal x2 = _fx*v2.x*finvz2 + _cx, y2 = _fy*v2.y*finvz2 + _cy;
+        dReal farea = (x1-x0)*(y2-y0) - (x2-x0)*(y1-y0);
+        if( RaveFabs(farea) <= g_fEpsilon ) {
+            return;
+        }
+        dReal finvarea = 1/farea;
+        int xmin = std::max(0, (int)std::floor(std::min(x0, std::min(x1, x2))));
+        int xmax = std::min(_width-1, (int)std::ceil(std::max(x0, std::max(x1, x2))));
+        int ymin = std::max(0, (int)std::floor(std::min(y0, std::min(y1, y2))));
+        int ymax = std::min(_height-1, (int)std::ceil(std::max(y0, std::max(y1, y2))));
+        if( xmin > xmax || ymin > ymax ) {
+            return;
+        }
+        _dirtyxmin = std::min(_dirtyxmin, xmin); _dirtyxmax = std::max(_dirtyxmax, xmax);
+        _dirtyymin = std::min(_dirtyymin, ymin); _dirtyymax = std::max(_dirtyymax, ymax);
+        for(int y = ymin; y <= ymax; ++y) {
+            dReal py = y + 0.5;
+            for(int x = xmin; x <= xmax; ++x) {
+                dReal px = x + 0.5;
+                // barycentric coordinates of the pixel center, same sign as the area if inside
+                dReal w0 = ((x1-px)*(y2-py) - (x2-px)*(y1-py))*finvarea;
+                dReal w1 = ((x2-px)*(y0-py) - (x0-px)*(y2-py))*finvarea;
+                dReal w2 = 1 - w0 - w1;
+                if( w0 < 0 || w1 < 0 || w2 < 0 ) {
+                    continue;
+                }
+                float fdepth = (float)(1/(w0*finvz0 + w1*finvz1 + w2*finvz2));
+                int index = y*_width+x;
+                if( fdepth < _vdepth[index] ) {
+                    _vdepth[index] = fdepth;
+                    _vlinkindices[index] = linkindex;
+                }
+            }
+        }
+    }
+
+    dReal _fx, _fy, _cx, _cy;
+    int _width, _height;
+    dReal _fnear;
+    int _dirtyxmin, _dirtyxmax, _dirtyymin, _dirtyymax; ///< bounds of the pixels that were rasterized since the last clear
+    std::vector<float> _vdepth; ///< camera z of every pixel, row major
+    std::vector<int> _vlinkindices; ///< index into _vlinknames of every pixel
+    std::vector<std::string> _vlinknames; ///< body/link names of the rasterized links
+    std::vector<Vector> _vcameravertices; ///< cache
+};
+
+/// \brief compares a sequence of values with the one stored in a vector while overwriting it
+///
+/// Lets a cache keep a single copy of the state it was computed with.
+class SignatureUpdater
+{
+public:
+    SignatureUpdater(std::vector<dReal>& vsignature) : _vsignature(vsignature), _index(0), _bChanged(false) {
+    }
+
+    inline void Add(dReal f)
+    {
+        if( _index < _vsignature.size() ) {
+            if( _vsignature[_index] != f ) {
+                _vsignature[_index] = f;
+                _bChanged = true;
+            }
+        }
+        else {
+            _vsignature.push_back(f);
+            _bChanged = true;
+        }
+        ++_index;
+    }
+
+    /// \brief returns true if the added values differ from the previous ones
+    bool Finish()
+    {
+        if( _index != _vsignature.size() ) {
+            _vsignature.resize(_index);
+            _bChanged = true;
+        }
+        return _bChanged;
+    }
+
+private:
+    std::vector<dReal>& _vsignature;
+    size_t _index;
+    bool _bChanged;
+};
+
 class VisualFeedback : public ModuleBase
 {
 public:
@@ -181,6 +383,7 @@ public:
 
             // create the dummy box
             _vTargetLocalOBBs.reserve(1);
+            _targetbodylinkname = _vf->_targetlink->GetParent()->GetName() + "/" + _vf->_targetlink->GetName();
 
             if( !_vf->_targetlink->IsVisible() ) {
                 throw OPENRAVE_EXCEPTION_FORMAT("no geometries target link %s is visible so cannot use it for visibility checking", _vf->_targetlink->GetName(), ORE_InvalidArguments);
@@ -194,6 +397,7 @@ public:
                 KinBody::Link::GeometryPtr pgeom = _vf->_targetlink->GetGeometries().at(igeom);
                 if( pgeom->IsVisible() && (_vf->_targetGeomName.size() == 0 || pgeom->GetName() == _vf->_targetGeomName) ) {
                     _vTargetLocalOBBs.push_back(geometry::OBBFromAABB(pgeom->ComputeAABB(Transform()), Transform()));
+                    _ptargetgeom = pgeom;
                     break;
                 }
             }
@@ -355,26 +559,26 @@ public:
         /// \param tCameraInTarget in target coordinate system
         bool IsOccluded(const TransformMatrix& tCameraInTarget, bool bOutputError, std::string& errormsg)
         {
-            KinBody::KinBodyStateSaver saver1(_ptargetbox), saver2(_vf->_targetlink->GetParent(),KinBody::Save_LinkEnable);
-            TransformMatrix tCameraInTargetinv = tCameraInTarget.inverse();
-            Transform ttarget = _vf->_targetlink->GetTransform();
-            _ptargetbox->SetTransform(ttarget); // world
-            Transform tworldcamera = ttarget*tCameraInTarget;  // tCameraInTarget is in targetLink coordinates
-            _ptargetbox->Enable(true);
-            SampleRaysScope srs(*this);
             std::string occludingbodyandlinkname = "";
-            FOREACH(itobb,_vTargetLocalOBBs) {  // itobb is in targetlink coordinates
-                OBB cameraobb = geometry::TransformOBB(tCameraInTargetinv,*itobb);
-                // SampleProjectedOBBWithTest usually quits when first occlusion is found, so just passing occludingbodyandlinkname to _TestRay should return the initial occluding part.
-                if( !SampleProjectedOBBWithTest(cameraobb, _vf->_fSampleRayDensity, boost::bind(&VisibilityConstraintFunction::_TestRay, this, _1, boost::ref(tworldcamera), boost::ref(occludingbodyandlinkname)),_vf->_fAllowableOcclusion) ) {
-                    RAVELOG_VERBOSE("box is occluded\n");
-                    errormsg = str(boost::format("{\"type\":\"pattern_occluded\", \"bodylinkname\":\"%s\"}")%occludingbodyandlinkname);
-                    return true;
-                }
+            if( !_SampleTarget(tCameraInTarget, _vf->_fAllowableOcclusion, NULL, occludingbodyandlinkname) ) {
+                RAVELOG_VERBOSE("box is occluded\n");
+                errormsg = str(boost::format("{\"type\":\"pattern_occluded\", \"bodylinkname\":\"%s\"}")%occludingbodyandlinkname);
+                return true;
             }
             return false;
         }
 
+        /// \brief tests every sample of the target like IsOccluded without stopping at the first occluded one
+        ///
+        /// \param tCameraInTarget in target coordinate system
+        /// \param vsamples filled with x, y, and 1 if visible or 0 if occluded, for each sample on the z=1 plane of the camera
+        void GetOcclusionSamples(const TransformMatrix& tCameraInTarget, std::vector<dReal>& vsamples)
+        {
+            std::string occludingbodyandlinkname;
+            vsamples.resize(0);
+            _SampleTarget(tCameraInTarget, 0, &vsamples, occludingbodyandlinkname);
+        }
+
         /// check if just the rigidly attached links of the gripper are in the way
         /// this function is not meant to be called during planning (only database generation)
         bool IsOccludedByRigid(const TransformMatrix& tcamera)
@@ -382,6 +586,31 @@ public:
             KinBody::KinBodyStateSaver saver1(_ptargetbox), saver2(_vf->_targetlink->GetParent());
             vector<KinBody::LinkPtr> vattachedlinks;
             _vf->_psensor->GetAttachingLink()->GetRigidlyAttachedLinks(vattachedlinks);
+            TransformMatrix tcamerainv = tcamera.inverse();
+            if( _vf->_bUseDepthBuffer ) {
+                // the attached links do not move with respect to the camera, so only render them again when the enabled ones change
+                SignatureUpdater signature(_vrigiddepthbuffersignature);
+                FOREACHC(itlink, vattachedlinks) {
+                    signature.Add((*itlink)->IsEnabled());
+                }
+                if( signature.Finish() ) {
+                    Transform tsensorinv = _vf->_psensor->GetTransform().inverse();
+                    _rigiddepthbuffer.Init(_vf->_pcamerageom->KK, _vf->_pcamerageom->width, _vf->_pcamerageom->height, _vf->_fDepthBufferScale, _vf->_fRayMinDist);
+                    FOREACHC(itlink, vattachedlinks) {
+                        if( (*itlink)->IsEnabled() ) {
+                            _rigiddepthbuffer.AddLink(*itlink, tsensorinv);
+                        }
+                    }
+                }
+                std::string occludingbodyandlinkname;
+                FOREACH(itobb,_vTargetLocalOBBs) {
+                    OBB cameraobb = geometry::TransformOBB(tcamerainv,*itobb);
+                    if( !SampleProjectedOBBWithTest(cameraobb, _vf->_fSampleRayDensity, boost::bind(&VisibilityConstraintFunction::_TestDepth, this, _1, boost::cref(cameraobb), boost::cref(_rigiddepthbuffer), (const VisibilityDepthBuffer*)NULL, boost::ref(occludingbodyandlinkname)), 0.0f) ) {
+                        return true;
+                    }
+                }
+                return false;
+            }
             RobotBase::RobotStateSaver robotsaver(_vf->_robot,RobotBase::Save_LinkTransformation|RobotBase::Save_LinkEnable);
             Transform tsensorinv = _vf->_psensor->GetTransform().inverse();
             FOREACHC(itlink,_vf->_robot->GetLinks()) {
@@ -391,7 +620,6 @@ public:
                     (*itlink)->SetTransform(tsensorinv*(*itlink)->GetTransform());
                 }
             }
-            TransformMatrix tcamerainv = tcamera.inverse();
             Transform ttarget = _vf->_targetlink->GetTransform();
             _ptargetbox->SetTransform(ttarget);
             Transform tworldcamera = ttarget*tcamera;
@@ -411,6 +639,53 @@ private:
         ///
         /// \brief v is in camera coordinate system
         /// \brief tcamera is the camera in the world coordinate system
+        /// \brief samples the faces of the target boxes seen by the camera and tests them with the depth buffers or with rays
+        ///
+        /// \param pvsamples if not NULL, all the samples are tested and appended as x, y, visible
+        /// \return false if more than fallowableocclusion of the samples of a box are occluded
+        bool _SampleTarget(const TransformMatrix& tCameraInTarget, dReal fallowableocclusion, std::vector<dReal>* pvsamples, std::string& occludingbodyandlinkname)
+        {
+            KinBody::KinBodyStateSaver saver1(_ptargetbox), saver2(_vf->_targetlink->GetParent(),KinBody::Save_LinkEnable);
+            TransformMatrix tCameraInTargetinv = tCameraInTarget.inverse();
+            Transform ttarget = _vf->_targetlink->GetTransform();
+            _ptargetbox->SetTransform(ttarget); // world
+            Transform tworldcamera = ttarget*tCameraInTarget;  // tCameraInTarget is in targetLink coordinates
+            TransformMatrix tmworldcamera(tworldcamera);
+            if( _vf->_bUseDepthBuffer ) {
+                _UpdateDepthBuffer(tworldcamera);
+            }
+            else {
+                _ptargetbox->Enable(true);
+            }
+            SampleRaysScope srs(*this);
+            FOREACH(itobb,_vTargetLocalOBBs) {  // itobb is in targetlink coordinates
+                OBB cameraobb = geometry::TransformOBB(tCameraInTargetinv,*itobb);
+                boost::function<bool(const Vector&)> testfn;
+                if( _vf->_bUseDepthBuffer ) {
+                    testfn = boost::bind(&VisibilityConstraintFunction::_TestDepth, this, _1, boost::cref(cameraobb), boost::cref(_vf->_staticdepthbuffer), &_vf->_depthbuffer, boost::ref(occludingbodyandlinkname));
+                }
+                else {
+                    // SampleProjectedOBBWithTest usually quits when first occlusion is found, so just passing occludingbodyandlinkname to _TestRay should return the initial occluding part.
+                    testfn = boost::bind(&VisibilityConstraintFunction::_TestRay, this, _1, boost::cref(tmworldcamera), boost::ref(occludingbodyandlinkname));
+                }
+                if( !!pvsamples ) {
+                    testfn = boost::bind(&VisibilityConstraintFunction::_RecordSample, _1, testfn, pvsamples);
+                }
+                if( !SampleProjectedOBBWithTest(cameraobb, _vf->_fSampleRayDensity, testfn, fallowableocclusion) ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static bool _RecordSample(const Vector& v, const boost::function<bool(const Vector&)>& testfn, std::vector<dReal>* pvsamples)
+        {
+            pvsamples->push_back(v.x);
+            pvsamples->push_back(v.y);
+            pvsamples->push_back(testfn(v));
+            return true;
+        }
+
         bool _TestRay(const Vector& v, const TransformMatrix& tcamera, std::string& errormsg)
         {
             RAY r;
@@ -489,6 +764,144 @@ private:
             return true;
         }
 
+        /// \brief returns true if the link can block the view of the camera, follows the collisions that are considered by the rays
+        bool _IsDepthOccluder(KinBody::LinkConstPtr plink) const
+        {
+            if( !plink->IsEnabled() ) {
+                return false;
+            }
+            if( _vf->_bIgnoreSensorCollision && !!_vf->_sensorrobot ) {
+                if( !plink->IsVisible() || plink->GetParent() == _vf->_sensorrobot ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// \brief renders the environment from the camera into _vf->_staticdepthbuffer and _vf->_depthbuffer
+        ///
+        /// The bodies that do not move with the robot are rendered into _vf->_staticdepthbuffer, which is only rendered
+        /// again when the camera or any of those bodies changed. The robot, the sensor robot, and the grabbed bodies are
+        /// rendered into _vf->_depthbuffer every call.
+        /// \param tworldcamera the camera in the world coordinate system
+        void _UpdateDepthBuffer(const Transform& tworldcamera)
+        {
+            EnvironmentBasePtr penv = _vf->_robot->GetEnv();
+            std::vector<KinBodyPtr> vbodies, vdynamicbodies;
+            penv->GetBodies(vbodies);
+            _vf->_robot->GetGrabbed(vdynamicbodies);
+            vdynamicbodies.push_back(_vf->_robot);
+            if( !!_vf->_sensorrobot && _vf->_sensorrobot != _vf->_robot ) {
+                vdynamicbodies.push_back(_vf->_sensorrobot);
+            }
+
+            SignatureUpdater signature(_vf->_vdepthbuffersignature);
+            for(int i = 0; i < 4; ++i) {
+                signature.Add(tworldcamera.rot[i]);
+            }
+            for(int i = 0; i < 3; ++i) {
+                signature.Add(tworldcamera.trans[i]);
+            }
+            const SensorBase::CameraIntrinsics& KK = _vf->_pcamerageom->KK;
+            signature.Add(KK.fx); signature.Add(KK.fy); signature.Add(KK.cx); signature.Add(KK.cy);
+            signature.Add(_vf->_pcamerageom->width); signature.Add(_vf->_pcamerageom->height);
+            signature.Add(_vf->_fDepthBufferScale); signature.Add(_vf->_fRayMinDist); signature.Add(_vf->_bIgnoreSensorCollision);
+            FOREACHC(itbody, vbodies) {
+                if( *itbody == _ptargetbox || find(vdynamicbodies.begin(), vdynamicbodies.end(), *itbody) != vdynamicbodies.end() ) {
+                    continue;
+                }
+                signature.Add((*itbody)->GetEnvironmentId());
+                signature.Add((*itbody)->GetUpdateStamp());
+                FOREACHC(itlink, (*itbody)->GetLinks()) {
+                    signature.Add(_IsDepthOccluder(*itlink));
+                }
+            }
+
+            Transform tcamerainv = tworldcamera.inverse();
+            if( signature.Finish() ) {
+                _vf->_staticdepthbuffer.Init(KK, _vf->_pcamerageom->width, _vf->_pcamerageom->height, _vf->_fDepthBufferScale, _vf->_fRayMinDist);
+                FOREACHC(itbody, vbodies) {
+                    if( *itbody == _ptargetbox || find(vdynamicbodies.begin(), vdynamicbodies.end(), *itbody) != vdynamicbodies.end() ) {
+                        continue;
+                    }
+                    _AddDepthOccluders(_vf->_staticdepthbuffer, *itbody, tcamerainv);
+                }
+            }
+
+            _vf->_depthbuffer.Init(KK, _vf->_pcamerageom->width, _vf->_pcamerageom->height, _vf->_fDepthBufferScale, _vf->_fRayMinDist);
+            FOREACHC(itbody, vdynamicbodies) {
+                _AddDepthOccluders(_vf->_depthbuffer, *itbody, tcamerainv);
+            }
+        }
+
+        void _AddDepthOccluders(VisibilityDepthBuffer& depthbuffer, KinBodyConstPtr pbody, const Transform& tcamerainv)
+        {
+            FOREACHC(itlink, pbody->GetLinks()) {
+                if( _IsDepthOccluder(*itlink) ) {
+                    // the target geometry itself cannot occlude the target
+                    depthbuffer.AddLink(*itlink, tcamerainv, *itlink == _vf->_targetlink ? _ptargetgeom : KinBody::Link::GeometryConstPtr());
+                }
+            }
+        }
+
+        /// \brief return true if nothing in the depth buffers is in front of the target box at v
+        ///
+        /// \param v is a point on the z=1 plane of the camera coordinate system
+        /// \param cameraobb the target box in the camera coordinate system
+        /// \param pdepthbuffer2 if not NULL, also tested
+        bool _TestDepth(const Vector& v, const OBB& cameraobb, const VisibilityDepthBuffer& depthbuffer, const VisibilityDepthBuffer* pdepthbuffer2, std::string& errormsg)
+        {
+            // intersect the ray from the camera center with the box, the distance along v is the z of the intersection
+            dReal ftargetdepth = 0, fexitdepth = std::numeric_limits<dReal>::infinity();
+            const Vector* paxes[3] = { &cameraobb.right, &cameraobb.up, &cameraobb.dir};
+            for(int i = 0; i < 3; ++i) {
+                dReal forigin = -cameraobb.pos.dot3(*paxes[i]), fdir = v.dot3(*paxes[i]);
+                dReal fextent = cameraobb.extents[i];
+                if( RaveFabs(fdir) <= g_fEpsilon ) {
+                    if( RaveFabs(forigin) > fextent ) {
+                        return true; // not supposed to happen, but it is OK
+                    }
+                    continue;
+                }
+                dReal t0 = (-fextent-forigin)/fdir, t1 = (fextent-forigin)/fdir;
+                if( t0 > t1 ) {
+                    std::swap(t0, t1);
+                }
+                ftargetdepth = std::max(ftargetdepth, t0);
+                fexitdepth = std::min(fexitdepth, t1);
+            }
+            if( ftargetdepth > fexitdepth ) {
+                return true; // not supposed to happen, but it is OK
+            }
+
+            int linkindex = -1;
+            const VisibilityDepthBuffer* pclosestbuffer = &depthbuffer;
+            dReal fdepth = depthbuffer.GetDepth(v, linkindex);
+            if( !!pdepthbuffer2 ) {
+                int linkindex2 = -1;
+                dReal fdepth2 = pdepthbuffer2->GetDepth(v, linkindex2);
+                if( fdepth2 < fdepth ) {
+                    fdepth = fdepth2;
+                    linkindex = linkindex2;
+                    pclosestbuffer = pdepthbuffer2;
+                }
+            }
+            // same tolerance as the extents of the target box of the rays
+            if( fdepth >= ftargetdepth - 0.0001 ) {
+                return true;
+            }
+            errormsg = pclosestbuffer->GetLinkName(linkindex);
+            if( errormsg == _targetbodylinkname ) {
+                // like the rays, the target link only occludes the target where its surface is outside of the target box
+                Vector voffset = v*fdepth - cameraobb.pos;
+                if( RaveFabs(voffset.dot3(cameraobb.right)) <= cameraobb.extents.x && RaveFabs(voffset.dot3(cameraobb.up)) <= cameraobb.extents.y && RaveFabs(voffset.dot3(cameraobb.dir)) <= cameraobb.extents.z ) {
+                    return true;
+                }
+            }
+            RAVELOG_VERBOSE_FORMAT("depth buffer has %s in front of the target, reject.", errormsg);
+            return false;
+        }
+
         CollisionAction _IgnoreCollisionCallback(CollisionReportPtr preport, bool IsCalledFromPhysicsEngine)
         {
             if( _bSamplingRays ) {
@@ -508,6 +921,10 @@ private:
         bool _bSamplingRays;
         boost::shared_ptr<VisualFeedback> _vf;
         KinBodyPtr _ptargetbox;         ///< box to represent the target for simulating ray collisions
+        KinBody::Link::GeometryConstPtr _ptargetgeom; ///< the geometry of the target link that has to be visible
+        std::string _targetbodylinkname; ///< body/link name of the target link in the depth buffers
+        VisibilityDepthBuffer _rigiddepthbuffer; ///< the links rigidly attached to the camera, used by IsOccludedByRigid
+        std::vector<dReal> _vrigiddepthbuffersignature; ///< enabled state of the attached links that _rigiddepthbuffer was rendered with
         UserDataPtr _collisionfn;
 
         vector<OBB> _vTargetLocalOBBs;         ///< target geometry bounding boxes in the target link coordinate system
@@ -586,6 +1003,8 @@ Visibility computation checks occlusion with other objects using ray sampling in
         _fSampleRayDensity = 0.001;
         _fAllowableOcclusion = 0.1;
         _fRayMinDist = 0.02f;
+        _bUseDepthBuffer = false;
+        _fDepthBufferScale = 1;
 
         RegisterCommand("SetCameraAndTarget",boost::bind(&VisualFeedback::SetCameraAndTarget,this,_1,_2),
                         "Sets the camera index from the robot and its convex hull");
@@ -598,6 +1017,8 @@ Visibility computation checks occlusion with other objects using ray sampling in
                         "Sets new camera transformations. Can optionally choose a minimum distance from all planes of the camera convex hull (includes gripper mask)");
         RegisterCommand("ComputeVisibility",boost::bind(&VisualFeedback::ComputeVisibility,this,_1,_2),
                         "Computes the visibility of the current robot configuration");
+        RegisterCommand("ComputeVisibilitySamples",boost::bind(&VisualFeedback::ComputeVisibilitySamples,this,_1,_2),
+                        "Tests all the samples of the target at the current robot configuration and returns x y visible for every sample on the z=1 plane of the camera");
         RegisterCommand("ComputeVisibleConfiguration",boost::bind(&VisualFeedback::ComputeVisibleConfiguration,this,_1,_2),
                         "Gives a camera transformation, computes the visibility of the object and returns the robot configuration that takes the camera to its specified position, otherwise returns false");
         RegisterCommand("SampleVisibilityGoal",boost::bind(&VisualFeedback::SampleVisibilityGoal,this,_1,_2),
@@ -607,7 +1028,12 @@ Visibility computation checks occlusion with other objects using ray sampling in
         RegisterCommand("VisualFeedbackGrasping",boost::bind(&VisualFeedback::VisualFeedbackGrasping,this,_1,_2),
                         "Stochastic greedy grasp planner considering visibility");
         RegisterCommand("SetParameter",boost::bind(&VisualFeedback::SetParameter,this,_1,_2),
-                        "Sets internal parameters of visibility computation");
+                        "Sets internal parameters of visibility computation.\n\n\
+:param raydensity: distance between the samples of the target on the z=1 plane of the camera\n\
+:param raymindist: objects closer to the camera than this are ignored\n\
+:param allowableocclusion: the fraction of the target that can be occluded\n\
+:param usedepthbuffer: if 1, renders the occluders into a depth buffer at the camera intrinsics once per camera pose and tests the samples against it instead of shooting a ray per sample\n\
+:param depthbufferscale: scales the resolution of the depth buffer with respect to the camera image");
     }
 
     virtual ~VisualFeedback() {
@@ -624,6 +1050,7 @@ Visibility computation checks occlusion with other objects using ray sampling in
         _pcamerageom.reset();
         _visibilitytransforms.clear();
         _preport.reset();
+        _vdepthbuffersignature.clear();
         ModuleBase::Destroy();
     }
 
@@ -1140,6 +1567,21 @@ Visibility computation checks occlusion with other objects using ray sampling in
         return true;
     }
 
+    bool ComputeVisibilitySamples(ostream& sout, istream& sinput)
+    {
+        RobotBase::RobotStateSaver saver(_robot);
+        _robot->SetActiveManipulator(_pmanip);
+        _robot->SetActiveDOFs(_pmanip->GetArmIndices());
+        boost::shared_ptr<VisibilityConstraintFunction> pconstraintfn(new VisibilityConstraintFunction(shared_problem()));
+
+        std::vector<dReal> vsamples;
+        pconstraintfn->GetOcclusionSamples(_targetlink->GetTransform().inverse()*_psensor->GetTransform(), vsamples);
+        FOREACHC(it, vsamples) {
+            sout << *it << " ";
+        }
+        return true;
+    }
+
     bool SetParameter(ostream& sout, istream& sinput)
     {
         string cmd;
@@ -1160,6 +1602,12 @@ Visibility computation checks occlusion with other objects using ray sampling in
             else if( cmd == "allowableocclusion" ) {
                 sinput >> _fAllowableOcclusion;
             }
+            else if( cmd == "usedepthbuffer" ) {
+                sinput >> _bUseDepthBuffer;
+            }
+            else if( cmd == "depthbufferscale" ) {
+                sinput >> _fDepthBufferScale;
+            }
             else {
                 RAVELOG_WARN(str(boost::format("unrecognized command: %s\n")%cmd));
                 break;
@@ -1481,6 +1929,7 @@ Visibility computation checks occlusion with other objects using ray sampling in
             RAVELOG_DEBUG("using visibility constraints\n");
             boost::shared_ptr<VisibilityConstraintFunction> pconstraint(new VisibilityConstraintFunction(shared_problem(), params->_checkpathvelocityconstraintsfn));
             params->_checkpathvelocityconstraintsfn = boost::bind(&VisibilityConstraintFunction::Constraint,pconstraint,_1,_2,_3,_4,_5,_6,_7,_8);
+            params->_bDefaultFunctions = false;
         }
 
         params->_ptarget = _targetlink->GetParent();
@@ -1539,6 +1988,11 @@ protected:
     Transform _tToManip;     ///< transforms a coord system from the link to the gripper coordsystem. tLinkInWorld * _tToManip = tManipInWorld
     vector<Transform> _visibilitytransforms; ///< the transform with respect to the targetlink and camera (or vice-versa)
     dReal _fRayMinDist, _fAllowableOcclusion, _fSampleRayDensity;
+    bool _bUseDepthBuffer; ///< if true, test the visibility with a depth buffer rather than with rays
+    dReal _fDepthBufferScale; ///< resolution of the depth buffer with respect to the camera image
+    VisibilityDepthBuffer _staticdepthbuffer; ///< the bodies that do not move with the robot seen from the last camera pose
+    std::vector<dReal> _vdepthbuffersignature; ///< camera pose and state of the bodies that _staticdepthbuffer was rendered with
+    VisibilityDepthBuffer _depthbuffer; ///< the robot, the sensor robot and the grabbed bodies seen from the last camera pose, tested together with _staticdepthbuffer
 
     CollisionReportPtr _preport;
 
@@ -36,6 +36,13 @@ struct ManipConstraintInfo2
     dReal fmaxdistfromcenter; ///< maximum distance from any check point to the EE center
     std::vector<int> vuseddofindices; ///< a vector of unique DOF indices targetted for the body
     std::vector<int> vconfigindices;  ///< for every index in vusedofindices, returns the first configuration space index it came from
+
+//@{ kinematics of plink at the last evaluated configuration, see ManipConstraintChecker2::_ComputeEndEffectorVelocitiesAccelerations
+    std::vector<dReal> vcachedkey; ///< robot dof values followed by the base translation and rotation, and 1 if the hessians were computed
+    Transform tcachedlink;
+    std::vector<dReal> vcachedtransjacobian, vcachedrotjacobian; ///< 3xDOF
+    std::vector<dReal> vcachedtranshessian, vcachedrothessian; ///< DOFx3xDOF
+//@}
 };
 
 class ManipConstraintChecker2
@@ -386,7 +393,7 @@ public:
         vDOFAccelAtViolation.resize(0);
 
         if( !(interval == IT_OpenStart) ) {
-            FOREACHC(itmanipinfo, _listCheckManips) {
+            FOREACH(itmanipinfo, _listCheckManips) {
                 bBoundExceeded = false;
                 KinBodyPtr probot = itmanipinfo->plink->GetParent();
                 itrampnd->GetAVect(ac);
@@ -399,19 +406,8 @@ public:
                     _afill[itmanipinfo->vuseddofindices.at(index)] = ac.at(itmanipinfo->vconfigindices[index]);
                 }
 
-                int endeffindex = itmanipinfo->plink->GetIndex();
-                KinBody::KinBodyStateSaver saver(probot, KinBody::Save_LinkTransformation|KinBody::Save_LinkVelocities);
-
-                // Set the robot to the new state
-                probot->SetDOFValues(qfillactive, KinBody::CLA_CheckLimits, itmanipinfo->vuseddofindices);
-                probot->SetDOFVelocities(_vfillactive, KinBody::CLA_CheckLimits, itmanipinfo->vuseddofindices);
-                probot->GetLinkVelocities(endeffvels);
-                probot->GetLinkAccelerations(_afill,endeffaccs);
-                endeffvellin = endeffvels.at(endeffindex).first;
-                endeffvelang = endeffvels.at(endeffindex).second;
-                endeffacclin = endeffaccs.at(endeffindex).first;
-                endeffaccang = endeffaccs.at(endeffindex).second;
-                Transform R = itmanipinfo->plink->GetTransform();
+                Transform R;
+                _ComputeEndEffectorVelocitiesAccelerations(*itmanipinfo, qfillactive, _vfillactive, _afill, R, endeffvellin, endeffvelang, endeffacclin, endeffaccang);
 
                 FOREACH(itpoint, itmanipinfo->checkpoints) {
                     Vector point = R.rotate(*itpoint);
@@ -670,7 +666,7 @@ public:
         // Check manipspeed and manipaccel at the end of the segment
         itrampnd = rampndVect.end() - 1;
         curmanipindex = 0;
-        FOREACHC(itmanipinfo, _listCheckManips) {
+        FOREACH(itmanipinfo, _listCheckManips) {
             bBoundExceeded = false;
             KinBodyPtr probot = itmanipinfo->plink->GetParent();
             itrampnd->GetAVect(ac);
@@ -683,19 +679,8 @@ public:
                 _afill[itmanipinfo->vuseddofindices.at(index)] = ac.at(itmanipinfo->vconfigindices[index]);
             }
 
-            int endeffindex = itmanipinfo->plink->GetIndex();
-            KinBody::KinBodyStateSaver saver(probot, KinBody::Save_LinkTransformation|KinBody::Save_LinkVelocities);
-
-            // Set the robot to the new state
-            probot->SetDOFValues(qfillactive, KinBody::CLA_CheckLimits, itmanipinfo->vuseddofindices);
-            probot->SetDOFVelocities(_vfillactive, KinBody::CLA_CheckLimits, itmanipinfo->vuseddofindices);
-            probot->GetLinkVelocities(endeffvels);
-            probot->GetLinkAccelerations(_afill,endeffaccs);
-            endeffvellin = endeffvels.at(endeffindex).first;
-            endeffvelang = endeffvels.at(endeffindex).second;
-            endeffacclin = endeffaccs.at(endeffindex).first;
-            endeffaccang = endeffaccs.at(endeffindex).second;
-            Transform R = itmanipinfo->plink->GetTransform();
+            Transform R;
+            _ComputeEndEffectorVelocitiesAccelerations(*itmanipinfo, qfillactive, _vfillactive, _afill, R, endeffvellin, endeffvelang, endeffacclin, endeffaccang);
 
             FOREACH(itpoint, itmanipinfo->checkpoints) {
                 Vector point = R.rotate(*itpoint);
@@ -936,6 +921,87 @@ public:
     }
 
 private:
+    /// \brief Compute the world velocity and acceleration of the end-effector of manipinfo given the
+    /// values, velocities, and accelerations of its used DOFs. Velocities come from the Jacobians and
+    /// accelerations from the Jacobians and Hessians, so the robot velocities are never set. The
+    /// Jacobians and Hessians are cached in manipinfo for the last configuration so evaluating at
+    /// the same configuration again (e.g. the end of one segment and the start of the next, or the
+    /// same segment being slowed down) does not touch the robot at all.
+    ///
+    /// \param q values of manipinfo.vuseddofindices
+    /// \param qd velocities of manipinfo.vuseddofindices
+    /// \param afill accelerations of all the robot DOFs
+    /// \param tlink [out] transform of the end-effector
+    void _ComputeEndEffectorVelocitiesAccelerations(ManipConstraintInfo2& manipinfo, const std::vector<dReal>& q, const std::vector<dReal>& qd, const std::vector<dReal>& afill, Transform& tlink, Vector& vellin, Vector& velang, Vector& acclin, Vector& accang)
+    {
+        KinBodyPtr probot = manipinfo.plink->GetParent();
+        const std::vector<int>& vuseddofindices = manipinfo.vuseddofindices;
+        const size_t ndof = vuseddofindices.size();
+
+        // The kinematics of the end-effector depend on all the robot DOFs and the base transform. The
+        // Hessians are only computed when manip accelerations are checked, so that is part of the key too.
+        probot->GetDOFValues(_vcachekey);
+        for (size_t index = 0; index < ndof; ++index) {
+            _vcachekey[vuseddofindices[index]] = q[index];
+        }
+        Transform tbase = probot->GetTransform();
+        _vcachekey.push_back(tbase.trans.x); _vcachekey.push_back(tbase.trans.y); _vcachekey.push_back(tbase.trans.z);
+        _vcachekey.push_back(tbase.rot.x); _vcachekey.push_back(tbase.rot.y); _vcachekey.push_back(tbase.rot.z); _vcachekey.push_back(tbase.rot.w);
+        _vcachekey.push_back(_maxmanipaccel > 0 ? 1 : 0);
+
+        if( manipinfo.vcachedkey != _vcachekey ) {
+            KinBody::KinBodyStateSaver saver(probot, KinBody::Save_LinkTransformation);
+            probot->SetDOFValues(q, KinBody::CLA_CheckLimits, vuseddofindices);
+            int endeffindex = manipinfo.plink->GetIndex();
+            manipinfo.tcachedlink = manipinfo.plink->GetTransform();
+            probot->ComputeJacobianTranslation(endeffindex, manipinfo.tcachedlink.trans, manipinfo.vcachedtransjacobian, vuseddofindices);
+            probot->ComputeJacobianAxisAngle(endeffindex, manipinfo.vcachedrotjacobian, vuseddofindices);
+            if( _maxmanipaccel > 0 ) {
+                probot->ComputeHessianTranslation(endeffindex, manipinfo.tcachedlink.trans, manipinfo.vcachedtranshessian, vuseddofindices);
+                probot->ComputeHessianAxisAngle(endeffindex, manipinfo.vcachedrothessian, vuseddofindices);
+            }
+            manipinfo.vcachedkey.swap(_vcachekey);
+        }
+        tlink = manipinfo.tcachedlink;
+
+        // v = J*qd, a = J*qdd + qd^T*H*qd
+        const std::vector<dReal>& vtransjacobian = manipinfo.vcachedtransjacobian, &vrotjacobian = manipinfo.vcachedrotjacobian;
+        dReal fvellin[3] = {0, 0, 0}, fvelang[3] = {0, 0, 0}, facclin[3] = {0, 0, 0}, faccang[3] = {0, 0, 0};
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t k = 0; k < ndof; ++k) {
+                dReal qdd = afill[vuseddofindices[k]];
+                fvellin[j] += vtransjacobian[j*ndof + k]*qd[k];
+                fvelang[j] += vrotjacobian[j*ndof + k]*qd[k];
+                facclin[j] += vtransjacobian[j*ndof + k]*qdd;
+                faccang[j] += vrotjacobian[j*ndof + k]*qdd;
+            }
+        }
+        if( _maxmanipaccel > 0 ) {
+            // H[i,j,k] = hessian[k + ndof*(j + 3*i)]. The axis-angle hessian holds the cross products
+            // of joint axes in both its symmetric entries so only half of it contributes to the
+            // angular acceleration.
+            const std::vector<dReal>& vtranshessian = manipinfo.vcachedtranshessian, &vrothessian = manipinfo.vcachedrothessian;
+            for (size_t i = 0; i < ndof; ++i) {
+                if( qd[i] == 0 ) {
+                    continue;
+                }
+                for (size_t j = 0; j < 3; ++j) {
+                    dReal ftrans = 0, frot = 0;
+                    for (size_t k = 0; k < ndof; ++k) {
+                        ftrans += vtranshessian[k + ndof*(j + 3*i)]*qd[k];
+                        frot += vrothessian[k + ndof*(j + 3*i)]*qd[k];
+                    }
+                    facclin[j] += qd[i]*ftrans;
+                    faccang[j] += 0.5*qd[i]*frot;
+                }
+            }
+        }
+        vellin = Vector(fvellin[0], fvellin[1], fvellin[2]);
+        velang = Vector(fvelang[0], fvelang[1], fvelang[2]);
+        acclin = Vector(facclin[0], facclin[1], facclin[2]);
+        accang = Vector(faccang[0], faccang[1], faccang[2]);
+    }
+
     EnvironmentBasePtr _penv;
     std::string _manipname;
     std::vector<KinBodyPtr> listUsedBodies;
@@ -946,10 +1012,10 @@ private:
     std::list< ManipConstraintInfo2 > _listCheckManips; ///< the manipulators and the points on their end efffectors to check for velocity and acceleration constraints
     std::vector<dReal> ac, qfillactive, _vfillactive; // the active DOF
     std::vector<dReal> _afill; // full robot DOF
-    std::vector<std::pair<Vector,Vector> > endeffvels, endeffaccs;
     std::vector<dReal> _vtransjacobian, _vangularjacobian, _vbestvels2, _vbestaccels2;
     std::vector<dReal> _vdotproducts, _vscalingfactors, _vdofvalues, _vdofvelocities, _vdofaccelerations;
     std::vector<int> _vindices;
+    std::vector<dReal> _vcachekey; ///< used in _ComputeEndEffectorVelocitiesAccelerations
 //@}
 
 };
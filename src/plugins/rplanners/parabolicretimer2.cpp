@@ -39,6 +39,8 @@ public:
     ParabolicTrajectoryRetimer2(EnvironmentBasePtr penv, std::istream& sinput) : TrajectoryRetimer2(penv, sinput)
     {
         __description = ":Interface Author: Rosen Diankov\n\nSimple parabolic trajectory re-timing while passing through all the waypoints, waypoints will not be modified. This assumes all waypoints have velocity 0 (unless the start and final points are forced). Overwrites the velocities and timestamps of input trajectory.";
+        RegisterCommand("BenchmarkInterpolation", boost::bind(&ParabolicTrajectoryRetimer2::_BenchmarkInterpolationCommand, this, _1, _2),
+                        "Times computing minimum 1D durations DOF by DOF versus all at once. Input: ndof numsegments numrepeats. Output: scalartime batchtime maxdiff (times in seconds)");
     }
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj, int planningoptions) override
@@ -50,6 +52,53 @@ public:
     }
 
 protected:
+    bool _BenchmarkInterpolationCommand(std::ostream& sout, std::istream& sinput)
+    {
+        size_t ndof = 0, numsegments = 0, numrepeats = 0;
+        sinput >> ndof >> numsegments >> numrepeats;
+        if( !sinput || ndof == 0 || numsegments == 0 || numrepeats == 0 ) {
+            return false;
+        }
+
+        // Random feasible boundary conditions for numsegments segments, stored DOF-contiguously
+        // per segment so that the batch kernel sees all segments at once.
+        size_t n = ndof*numsegments;
+        std::vector<dReal> x0(n), x1(n), v0(n), v1(n), vm(n), am(n), tscalar(n), tbatch(n);
+        for (size_t i = 0; i < n; ++i) {
+            vm[i] = 0.5 + 2*RaveRandomFloat();
+            am[i] = 1 + 5*RaveRandomFloat();
+            x0[i] = 4*RaveRandomFloat() - 2;
+            x1[i] = 4*RaveRandomFloat() - 2;
+            v0[i] = (2*RaveRandomFloat() - 1)*vm[i];
+            v1[i] = (2*RaveRandomFloat() - 1)*vm[i];
+        }
+
+        RampOptimizer::ParabolicInterpolator interpolator(ndof, GetEnv()->GetId());
+        RampOptimizer::ParabolicCurve curve;
+        uint64_t starttime = utils::GetMicroTime();
+        for (size_t irepeat = 0; irepeat < numrepeats; ++irepeat) {
+            for (size_t i = 0; i < n; ++i) {
+                interpolator.Compute1DTrajectory(x0[i], x1[i], v0[i], v1[i], vm[i], am[i], curve, false);
+                tscalar[i] = curve.GetDuration();
+            }
+        }
+        uint64_t scalartime = utils::GetMicroTime() - starttime;
+
+        starttime = utils::GetMicroTime();
+        for (size_t irepeat = 0; irepeat < numrepeats; ++irepeat) {
+            RampOptimizer::ParabolicInterpolator::ComputeMinimumDurations1D(&x0[0], &x1[0], &v0[0], &v1[0], &vm[0], &am[0], n, &tbatch[0]);
+        }
+        uint64_t batchtime = utils::GetMicroTime() - starttime;
+
+        dReal maxdiff = 0;
+        for (size_t i = 0; i < n; ++i) {
+            maxdiff = max(maxdiff, RaveFabs(tscalar[i] - tbatch[i]));
+        }
+        RAVELOG_DEBUG_FORMAT("env=%d, ndof=%d; numsegments=%d; scalar=%fs; batch=%fs; maxdiff=%.15e", GetEnv()->GetId()%ndof%numsegments%(scalartime*1e-6)%(batchtime*1e-6)%maxdiff);
+        sout << (scalartime*1e-6) << " " << (batchtime*1e-6) << " " << maxdiff;
+        return true;
+    }
+
     GroupInfoPtr CreateGroupInfo(int degree, const ConfigurationSpecification& origspec, const ConfigurationSpecification::Group& gpos, const ConfigurationSpecification::Group &gvel)
     {
         ParabolicGroupInfoPtr g(new ParabolicGroupInfo(degree, gpos, gvel));
@@ -518,6 +518,7 @@ public:
         }
 
         uint32_t baseTime = utils::GetMilliTime();
+        size_t nRampNDHeapAllocationsStart = RampOptimizer::RampND::GetNumHeapAllocations();
         ConfigurationSpecification posSpec = _parameters->_configurationspecification;
         ConfigurationSpecification velSpec = posSpec.ConvertToVelocitySpecification();
         ConfigurationSpecification timeSpec;
@@ -720,7 +721,12 @@ public:
 #ifdef SMOOTHER2_ENABLE_MERGING
                 nummerges = _MergeConsecutiveSegments(parabolicpath, parameters->_fStepLength*0.99);
 #endif
-                numShortcuts = _Shortcut(parabolicpath, parameters->_nMaxIterations, this, parameters->_fStepLength*0.99);
+                if( parameters->nshortcutthreads > 1 ) {
+                    numShortcuts = _ShortcutParallel(parabolicpath, parameters->_nMaxIterations, this, parameters->_fStepLength*0.99);
+                }
+                else {
+                    numShortcuts = _Shortcut(parabolicpath, parameters->_nMaxIterations, this, parameters->_fStepLength*0.99);
+                }
 #ifdef SMOOTHER2_TIMING_DEBUG
                 _tShortcutEnd = utils::GetMicroTime();
 #endif
@@ -765,8 +771,10 @@ public:
             RAVELOG_DEBUG_FORMAT("env=%d, start inserting the first waypoint to dummytraj", _environmentid);
             waypoints.resize(newSpec.GetDOF()); // reuse _cacheWaypoints
 
-            ConfigurationSpecification::ConvertData(waypoints.begin(), newSpec, parabolicpath.GetRampNDVect().front().GetX0Vect(), posSpec, 1, GetEnv(), true);
-            ConfigurationSpecification::ConvertData(waypoints.begin(), newSpec, parabolicpath.GetRampNDVect().front().GetV0Vect(), velSpec, 1, GetEnv(), false);
+            parabolicpath.GetRampNDVect().front().GetX0Vect(x0Vect);
+            parabolicpath.GetRampNDVect().front().GetV0Vect(v0Vect);
+            ConfigurationSpecification::ConvertData(waypoints.begin(), newSpec, x0Vect.begin(), posSpec, 1, GetEnv(), true);
+            ConfigurationSpecification::ConvertData(waypoints.begin(), newSpec, v0Vect.begin(), velSpec, 1, GetEnv(), false);
             waypoints[waypointOffset] = 1;
             waypoints.at(timeOffset) = 0;
             _pdummytraj->Insert(_pdummytraj->GetNumWaypoints(), waypoints);
@@ -975,7 +983,7 @@ public:
             RAVELOG_WARN(description);
             return PlannerStatus(description, PS_Failed);
         }
-        RAVELOG_DEBUG_FORMAT("env=%d, path optimizing - computation time = %f s.", _environmentid%(0.001f*(float)(utils::GetMilliTime() - baseTime)));
+        RAVELOG_DEBUG_FORMAT("env=%d, path optimizing - computation time = %f s., rampnd heap allocations = %d", _environmentid%(0.001f*(float)(utils::GetMilliTime() - baseTime))%(RampOptimizer::RampND::GetNumHeapAllocations() - nRampNDHeapAllocationsStart));
 
         if( IS_DEBUGLEVEL(Level_Verbose) ) {
             RAVELOG_VERBOSE_FORMAT("env=%d, Start sampling trajectory after shortcutting (for verification)", _environmentid);
@@ -1347,6 +1355,20 @@ protected:
         dReal rightneighbor; // the first switch time to the right of this zero-velocity point
     };
 
+    /// \brief One sampled shortcut attempt when shortcutting in parallel. Candidates of a batch are
+    /// checked independently against the same path and then committed by the main thread.
+    struct ShortcutCandidate
+    {
+        ShortcutCandidate() : t0(0), t1(0), fStartTimeVelMult(1), fStartTimeAccelMult(1), fCurVelMult(1), fCurAccelMult(1), fTimeSaved(0), bSuccess(false) {
+        }
+        dReal t0, t1;                                   // time instants on the current path to connect
+        dReal fStartTimeVelMult, fStartTimeAccelMult;   // multipliers to start the slow down search with
+        dReal fCurVelMult, fCurAccelMult;               // multipliers with which the candidate succeeded
+        dReal fTimeSaved;                               // (t1 - t0) minus the duration of the new segment
+        bool bSuccess;
+        std::vector<RampOptimizer::RampND> vrampnds;    // checked segment replacing [t0, t1]
+    };
+
     /// \brief Time-parameterize the ordered set of waypoints to a trajectory that stops at every
     /// waypoint. _SetMilestones also adds some extra waypoints to the original set if any two
     /// consecutive waypoints are too far apart.
@@ -1686,7 +1708,7 @@ protected:
         shortcutprogress << std::setprecision(std::numeric_limits<dReal>::digits10 + 1);
 #endif
 
-        std::vector<RampOptimizer::RampND> rampndVect = parabolicpath.GetRampNDVect(); // for convenience
+        const std::vector<RampOptimizer::RampND>& rampndVect = parabolicpath.GetRampNDVect(); // for convenience. ReplaceSegment updates the path in place so this stays valid.
 
         // Caching stuff
         std::vector<RampOptimizer::RampND>& shortcutRampNDVect = _cacheRampNDVect; // for storing interpolated trajectory
@@ -2344,8 +2366,6 @@ protected:
                 parabolicpath.ReplaceSegment(t0, t1, shortcutRampNDVectOut);
                 iIterProgress += 0x10000000;
 
-                rampndVect = parabolicpath.GetRampNDVect();
-
                 // Check consistency
                 if( IS_DEBUGLEVEL(Level_Verbose) ) {
                     rampndVect.front().GetX0Vect(x0Vect);
@@ -2406,7 +2426,7 @@ protected:
         shortcutprogress << std::setprecision(std::numeric_limits<dReal>::digits10 + 1);
 #endif
 
-        std::vector<RampOptimizer::RampND> rampndVect = parabolicpath.GetRampNDVect(); // for convenience
+        const std::vector<RampOptimizer::RampND>& rampndVect = parabolicpath.GetRampNDVect(); // for convenience. ReplaceSegment updates the path in place so this stays valid.
 
         // Caching stuff
         std::vector<RampOptimizer::RampND>& shortcutRampNDVect = _cacheRampNDVect; // for storing interpolated trajectory
@@ -3206,8 +3226,6 @@ protected:
                 parabolicpath.ReplaceSegment(t0, t1, shortcutRampNDVectOut);
                 iIterProgress += 0x10000000;
 
-                rampndVect = parabolicpath.GetRampNDVect();
-
                 // Check consistency
                 if( IS_DEBUGLEVEL(Level_Verbose) ) {
                     rampndVect.front().GetX0Vect(x0Vect);
@@ -3270,6 +3288,484 @@ protected:
         return numShortcuts;
     }
 
+    /// \brief Shortcut the path by sampling batches of nshortcutthreads candidates, checking them
+    /// concurrently on cloned environments, and committing the best non-overlapping successful
+    /// ones. Candidates are sampled with the seeded rng and committed in a fixed order, so the
+    /// result does not depend on thread scheduling. Return the number of successful shortcut.
+    int _ShortcutParallel(RampOptimizer::ParabolicPath& parabolicpath, int numIters, RampOptimizer::RandomNumberGeneratorBase* rng, dReal minTimeStep)
+    {
+        if( !_parameters->HasDefaultFunctions() ) {
+            // the workers re-create the parameters from the configuration specification, so they would not check the user functions
+            RAVELOG_DEBUG_FORMAT("env=%d, parameters have custom state or constraint functions, so shortcutting sequentially", _environmentid);
+            return _Shortcut(parabolicpath, numIters, rng, minTimeStep);
+        }
+
+        ShortcutWorkersDestroyer workersdestroyer(*this);
+        if( !_InitShortcutWorkers(_parameters->nshortcutthreads) ) {
+            RAVELOG_WARN_FORMAT("env=%d, failed to initialize %d shortcut workers, falling back to sequential shortcutting", _environmentid%_parameters->nshortcutthreads);
+            _DestroyShortcutWorkers();
+            return _Shortcut(parabolicpath, numIters, rng, minTimeStep);
+        }
+
+        uint32_t tStartShortcut = utils::GetMicroTime();
+        int numShortcuts = 0;
+        const dReal tOriginal = parabolicpath.GetDuration();
+        dReal tTotal = tOriginal;
+
+        const size_t nworkers = _vShortcutWorkers.size();
+        std::vector<ShortcutCandidate>& vcandidates = _vShortcutCandidates;
+        vcandidates.resize(nworkers);
+        std::vector<size_t>& vsuccessindices = _vShortcutSuccessIndices;
+        std::vector<size_t>& vcommitindices = _vShortcutCommitIndices;
+        utils::ThreadPool threadpool((int)nworkers);
+        std::vector< boost::function<void()> > vtasks;
+        vtasks.reserve(nworkers);
+
+        dReal fiSearchVelAccelMult = 1.0/_parameters->fSearchVelAccelMult;
+        dReal fStartTimeVelMult = 1.0, fStartTimeAccelMult = 1.0;
+        size_t nItersFromPrevSuccessful = 0;
+        size_t nCutoffIters = std::max(_parameters->nshortcutcycles, min(100, numIters/2));
+        dReal specialShortcutWeight = 0.1;
+        dReal specialShortcutCutoffTime = 0.75;
+        int numBatches = 0;
+
+        int iters = 0;
+        while( iters < numIters ) {
+            if( tTotal < minTimeStep || nItersFromPrevSuccessful > nCutoffIters ) {
+                break;
+            }
+
+            // Sample a batch of candidates. Samples that are too close to be useful still consume an iteration.
+            size_t ncandidates = 0;
+            while( ncandidates < nworkers && iters < numIters ) {
+                dReal t0, t1;
+                if( iters == 0 ) {
+                    t0 = 0;
+                    t1 = tTotal;
+                }
+                else if( (_vZeroVelPointInfos.size() > 0 && rng->Rand() <= specialShortcutWeight) || (numIters - iters <= (int)_vZeroVelPointInfos.size()) ) {
+                    size_t index = _uniformsampler->SampleSequenceOneUInt32()%_vZeroVelPointInfos.size();
+                    dReal t = _vZeroVelPointInfos[index].point;
+                    t0 = t - rng->Rand()*min(specialShortcutCutoffTime, t);
+                    t1 = t + rng->Rand()*min(specialShortcutCutoffTime, tTotal - t);
+                }
+                else {
+                    t0 = rng->Rand()*tTotal;
+                    t1 = rng->Rand()*tTotal;
+                    if( t0 > t1 ) {
+                        RampOptimizer::Swap(t0, t1);
+                    }
+                }
+                ++iters;
+                ++nItersFromPrevSuccessful;
+                if( t1 - t0 < minTimeStep ) {
+                    continue;
+                }
+                ShortcutCandidate& candidate = vcandidates[ncandidates];
+                candidate.t0 = t0;
+                candidate.t1 = t1;
+                candidate.fStartTimeVelMult = fStartTimeVelMult;
+                candidate.fStartTimeAccelMult = fStartTimeAccelMult;
+                ++ncandidates;
+            }
+            if( ncandidates == 0 ) {
+                continue;
+            }
+
+            _progress._iteration += ncandidates;
+            if( _CallCallbacks(_progress) == PA_Interrupt ) {
+                return -1;
+            }
+
+            // Check all candidates of the batch concurrently. Each worker owns a cloned environment.
+            size_t nthreads = min(nworkers, ncandidates);
+            vtasks.resize(0);
+            for (size_t iworker = 0; iworker < nthreads; ++iworker) {
+                vtasks.push_back(boost::bind(&ParabolicSmoother2::_ShortcutWorkerThreadCB, _vShortcutWorkers[iworker], boost::cref(parabolicpath), boost::ref(vcandidates), iworker, nthreads, ncandidates, minTimeStep));
+            }
+            threadpool.RunTasks(vtasks);
+            ++numBatches;
+
+            // Pick the successful candidates with the largest time savings that do not overlap. Ties
+            // are broken by sampling order to keep results deterministic.
+            vsuccessindices.resize(0);
+            for (size_t icandidate = 0; icandidate < ncandidates; ++icandidate) {
+                if( vcandidates[icandidate].bSuccess && vcandidates[icandidate].vrampnds.size() > 0 ) {
+                    vsuccessindices.push_back(icandidate);
+                }
+            }
+            if( vsuccessindices.size() == 0 ) {
+                continue;
+            }
+            std::stable_sort(vsuccessindices.begin(), vsuccessindices.end(), boost::bind(&ParabolicSmoother2::_CompareShortcutCandidates, boost::cref(vcandidates), _1, _2));
+
+            vcommitindices.resize(0);
+            FOREACHC(itindex, vsuccessindices) {
+                const ShortcutCandidate& candidate = vcandidates[*itindex];
+                bool bOverlap = false;
+                FOREACHC(itcommitted, vcommitindices) {
+                    if( candidate.t0 < vcandidates[*itcommitted].t1 && vcandidates[*itcommitted].t0 < candidate.t1 ) {
+                        bOverlap = true;
+                        break;
+                    }
+                }
+                if( !bOverlap ) {
+                    vcommitindices.push_back(*itindex);
+                }
+            }
+
+            // The best candidate drives the slow down multipliers for the next batch.
+            fStartTimeVelMult = min(1.0, vcandidates[vcommitindices.front()].fCurVelMult * fiSearchVelAccelMult);
+            fStartTimeAccelMult = min(1.0, vcandidates[vcommitindices.front()].fCurAccelMult * fiSearchVelAccelMult);
+
+            // Replace segments from the latest one backwards so that time instants of the remaining candidates stay valid.
+            std::sort(vcommitindices.begin(), vcommitindices.end(), boost::bind(&ParabolicSmoother2::_CompareShortcutCandidatesStartTime, boost::cref(vcandidates), _1, _2));
+            FOREACHC(itindex, vcommitindices) {
+                const ShortcutCandidate& candidate = vcandidates[*itindex];
+                size_t writeIndex = 0;
+                for( size_t readIndex = 0; readIndex < _vZeroVelPointInfos.size(); ++readIndex ) {
+                    if( _vZeroVelPointInfos[readIndex].point <= candidate.t0 ) {
+                        _vZeroVelPointInfos[writeIndex++] = _vZeroVelPointInfos[readIndex];
+                    }
+                    else if( _vZeroVelPointInfos[readIndex].point > candidate.t1 ) {
+                        _vZeroVelPointInfos[writeIndex] = _vZeroVelPointInfos[readIndex];
+                        _vZeroVelPointInfos[writeIndex].point -= candidate.fTimeSaved;
+                        _vZeroVelPointInfos[writeIndex].leftneighbor -= candidate.fTimeSaved;
+                        _vZeroVelPointInfos[writeIndex].rightneighbor -= candidate.fTimeSaved;
+                        writeIndex += 1;
+                    }
+                }
+                _vZeroVelPointInfos.resize(writeIndex);
+
+                parabolicpath.ReplaceSegment(candidate.t0, candidate.t1, candidate.vrampnds);
+                ++numShortcuts;
+            }
+
+            if( IS_DEBUGLEVEL(Level_Verbose) ) {
+                std::vector<dReal>& x0Vect = _cacheX0Vect, &x1Vect = _cacheX1Vect, &v0Vect = _cacheV0Vect, &v1Vect = _cacheV1Vect;
+                const std::vector<RampOptimizer::RampND>& rampndVect = parabolicpath.GetRampNDVect();
+                rampndVect.front().GetX0Vect(x0Vect);
+                rampndVect.back().GetX1Vect(x1Vect);
+                rampndVect.front().GetV0Vect(v0Vect);
+                rampndVect.back().GetV1Vect(v1Vect);
+                RampOptimizer::ParabolicCheckReturn parabolicret = RampOptimizer::CheckRampNDs(rampndVect, _parameters->_vConfigLowerLimit, _parameters->_vConfigUpperLimit, _parameters->_vConfigVelocityLimit, _parameters->_vConfigAccelerationLimit, x0Vect, x1Vect, v0Vect, v1Vect);
+                OPENRAVE_ASSERT_OP(parabolicret, ==, RampOptimizer::PCR_Normal);
+            }
+
+            tTotal = parabolicpath.GetDuration();
+            nItersFromPrevSuccessful = 0;
+            RAVELOG_DEBUG_FORMAT("env=%d, shortcut batch=%d (iter=%d/%d) committed %d/%d candidates, tTotal=%.15e", _environmentid%numBatches%iters%numIters%vcommitindices.size()%ncandidates%tTotal);
+        }
+
+        RAVELOG_DEBUG_FORMAT("env=%d, parallel shortcutting with %d workers finished at iter=%d, batches=%d, successful=%d, endTime: %.15e -> %.15e; diff = %.15e; took %.3f s", _environmentid%nworkers%iters%numBatches%numShortcuts%tOriginal%tTotal%(tOriginal - tTotal)%(0.000001f*(float)(utils::GetMicroTime() - tStartShortcut)));
+        return numShortcuts;
+    }
+
+    static bool _CompareShortcutCandidates(const std::vector<ShortcutCandidate>& vcandidates, size_t index0, size_t index1)
+    {
+        return vcandidates[index0].fTimeSaved > vcandidates[index1].fTimeSaved;
+    }
+
+    static bool _CompareShortcutCandidatesStartTime(const std::vector<ShortcutCandidate>& vcandidates, size_t index0, size_t index1)
+    {
+        return vcandidates[index0].t0 > vcandidates[index1].t0;
+    }
+
+    /// \brief Destroys the shortcut workers and their cloned environments when going out of scope.
+    class ShortcutWorkersDestroyer
+    {
+public:
+        ShortcutWorkersDestroyer(ParabolicSmoother2& smoother) : _smoother(smoother) {
+        }
+        ~ShortcutWorkersDestroyer() {
+            _smoother._DestroyShortcutWorkers();
+        }
+protected:
+        ParabolicSmoother2& _smoother;
+    };
+
+    /// \brief Clone the environment nworkers times and create a smoother in each clone that shares
+    /// this smoother's parameters. Only the default collision/limits constraints of the
+    /// configuration specification are available in the clones, so the parameters have to
+    /// HasDefaultFunctions; time-based manip constraints are re-created by each worker from
+    /// manipname.
+    bool _InitShortcutWorkers(int nworkers)
+    {
+        _DestroyShortcutWorkers();
+        try {
+            for (int iworker = 0; iworker < nworkers; ++iworker) {
+                EnvironmentBasePtr pcloneenv = GetEnv()->CloneSelf(Clone_Bodies);
+                // kept separately so that _DestroyShortcutWorkers also destroys it if the worker fails to initialize
+                _vShortcutWorkerEnvs.push_back(pcloneenv);
+                EnvironmentMutex::scoped_lock lock(pcloneenv->GetMutex());
+                ConstraintTrajectoryTimingParametersPtr params(new ConstraintTrajectoryTimingParameters());
+                params->copy(_parameters);
+                params->SetConfigurationSpecification(pcloneenv, _parameters->_configurationspecification);
+                // SetConfigurationSpecification resets the limits to those of the bodies, so restore the requested ones
+                params->_vConfigLowerLimit = _parameters->_vConfigLowerLimit;
+                params->_vConfigUpperLimit = _parameters->_vConfigUpperLimit;
+                params->_vConfigVelocityLimit = _parameters->_vConfigVelocityLimit;
+                params->_vConfigAccelerationLimit = _parameters->_vConfigAccelerationLimit;
+                params->_vConfigResolution = _parameters->_vConfigResolution;
+                params->nshortcutthreads = 0;
+
+                std::stringstream ssempty;
+                boost::shared_ptr<ParabolicSmoother2> pworker(new ParabolicSmoother2(pcloneenv, ssempty));
+                if( !pworker->InitPlan(RobotBasePtr(), params) ) {
+                    return false;
+                }
+                pworker->_feasibilitychecker.tol = _feasibilitychecker.tol;
+                _vShortcutWorkers.push_back(pworker);
+            }
+        }
+        catch (const std::exception& ex) {
+            RAVELOG_WARN_FORMAT("env=%d, failed to create shortcut worker: %s", _environmentid%ex.what());
+            return false;
+        }
+        return _vShortcutWorkers.size() > 0;
+    }
+
+    void _DestroyShortcutWorkers()
+    {
+        _vShortcutWorkers.resize(0);
+        FOREACH(itenv, _vShortcutWorkerEnvs) {
+            (*itenv)->Destroy();
+        }
+        _vShortcutWorkerEnvs.resize(0);
+    }
+
+    /// \brief Worker thread entry for _ShortcutParallel. Checks candidates istart, istart + nstep, ... on
+    /// this (cloned) smoother.
+    void _ShortcutWorkerThreadCB(const RampOptimizer::ParabolicPath& parabolicpath, std::vector<ShortcutCandidate>& vcandidates, size_t istart, size_t nstep, size_t ncandidates, dReal minTimeStep)
+    {
+        EnvironmentMutex::scoped_lock lock(GetEnv()->GetMutex());
+        for (size_t icandidate = istart; icandidate < ncandidates; icandidate += nstep) {
+            ShortcutCandidate& candidate = vcandidates[icandidate];
+            try {
+                _EvaluateShortcutCandidate(parabolicpath, candidate, minTimeStep);
+            }
+            catch (const std::exception& ex) {
+                RAVELOG_WARN_FORMAT("env=%d, An exception happened when checking shortcut t0=%.15e, t1=%.15e: %s", _environmentid%candidate.t0%candidate.t1%ex.what());
+                candidate.bSuccess = false;
+            }
+        }
+    }
+
+    /// \brief Try to shortcut parabolicpath between candidate.t0 and candidate.t1 without modifying
+    /// it. Follows the sequential _Shortcut: segments that end with a different velocity after
+    /// checking get their last ramp re-interpolated, and vel/accel limits are estimated and scaled
+    /// down on time-based constraint failures, including the manip constraint heuristics.
+    bool _EvaluateShortcutCandidate(const RampOptimizer::ParabolicPath& parabolicpath, ShortcutCandidate& candidate, dReal minTimeStep)
+    {
+        candidate.bSuccess = false;
+        candidate.fTimeSaved = 0;
+        candidate.vrampnds.resize(0);
+
+        std::vector<RampOptimizer::RampND>& shortcutRampNDVect = _cacheRampNDVect;
+        std::vector<RampOptimizer::RampND>& shortcutRampNDVectOut1 = _cacheRampNDVectOut1;
+        std::vector<dReal>& x0Vect = _cacheX0Vect, &x1Vect = _cacheX1Vect, &v0Vect = _cacheV0Vect, &v1Vect = _cacheV1Vect;
+        std::vector<dReal>& x0LastVect = _cacheX0Vect1, &v0LastVect = _cacheV0Vect1;
+        std::vector<dReal>& vellimits = _cacheVellimits, &accellimits = _cacheAccelLimits;
+        const std::vector<RampOptimizer::RampND>& rampndVect = parabolicpath.GetRampNDVect();
+
+        int i0, i1;
+        dReal u0, u1;
+        parabolicpath.FindRampNDIndex(candidate.t0, i0, u0);
+        parabolicpath.FindRampNDIndex(candidate.t1, i1, u1);
+
+        rampndVect[i0].EvalPos(u0, x0Vect);
+        if( _parameters->SetStateValues(x0Vect) != 0 ) {
+            return false;
+        }
+        _parameters->_getstatefn(x0Vect);
+        rampndVect[i1].EvalPos(u1, x1Vect);
+        if( _parameters->SetStateValues(x1Vect) != 0 ) {
+            return false;
+        }
+        _parameters->_getstatefn(x1Vect);
+        rampndVect[i0].EvalVel(u0, v0Vect);
+        rampndVect[i1].EvalVel(u1, v1Vect);
+
+        vellimits = _parameters->_vConfigVelocityLimit;
+        accellimits = _parameters->_vConfigAccelerationLimit;
+        if( !(_bmanipconstraints && _manipconstraintchecker && _bUseNewHeuristic) ) {
+            for (size_t j = 0; j < vellimits.size(); ++j) {
+                dReal fminvel = max(RaveFabs(v0Vect[j]), RaveFabs(v1Vect[j]));
+                vellimits[j] = min(vellimits[j], max(fminvel, candidate.fStartTimeVelMult * _parameters->_vConfigVelocityLimit[j]));
+                accellimits[j] = min(accellimits[j], candidate.fStartTimeAccelMult * _parameters->_vConfigAccelerationLimit[j]);
+            }
+        }
+
+        dReal fCurVelMult = candidate.fStartTimeVelMult;
+        dReal fCurAccelMult = candidate.fStartTimeAccelMult;
+        size_t maxSlowDownTries = 100;
+        for (size_t iSlowDown = 0; iSlowDown < maxSlowDownTries; ++iSlowDown) {
+            if( !_interpolator.ComputeArbitraryVelNDTrajectory(x0Vect, x1Vect, v0Vect, v1Vect, _parameters->_vConfigLowerLimit, _parameters->_vConfigUpperLimit, vellimits, accellimits, shortcutRampNDVect, true) ) {
+                return false;
+            }
+
+            dReal segmentTime = 0;
+            FOREACHC(itrampnd, shortcutRampNDVect) {
+                segmentTime += itrampnd->GetDuration();
+            }
+            if( segmentTime + minTimeStep > candidate.t1 - candidate.t0 ) {
+                return false;
+            }
+
+            if( _parameters->SetStateValues(x1Vect) != 0 ) {
+                return false;
+            }
+            _parameters->_getstatefn(x1Vect);
+
+            RampOptimizer::CheckReturn retcheck = _feasibilitychecker.Check2(shortcutRampNDVect, 0xffff, candidate.vrampnds);
+            if( retcheck.retcode == 0 ) {
+                // Check2 may have modified the segment, so keep vellimits above its velocities
+                FOREACHC(itrampnd, candidate.vrampnds) {
+                    for (size_t jdof = 0; jdof < itrampnd->GetDOF(); ++jdof) {
+                        vellimits[jdof] = max(vellimits[jdof], max(RaveFabs(itrampnd->GetV0At(jdof)), RaveFabs(itrampnd->GetV1At(jdof))));
+                    }
+                }
+
+                if( retcheck.bDifferentVelocity && candidate.vrampnds.size() > 0 ) {
+                    // Re-interpolate the last ramp so that the segment ends at v1 again. Its start is
+                    // kept separately so that x0Vect/v0Vect stay valid for further slow downs.
+                    dReal allowedStretchTime = (candidate.t1 - candidate.t0) - (segmentTime + minTimeStep);
+                    candidate.vrampnds.back().GetX0Vect(x0LastVect);
+                    candidate.vrampnds.back().GetV0Vect(v0LastVect);
+                    if( !_interpolator.ComputeArbitraryVelNDTrajectory(x0LastVect, x1Vect, v0LastVect, v1Vect, _parameters->_vConfigLowerLimit, _parameters->_vConfigUpperLimit, vellimits, accellimits, shortcutRampNDVect, true) ) {
+                        return false;
+                    }
+                    dReal lastSegmentTime = 0;
+                    FOREACHC(itrampnd, shortcutRampNDVect) {
+                        lastSegmentTime += itrampnd->GetDuration();
+                    }
+                    if( lastSegmentTime - candidate.vrampnds.back().GetDuration() > allowedStretchTime ) {
+                        return false;
+                    }
+
+                    retcheck = _feasibilitychecker.Check2(shortcutRampNDVect, 0xffff, shortcutRampNDVectOut1);
+                    if( retcheck.retcode == 0 ) {
+                        if( retcheck.bDifferentVelocity ) {
+                            return false;
+                        }
+                        candidate.vrampnds.pop_back();
+                        candidate.vrampnds.insert(candidate.vrampnds.end(), shortcutRampNDVectOut1.begin(), shortcutRampNDVectOut1.end());
+                    }
+                }
+            }
+
+            if( retcheck.retcode == 0 ) {
+                if( candidate.vrampnds.size() == 0 ) {
+                    return false;
+                }
+                dReal newSegmentTime = 0;
+                FOREACHC(itrampnd, candidate.vrampnds) {
+                    newSegmentTime += itrampnd->GetDuration();
+                }
+                candidate.fTimeSaved = (candidate.t1 - candidate.t0) - newSegmentTime;
+                if( candidate.fTimeSaved <= 0 ) {
+                    return false;
+                }
+                candidate.fCurVelMult = fCurVelMult;
+                candidate.fCurAccelMult = fCurAccelMult;
+                candidate.bSuccess = true;
+                return true;
+            }
+            else if( retcheck.retcode != CFO_CheckTimeBasedConstraints ) {
+                return false;
+            }
+
+            candidate.vrampnds.resize(0);
+            if( _bmanipconstraints && _manipconstraintchecker ) {
+                if( iSlowDown == 0 && !_bUseNewHeuristic ) {
+                    // Try computing estimates of vellimits and accellimits before scaling down
+                    if( _parameters->SetStateValues(x0Vect) != 0 ) {
+                        return false;
+                    }
+                    _manipconstraintchecker->GetMaxVelocitiesAccelerations(v0Vect, vellimits, accellimits);
+                    if( _parameters->SetStateValues(x1Vect) != 0 ) {
+                        return false;
+                    }
+                    _manipconstraintchecker->GetMaxVelocitiesAccelerations(v1Vect, vellimits, accellimits);
+                    for (size_t j = 0; j < vellimits.size(); ++j) {
+                        vellimits[j] = max(vellimits[j], max(RaveFabs(v0Vect[j]), RaveFabs(v1Vect[j])));
+                    }
+                }
+                else {
+                    bool bUseReductionFactors = _bUseNewHeuristic && retcheck.vReductionFactors.size() > 0;
+                    if( retcheck.fMaxManipAccel > _parameters->maxmanipaccel ) {
+                        // scale both vellimits and accellimits down
+                        if( bUseReductionFactors ) {
+                            _ApplyShortcutReductionFactors(retcheck.vReductionFactors, true, v0Vect, v1Vect, vellimits, accellimits);
+                        }
+                        else {
+                            fCurAccelMult *= retcheck.fTimeBasedSurpassMult*retcheck.fTimeBasedSurpassMult;
+                            fCurVelMult *= retcheck.fTimeBasedSurpassMult;
+                            if( fCurAccelMult < 0.0001 || fCurVelMult < 0.01 ) {
+                                return false;
+                            }
+                            for (size_t j = 0; j < vellimits.size(); ++j) {
+                                dReal fMinVel = max(RaveFabs(v0Vect[j]), RaveFabs(v1Vect[j]));
+                                vellimits[j] = max(fMinVel, retcheck.fTimeBasedSurpassMult * vellimits[j]);
+                                accellimits[j] *= retcheck.fTimeBasedSurpassMult*retcheck.fTimeBasedSurpassMult;
+                            }
+                        }
+                    }
+                    else {
+                        // manip speed violated, or ramps modified by CheckPathAllConstraints exceed
+                        // vellimits. Only scale vellimits down.
+                        if( bUseReductionFactors ) {
+                            _ApplyShortcutReductionFactors(retcheck.vReductionFactors, false, v0Vect, v1Vect, vellimits, accellimits);
+                        }
+                        else {
+                            fCurVelMult *= retcheck.fTimeBasedSurpassMult;
+                            if( fCurVelMult < 0.01 ) {
+                                return false;
+                            }
+                            for (size_t j = 0; j < vellimits.size(); ++j) {
+                                dReal fMinVel = max(RaveFabs(v0Vect[j]), RaveFabs(v1Vect[j]));
+                                vellimits[j] = max(fMinVel, retcheck.fTimeBasedSurpassMult * vellimits[j]);
+                            }
+                        }
+                    }
+                }
+            }
+            else {
+                fCurVelMult *= retcheck.fTimeBasedSurpassMult;
+                fCurAccelMult *= retcheck.fTimeBasedSurpassMult*retcheck.fTimeBasedSurpassMult;
+                if( fCurVelMult < 0.01 || fCurAccelMult < 0.0001 ) {
+                    return false;
+                }
+                for (size_t j = 0; j < vellimits.size(); ++j) {
+                    dReal fMinVel = max(RaveFabs(v0Vect[j]), RaveFabs(v1Vect[j]));
+                    vellimits[j] = max(fMinVel, retcheck.fTimeBasedSurpassMult * vellimits[j]);
+                    accellimits[j] *= retcheck.fTimeBasedSurpassMult*retcheck.fTimeBasedSurpassMult;
+                }
+            }
+        }
+        return false;
+    }
+
+    /// \brief Scale vellimits (by sqrt of the factors when bScaleAccel) and accellimits by the
+    /// dof-dependent reduction factors of the manip constraint checker, never going below
+    /// max(|v0|, |v1|). Same as the _bUseNewHeuristic branches of _Shortcut.
+    static void _ApplyShortcutReductionFactors(const std::vector<dReal>& vReductionFactors, bool bScaleAccel, const std::vector<dReal>& v0Vect, const std::vector<dReal>& v1Vect, std::vector<dReal>& vellimits, std::vector<dReal>& accellimits)
+    {
+        for (size_t j = 0; j < vellimits.size(); ++j) {
+            dReal fMinVelLimit = max(RaveFabs(v0Vect[j]), RaveFabs(v1Vect[j]));
+            dReal fVelMult = bScaleAccel ? RaveSqrt(vReductionFactors[j]) : vReductionFactors[j];
+            if( vellimits[j] * fVelMult < fMinVelLimit ) {
+                vellimits[j] = fMinVelLimit + RampOptimizer::g_fRampEpsilon;
+            }
+            else {
+                vellimits[j] *= fVelMult;
+            }
+            if( bScaleAccel ) {
+                accellimits[j] *= vReductionFactors[j];
+            }
+        }
+    }
+
     void _DumpParabolicPath(RampOptimizer::ParabolicPath& parabolicpath, DebugLevel level=Level_Verbose, uint32_t fileindex=10000, int option=-1) const
     {
         if( !IS_DEBUGLEVEL(level) ) {
@@ -3382,12 +3878,19 @@ protected:
 
     // in _ComputeRampWithZeroVelEndpoints
     std::vector<dReal> _cacheX0Vect1, _cacheX1Vect1; ///< need to have another copies of x0 and x1 vectors. For v0 and v1 vectors, we can reuse to ones above.
+    std::vector<dReal> _cacheV0Vect1; ///< start velocity of the last ramp being corrected in _EvaluateShortcutCandidate
     std::vector<dReal> _cacheVellimits, _cacheAccelLimits; ///< stores current velocity and acceleration limits, also used in _Shortcut
     std::vector<RampOptimizer::RampND> _cacheRampNDVectOut1; ///< stores output from the check function, also used in _Shortcut
 
     // in _Shortcut
     std::vector<uint8_t> _vVisitedDiscretizationCache;
 
+    // in _ShortcutParallel
+    std::vector< boost::shared_ptr<ParabolicSmoother2> > _vShortcutWorkers; ///< one smoother per cloned environment, only alive during _ShortcutParallel
+    std::vector<EnvironmentBasePtr> _vShortcutWorkerEnvs; ///< the cloned environments of _vShortcutWorkers, including the one of a worker that failed to initialize
+    std::vector<ShortcutCandidate> _vShortcutCandidates;
+    std::vector<size_t> _vShortcutSuccessIndices, _vShortcutCommitIndices;
+
 #ifdef SMOOTHER2_TIMING_DEBUG
     // Statistics
     uint32_t _tShortcutStart, _tShortcutEnd;
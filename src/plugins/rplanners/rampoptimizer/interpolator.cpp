@@ -34,6 +34,7 @@ ParabolicInterpolator::ParabolicInterpolator(size_t ndof, int envid)
     _cacheV0Vect.resize(_ndof);
     _cacheV1Vect.resize(_ndof);
     _cacheAVect.resize(_ndof);
+    _cacheDurationsVect.resize(_ndof);
     _cacheCurvesVect.resize(_ndof);
     _envid = envid;
 
@@ -51,6 +52,7 @@ void ParabolicInterpolator::Initialize(size_t ndof, int envid)
     _cacheV0Vect.resize(_ndof);
     _cacheV1Vect.resize(_ndof);
     _cacheAVect.resize(_ndof);
+    _cacheDurationsVect.resize(_ndof);
     _cacheCurvesVect.resize(_ndof);
     _envid = envid;
 }
@@ -227,25 +229,27 @@ bool ParabolicInterpolator::ComputeArbitraryVelNDTrajectory(const std::vector<dR
         }
     }
 
-    // First compute the minimum trajectory duration for each joint.
+    // First compute the minimum trajectory duration for each joint. Only the durations are needed
+    // to find the slowest joint so compute them all at once and construct only the slowest curve.
+    ComputeMinimumDurations1D(&x0Vect[0], &x1Vect[0], &v0Vect[0], &v1Vect[0], &vmVect[0], &amVect[0], _ndof, &_cacheDurationsVect[0]);
     dReal maxDuration = 0;
     size_t maxIndex = 0;
     for (size_t idof = 0; idof < _ndof; ++idof) {
-        if( !Compute1DTrajectory(x0Vect[idof], x1Vect[idof], v0Vect[idof], v1Vect[idof], vmVect[idof], amVect[idof], _cacheCurvesVect[idof], BCHECK_1D_TRAJ) ) {
-            return false;
-        }
-        if( _cacheCurvesVect[idof].GetDuration() > maxDuration ) {
-            maxDuration = _cacheCurvesVect[idof].GetDuration();
+        if( _cacheDurationsVect[idof] > maxDuration ) {
+            maxDuration = _cacheDurationsVect[idof];
             maxIndex = idof;
         }
     }
+    if( !Compute1DTrajectory(x0Vect[maxIndex], x1Vect[maxIndex], v0Vect[maxIndex], v1Vect[maxIndex], vmVect[maxIndex], amVect[maxIndex], _cacheCurvesVect[maxIndex], BCHECK_1D_TRAJ) ) {
+        return false;
+    }
 
     //RAVELOG_VERBOSE_FORMAT("Joint %d has the longest duration of %.15e s.", maxIndex%maxDuration);
 
     // Now stretch all the trajectories to some duration t. If not tryHarder, t will be
     // maxDuration. Otherwise, t will be the maximum of maxDuration and tbound (computed by taking
     // into account inoperative time intervals.
-    if( !_RecomputeNDTrajectoryFixedDuration(_cacheCurvesVect, vmVect, amVect, maxIndex, tryHarder) ) {
+    if( !_RecomputeNDTrajectoryFixedDuration(x0Vect, x1Vect, v0Vect, v1Vect, _cacheCurvesVect, vmVect, amVect, maxIndex, tryHarder) ) {
         // Note, however, that even with tryHarder = true, the above interpolation may fail due to
         // inability to fix joint limits violation.
         return false;
@@ -285,7 +289,7 @@ bool ParabolicInterpolator::ComputeArbitraryVelNDTrajectory(const std::vector<dR
     return true;
 }
 
-bool ParabolicInterpolator::_RecomputeNDTrajectoryFixedDuration(std::vector<ParabolicCurve>& curvesVect, const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, size_t maxIndex, bool tryHarder)
+bool ParabolicInterpolator::_RecomputeNDTrajectoryFixedDuration(const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vect, const std::vector<dReal>& v0Vect, const std::vector<dReal>& v1Vect, std::vector<ParabolicCurve>& curvesVect, const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, size_t maxIndex, bool tryHarder)
 {
     dReal newDuration = curvesVect[maxIndex].GetDuration();
     bool bSuccess = true;
@@ -295,7 +299,7 @@ bool ParabolicInterpolator::_RecomputeNDTrajectoryFixedDuration(std::vector<Para
             //RAVELOG_VERBOSE_FORMAT("joint %d is already the slowest DOF, continue to the next DOF (if any)", idof);
             continue;
         }
-        if( !Compute1DTrajectoryFixedDuration(curvesVect[idof].GetX0(), curvesVect[idof].GetX1(), curvesVect[idof].GetV0(), curvesVect[idof].GetV1(), vmVect[idof], amVect[idof], newDuration, _cacheCurve) ) {
+        if( !Compute1DTrajectoryFixedDuration(x0Vect[idof], x1Vect[idof], v0Vect[idof], v1Vect[idof], vmVect[idof], amVect[idof], newDuration, _cacheCurve) ) {
             bSuccess = false;
             iFailingDOF = idof;
             break;
@@ -306,13 +310,13 @@ bool ParabolicInterpolator::_RecomputeNDTrajectoryFixedDuration(std::vector<Para
 
     if( !bSuccess ) {
         if( !tryHarder ) {
-            RAVELOG_VERBOSE_FORMAT("env=%d, Failed for joint %d. Info: x0=%.15e; x1=%.15e; v0=%.15e; v1=%.15e; duration=%.15e; vm=%.15e; am=%.15e", _envid%iFailingDOF%curvesVect[iFailingDOF].GetX0()%curvesVect[iFailingDOF].GetX1()%curvesVect[iFailingDOF].GetV0()%curvesVect[iFailingDOF].GetV1()%newDuration%vmVect[iFailingDOF]%amVect[iFailingDOF]);
+            RAVELOG_VERBOSE_FORMAT("env=%d, Failed for joint %d. Info: x0=%.15e; x1=%.15e; v0=%.15e; v1=%.15e; duration=%.15e; vm=%.15e; am=%.15e", _envid%iFailingDOF%x0Vect[iFailingDOF]%x1Vect[iFailingDOF]%v0Vect[iFailingDOF]%v1Vect[iFailingDOF]%newDuration%vmVect[iFailingDOF]%amVect[iFailingDOF]);
             return bSuccess;
         }
 
         for (size_t idof = 0; idof < _ndof; ++idof) {
             dReal tBound;
-            if( !_CalculateLeastUpperBoundInoperativeTimeInterval(curvesVect[idof].GetX0(), curvesVect[idof].GetX1(), curvesVect[idof].GetV0(), curvesVect[idof].GetV1(), vmVect[idof], amVect[idof], tBound) ) {
+            if( !_CalculateLeastUpperBoundInoperativeTimeInterval(x0Vect[idof], x1Vect[idof], v0Vect[idof], v1Vect[idof], vmVect[idof], amVect[idof], tBound) ) {
                 return false;
             }
             if( tBound > newDuration ) {
@@ -322,7 +326,7 @@ bool ParabolicInterpolator::_RecomputeNDTrajectoryFixedDuration(std::vector<Para
         RAVELOG_VERBOSE_FORMAT("env=%d, Desired trajectory duration changed: %.15e --> %.15e; diff = %.15e", _envid%curvesVect[maxIndex].GetDuration()%newDuration%(newDuration - curvesVect[maxIndex].GetDuration()));
         bSuccess = true;
         for (size_t idof = 0; idof < _ndof; ++idof) {
-            if( !Compute1DTrajectoryFixedDuration(curvesVect[idof].GetX0(), curvesVect[idof].GetX1(), curvesVect[idof].GetV0(), curvesVect[idof].GetV1(), vmVect[idof], amVect[idof], newDuration, _cacheCurve) ) {
+            if( !Compute1DTrajectoryFixedDuration(x0Vect[idof], x1Vect[idof], v0Vect[idof], v1Vect[idof], vmVect[idof], amVect[idof], newDuration, _cacheCurve) ) {
                 bSuccess = false;
                 iFailingDOF = idof;
                 break;
@@ -331,7 +335,7 @@ bool ParabolicInterpolator::_RecomputeNDTrajectoryFixedDuration(std::vector<Para
             curvesVect[idof] = _cacheCurve;
         }
         if( !bSuccess ) {
-            RAVELOG_VERBOSE_FORMAT("env=%d, Failed for joint %d. Info: x0=%.15e; x1=%.15e; v0=%.15e; v1=%.15e; duration=%.15e; vm=%.15e; am=%.15e", _envid%iFailingDOF%curvesVect[iFailingDOF].GetX0()%curvesVect[iFailingDOF].GetX1()%curvesVect[iFailingDOF].GetV0()%curvesVect[iFailingDOF].GetV1()%newDuration%vmVect[iFailingDOF]%amVect[iFailingDOF]);
+            RAVELOG_VERBOSE_FORMAT("env=%d, Failed for joint %d. Info: x0=%.15e; x1=%.15e; v0=%.15e; v1=%.15e; duration=%.15e; vm=%.15e; am=%.15e", _envid%iFailingDOF%x0Vect[iFailingDOF]%x1Vect[iFailingDOF]%v0Vect[iFailingDOF]%v1Vect[iFailingDOF]%newDuration%vmVect[iFailingDOF]%amVect[iFailingDOF]);
         }
     }
     return bSuccess;
@@ -563,6 +567,31 @@ bool ParabolicInterpolator::Compute1DTrajectory(dReal x0, dReal x1, dReal v0, dR
     return true;
 }
 
+void ParabolicInterpolator::ComputeMinimumDurations1D(const dReal* x0, const dReal* x1, const dReal* v0, const dReal* v1, const dReal* vm, const dReal* am, size_t n, dReal* tOut)
+{
+    // Same case analysis as Compute1DTrajectory, written with selects instead of branches.
+    for (size_t i = 0; i < n; ++i) {
+        dReal d = x1[i] - x0[i];
+        dReal dv = v1[i] - v0[i];
+        dReal v0Sqr = v0[i]*v0[i];
+        dReal v1Sqr = v1[i]*v1[i];
+        dReal aminv = 1/am[i];
+        dReal dStraight = (dv >= 0 ? 0.5 : -0.5)*(v1Sqr - v0Sqr)*aminv;
+
+        // v1 can be reached from v0 by the acceleration am or -am
+        dReal tStraight = Abs(dv)*aminv;
+
+        // Two ramps with peak velocity vp, or three ramps if vp exceeds the velocity limit
+        dReal sign = d > dStraight ? 1 : -1;
+        dReal vp = sign*Sqrt(Max(0.5*(v0Sqr + v1Sqr) + sign*am[i]*d, 0));
+        dReal h = Abs(vp) - vm[i];
+        h = h > g_fRampEpsilon ? h : 0;
+        dReal tPeak = sign*(2*vp - v0[i] - v1[i])*aminv + h*h*aminv/vm[i];
+
+        tOut[i] = FuzzyEquals(d, dStraight, g_fRampEpsilon) ? tStraight : tPeak;
+    }
+}
+
 bool ParabolicInterpolator::_ImposeJointLimitFixedDuration(ParabolicCurve& curve, dReal xmin, dReal xmax, dReal vm, dReal am, bool bCheck)
 {
     dReal bmin, bmax;
@@ -85,13 +85,18 @@ public:
        trajectory duration. Otherwise, t will be calculated by taking into account inoperative time
        intervals of every joint.
 
-       \param curvesVect the input vector of ParabolicCurves. This will also carry the resulting ParabolicCurves.
+       \param x0Vect initial position
+       \param x1Vect final position
+       \param v0Vect initial velocity
+       \param v1Vect final velocity
+       \param curvesVect carries the resulting ParabolicCurves. curvesVect[maxIndex] has to be
+                         already computed (with the longest duration).
        \param vmVect velocity limts
        \param amVect acceleration limits
        \param maxIndex the index of the trajectory with the longest duration
        \param tryHarder
      */
-    bool _RecomputeNDTrajectoryFixedDuration(std::vector<ParabolicCurve>& curvesVect, const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, size_t maxIndex, bool tryHarder);
+    bool _RecomputeNDTrajectoryFixedDuration(const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vect, const std::vector<dReal>& v0Vect, const std::vector<dReal>& v1Vect, std::vector<ParabolicCurve>& curvesVect, const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, size_t maxIndex, bool tryHarder);
 
     /**
 
@@ -117,6 +122,18 @@ public:
      */
     bool Compute1DTrajectory(dReal x0, dReal x1, dReal v0, dReal v1, dReal vm, dReal am, ParabolicCurve& curveOut, bool bCheck=true);
 
+    /**
+       \brief Compute the minimum durations of n independent 1D problems at once. tOut[i] is the
+       duration of the trajectory that Compute1DTrajectory would return for (x0[i], x1[i], v0[i],
+       v1[i], vm[i], am[i]), but no ramps are constructed and no checking is done.
+
+       The inputs are contiguous arrays and the loop body has no branches so that the compiler can
+       vectorize it. The arrays can hold all DOFs of one segment or the DOFs of many segments
+       concatenated together. The same assumptions as in Compute1DTrajectory apply, i.e. vm[i] > 0,
+       am[i] > 0, |v0[i]| <= vm[i], and |v1[i]| <= vm[i].
+     */
+    static void ComputeMinimumDurations1D(const dReal* x0, const dReal* x1, const dReal* v0, const dReal* v1, const dReal* vm, const dReal* am, size_t n, dReal* tOut);
+
     /**
        \brief Impose the given joint limits to a 1D parabolic trajectory while maintaining the
        original duration of the trajectory. This function is only called from ND trajectory
@@ -196,6 +213,7 @@ private:
 
     // Caching stuff
     std::vector<dReal> _cacheVect, _cacheSwitchpointsList;
+    std::vector<dReal> _cacheDurationsVect; ///< minimum durations of each DOF, used in ComputeArbitraryVelNDTrajectory
     std::vector<dReal> _cacheX0Vect, _cacheX1Vect, _cacheV0Vect, _cacheV1Vect, _cacheAVect;
     Ramp _cacheRamp;
     std::vector<Ramp> _cacheRampsVect;
@@ -13,6 +13,7 @@
 // If not, see <http://www.gnu.org/licenses/>.
 #include "ramp.h"
 #include <iostream>
+#include <atomic>
 
 namespace OpenRAVE {
 
@@ -619,14 +620,89 @@ void ParabolicCurve::TrimBack(dReal t)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // RampND
-RampND::RampND(size_t ndof)
+static std::atomic<size_t> s_numRampNDHeapAllocations(0);
+
+RampND::RampND(size_t ndof) : _ndof(0), _duration(0)
 {
     OPENRAVE_ASSERT_OP(ndof, >, 0);
-    _ndof = ndof;
-    _data.resize(5*_ndof);
+    _Allocate(ndof);
     constraintChecked = false;
 }
 
+RampND::RampND(const RampND& r) : _ndof(0), _duration(0)
+{
+    _CopyData(r);
+}
+
+RampND::RampND(RampND&& r) noexcept : _ndof(0), _duration(0)
+{
+    *this = std::move(r);
+}
+
+RampND& RampND::operator=(const RampND& r)
+{
+    if( this != &r ) {
+        _CopyData(r);
+    }
+    return *this;
+}
+
+RampND& RampND::operator=(RampND&& r) noexcept
+{
+    if( this == &r ) {
+        return *this;
+    }
+    if( r._ndof <= RAMPND_INLINE_MAXDOF ) {
+        // copying into the inline buffer never allocates
+        _ndof = r._ndof;
+        const dReal* psrc = r._GetBuffer();
+        std::copy(psrc, psrc + 5*_ndof, _GetBuffer());
+        _duration = r._duration;
+        constraintChecked = r.constraintChecked;
+    }
+    else {
+        // take over the heap buffer instead of copying it. r gets the previous buffer of this and
+        // is left empty.
+        _heapdata.swap(r._heapdata);
+        _ndof = r._ndof;
+        _duration = r._duration;
+        constraintChecked = r.constraintChecked;
+        r._ndof = 0;
+        r._duration = 0;
+    }
+    return *this;
+}
+
+void RampND::_Allocate(size_t ndof)
+{
+    if( ndof > RAMPND_INLINE_MAXDOF && _heapdata.size() < 5*ndof ) {
+        if( _heapdata.capacity() < 5*ndof ) {
+            _NotifyHeapAllocation();
+        }
+        _heapdata.resize(5*ndof);
+    }
+    _ndof = ndof;
+}
+
+void RampND::_NotifyHeapAllocation()
+{
+    ++s_numRampNDHeapAllocations;
+}
+
+void RampND::_CopyData(const RampND& r)
+{
+    _Allocate(r._ndof);
+    const dReal* psrc = r._GetBuffer();
+    std::copy(psrc, psrc + 5*_ndof, _GetBuffer());
+    _duration = r._duration;
+    constraintChecked = r.constraintChecked;
+}
+
+size_t RampND::GetNumHeapAllocations()
+{
+    return s_numRampNDHeapAllocations;
+}
+
 RampND::RampND(const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vect, const std::vector<dReal>& v0Vect, const std::vector<dReal>& v1Vect, const std::vector<dReal>& aVect, dReal t)
 {
     if( t < 0 ) {
@@ -641,28 +717,30 @@ RampND::RampND(const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vec
     if( aVect.size() > 0 ) {
         OPENRAVE_ASSERT_OP(aVect.size(), ==, _ndof);
     }
-    _data.resize(5*_ndof);
+    size_t ndof = _ndof;
+    _ndof = 0;
+    _Allocate(ndof);
 
-    std::copy(x0Vect.begin(), x0Vect.end(), IT_X0_BEGIN(_data, _ndof));
-    std::copy(x1Vect.begin(), x1Vect.end(), IT_X1_BEGIN(_data, _ndof));
-    std::copy(v0Vect.begin(), v0Vect.end(), IT_V0_BEGIN(_data, _ndof));
-    std::copy(v1Vect.begin(), v1Vect.end(), IT_V1_BEGIN(_data, _ndof));
+    std::copy(x0Vect.begin(), x0Vect.end(), IT_X0_BEGIN(_GetBuffer(), _ndof));
+    std::copy(x1Vect.begin(), x1Vect.end(), IT_X1_BEGIN(_GetBuffer(), _ndof));
+    std::copy(v0Vect.begin(), v0Vect.end(), IT_V0_BEGIN(_GetBuffer(), _ndof));
+    std::copy(v1Vect.begin(), v1Vect.end(), IT_V1_BEGIN(_GetBuffer(), _ndof));
 
     if( aVect.size() == 0 ) {
         if( t == 0 ) {
-            std::fill(IT_A_BEGIN(_data, _ndof), IT_A_END(_data, _ndof), 0);
+            std::fill(IT_A_BEGIN(_GetBuffer(), _ndof), IT_A_END(_GetBuffer(), _ndof), 0);
         }
         else {
             // Calculating accelerations using the same procedure as in ParabolicCurve::SetSegment.
             dReal tSqr = t*t;
             dReal divMult = 1/(t*(0.5*tSqr + 2));
             for (size_t idof = 0; idof < _ndof; ++idof) {
-                _data[DATA_OFFSET_A*_ndof + idof] = -(v0Vect[idof]*tSqr + t*(x0Vect[idof] - x1Vect[idof]) + 2*(v0Vect[idof] - v1Vect[idof]))*divMult;
+                _GetBuffer()[DATA_OFFSET_A*_ndof + idof] = -(v0Vect[idof]*tSqr + t*(x0Vect[idof] - x1Vect[idof]) + 2*(v0Vect[idof] - v1Vect[idof]))*divMult;
             }
         }
     }
     else {
-        std::copy(aVect.begin(), aVect.end(), IT_A_BEGIN(_data, _ndof));
+        std::copy(aVect.begin(), aVect.end(), IT_A_BEGIN(_GetBuffer(), _ndof));
     }
 
     _duration = t;
@@ -670,14 +748,14 @@ RampND::RampND(const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vec
     constraintChecked = false;
 }
 
-void RampND::EvalPos(dReal t, std::vector<dReal>::iterator it) const
+void RampND::EvalPos(dReal t, dReal* it) const
 {
     if( t <= 0 ) {
-        std::copy(IT_X0_BEGIN(_data, _ndof), IT_X0_END(_data, _ndof), it);
+        std::copy(IT_X0_BEGIN(_GetBuffer(), _ndof), IT_X0_END(_GetBuffer(), _ndof), it);
         return;
     }
     else if( t >= GetDuration() ) {
-        std::copy(IT_X1_BEGIN(_data, _ndof), IT_X1_END(_data, _ndof), it);
+        std::copy(IT_X1_BEGIN(_GetBuffer(), _ndof), IT_X1_END(_GetBuffer(), _ndof), it);
         return;
     }
 
@@ -687,14 +765,14 @@ void RampND::EvalPos(dReal t, std::vector<dReal>::iterator it) const
     return;
 }
 
-void RampND::EvalVel(dReal t, std::vector<dReal>::iterator it) const
+void RampND::EvalVel(dReal t, dReal* it) const
 {
     if( t <= 0 ) {
-        std::copy(IT_V0_BEGIN(_data, _ndof), IT_V0_END(_data, _ndof), it);
+        std::copy(IT_V0_BEGIN(_GetBuffer(), _ndof), IT_V0_END(_GetBuffer(), _ndof), it);
         return;
     }
     else if( t >= GetDuration() ) {
-        std::copy(IT_V1_BEGIN(_data, _ndof), IT_V1_END(_data, _ndof), it);
+        std::copy(IT_V1_BEGIN(_GetBuffer(), _ndof), IT_V1_END(_GetBuffer(), _ndof), it);
         return;
     }
 
@@ -704,9 +782,9 @@ void RampND::EvalVel(dReal t, std::vector<dReal>::iterator it) const
     return;
 }
 
-void RampND::EvalAcc(std::vector<dReal>::iterator it) const
+void RampND::EvalAcc(dReal* it) const
 {
-    std::copy(IT_A_BEGIN(_data, _ndof), IT_A_END(_data, _ndof), it);
+    std::copy(IT_A_BEGIN(_GetBuffer(), _ndof), IT_A_END(_GetBuffer(), _ndof), it);
     return;
 }
 
@@ -721,7 +799,7 @@ void RampND::EvalPos(dReal t, std::vector<dReal>& xVect) const
         return;
     }
 
-    xVect.resize(_ndof);
+    _ResizeOutput(xVect);
     for (size_t idof = 0; idof < _ndof; ++idof) {
         xVect[idof] = GetX0At(idof) + t*(GetV0At(idof) + 0.5*t*GetAAt(idof));
     }
@@ -739,7 +817,7 @@ void RampND::EvalVel(dReal t, std::vector<dReal>& vVect) const
         return;
     }
 
-    vVect.resize(_ndof);
+    _ResizeOutput(vVect);
     for (size_t idof = 0; idof < _ndof; ++idof) {
         vVect[idof] = GetV0At(idof) + t*GetAAt(idof);
     }
@@ -755,11 +833,9 @@ void RampND::EvalAcc(std::vector<dReal>& aVect) const
 void RampND::Initialize(size_t ndof)
 {
     constraintChecked = false;
-    _ndof = ndof;
-    if( _data.size() != 5*_ndof ) {
-        _data.resize(5*_ndof);
-    }
-    std::fill(_data.begin(), _data.end(), 0);
+    _Allocate(ndof);
+    dReal* pdata = _GetBuffer();
+    std::fill(pdata, pdata + 5*_ndof, 0);
 }
 
 void RampND::Initialize(const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vect, const std::vector<dReal>& v0Vect, const std::vector<dReal>& v1Vect, const std::vector<dReal>& aVect, dReal t)
@@ -777,30 +853,28 @@ void RampND::Initialize(const std::vector<dReal>& x0Vect, const std::vector<dRea
     if( aVect.size() > 0 ) {
         OPENRAVE_ASSERT_OP(aVect.size(), ==, _ndof);
     }
-    if( _data.size() != 5*_ndof ) {
-        _data.resize(5*_ndof);
-    }
+    _Allocate(_ndof);
 
-    std::copy(x0Vect.begin(), x0Vect.end(), IT_X0_BEGIN(_data, _ndof));
-    std::copy(x1Vect.begin(), x1Vect.end(), IT_X1_BEGIN(_data, _ndof));
-    std::copy(v0Vect.begin(), v0Vect.end(), IT_V0_BEGIN(_data, _ndof));
-    std::copy(v1Vect.begin(), v1Vect.end(), IT_V1_BEGIN(_data, _ndof));
+    std::copy(x0Vect.begin(), x0Vect.end(), IT_X0_BEGIN(_GetBuffer(), _ndof));
+    std::copy(x1Vect.begin(), x1Vect.end(), IT_X1_BEGIN(_GetBuffer(), _ndof));
+    std::copy(v0Vect.begin(), v0Vect.end(), IT_V0_BEGIN(_GetBuffer(), _ndof));
+    std::copy(v1Vect.begin(), v1Vect.end(), IT_V1_BEGIN(_GetBuffer(), _ndof));
 
     if( aVect.size() == 0 ) {
         if( t == 0 ) {
-            std::fill(IT_A_BEGIN(_data, _ndof), IT_A_END(_data, _ndof), 0);
+            std::fill(IT_A_BEGIN(_GetBuffer(), _ndof), IT_A_END(_GetBuffer(), _ndof), 0);
         }
         else {
             // Calculating accelerations using the same procedure as in ParabolicCurve::SetSegment.
             dReal tSqr = t*t;
             dReal divMult = 1/(t*(0.5*tSqr + 2));
             for (size_t idof = 0; idof < _ndof; ++idof) {
-                _data[DATA_OFFSET_A*_ndof + idof] = -(v0Vect[idof]*tSqr + t*(x0Vect[idof] - x1Vect[idof]) + 2*(v0Vect[idof] - v1Vect[idof]))*divMult;
+                _GetBuffer()[DATA_OFFSET_A*_ndof + idof] = -(v0Vect[idof]*tSqr + t*(x0Vect[idof] - x1Vect[idof]) + 2*(v0Vect[idof] - v1Vect[idof]))*divMult;
             }
         }
     }
     else {
-        std::copy(aVect.begin(), aVect.end(), IT_A_BEGIN(_data, _ndof));
+        std::copy(aVect.begin(), aVect.end(), IT_A_BEGIN(_GetBuffer(), _ndof));
     }
 
     _duration = t;
@@ -812,9 +886,9 @@ void RampND::SetConstant(const std::vector<dReal>& xVect, const dReal t)
 {
     OPENRAVE_ASSERT_OP(xVect.size(), ==, _ndof);
     OPENRAVE_ASSERT_OP(t, >=, -g_fRampEpsilon);
-    std::copy(xVect.begin(), xVect.end(), IT_X0_BEGIN(_data, _ndof)); // x0Vect
-    std::copy(xVect.begin(), xVect.end(), IT_X1_BEGIN(_data, _ndof)); // x1Vect
-    std::fill(IT_V0_BEGIN(_data, _ndof), _data.end(),  0); // v0Vect, v1Vect, aVect
+    std::copy(xVect.begin(), xVect.end(), IT_X0_BEGIN(_GetBuffer(), _ndof)); // x0Vect
+    std::copy(xVect.begin(), xVect.end(), IT_X1_BEGIN(_GetBuffer(), _ndof)); // x1Vect
+    std::fill(IT_V0_BEGIN(_GetBuffer(), _ndof), IT_A_END(_GetBuffer(), _ndof),  0); // v0Vect, v1Vect, aVect
     _duration = t; // duration
     return;
 }
@@ -840,50 +914,50 @@ void RampND::Cut(dReal t, RampND& remRampND)
     remRampND.constraintChecked = constraintChecked;
 
     if( t <= 0 ) {
-        // Copy _data to remRampND._data
-        std::copy(_data.begin(), _data.end(), remRampND._data.begin());
+        // Copy all data to remRampND
+        std::copy(_GetBuffer(), _GetBuffer() + 5*_ndof, remRampND._GetBuffer());
         remRampND._duration = _duration;
 
         // Update x1 of this
-        std::copy(IT_X0_BEGIN(_data, _ndof), IT_X0_END(_data, _ndof), IT_X1_BEGIN(_data, _ndof));
+        std::copy(IT_X0_BEGIN(_GetBuffer(), _ndof), IT_X0_END(_GetBuffer(), _ndof), IT_X1_BEGIN(_GetBuffer(), _ndof));
         // Update v1 of this
-        std::copy(IT_V0_BEGIN(_data, _ndof), IT_V0_END(_data, _ndof), IT_V1_BEGIN(_data, _ndof));
+        std::copy(IT_V0_BEGIN(_GetBuffer(), _ndof), IT_V0_END(_GetBuffer(), _ndof), IT_V1_BEGIN(_GetBuffer(), _ndof));
 
         _duration = 0;
         return;
     }
     else if( t >= _duration ) {
         // Update x0 of remRampND
-        std::copy(IT_X1_BEGIN(_data, _ndof), IT_X1_END(_data, _ndof), IT_X0_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_X1_BEGIN(_GetBuffer(), _ndof), IT_X1_END(_GetBuffer(), _ndof), IT_X0_BEGIN(remRampND._GetBuffer(), _ndof));
         // Update x1 of remRampND
-        std::copy(IT_X1_BEGIN(_data, _ndof), IT_X1_END(_data, _ndof), IT_X1_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_X1_BEGIN(_GetBuffer(), _ndof), IT_X1_END(_GetBuffer(), _ndof), IT_X1_BEGIN(remRampND._GetBuffer(), _ndof));
         // Update v0 of remRampND
-        std::copy(IT_V1_BEGIN(_data, _ndof), IT_V1_END(_data, _ndof), IT_V0_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_V1_BEGIN(_GetBuffer(), _ndof), IT_V1_END(_GetBuffer(), _ndof), IT_V0_BEGIN(remRampND._GetBuffer(), _ndof));
         // Update v1 of remRampND
-        std::copy(IT_V1_BEGIN(_data, _ndof), IT_V1_END(_data, _ndof), IT_V1_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_V1_BEGIN(_GetBuffer(), _ndof), IT_V1_END(_GetBuffer(), _ndof), IT_V1_BEGIN(remRampND._GetBuffer(), _ndof));
         // Update a of remRampND
-        std::copy(IT_A_BEGIN(_data, _ndof), IT_A_END(_data, _ndof), IT_A_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_A_BEGIN(_GetBuffer(), _ndof), IT_A_END(_GetBuffer(), _ndof), IT_A_BEGIN(remRampND._GetBuffer(), _ndof));
 
         remRampND._duration = 0;
         return;
     }
     else {
         // Update x1 of remRampND
-        std::copy(IT_X1_BEGIN(_data, _ndof), IT_X1_END(_data, _ndof), IT_X1_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_X1_BEGIN(_GetBuffer(), _ndof), IT_X1_END(_GetBuffer(), _ndof), IT_X1_BEGIN(remRampND._GetBuffer(), _ndof));
         // Update v1 of remRampND
-        std::copy(IT_V1_BEGIN(_data, _ndof), IT_V1_END(_data, _ndof), IT_V1_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_V1_BEGIN(_GetBuffer(), _ndof), IT_V1_END(_GetBuffer(), _ndof), IT_V1_BEGIN(remRampND._GetBuffer(), _ndof));
         // Update a of remRampND
-        std::copy(IT_A_BEGIN(_data, _ndof), IT_A_END(_data, _ndof), IT_A_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_A_BEGIN(_GetBuffer(), _ndof), IT_A_END(_GetBuffer(), _ndof), IT_A_BEGIN(remRampND._GetBuffer(), _ndof));
 
         // Update x1 of this
-        EvalPos(t, IT_X1_BEGIN(_data, _ndof));
+        EvalPos(t, IT_X1_BEGIN(_GetBuffer(), _ndof));
         // Update v1 of this. Note that the update of x1 does not affect this velocity calculation.
-        EvalVel(t, IT_V1_BEGIN(_data, _ndof));
+        EvalVel(t, IT_V1_BEGIN(_GetBuffer(), _ndof));
 
         // Update x0 of remRampND
-        std::copy(IT_X1_BEGIN(_data, _ndof), IT_X1_END(_data, _ndof), IT_X0_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_X1_BEGIN(_GetBuffer(), _ndof), IT_X1_END(_GetBuffer(), _ndof), IT_X0_BEGIN(remRampND._GetBuffer(), _ndof));
         // Update v0 of remRampND
-        std::copy(IT_V1_BEGIN(_data, _ndof), IT_V1_END(_data, _ndof), IT_V0_BEGIN(remRampND._data, _ndof));
+        std::copy(IT_V1_BEGIN(_GetBuffer(), _ndof), IT_V1_END(_GetBuffer(), _ndof), IT_V0_BEGIN(remRampND._GetBuffer(), _ndof));
 
         // Update duration
         remRampND._duration = _duration - t;
@@ -898,14 +972,14 @@ void RampND::TrimFront(dReal t)
         return;
     }
     else if( t >= _duration ) {
-        std::copy(IT_X1_BEGIN(_data, _ndof), IT_X1_END(_data, _ndof), IT_X0_BEGIN(_data, _ndof)); // replace x0 by x1
-        std::copy(IT_V1_BEGIN(_data, _ndof), IT_V1_END(_data, _ndof), IT_V0_BEGIN(_data, _ndof)); // replace v0 by v1
+        std::copy(IT_X1_BEGIN(_GetBuffer(), _ndof), IT_X1_END(_GetBuffer(), _ndof), IT_X0_BEGIN(_GetBuffer(), _ndof)); // replace x0 by x1
+        std::copy(IT_V1_BEGIN(_GetBuffer(), _ndof), IT_V1_END(_GetBuffer(), _ndof), IT_V0_BEGIN(_GetBuffer(), _ndof)); // replace v0 by v1
         _duration = 0; // duration
         return;
     }
     else {
-        EvalPos(t, IT_X0_BEGIN(_data, _ndof)); // update x0
-        EvalVel(t, IT_V0_BEGIN(_data, _ndof)); // update v0. Note that the update of x0 does not affect velocity calculation
+        EvalPos(t, IT_X0_BEGIN(_GetBuffer(), _ndof)); // update x0
+        EvalVel(t, IT_V0_BEGIN(_GetBuffer(), _ndof)); // update v0. Note that the update of x0 does not affect velocity calculation
         _duration -= t;
         return;
     }
@@ -914,8 +988,8 @@ void RampND::TrimFront(dReal t)
 void RampND::TrimBack(dReal t)
 {
     if( t <= 0 ) {
-        std::copy(IT_X0_BEGIN(_data, _ndof), IT_X0_END(_data, _ndof), IT_X1_BEGIN(_data, _ndof)); // replace x1 by x0
-        std::copy(IT_V0_BEGIN(_data, _ndof), IT_V0_END(_data, _ndof), IT_V1_BEGIN(_data, _ndof)); // replace v1 by v0
+        std::copy(IT_X0_BEGIN(_GetBuffer(), _ndof), IT_X0_END(_GetBuffer(), _ndof), IT_X1_BEGIN(_GetBuffer(), _ndof)); // replace x1 by x0
+        std::copy(IT_V0_BEGIN(_GetBuffer(), _ndof), IT_V0_END(_GetBuffer(), _ndof), IT_V1_BEGIN(_GetBuffer(), _ndof)); // replace v1 by v0
         _duration = 0; // duration
         return;
     }
@@ -923,8 +997,8 @@ void RampND::TrimBack(dReal t)
         return;
     }
     else {
-        EvalPos(t, IT_X1_BEGIN(_data, _ndof)); // update x1
-        EvalVel(t, IT_V1_BEGIN(_data, _ndof)); // update v1. Note that the update of x1 does not affect velocity calculation
+        EvalPos(t, IT_X1_BEGIN(_GetBuffer(), _ndof)); // update x1
+        EvalVel(t, IT_V1_BEGIN(_GetBuffer(), _ndof)); // update v1. Note that the update of x1 does not affect velocity calculation
         _duration = t;
         return;
     }
@@ -933,8 +1007,9 @@ void RampND::TrimBack(dReal t)
 void RampND::Serialize(std::ostream& O) const
 {
     O << _ndof;
-    for (size_t i = 0; i < _data.size(); ++i) {
-        O << " " << _data[i];
+    const dReal* pdata = _GetBuffer();
+    for (size_t i = 0; i < 5*_ndof; ++i) {
+        O << " " << pdata[i];
     }
     O << " " << _duration << "\n";
 }
@@ -952,7 +1027,7 @@ void ParabolicPath::EvalPos(dReal t, std::vector<dReal>& xVect) const
     int index;
     dReal remainder;
     FindRampNDIndex(t, index, remainder);
-    _rampnds[index].EvalPos(remainder, xVect.begin());
+    _rampnds[index].EvalPos(remainder, xVect);
 }
 
 void ParabolicPath::EvalVel(dReal t, std::vector<dReal>& vVect) const
@@ -960,7 +1035,7 @@ void ParabolicPath::EvalVel(dReal t, std::vector<dReal>& vVect) const
     int index;
     dReal remainder;
     FindRampNDIndex(t, index, remainder);
-    _rampnds[index].EvalVel(remainder, vVect.begin());
+    _rampnds[index].EvalVel(remainder, vVect);
 }
 
 void ParabolicPath::EvalAcc(dReal t, std::vector<dReal>& aVect) const
@@ -968,7 +1043,7 @@ void ParabolicPath::EvalAcc(dReal t, std::vector<dReal>& aVect) const
     int index;
     dReal remainder;
     FindRampNDIndex(t, index, remainder);
-    _rampnds[index].EvalAcc(aVect.begin());
+    _rampnds[index].EvalAcc(aVect);
 }
 
 void ParabolicPath::FindRampNDIndex(dReal t, int& index, dReal& remainder) const
@@ -1040,17 +1115,13 @@ void ParabolicPath::ReplaceSegment(dReal t0, dReal t1, const std::vector<RampND>
         // The new size is greater than the original size. Resize the container first and start
         // moving from right to left.
         _rampnds.resize(newSize);
-        for (size_t irampnd = 0; irampnd < rightPartLength; ++irampnd) {
-            _rampnds[newSize - 1 - irampnd] = _rampnds[prevSize - 1 - irampnd];
-        }
+        std::move_backward(_rampnds.begin() + (prevSize - rightPartLength), _rampnds.begin() + prevSize, _rampnds.end());
         newindex1 = newSize - rightPartLength;
     }
     else if( prevSize > newSize ) {
         // The new size is less than the current size. We need to move the RampNDs (from left to
         // right) first before resizing the container.
-        for (size_t irampnd = 0; irampnd < rightPartLength; ++irampnd) {
-            _rampnds[newSize - rightPartLength + irampnd] = _rampnds[prevSize - rightPartLength + irampnd];
-        }
+        std::move(_rampnds.begin() + (prevSize - rightPartLength), _rampnds.end(), _rampnds.begin() + (newSize - rightPartLength));
         _rampnds.resize(newSize);
         newindex1 = newSize - rightPartLength;
     }
@@ -28,16 +28,19 @@ namespace RampOptimizerInternal {
 #define DATA_OFFSET_V1 3
 #define DATA_OFFSET_A 4
 
-#define IT_X0_BEGIN(data, ndof) ((data).begin() + DATA_OFFSET_X0*ndof)
-#define IT_X0_END(data, ndof) ((data).begin() + DATA_OFFSET_X0*ndof + ndof)
-#define IT_X1_BEGIN(data, ndof) ((data).begin() + DATA_OFFSET_X1*ndof)
-#define IT_X1_END(data, ndof) ((data).begin() + DATA_OFFSET_X1*ndof + ndof)
-#define IT_V0_BEGIN(data, ndof) ((data).begin() + DATA_OFFSET_V0*ndof)
-#define IT_V0_END(data, ndof) ((data).begin() + DATA_OFFSET_V0*ndof + ndof)
-#define IT_V1_BEGIN(data, ndof) ((data).begin() + DATA_OFFSET_V1*ndof)
-#define IT_V1_END(data, ndof) ((data).begin() + DATA_OFFSET_V1*ndof + ndof)
-#define IT_A_BEGIN(data, ndof) ((data).begin() + DATA_OFFSET_A*ndof)
-#define IT_A_END(data, ndof) ((data).begin() + DATA_OFFSET_A*ndof + ndof)
+/// RampND keeps its data inline (no heap allocation) when the number of DOFs is at most this value.
+#define RAMPND_INLINE_MAXDOF 16
+
+#define IT_X0_BEGIN(data, ndof) ((data) + DATA_OFFSET_X0*ndof)
+#define IT_X0_END(data, ndof) ((data) + DATA_OFFSET_X0*ndof + ndof)
+#define IT_X1_BEGIN(data, ndof) ((data) + DATA_OFFSET_X1*ndof)
+#define IT_X1_END(data, ndof) ((data) + DATA_OFFSET_X1*ndof + ndof)
+#define IT_V0_BEGIN(data, ndof) ((data) + DATA_OFFSET_V0*ndof)
+#define IT_V0_END(data, ndof) ((data) + DATA_OFFSET_V0*ndof + ndof)
+#define IT_V1_BEGIN(data, ndof) ((data) + DATA_OFFSET_V1*ndof)
+#define IT_V1_END(data, ndof) ((data) + DATA_OFFSET_V1*ndof + ndof)
+#define IT_A_BEGIN(data, ndof) ((data) + DATA_OFFSET_A*ndof)
+#define IT_A_END(data, ndof) ((data) + DATA_OFFSET_A*ndof + ndof)
 
 class Ramp {
 public:
@@ -231,11 +234,16 @@ private:
 
 class RampND {
 public:
-    RampND() {
+    RampND() : _ndof(0), _duration(0) {
         constraintChecked = false;
     }
     RampND(size_t ndof);
 
+    RampND(const RampND& r);
+    RampND(RampND&& r) noexcept;
+    RampND& operator=(const RampND& r);
+    RampND& operator=(RampND&& r) noexcept;
+
     /**
        \brief Initialize RampND to hold the given values. There can be X different initializations
        as follows:
@@ -251,13 +259,13 @@ public:
     }
 
     /// \brief Evaluate the position at time t
-    void EvalPos(dReal t, std::vector<dReal>::iterator it) const;
+    void EvalPos(dReal t, dReal* it) const;
 
     /// \brief Evaluate the velocity at time t
-    void EvalVel(dReal t, std::vector<dReal>::iterator it) const;
+    void EvalVel(dReal t, dReal* it) const;
 
     /// \brief Evaluate the acceleration at time t
-    void EvalAcc(std::vector<dReal>::iterator it) const;
+    void EvalAcc(dReal* it) const;
 
     /// \brief Evaluate the position at time t
     void EvalPos(dReal t, std::vector<dReal>& xVect) const;
@@ -295,56 +303,56 @@ public:
         return _ndof;
     }
 
-    /// Before calling Get functions, users need to make sure that _data has been
+    /// Before calling Get functions, users need to make sure that the data has been
     /// initialized beforehand.
     inline const dReal GetX0At(int idof) const
     {
-        return _data[DATA_OFFSET_X0*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_X0*_ndof + idof];
     }
 
     inline const dReal GetX1At(int idof) const
     {
-        return _data[DATA_OFFSET_X1*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_X1*_ndof + idof];
     }
 
     inline const dReal GetV0At(int idof) const
     {
-        return _data[DATA_OFFSET_V0*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_V0*_ndof + idof];
     }
 
     inline const dReal GetV1At(int idof) const
     {
-        return _data[DATA_OFFSET_V1*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_V1*_ndof + idof];
     }
 
     inline const dReal GetAAt(int idof) const
     {
-        return _data[DATA_OFFSET_A*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_A*_ndof + idof];
     }
 
     inline dReal& GetX0At(int idof)
     {
-        return _data[DATA_OFFSET_X0*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_X0*_ndof + idof];
     }
 
     inline dReal& GetX1At(int idof)
     {
-        return _data[DATA_OFFSET_X1*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_X1*_ndof + idof];
     }
 
     inline dReal& GetV0At(int idof)
     {
-        return _data[DATA_OFFSET_V0*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_V0*_ndof + idof];
     }
 
     inline dReal& GetV1At(int idof)
     {
-        return _data[DATA_OFFSET_V1*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_V1*_ndof + idof];
     }
 
     inline dReal& GetAAt(int idof)
     {
-        return _data[DATA_OFFSET_A*_ndof + idof];
+        return _GetBuffer()[DATA_OFFSET_A*_ndof + idof];
     }
 
     inline const dReal GetDuration() const
@@ -379,8 +387,9 @@ public:
 
     inline void _GetData(std::vector<dReal>& res, int offset) const
     {
-        res.resize(_ndof);
-        std::copy(_data.begin() + offset, _data.begin() + offset + _ndof, res.begin());
+        _ResizeOutput(res);
+        const dReal* pdata = _GetBuffer() + offset;
+        std::copy(pdata, pdata + _ndof, res.begin());
         return;
     }
 
@@ -421,73 +430,69 @@ public:
     inline void _SetData(const std::vector<dReal>& valueVect, int offset)
     {
         OPENRAVE_ASSERT_OP(valueVect.size(), ==, _ndof);
-        std::copy(valueVect.begin(), valueVect.end(), _data.begin() + offset);
+        std::copy(valueVect.begin(), valueVect.end(), _GetBuffer() + offset);
         return;
     }
 
     // Get/Set value by giving a pointer to the first element in the vector. Users need to make sure
-    // that the given iterator is pointing to a vector of dimension consistent with _ndof
-
-    // These functions may not be that useful. Will see later if we should remove them.
-    inline std::vector<dReal>::const_iterator GetX0Vect() const
+    // that the given pointer is pointing to an array of dimension consistent with _ndof
+    inline const dReal* GetX0Vect() const
     {
-        return IT_X0_BEGIN(_data, _ndof);
+        return IT_X0_BEGIN(_GetBuffer(), _ndof);
     }
 
-    inline std::vector<dReal>::const_iterator GetX1Vect() const
+    inline const dReal* GetX1Vect() const
     {
-        return IT_X1_BEGIN(_data, _ndof);
+        return IT_X1_BEGIN(_GetBuffer(), _ndof);
     }
 
-    inline std::vector<dReal>::const_iterator GetV0Vect() const
+    inline const dReal* GetV0Vect() const
     {
-        return IT_V0_BEGIN(_data, _ndof);
+        return IT_V0_BEGIN(_GetBuffer(), _ndof);
     }
 
-    inline std::vector<dReal>::const_iterator GetV1Vect() const
+    inline const dReal* GetV1Vect() const
     {
-        return IT_V1_BEGIN(_data, _ndof);
+        return IT_V1_BEGIN(_GetBuffer(), _ndof);
     }
 
-    inline std::vector<dReal>::const_iterator GetAVect() const
+    inline const dReal* GetAVect() const
     {
-        return IT_A_BEGIN(_data, _ndof);
+        return IT_A_BEGIN(_GetBuffer(), _ndof);
     }
 
-    inline void SetX0Vect(std::vector<dReal>::const_iterator it)
+    inline void SetX0Vect(const dReal* it)
     {
         return _SetData(it, 0);
     }
 
-    inline void SetX1Vect(std::vector<dReal>::const_iterator it)
+    inline void SetX1Vect(const dReal* it)
     {
         return _SetData(it, _ndof);
     }
 
-    inline void SetV0Vect(std::vector<dReal>::const_iterator it)
+    inline void SetV0Vect(const dReal* it)
     {
         return _SetData(it, 2*_ndof);
     }
 
-    inline void SetV1Vect(std::vector<dReal>::const_iterator it)
+    inline void SetV1Vect(const dReal* it)
     {
         return _SetData(it, 3*_ndof);
     }
 
-    inline void SetAVect(std::vector<dReal>::const_iterator it)
+    inline void SetAVect(const dReal* it)
     {
         return _SetData(it, 4*_ndof);
     }
 
-    inline void _SetData(std::vector<dReal>::const_iterator it, int offset)
+    inline void _SetData(const dReal* it, int offset)
     {
-        for (size_t idof = 0; idof < _ndof; ++idof) {
-            *(_data.begin() + offset + idof) = *(it + idof);
-        }
+        std::copy(it, it + _ndof, _GetBuffer() + offset);
         return;
     }
 
-    /// \brief Serialize this RampND. The format is _ndof<space>all entries in _data<space>_duration
+    /// \brief Serialize this RampND. The format is _ndof<space>all 5*_ndof data entries<space>_duration
     void Serialize(std::ostream& O) const;
 
     /**
@@ -501,11 +506,46 @@ public:
      */
     mutable bool constraintChecked;
 
+    /// \brief Return the number of heap allocations done by any RampND, both for its own storage
+    /// (RampNDs with more than RAMPND_INLINE_MAXDOF DOFs) and for growing the output vectors passed
+    /// to its getters and evaluation functions. Useful for checking that smoothing runs do not
+    /// allocate per ramp.
+    static size_t GetNumHeapAllocations();
+
 private:
+    /// \brief Increment the counter returned by GetNumHeapAllocations.
+    static void _NotifyHeapAllocation();
+
+    /// \brief Resize an output vector to _ndof, counting the allocation if it has to grow.
+    inline void _ResizeOutput(std::vector<dReal>& res) const
+    {
+        if( res.capacity() < _ndof ) {
+            _NotifyHeapAllocation();
+        }
+        res.resize(_ndof);
+    }
+
+    /// \brief Prepare the storage for 5*ndof values and set _ndof.
+    void _Allocate(size_t ndof);
+
+    /// \brief Copy the data of r into this RampND, reusing the existing storage when possible.
+    void _CopyData(const RampND& r);
+
+    inline dReal* _GetBuffer()
+    {
+        return _ndof <= RAMPND_INLINE_MAXDOF ? _inlinedata : &_heapdata[0];
+    }
+
+    inline const dReal* _GetBuffer() const
+    {
+        return _ndof <= RAMPND_INLINE_MAXDOF ? _inlinedata : &_heapdata[0];
+    }
+
     size_t _ndof;
     dReal _duration;
-    std::vector<dReal> _data; // a vector of size 5*_ndof containing the data of the following
-                              // order: x0Vect, x1Vect, v0Vect, v1Vect, and aVect.
+    dReal _inlinedata[5*RAMPND_INLINE_MAXDOF]; // holds 5*_ndof values of the following order: x0Vect, x1Vect,
+                                               // v0Vect, v1Vect, and aVect. Used when _ndof <= RAMPND_INLINE_MAXDOF.
+    std::vector<dReal> _heapdata; // same layout as _inlinedata. Used when _ndof > RAMPND_INLINE_MAXDOF.
 }; // end class RampND
 
 class ParabolicPath {
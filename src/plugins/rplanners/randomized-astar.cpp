@@ -123,72 +123,6 @@ public:
     };
 
 public:
-    class RAStarParameters : public PlannerBase::PlannerParameters {
-public:
-        RAStarParameters() : fRadius(0.1f), fDistThresh(0.03f), fGoalCoeff(1), nMaxChildren(5), nMaxSampleTries(10), _bProcessingRA(false) {
-            _vXMLParameters.push_back("radius");
-            _vXMLParameters.push_back("distthresh");
-            _vXMLParameters.push_back("goalcoeff");
-            _vXMLParameters.push_back("maxchildren");
-            _vXMLParameters.push_back("maxsampletries");
-        }
-
-        dReal fRadius;              ///< _pDistMetric thresh is the radius that children must be within parents
-        dReal fDistThresh;          ///< gamma * _pDistMetric->thresh is the sampling radius
-        dReal fGoalCoeff;           ///< balancees exploratino vs cost
-        int nMaxChildren;           ///< limit on number of children
-        int nMaxSampleTries;         ///< max sample tries before giving up on creating a child
-protected:
-        bool _bProcessingRA;
-        virtual bool serialize(std::ostream& O) const
-        {
-            if( !PlannerParameters::serialize(O) )
-                return false;
-
-            O << "<radius>" << fRadius << "</radius>" << endl;
-            O << "<distthresh>" << fDistThresh << "</distthresh>" << endl;
-            O << "<goalcoeff>" << fGoalCoeff << "</goalcoeff>" << endl;
-            O << "<maxchildren>" << nMaxChildren << "</maxchildren>" << endl;
-            O << "<maxsampletries>" << nMaxSampleTries << "</maxsampletries>" << endl;
-
-            return !!O;
-        }
-
-        ProcessElement startElement(const std::string& name, const AttributesList& atts)
-        {
-            if( _bProcessingRA )
-                return PE_Ignore;
-            switch( PlannerBase::PlannerParameters::startElement(name,atts) ) {
-            case PE_Pass: break;
-            case PE_Support: return PE_Support;
-            case PE_Ignore: return PE_Ignore;
-            }
-            _bProcessingRA = name=="radius"||name=="distthresh"||name=="goalcoeff"||name=="maxchildren"||name=="maxsampletries";
-            return _bProcessingRA ? PE_Support : PE_Pass;
-        }
-        virtual bool endElement(const string& name)
-        {
-            if( _bProcessingRA ) {
-                if( name == "radius")
-                    _ss >> fRadius;
-                else if( name == "distthresh")
-                    _ss >> fDistThresh;
-                else if( name == "goalcoeff")
-                    _ss >> fGoalCoeff;
-                else if( name == "maxchildren")
-                    _ss >> nMaxChildren;
-                else if( name == "maxsampletries")
-                    _ss >> nMaxSampleTries;
-                else
-                    RAVELOG_WARN(str(boost::format("unknown tag %s\n")%name));
-                _bProcessingRA = false;
-                return false;
-            }
-            // give a chance for the default parameters to get processed
-            return PlannerParameters::endElement(name);
-        }
-    };
-
     struct Node
     {
         Node() {
@@ -19,6 +19,7 @@
 
 #include "openraveplugindefs.h"
 
+#include <openrave/planningutils.h>
 #include <boost/pool/pool.hpp>
 
 #define _(msgid) OpenRAVE::RaveGetLocalizedTextForDomain("openrave_plugins_rplanners", msgid)
@@ -179,6 +180,12 @@ public:
         }
         _planner = planner;
         _distmetricfn = distmetricfn;
+        _vdistweights2.resize(0);
+        const planningutils::JointDistanceMetric* pjointmetric = distmetricfn.template target<planningutils::JointDistanceMetric>();
+        if( !!pjointmetric && !pjointmetric->HasCircularDOFs() && (int)pjointmetric->GetWeights2().size() == dof ) {
+            // plain weighted euclidean metric, so can evaluate it directly on the node states
+            _vdistweights2 = pjointmetric->GetWeights2();
+        }
         _fStepLength = fStepLength;
         _dof = dof;
         _vNewConfig.resize(dof);
@@ -214,18 +221,39 @@ public:
         _numnodes = 0;
     }
 
+    /// \brief sqrt(sum_i weights2[i]*(config0[i]-config1[i])^2). No branches or calls inside the loop so that the compiler can vectorize it.
+    inline dReal _ComputeWeightedEuclideanDistance(const dReal* config0, const dReal* config1) const
+    {
+        const dReal* pweights2 = &_vdistweights2[0];
+        dReal dist = 0;
+        for(int i = 0; i < _dof; ++i) {
+            dReal diff = config0[i] - config1[i];
+            dist += pweights2[i]*diff*diff;
+        }
+        return RaveSqrt(dist);
+    }
+
     inline dReal _ComputeDistance(const dReal* config0, const dReal* config1) const
     {
+        if( _vdistweights2.size() > 0 ) {
+            return _ComputeWeightedEuclideanDistance(config0, config1);
+        }
         return _distmetricfn(VectorWrapper<dReal>(config0, config0+_dof), VectorWrapper<dReal>(config1, config1+_dof));
     }
 
     inline dReal _ComputeDistance(const dReal* config0, const std::vector<dReal>& config1) const
     {
+        if( _vdistweights2.size() > 0 ) {
+            return _ComputeWeightedEuclideanDistance(config0, &config1[0]);
+        }
         return _distmetricfn(VectorWrapper<dReal>(config0,config0+_dof), config1);
     }
 
     inline dReal _ComputeDistance(NodePtr node0, NodePtr node1) const
     {
+        if( _vdistweights2.size() > 0 ) {
+            return _ComputeWeightedEuclideanDistance(node0->q, node1->q);
+        }
         return _distmetricfn(VectorWrapper<dReal>(node0->q, &node0->q[_dof]), VectorWrapper<dReal>(node1->q, &node1->q[_dof]));
     }
 
@@ -1046,6 +1074,7 @@ private:
 
 
     boost::function<dReal(const std::vector<dReal>&, const std::vector<dReal>&)> _distmetricfn;
+    std::vector<dReal> _vdistweights2; ///< if not empty, _distmetricfn is a planningutils::JointDistanceMetric without circular DOFs and distances are computed directly from these squared weights
     boost::weak_ptr<PlannerBase> _planner;
     dReal _fStepLength;
     int _dof; ///< the number of values of each state
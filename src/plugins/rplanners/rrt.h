@@ -36,6 +36,8 @@ Uses the Rapidly-Exploring Random Trees Algorithm.\n\
                         "returns the goal index of the plan");
         RegisterCommand("GetInitGoalIndices",boost::bind(&RrtPlanner<Node>::GetInitGoalIndicesCommand,this,_1,_2),
                         "returns the start and goal indices");
+        RegisterCommand("BenchmarkNearestNeighbor",boost::bind(&RrtPlanner<Node>::BenchmarkNearestNeighborCommand,this,_1,_2),
+                        "Input: numnodes numqueries. Fills a tree with numnodes random configurations within the limits of the current planner parameters and times numqueries nearest neighbor queries once with the direct distance evaluation and once through the generic distance metric callback. Returns \"numinsertednodes directtime callbacktime nummismatches\". InitPlan has to be called beforehand.");
         _filterreturn.reset(new ConstraintFilterReturn());
     }
     virtual ~RrtPlanner() {
@@ -244,6 +246,68 @@ Uses the Rapidly-Exploring Random Trees Algorithm.\n\
         return !!os;
     }
 
+    bool BenchmarkNearestNeighborCommand(std::ostream& os, std::istream& is)
+    {
+        int numnodes = 10000, numqueries = 1000;
+        is >> numnodes >> numqueries;
+        PlannerParametersConstPtr params = GetParameters();
+        if( !params || !_uniformsampler ) {
+            RAVELOG_WARN_FORMAT("env=%d, planner is not initialized", GetEnv()->GetId());
+            return false;
+        }
+        const int dof = params->GetDOF();
+        std::vector<dReal> vsamples, vqueries;
+        _uniformsampler->SampleSequence(vsamples, numnodes*dof);
+        _uniformsampler->SampleSequence(vqueries, numqueries*dof);
+        for(size_t i = 0; i < vsamples.size(); ++i) {
+            vsamples[i] = params->_vConfigLowerLimit[i%dof] + vsamples[i]*(params->_vConfigUpperLimit[i%dof] - params->_vConfigLowerLimit[i%dof]);
+        }
+        for(size_t i = 0; i < vqueries.size(); ++i) {
+            vqueries[i] = params->_vConfigLowerLimit[i%dof] + vqueries[i]*(params->_vConfigUpperLimit[i%dof] - params->_vConfigLowerLimit[i%dof]);
+        }
+
+        // binding the metric hides its type from the tree, so the second tree always goes through the callback
+        boost::function<dReal(const std::vector<dReal>&, const std::vector<dReal>&)> directmetricfn = params->_distmetricfn;
+        boost::function<dReal(const std::vector<dReal>&, const std::vector<dReal>&)> callbackmetricfn = boost::bind(params->_distmetricfn, _1, _2);
+        dReal maxdistance = params->_distmetricfn(params->_vConfigLowerLimit, params->_vConfigUpperLimit);
+        SpatialTree<Node> directtree(0), callbacktree(0);
+        directtree.Init(shared_planner(), dof, directmetricfn, params->_fStepLength, maxdistance);
+        callbacktree.Init(shared_planner(), dof, callbackmetricfn, params->_fStepLength, maxdistance);
+        std::vector<dReal> vconfig(dof);
+        int numinserted = 0;
+        for(int inode = 0; inode < numnodes; ++inode) {
+            std::copy(vsamples.begin()+inode*dof, vsamples.begin()+(inode+1)*dof, vconfig.begin());
+            if( !!directtree.InsertNode(NULL, vconfig, inode) ) {
+                ++numinserted;
+            }
+            callbacktree.InsertNode(NULL, vconfig, inode);
+        }
+
+        std::vector< std::pair<NodeBasePtr, dReal> > vdirectnearest(numqueries), vcallbacknearest(numqueries);
+        uint64_t starttime = utils::GetMicroTime();
+        for(int iquery = 0; iquery < numqueries; ++iquery) {
+            std::copy(vqueries.begin()+iquery*dof, vqueries.begin()+(iquery+1)*dof, vconfig.begin());
+            vdirectnearest[iquery] = directtree.FindNearestNode(vconfig);
+        }
+        uint64_t directtime = utils::GetMicroTime() - starttime;
+        starttime = utils::GetMicroTime();
+        for(int iquery = 0; iquery < numqueries; ++iquery) {
+            std::copy(vqueries.begin()+iquery*dof, vqueries.begin()+(iquery+1)*dof, vconfig.begin());
+            vcallbacknearest[iquery] = callbacktree.FindNearestNode(vconfig);
+        }
+        uint64_t callbacktime = utils::GetMicroTime() - starttime;
+
+        int nummismatches = 0;
+        for(int iquery = 0; iquery < numqueries; ++iquery) {
+            if( RaveFabs(vdirectnearest[iquery].second - vcallbacknearest[iquery].second) > g_fEpsilonLinear ) {
+                ++nummismatches;
+            }
+        }
+        RAVELOG_DEBUG_FORMAT("env=%d, nearest neighbor with %d nodes: direct=%fs, callback=%fs for %d queries", GetEnv()->GetId()%numinserted%(directtime*1e-6)%(callbacktime*1e-6)%numqueries);
+        os << numinserted << " " << (directtime*1e-6) << " " << (callbacktime*1e-6) << " " << nummismatches;
+        return !!os;
+    }
+
 protected:
     RobotBasePtr _robot;
     std::vector<dReal> _sampleConfig;
@@ -357,6 +421,7 @@ Some python code to display data::\n\
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj, int planningoptions) override
     {
+        OPENRAVE_PROFILE_SCOPE("BirrtPlanner::PlanPath");
         _goalindex = -1;
         _startindex = -1;
         if(!_parameters) {
@@ -379,6 +444,7 @@ Some python code to display data::\n\
         PlannerProgress progress;
         PlannerAction callbackaction=PA_None;
         while(_vgoalpaths.size() < _parameters->_minimumgoalpaths && iter < 3*_parameters->_nMaxIterations) {
+            OPENRAVE_PROFILE_SCOPE("BirrtPlanner iteration");
             RAVELOG_VERBOSE_FORMAT("env=%d, iter=%d, forward=%d, backward=%d", GetEnv()->GetId()%(iter/3)%_treeForward.GetNumNodes()%_treeBackward.GetNumNodes());
             ++iter;
 
@@ -725,6 +791,7 @@ public:
 
     PlannerStatus PlanPath(TrajectoryBasePtr ptraj, int planningoptions) override
     {
+        OPENRAVE_PROFILE_SCOPE("BasicRrtPlanner::PlanPath");
         if(!_parameters) {
             std::string description = "RrtPlanner::PlanPath - Error, planner not initialized\n";
             RAVELOG_WARN(description);
@@ -752,6 +819,7 @@ public:
         int numfoundgoals = 0;
 
         while(iter < _parameters->_nMaxIterations) {
+            OPENRAVE_PROFILE_SCOPE("BasicRrtPlanner iteration");
             iter++;
             if( !!bestGoalNode && iter >= _parameters->_nMinIterations ) {
                 break;
@@ -949,6 +1017,7 @@ public:
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj, int planningoptions) override
     {
+        OPENRAVE_PROFILE_SCOPE("ExplorationPlanner::PlanPath");
         _goalindex = -1;
         _startindex = -1;
         if( !_parameters ) {
@@ -962,6 +1031,7 @@ public:
 
         int iter = 0;
         while(iter < _parameters->_nMaxIterations && _treeForward.GetNumNodes() < _parameters->_nExpectedDataSize ) {
+            OPENRAVE_PROFILE_SCOPE("ExplorationPlanner iteration");
             ++iter;
 
             if( RaveRandomFloat() < _parameters->_fExploreProb ) {
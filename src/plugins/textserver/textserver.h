@@ -291,6 +291,7 @@ public:
         mapNetworkFns["env_getrobots"] = RAVENETWORKFN(boost::bind(&SimpleTextServer::orEnvGetRobots,this,_1,_2,_3), OpenRaveWorkerFn(), true);
         mapNetworkFns["env_getbody"] = RAVENETWORKFN(boost::bind(&SimpleTextServer::orEnvGetBody,this,_1,_2,_3), OpenRaveWorkerFn(), true);
         mapNetworkFns["env_loadplugin"] = RAVENETWORKFN(boost::bind(&SimpleTextServer::orEnvLoadPlugin,this,_1,_2,_3), OpenRaveWorkerFn(), true);
+        mapNetworkFns["env_profiling"] = RAVENETWORKFN(boost::bind(&SimpleTextServer::orEnvProfiling,this,_1,_2,_3), OpenRaveWorkerFn(), true);
         mapNetworkFns["env_raycollision"] = RAVENETWORKFN(boost::bind(&SimpleTextServer::orEnvRayCollision,this,_1,_2,_3), OpenRaveWorkerFn(), true);
         mapNetworkFns["env_stepsimulation"] = RAVENETWORKFN(boost::bind(&SimpleTextServer::orEnvStepSimulation,this,_1,_2,_3), boost::bind(&SimpleTextServer::worEnvStepSimulation,this,_1,_2), false);
         mapNetworkFns["env_triangulate"] = RAVENETWORKFN(boost::bind(&SimpleTextServer::orEnvTriangulate,this,_1,_2,_3), OpenRaveWorkerFn(), true);
@@ -2204,6 +2205,41 @@ protected:
         return true;
     }
 
+    /// orEnvProfiling(cmd) - controls the profiling events of all environments, cmd is one of
+    /// enable, disable, clear, trace (returns the chrome trace json), histograms (returns the statistics json of every event name), dropped (returns the number of events missing from the trace)
+    bool orEnvProfiling(istream& is, ostream& os, boost::shared_ptr<void>& pdata)
+    {
+        string cmd;
+        is >> cmd;
+        if( !is ) {
+            return false;
+        }
+        std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+        if( cmd == "enable" ) {
+            RaveSetProfilingEnabled(true);
+        }
+        else if( cmd == "disable" ) {
+            RaveSetProfilingEnabled(false);
+        }
+        else if( cmd == "clear" ) {
+            RaveClearProfileEvents();
+        }
+        else if( cmd == "trace" ) {
+            RaveWriteProfileChromeTrace(os);
+        }
+        else if( cmd == "histograms" ) {
+            RaveWriteProfileHistograms(os);
+        }
+        else if( cmd == "dropped" ) {
+            os << RaveGetNumDroppedProfileEvents();
+        }
+        else {
+            RAVELOG_WARN_FORMAT("unknown profiling command %s", cmd);
+            return false;
+        }
+        return true;
+    }
+
     // waits for rave to finish commands
     // if a robot id is specified, also waits for that robot's trajectory to finish
     bool orEnvWait(istream& is, ostream& os, boost::shared_ptr<void>& pdata)
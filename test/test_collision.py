@@ -82,6 +82,29 @@ class RunCollision(EnvironmentSetup):
             assert(not target1.CheckSelfCollision())
             assert(self.env.CheckCollision(target1,report))
 
+    def test_collisionconfigurations(self):
+        env=self.env
+        with env:
+            self.LoadEnv('robots/barrettwam.robot.xml')
+            robot=env.GetRobots()[0]
+            lower,upper = robot.GetDOFLimits()
+            initialvalues = robot.GetDOFValues()
+            configurations = array([lower+(upper-lower)*random.rand(len(lower)) for i in range(20)])
+            collisions = robot.CheckCollisionConfigurations(configurations)
+            assert(len(collisions) == len(configurations))
+            assert(transdist(robot.GetDOFValues(),initialvalues) <= g_epsilon)
+            for values,collision in zip(configurations,collisions):
+                robot.SetDOFValues(values)
+                assert(collision == (env.CheckCollision(robot) or robot.CheckSelfCollision()))
+            dofindices = [0,1]
+            collisions = robot.CheckCollisionConfigurations(configurations[:,dofindices].tolist(),dofindices,False)
+            assert(len(collisions) == len(configurations))
+            collisions2 = robot.CheckCollisionConfigurations(configurations[:,dofindices],array(dofindices),False)
+            assert(all(collisions2 == collisions))
+            # float indices have to be rejected instead of truncated
+            assert_raises(Exception, robot.CheckCollisionConfigurations, configurations[:,dofindices], [0.5,1.5], False)
+            assert_raises(Exception, robot.CheckCollisionConfigurations, configurations[:,dofindices], array([0.5,1.5]), False)
+
     def test_attachedbodiescollision(self):
         with self.env:
             self.LoadEnv('data/lab1.env.xml')
@@ -268,6 +291,44 @@ class RunCollision(EnvironmentSetup):
         manip.CheckEndEffectorCollision(report)
         assert(len(report.vLinkColliding)==4)
 
+    def test_compactlinkcolliding(self):
+        env=self.env
+        env.GetCollisionChecker().SetCollisionOptions(CollisionOptions.AllLinkCollisions)
+        self.LoadEnv('data/lab1.env.xml')
+        robot = env.GetRobots()[0]
+        manip = robot.GetManipulators()[0]
+        body1 = env.GetKinBody('mug1')
+        body2 = env.GetKinBody('mug2')
+
+        body1.SetTransform(manip.GetEndEffector().GetTransform())
+        body2.SetTransform(manip.GetEndEffector().GetTransform())
+
+        def GetLinkPairs(report):
+            linkpairs = []
+            for link1,link2 in report.vLinkColliding:
+                linkpairs.append(tuple(sorted([(link1.GetParent().GetName(),link1.GetName()),(link2.GetParent().GetName(),link2.GetName())])))
+            return sorted(linkpairs)
+
+        # checkers that do not support the compact pairs fill vLinkColliding, so the pairs have to be the same for all of them
+        report = CollisionReport()
+        compactreport = CollisionReport()
+        compactreport.bCompactLinkColliding = True
+        env.CheckCollision(robot,report=report)
+        env.CheckCollision(robot,report=compactreport)
+        assert(len(report.vLinkColliding)==8)
+        robotlinkpairs = GetLinkPairs(report)
+        assert(GetLinkPairs(compactreport)==robotlinkpairs)
+
+        # reusing the reports after Reset keeps their storage, none of the previous pairs should remain
+        manip.CheckEndEffectorCollision(report)
+        manip.CheckEndEffectorCollision(compactreport)
+        assert(len(report.vLinkColliding)==4)
+        assert(GetLinkPairs(compactreport)==GetLinkPairs(report))
+        assert(compactreport.bCompactLinkColliding)
+
+        env.CheckCollision(robot,report=compactreport)
+        assert(GetLinkPairs(compactreport)==robotlinkpairs)
+
 #generate_classes(RunCollision, globals(), [('ode','ode'),('bullet','bullet')])
 
 class test_ode(RunCollision):
@@ -278,6 +339,136 @@ class test_fcl(RunCollision):
     def __init__(self):
         RunCollision.__init__(self, 'fcl_')
 
+class test_fclbroadphase(EnvironmentSetup):
+    """tests the adaptive broadphase managers of the fcl checker through GetBroadphaseStatistics
+    """
+    def setup(self):
+        EnvironmentSetup.setup(self)
+        self.checker = RaveCreateCollisionChecker(self.env,'fcl_')
+        self.env.SetCollisionChecker(self.checker)
+
+    def _AddBoxGrid(self, prefix, numx, numy, spacing, halfextent, z):
+        bodies = []
+        for ix in range(numx):
+            for iy in range(numy):
+                body = RaveCreateKinBody(self.env,'')
+                body.InitFromBoxes(array([[ix*spacing,iy*spacing,z,halfextent,halfextent,halfextent]]),True)
+                body.SetName('%s%d_%d'%(prefix,ix,iy))
+                self.env.Add(body)
+                bodies.append(body)
+        return bodies
+
+    def _GetStatistics(self, probe):
+        """returns the statistics of the body manager of probe and of the env manager excluding it
+        """
+        bodystats = None
+        envstats = None
+        for line in self.checker.SendCommand('GetBroadphaseStatistics').splitlines():
+            fields = line.split()
+            stats = {'algorithm':fields[1], 'numobjects':int(fields[2]), 'cellsize':float(fields[7]), 'limits':array([float(f) for f in fields[8:14]])}
+            if fields[0] == 'body' and stats['numobjects'] == len(probe.GetLinks()):
+                bodystats = stats
+            elif fields[0] == 'env' and (envstats is None or stats['numobjects'] > envstats['numobjects']):
+                envstats = stats
+        assert(bodystats is not None and envstats is not None)
+        return bodystats, envstats
+
+    def _RunWindow(self, probe):
+        """runs enough queries for the managers to be re-evaluated once
+        """
+        for i in range(40):
+            self.env.CheckCollision(probe)
+        time.sleep(1.1)
+        self.env.CheckCollision(probe)
+
+    def _CheckProbeCollisions(self, probe, boxes, spacing, z):
+        # centered on a box, in the middle of four boxes, and on the last box of the grid
+        for ix, iy, expected in [(0,0,True), (3,5,True), (2.5,4.5,False), (10.5,0.5,False), (24,23,True)]:
+            probe.SetTransform(matrixFromPose([1,0,0,0,ix*spacing,iy*spacing,z]))
+            report = CollisionReport()
+            assert(self.env.CheckCollision(probe,report=report) == expected)
+            if expected:
+                assert(report.plink1.GetParent() == probe or report.plink2.GetParent() == probe)
+                otherbody = report.plink2.GetParent() if report.plink1.GetParent() == probe else report.plink1.GetParent()
+                assert(otherbody.GetName() == 'box%d_%d'%(ix,iy))
+
+    def test_autoselection(self):
+        env=self.env
+        with env:
+            spacing = 0.2
+            boxes = self._AddBoxGrid('box', 25, 24, spacing, 0.025, 0)
+            probe = RaveCreateKinBody(env,'')
+            probe.InitFromBoxes(array([[0,0,0,0.02,0.02,0.02]]),True)
+            probe.SetName('probe')
+            env.Add(probe)
+            probe.SetTransform(matrixFromPose([1,0,0,0,0.5*spacing,0.5*spacing,0]))
+            assert(self.checker.SendCommand('SetBroadphaseAlgorithm Auto') is not None)
+
+            # managers start as DynamicAABBTree2 until the first window is over
+            env.CheckCollision(probe)
+            bodystats, envstats = self._GetStatistics(probe)
+            assert(envstats['algorithm'] == 'DynamicAABBTree2')
+            assert(envstats['numobjects'] == len(boxes))
+
+            # the single object of the probe is tested naively, the many static boxes of the same size are hashed
+            self._RunWindow(probe)
+            bodystats, envstats = self._GetStatistics(probe)
+            assert(bodystats['algorithm'] == 'Naive')
+            assert(envstats['algorithm'] == 'SpatialHashing')
+            assert(abs(envstats['cellsize']-0.05) < 1e-4)
+            assert(all(envstats['limits'][:3] <= array([-0.025,-0.025,-0.025])))
+            assert(all(envstats['limits'][3:] >= array([24*spacing+0.025,23*spacing+0.025,0.025])))
+
+            # the managers differ, so the objects of the probe are queried one by one against the hashed boxes
+            self._CheckProbeCollisions(probe, boxes, spacing, 0)
+
+    def test_spatialhashingreevaluation(self):
+        env=self.env
+        with env:
+            spacing = 0.2
+            boxes = self._AddBoxGrid('box', 25, 24, spacing, 0.025, 0)
+            probe = RaveCreateKinBody(env,'')
+            probe.InitFromBoxes(array([[0,0,0,0.02,0.02,0.02]]),True)
+            probe.SetName('probe')
+            env.Add(probe)
+            probe.SetTransform(matrixFromPose([1,0,0,0,0.5*spacing,0.5*spacing,0]))
+            assert(self.checker.SendCommand('SetBroadphaseAlgorithm SpatialHashing') is not None)
+
+            # SpatialHashing builds the managers on the first query, with the same algorithm both managers are collided directly
+            env.CheckCollision(probe)
+            bodystats, envstats = self._GetStatistics(probe)
+            assert(bodystats['algorithm'] == 'SpatialHashing')
+            assert(envstats['algorithm'] == 'SpatialHashing')
+            assert(abs(envstats['cellsize']-0.05) < 1e-4)
+            self._CheckProbeCollisions(probe, boxes, spacing, 0)
+
+            # a box leaving the scene limits rebuilds the manager after the window
+            boxes[0].SetTransform(matrixFromPose([1,0,0,0,10,0,0]))
+            self._RunWindow(probe)
+            bodystats, envstats = self._GetStatistics(probe)
+            assert(envstats['algorithm'] == 'SpatialHashing')
+            assert(envstats['limits'][3] >= 10.025)
+            probe.SetTransform(matrixFromPose([1,0,0,0,10,0,0]))
+            assert(env.CheckCollision(probe,boxes[0]))
+            assert(env.CheckCollision(probe))
+            probe.SetTransform(matrixFromPose([1,0,0,0,0,0,0]))
+            assert(not env.CheckCollision(probe))
+
+            # adding as many boxes ten times larger drifts the mean extent away from the cell size
+            largeboxes = self._AddBoxGrid('largebox', 25, 24, 1.0, 0.25, 2)
+            env.CheckCollision(probe)
+            bodystats, envstats = self._GetStatistics(probe)
+            assert(envstats['numobjects'] == len(boxes)+len(largeboxes))
+            assert(abs(envstats['cellsize']-0.05) < 1e-4)
+            self._RunWindow(probe)
+            bodystats, envstats = self._GetStatistics(probe)
+            assert(envstats['algorithm'] == 'SpatialHashing')
+            assert(abs(envstats['cellsize']-0.275) < 1e-3)
+            assert(envstats['limits'][5] >= 2.25)
+            probe.SetTransform(matrixFromPose([1,0,0,0,3,4,2.2]))
+            assert(env.CheckCollision(probe,largeboxes[3*24+4]))
+            assert(env.CheckCollision(probe))
+
 # class test_bullet(RunCollision):
 #     def __init__(self):
 #         RunCollision.__init__(self, 'bullet')
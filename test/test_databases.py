@@ -37,6 +37,75 @@ class TestDatabases(EnvironmentSetup):
             out=ikmodule.SendCommand('LoadIKFastSolver %s %d 1'%(robot.GetName(),iktype))
             assert(out is not None)
             assert(manip.GetIkSolver() is not None)
-            
+
+    def test_ikmodulegenerationnonblocking(self):
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        manip=robot.GetActiveManipulator()
+        iktype=IkParameterizationType.Translation3D
+        # move the compiled solver away so that the module has to generate it
+        ikmodel = databases.inversekinematics.InverseKinematicsModel(robot,iktype=iktype)
+        ikfilename = ikmodel.getfilename(read=True)
+        if os.path.isfile(ikfilename):
+            os.rename(ikfilename,ikfilename+'.testbackup')
+        try:
+            manip.SetIkSolver(None)
+            ikmodule = RaveCreateModule(env,'ikfast')
+            env.Add(ikmodule)
+            starttime = time.time()
+            out=ikmodule.SendCommand('LoadIKFastSolver %s %d 1 1'%(robot.GetName(),iktype))
+            assert(out is not None)
+            # returns before the generation finishes with the numerical solver set
+            assert(time.time()-starttime < 10)
+            assert(manip.GetIkSolver() is not None and manip.GetIkSolver().GetXMLId() == 'numericalik')
+            status = ikmodule.SendCommand('GetIKFastGenerationStatus').split()
+            assert(status[0:3] == [robot.GetName(),manip.GetName(),'Translation3D'])
+            with env:
+                with robot:
+                    robot.SetDOFValues([0.5]*len(manip.GetArmIndices()),manip.GetArmIndices())
+                    ikparam = manip.GetIkParameterization(iktype)
+                sol = manip.FindIKSolution(ikparam,IkFilterOptions.IgnoreSelfCollisions)
+                assert(sol is not None)
+                with robot:
+                    robot.SetDOFValues(sol,manip.GetArmIndices())
+                    assert(manip.GetIkParameterization(iktype).ComputeDistanceSqr(ikparam) <= 1e-4)
+
+            # the generation thread locks the environment to swap in the compiled solver
+            while int(status[3]) == 0 and time.time()-starttime < 1200:
+                time.sleep(1)
+                status = ikmodule.SendCommand('GetIKFastGenerationStatus').split()
+            assert(int(status[3]) == 1)
+            assert(manip.GetIkSolver().GetXMLId() != 'numericalik')
+            with env:
+                sol = manip.FindIKSolution(ikparam,IkFilterOptions.IgnoreSelfCollisions)
+                assert(sol is not None)
+        finally:
+            if os.path.isfile(ikfilename+'.testbackup'):
+                os.rename(ikfilename+'.testbackup',ikfilename)
+
+    def test_kinematicreachability(self):
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        rmodel = databases.kinematicreachability.ReachabilityModel(robot)
+        if rmodel.ikmodel.ikfastproblem is None:
+            return
+        
+        # the native ComputeReachability has to match the producer/consumer/gatherer functions on a small grid
+        rmodel.generate(xyzdelta=0.2,quatdelta=1.0,numthreads=2)
+        reachability3d = array(rmodel.reachability3d)
+        reachabilitydensity3d = array(rmodel.reachabilitydensity3d)
+        reachabilitystats = array(rmodel.reachabilitystats)
+        assert(sum(reachability3d) > 0)
+        
+        databases.DatabaseGenerator.generate(rmodel,xyzdelta=0.2,quatdelta=1.0)
+        assert(transdist(reachability3d,rmodel.reachability3d) <= g_epsilon)
+        assert(transdist(reachabilitydensity3d,rmodel.reachabilitydensity3d) <= g_epsilon)
+        # both write the stats in the order of the points, the quaternions can differ in sign
+        assert(reachabilitystats.shape == rmodel.reachabilitystats.shape)
+        assert(transdist(reachabilitystats[:,4:],rmodel.reachabilitystats[:,4:]) <= 1e-6*len(reachabilitystats))
+        assert(all(abs(abs(sum(reachabilitystats[:,0:4]*rmodel.reachabilitystats[:,0:4],1))-1) <= 1e-6))
+        
 #     def test_database_paths(self):
 #         pass
@@ -14,6 +14,7 @@
 from common_test_openrave import *
 from subprocess import Popen, PIPE
 import shutil
+import tempfile
 import threading
 
 class TestEnvironment(EnvironmentSetup):
@@ -34,6 +35,54 @@ class TestEnvironment(EnvironmentSetup):
         trimesh=env.Triangulate(robot)
         assert(len(trimesh.vertices)==0)
         
+    def test_prefetchgeometries(self):
+        env=self.env
+        meshfilename = RaveFindLocalFile('data/mug1.dae')
+        datafilename = RaveFindLocalFile('models/objects/blue_mug_y_up.iv')
+        assert(len(meshfilename) > 0 and len(datafilename) > 0)
+        # the first geometry is loaded from its render file, the second from its data file
+        xml = """<environment>
+  <kinbody file="data/mug1.kinbody.xml"/>
+  <kinbody name="meshes">
+    <body name="base">
+      <geom type="trimesh">
+        <render>%s</render>
+      </geom>
+      <geom type="trimesh">
+        <data>%s</data>
+        <render>%s</render>
+      </geom>
+    </body>
+  </kinbody>
+</environment>"""%(meshfilename,datafilename,meshfilename)
+        tempdir = tempfile.mkdtemp()
+        try:
+            filename = os.path.join(tempdir,'prefetchgeometries.env.xml')
+            open(filename,'w').write(xml)
+            self.LoadEnv(filename,{'prefetchgeometries':'2'})
+            env2 = Environment()
+            try:
+                assert(env2.Load(filename))
+                bodies2 = dict([(body.GetName(),body) for body in env2.GetBodies()])
+                assert(len(env.GetBodies()) == len(bodies2))
+                for body in env.GetBodies():
+                    body2 = bodies2[body.GetName()]
+                    assert(len(body.GetLinks()) == len(body2.GetLinks()))
+                    for link, link2 in zip(body.GetLinks(),body2.GetLinks()):
+                        assert(len(link.GetGeometries()) == len(link2.GetGeometries()))
+                        for geom, geom2 in zip(link.GetGeometries(),link2.GetGeometries()):
+                            assert(geom.GetType() == geom2.GetType())
+                            assert(geom.GetRenderFilename() == geom2.GetRenderFilename())
+                            assert(transdist(geom.GetTransform(),geom2.GetTransform()) <= g_epsilon)
+                            mesh = geom.GetCollisionMesh()
+                            mesh2 = geom2.GetCollisionMesh()
+                            assert(mesh.vertices.shape == mesh2.vertices.shape and transdist(mesh.vertices,mesh2.vertices) <= g_epsilon)
+                            assert(all(mesh.indices == mesh2.indices))
+            finally:
+                env2.Destroy()
+        finally:
+            shutil.rmtree(tempdir)
+
     def test_misc(self):
         env=self.env
         assert(env.plot3([0,0,0],10)==None) # no viewer attached
@@ -209,6 +258,73 @@ class TestEnvironment(EnvironmentSetup):
         for t in threads:
             t.join()
 
+    def test_simulationscheduler(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        env2 = env.CloneSelf(CloningOptions.Bodies)
+        try:
+            scheduler = SimulationScheduler(2)
+            scheduler.AddEnvironment(env)
+            scheduler.AddEnvironment(env2)
+            assert(not env.IsSimulationRunning() and not env2.IsSimulationRunning())
+            starttimes = [env.GetSimulationTime(), env2.GetSimulationTime()]
+            scheduler.Step(0.01,10)
+            assert(env.GetSimulationTime()-starttimes[0] == env2.GetSimulationTime()-starttimes[1])
+            stats = scheduler.GetStatistics()
+            assert(len(stats) == 2 and stats[0]['numsteps'] == 10 and stats[1]['numsteps'] == 10)
+
+            # a simulation thread started by the user is stopped by the next step instead of stepping the environment twice
+            env2.StartSimulation(0.01,True)
+            scheduler.Step(0.01,1)
+            assert(not env2.IsSimulationRunning())
+
+            # environments can be removed from another thread while stepping
+            def removethread():
+                time.sleep(0.01)
+                scheduler.RemoveEnvironment(env2)
+            t = threading.Thread(target=removethread)
+            t.start()
+            scheduler.Step(0.01,100)
+            t.join()
+            assert(len(scheduler.GetEnvironments()) == 1)
+            stats = scheduler.GetStatistics()
+            assert(len(stats) == 1 and stats[0]['numsteps'] == 111)
+        finally:
+            env2.Destroy()
+
+    def test_concurrentlasers(self):
+        env=self.env
+        body=RaveCreateKinBody(env,'')
+        body.SetName('walls')
+        body.InitFromBoxes(array([[1.5,0,0.5,0.1,2,0.5],[-2,0.5,0.5,0.2,0.2,0.5],[0,-1.2,0.5,1,0.1,0.5]]),True)
+        env.Add(body)
+        env.StopSimulation()
+        lasers = []
+        for ilaser in range(4):
+            laser=RaveCreateSensor(env,'baselaser2d')
+            laser.SetName('laser%d'%ilaser)
+            env.Add(laser,True)
+            T = matrixFromAxisAngle([0,0,ilaser*pi/2])
+            T[0:3,3] = [0,0.1*ilaser,0.5]
+            laser.SetTransform(T)
+            laser.Configure(Sensor.ConfigureCommand.PowerOn)
+            lasers.append(laser)
+        # the lasers are stepped concurrently and have to match the rays of the collision checker
+        env.StepSimulation(0.01)
+        numhits = 0
+        for laser in lasers:
+            data = laser.GetSensorData(Sensor.Type.Laser)
+            geom = laser.GetSensorGeometry(Sensor.Type.Laser)
+            ranges = array(data.ranges)
+            vdirs = ranges/sqrt(sum(ranges**2,1))[:,newaxis]
+            rays = c_[data.positions[0]+geom.min_range*vdirs,(geom.max_range-geom.min_range)*vdirs]
+            collision,info = env.CheckCollisionRays(rays,None)
+            assert(all(collision == (array(data.intensity) > 0)))
+            hits = flatnonzero(collision)
+            assert(transdist(data.positions[0]+ranges[hits],info[hits,0:3]) <= 1e-4*len(hits))
+            numhits += len(hits)
+        assert(numhits > 0)
+
     def test_dataccess(self):
         RaveDestroy()
         OPENRAVE_DATA = os.environ.get('OPENRAVE_DATA','')
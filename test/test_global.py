@@ -63,3 +63,24 @@ def test_ikparam():
     
     ikparam2 = ikparam*T
     ikparam2.GetTranslationDirection5D().pos()
+
+@with_destroy
+def test_profiling():
+    import json
+    env=Environment()
+    env.Load('data/lab1.env.xml')
+    robot=env.GetRobots()[0]
+    RaveClearProfileEvents()
+    RaveSetProfilingEnabled(True)
+    try:
+        with env:
+            for i in range(10):
+                robot.SetDOFValues(robot.GetDOFValues())
+    finally:
+        RaveSetProfilingEnabled(False)
+    histograms = json.loads(RaveGetProfileHistograms())
+    assert(histograms['KinBody::SetDOFValues']['count'] >= 10)
+    trace = json.loads(RaveGetProfileChromeTrace())
+    assert(any(event['name'] == 'KinBody::SetDOFValues' and event['ph'] == 'X' for event in trace['traceEvents']))
+    RaveClearProfileEvents()
+    assert(len(json.loads(RaveGetProfileHistograms())) == 0)
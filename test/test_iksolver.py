@@ -65,6 +65,77 @@ class TestIkSolver(EnvironmentSetup):
             sols = ikmodel.manip.FindIKSolutions(T,IkFilterOptions.CheckEnvCollisions)
             assert(len(sols)>0 and any([sol[index] > 0.2 for sol in sols]) and any([sol[index] < -0.2 for sol in sols]) and any([sol[index] > -0.2 and sol[index] < 0.2 for sol in sols]))
 
+    def test_computeikbatch(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        ikmodel = databases.inversekinematics.InverseKinematicsModel(robot,IkParameterization.Type.Transform6D)
+        if not ikmodel.load():
+            ikmodel.autogenerate()
+
+        with env:
+            # the raw solutions of one ComputeIkBatch call have to be the same as solving every pose on its own
+            random.seed(0)
+            manip = ikmodel.manip
+            # the free joints keep their current values
+            sampledindices = [index for index in manip.GetArmIndices() if not index in ikmodel.freeindices]
+            lower,upper = robot.GetDOFLimits(sampledindices)
+            ikparams = []
+            with robot:
+                for i in range(20):
+                    robot.SetDOFValues(lower+random.rand(len(lower))*(upper-lower),sampledindices)
+                    ikparams.append(manip.GetIkParameterization(IkParameterization.Type.Transform6D,False))
+            cmd = 'ComputeIkBatch %d %s '%(len(ikparams),' '.join(str(ikparam) for ikparam in ikparams))
+            batchresults = [float(f) for f in manip.GetIkSolver().SendCommand(cmd+'1').split()]
+            singleresults = [float(f) for f in manip.GetIkSolver().SendCommand(cmd+'0').split()]
+            assert(len(batchresults) == len(singleresults))
+            assert(transdist(batchresults,singleresults) <= g_epsilon)
+            
+            # every pose was sampled from a configuration, so has solutions that reach it
+            index = 0
+            numarmdofs = len(manip.GetArmIndices())
+            with robot:
+                for ikparam in ikparams:
+                    numsolutions = int(batchresults[index])
+                    index += 1
+                    assert(numsolutions > 0)
+                    for isolution in range(numsolutions):
+                        robot.SetDOFValues(batchresults[index:index+numarmdofs],manip.GetArmIndices())
+                        index += numarmdofs
+                        assert(transdist(manip.GetTransform(),dot(manip.GetBase().GetTransform(),ikparam.GetTransform6D())) <= 1e-5)
+            assert(index == len(batchresults))
+
+    def test_numericalik(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        manip=robot.GetActiveManipulator()
+        with env:
+            iksolver = RaveCreateIkSolver(env,'numericalik')
+            assert(iksolver is not None)
+            assert(manip.SetIkSolver(iksolver))
+            assert(iksolver.Supports(IkParameterization.Type.Transform6D))
+            assert(iksolver.Supports(IkParameterization.Type.Translation3D))
+            assert(not iksolver.Supports(IkParameterization.Type.Direction3D))
+
+            random.seed(0)
+            lower,upper = robot.GetDOFLimits(manip.GetArmIndices())
+            for iktype in [IkParameterization.Type.Transform6D, IkParameterization.Type.Translation3D]:
+                numfound = 0
+                for i in range(10):
+                    with robot:
+                        robot.SetDOFValues(lower+random.rand(len(lower))*(upper-lower),manip.GetArmIndices())
+                        ikparam = manip.GetIkParameterization(iktype)
+                    sol = manip.FindIKSolution(ikparam,IkFilterOptions.IgnoreSelfCollisions)
+                    if sol is None:
+                        continue
+                    numfound += 1
+                    with robot:
+                        robot.SetDOFValues(sol,manip.GetArmIndices())
+                        assert(manip.GetIkParameterization(iktype).ComputeDistanceSqr(ikparam) <= 1e-4)
+                # the samples come from configurations, so the restarts should find most of them
+                assert(numfound >= 8)
+
     def test_iksolutionjitter(self):
         env=self.env
         self.LoadEnv('data/lab1.env.xml')
@@ -50,6 +50,27 @@ class RunPlanning(EnvironmentSetup):
             useddofindices, usedconfigindices = spec.ExtractUsedIndices(robot)
             assert(sorted(useddofindices) == sorted(manip.GetArmIndices()))
             
+    def test_plannerparameterscopy(self):
+        env = self.env
+        robot = self.LoadRobot('robots/barrettwam.robot.xml')
+        with env:
+            robot.SetActiveDOFs(robot.GetActiveManipulator().GetArmIndices())
+            parameters = Planner.PlannerParameters()
+            parameters.SetRobotActiveJoints(robot)
+            parameters.SetInitialConfig(robot.GetActiveDOFValues())
+            parameters.SetGoalConfig(robot.GetActiveDOFValues()+0.1)
+            parameters.SetExtraParameters('<radius>0.2</radius><maxchildren>7</maxchildren><maxsampletries>3</maxsampletries>')
+            # the first planner parses the extra parameters into its RAStarParameters
+            planner = RaveCreatePlanner(env,'RAStar')
+            assert(planner.InitPlan(robot,parameters))
+            rastarparameters = planner.GetParameters()
+            assert(repr(rastarparameters).find('<radius>0.2</radius>') >= 0)
+            assert(repr(rastarparameters).find('<maxchildren>7</maxchildren>') >= 0)
+            # the second planner gets a RAStarParameters, so copies it directly without going through xml
+            planner2 = RaveCreatePlanner(env,'RAStar')
+            assert(planner2.InitPlan(robot,rastarparameters))
+            assert(repr(planner2.GetParameters()) == repr(rastarparameters))
+
     def test_ikplanning(self):
         env = self.env
         self.LoadEnv('data/lab1.env.xml')
@@ -454,6 +475,12 @@ class RunPlanning(EnvironmentSetup):
             approachoffset = 0.02
             dests = ComputeDestinations(gmodel.target,env.GetKinBody('table'))
             Ttarget = gmodel.target.GetTransform()
+            # with one grasp planned at a time, evaluating the grasps in parallel has to return the same first grasp as the serial evaluation
+            goals1,graspindex1,searchtime1,traj1 = taskmanip.GraspPlanning(gmodel=gmodel,approachoffset=approachoffset,destposes=dests, seedgrasps = 1,seeddests=8,seedik=1,maxiter=1000, randomgrasps=False,randomdests=False,execute=False,outputtrajobj=True)
+            goals4,graspindex4,searchtime4,traj4 = taskmanip.GraspPlanning(gmodel=gmodel,approachoffset=approachoffset,destposes=dests, seedgrasps = 1,seeddests=8,seedik=1,maxiter=1000, randomgrasps=False,randomdests=False,execute=False,outputtrajobj=True,numthreads=4)
+            assert(graspindex4 == graspindex1)
+            assert(transdist(Ttarget,gmodel.target.GetTransform()) <= g_epsilon)
+            
             goals,graspindex,searchtime,traj = taskmanip.GraspPlanning(gmodel=gmodel,approachoffset=approachoffset,destposes=dests, seedgrasps = 3,seeddests=8,seedik=1,maxiter=1000, randomgrasps=False,randomdests=False,execute=False,outputtrajobj=True)
             assert(transdist(Ttarget,gmodel.target.GetTransform()) <= g_epsilon)
             self.RunTrajectory(robot,traj)
@@ -601,6 +628,40 @@ class RunPlanning(EnvironmentSetup):
             self.RunTrajectory(robot,traj1)
             self.RunTrajectory(robot,traj2)
 
+    def test_nearestneighbor(self):
+        env = self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot = env.GetRobots()[0]
+        with env:
+            robot.SetActiveDOFs(robot.GetActiveManipulator().GetArmIndices())
+            params = Planner.PlannerParameters()
+            params.SetRobotActiveJoints(robot)
+            params.SetGoalConfig(robot.GetActiveDOFValues())
+            planner = RaveCreatePlanner(env,'birrt')
+            planner.InitPlan(robot,params)
+            numinserted, directtime, callbacktime, nummismatches = planner.SendCommand('BenchmarkNearestNeighbor 5000 500').split()
+            log.info('%s nodes: direct=%ss, callback=%ss', numinserted, directtime, callbacktime)
+            assert(int(numinserted) > 0)
+            assert(int(nummismatches) == 0)
+
+    def test_defaultfunctions(self):
+        env = self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot = env.GetRobots()[0]
+        with env:
+            robot.SetActiveDOFs(robot.GetActiveManipulator().GetArmIndices())
+            params = Planner.PlannerParameters()
+            assert(not params.HasDefaultFunctions())
+            params.SetRobotActiveJoints(robot)
+            assert(params.HasDefaultFunctions())
+            # copies keep the flag
+            assert(Planner.PlannerParameters(params).HasDefaultFunctions())
+            params.AddCheckPathConstraintsFunction(lambda q0,q1,timeelapsed: True)
+            assert(not params.HasDefaultFunctions())
+            assert(not Planner.PlannerParameters(params).HasDefaultFunctions())
+            params.SetConfigurationSpecification(env,robot.GetActiveConfigurationSpecification())
+            assert(params.HasDefaultFunctions())
+
     def test_jittertransform(self):
         env=self.env
         self.LoadEnv('data/lab1.env.xml')
@@ -615,6 +676,57 @@ class RunPlanning(EnvironmentSetup):
             assert(success)
             assert(not env.CheckCollision(collisionbody))
 
+    def test_visualfeedbackdepthbuffer(self):
+        env=self.env
+        self.LoadEnv('data/testwamcamera.env.xml')
+        with env:
+            robot=env.GetRobots()[0]
+            armindices = robot.GetActiveManipulator().GetArmIndices()
+            lower,upper = robot.GetDOFLimits(armindices)
+            vprobs = []
+            for target in env.GetBodies():
+                if target == robot:
+                    continue
+                vprob = interfaces.VisualFeedback(robot)
+                try:
+                    vprob.SetCameraAndTarget(sensorname='camera',targetlink=target.GetLinks()[0])
+                except planning_error:
+                    continue
+                vprobs.append(vprob)
+            assert(len(vprobs) > 0)
+            
+            # the depth buffer has to agree with the rays on every sample of the target. Only samples at the silhouettes
+            # of the occluders can differ, where the rays classify a neighboring sample differently.
+            raydensity = 0.01
+            numsamples = 0
+            nummismatches = 0
+            numpy.random.seed(0)
+            with robot:
+                for iter in range(20):
+                    robot.SetDOFValues(lower+numpy.random.rand(len(lower))*(upper-lower),armindices)
+                    for vprob in vprobs:
+                        vprob.SetParameter(raydensity=raydensity,usedepthbuffer=0)
+                        raysamples = vprob.ComputeVisibilitySamples()
+                        rayvisible = vprob.ComputeVisibility()
+                        vprob.SetParameter(usedepthbuffer=1,depthbufferscale=1.0)
+                        depthsamples = vprob.ComputeVisibilitySamples()
+                        depthvisible = vprob.ComputeVisibility()
+                        # second call uses the cached static depth buffer
+                        assert(vprob.ComputeVisibility() == depthvisible)
+                        assert(raysamples.shape == depthsamples.shape)
+                        assert(numpy.all(abs(raysamples[:,:2]-depthsamples[:,:2]) <= g_epsilon))
+                        mismatches = numpy.flatnonzero(raysamples[:,2] != depthsamples[:,2])
+                        for isample in mismatches:
+                            distances = numpy.sqrt(numpy.sum((raysamples[:,:2]-raysamples[isample,:2])**2,1))
+                            neighbors = numpy.flatnonzero(distances <= 2.5*raydensity)
+                            assert(numpy.any(raysamples[neighbors,2] != raysamples[isample,2]))
+                        if rayvisible != depthvisible:
+                            assert(len(mismatches) > 0)
+                        numsamples += len(raysamples)
+                        nummismatches += len(mismatches)
+            assert(numsamples > 0)
+            self.log.info('%d/%d samples differ at silhouettes', nummismatches, numsamples)
+
 #generate_classes(RunPlanning, globals(), [('ode','ode'),('bullet','bullet')])
 
 class test_ode(RunPlanning):
@@ -12,6 +12,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 from common_test_openrave import *
+from subprocess import Popen, PIPE
+import sys
 
 class RunRobot(EnvironmentSetup):
     def __init__(self,collisioncheckername):
@@ -492,6 +494,75 @@ class RunRobot(EnvironmentSetup):
             sols = ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
             assert(numrepeats[0]==4)
 
+    def test_ikcache(self):
+        env=self.env
+        robot=self.LoadRobot('robots/kuka-kr5-r650.zae')
+        ikmodel = databases.inversekinematics.InverseKinematicsModel(robot, iktype=IkParameterization.Type.Transform6D)
+        if not ikmodel.load():
+            ikmodel.autogenerate()
+
+        with env:
+            iksolver = ikmodel.manip.GetIkSolver()
+            robot.SetDOFValues(ones(len(ikmodel.manip.GetArmIndices())),ikmodel.manip.GetArmIndices(),True)
+            ikparam = ikmodel.manip.GetIkParameterization(IkParameterization.Type.Transform6D)
+            sols = ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            iksolver.SendCommand('SetIkCache 100')
+            sols0 = ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            sols1 = ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            assert(transdist(sols,sols0) <= g_epsilon and transdist(sols,sols1) <= g_epsilon)
+            rawhits, rawmisses, rawsize, filteredhits, filteredmisses, filteredsize = [int(x) for x in iksolver.SendCommand('GetIkCacheStatistics').split()]
+            assert(filteredhits == 1 and filteredmisses == 1)
+
+            # adding another body changes the scene state, so only the raw solutions can be reused
+            box = RaveCreateKinBody(env,'')
+            box.InitFromBoxes(array([[5,5,5,0.1,0.1,0.1]]),True)
+            box.SetName('box')
+            env.Add(box,True)
+            sols2 = ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            assert(transdist(sols,sols2) <= g_epsilon)
+            rawhits2, rawmisses2, rawsize2, filteredhits2, filteredmisses2, filteredsize2 = [int(x) for x in iksolver.SendCommand('GetIkCacheStatistics').split()]
+            assert(filteredhits2 == 1 and filteredmisses2 == 2)
+            assert(rawhits2 > rawhits and rawmisses2 == rawmisses)
+            iksolver.SendCommand('ResetIkCache')
+            assert([int(x) for x in iksolver.SendCommand('GetIkCacheStatistics').split()] == [0]*6)
+
+            # grabbed bodies move with the arm, so the filtered results depend on where they are grabbed
+            box.SetTransform(ikmodel.manip.GetTransform())
+            robot.Grab(box)
+            ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            robot.Release(box)
+            T = ikmodel.manip.GetTransform()
+            T[2,3] += 0.05
+            box.SetTransform(T)
+            robot.Grab(box)
+            ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            rawhits3, rawmisses3, rawsize3, filteredhits3, filteredmisses3, filteredsize3 = [int(x) for x in iksolver.SendCommand('GetIkCacheStatistics').split()]
+            assert(filteredhits3 == 1 and filteredmisses3 == 2)
+            robot.ReleaseAllGrabbed()
+
+            # the keys use the exact pose even with a coarse quantization, so a nearby pose is solved again and its solutions reach it
+            iksolver.SendCommand('SetIkCache 100 0.01')
+            iksolver.SendCommand('ResetIkCache')
+            T = ikparam.GetTransform6D()
+            T[0,3] += 0.001
+            ikparam2 = IkParameterization(T,IkParameterization.Type.Transform6D)
+            ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            sols4 = ikmodel.manip.FindIKSolutions(ikparam2,IkFilterOptions.CheckEnvCollisions)
+            assert(len(sols4) > 0)
+            for sol in sols4:
+                robot.SetDOFValues(sol,ikmodel.manip.GetArmIndices())
+                assert(transdist(ikmodel.manip.GetTransform(),T) <= g_epsilon)
+            rawhits4, rawmisses4, rawsize4, filteredhits4, filteredmisses4, filteredsize4 = [int(x) for x in iksolver.SendCommand('GetIkCacheStatistics').split()]
+            assert(rawhits4 == 0 and filteredhits4 == 0 and filteredmisses4 == 2)
+
+            # moving another body changes the scene state
+            ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            box.SetTransform(matrixFromAxisAngle([0,0,0.1]))
+            ikmodel.manip.FindIKSolutions(ikparam,IkFilterOptions.CheckEnvCollisions)
+            rawhits5, rawmisses5, rawsize5, filteredhits5, filteredmisses5, filteredsize5 = [int(x) for x in iksolver.SendCommand('GetIkCacheStatistics').split()]
+            assert(filteredhits5 == 1 and filteredmisses5 == 3)
+
     def test_manipulators(self):
         env=self.env
         robot=self.LoadRobot('robots/pr2-beta-static.zae')
@@ -671,6 +742,63 @@ class RunRobot(EnvironmentSetup):
         assert robot.CheckSelfCollision() # succeeds
         assert cloned_robot.CheckSelfCollision() # fails
 
+    def _ComputeNonAdjacentLinks(self,body):
+        """computes the non-colliding non-adjacent link pairs at the current configuration from scratch
+        """
+        adjacentlinks = set(body.GetAdjacentLinks())
+        links = body.GetLinks()
+        nonadjacentlinks = []
+        for i in range(len(links)):
+            for j in range(i+1,len(links)):
+                if not (i,j) in adjacentlinks and not self.env.CheckCollision(links[i],links[j]):
+                    nonadjacentlinks.append((i,j))
+        return sorted(nonadjacentlinks)
+    
+    def test_nonadjacentlinkscache(self):
+        # non-adjacent links are shared between bodies of the same geometry, so have to be the same as the ones computed from scratch
+        env=self.env
+        robot=self.LoadRobot('robots/barrettwam.robot.xml')
+        with env:
+            nonadjacentlinks = robot.GetNonAdjacentLinks()
+            assert(len(nonadjacentlinks) > 0)
+            assert(sorted(nonadjacentlinks) == self._ComputeNonAdjacentLinks(robot))
+
+        env2 = env.CloneSelf(CloningOptions.Bodies)
+        try:
+            assert(all(env2.GetRobot(robot.GetName()).GetNonAdjacentLinks() == nonadjacentlinks))
+        finally:
+            env2.Destroy()
+
+        # a different initial configuration has its own link pairs
+        with env:
+            robot.SetDOFValues([3],[3])
+            robot.SetNonCollidingConfiguration()
+            assert(sorted(robot.GetNonAdjacentLinks()) == self._ComputeNonAdjacentLinks(robot))
+            
+        # bodies with many links are stored in the database, where other processes read them from
+        with env:
+            robot2=self.LoadRobot('robots/pr2-beta-static.zae')
+            nonadjacentlinks2 = robot2.GetNonAdjacentLinks()
+            assert(sorted(nonadjacentlinks2) == self._ComputeNonAdjacentLinks(robot2))
+            filenames = [os.path.join(dirpath,filename) for dirpath,dirnames,filenames in os.walk(os.path.join(RaveGetHomeDirectory(),'kinbody.%s'%robot2.GetKinematicsGeometryHash())) for filename in filenames if filename.startswith('nonadjacentlinks.')]
+            assert(len(filenames) > 0)
+        filename = max(filenames,key=os.path.getmtime)
+        with open(filename,'r') as f:
+            content = f.read()
+        values = content.split()
+        assert(int(values[0]) == len(nonadjacentlinks2))
+        try:
+            # another process has to return the pairs of the file rather than computing them
+            numpairs = len(nonadjacentlinks2)/2
+            with open(filename,'w') as f:
+                f.write('%d %s\n'%(numpairs,' '.join(values[1:1+numpairs])))
+            script = "from openravepy import *\nenv=Environment()\nenv.SetCollisionChecker(RaveCreateCollisionChecker(env,'%s'))\nrobot=env.ReadRobotURI('robots/pr2-beta-static.zae')\nenv.Add(robot,True)\nprint(len(robot.GetNonAdjacentLinks()))\nRaveDestroy()\n"%env.GetCollisionChecker().GetXMLId()
+            output = Popen([sys.executable,'-c',script],stdout=PIPE).communicate()[0]
+            assert(int(output.split()[-1]) == numpairs)
+        finally:
+            with open(filename,'w') as f:
+                f.write(content)
+
     def test_4dikparameterization(self):
         self.log.info('test 4dikparameterization')
         env=self.env
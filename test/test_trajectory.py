@@ -293,6 +293,74 @@ class TestTrajectory(EnvironmentSetup):
                 data2 = traj2.Sample(t)
                 assert( transdist(data1,data2) <= g_epsilon)
 
+    def test_manipaccelconstraints(self):
+        env=self.env
+        robot=self.LoadRobot('robots/barrettwam.robot.xml')
+        manip=robot.GetActiveManipulator()
+        maxmanipaccel = 2.0
+        with env:
+            robot.SetActiveDOFs(manip.GetArmIndices())
+            traj = RaveCreateTrajectory(env,'')
+            traj.Init(robot.GetActiveConfigurationSpecification('linear'))
+            traj.Insert(0,zeros(robot.GetActiveDOF()))
+            traj.Insert(1,[1.0,0.8,0.5,1.5,0.5,0.5,0.5])
+            plannerparameters = '<_nrandomgeneratorseed>1234</_nrandomgeneratorseed><_nmaxiterations>20</_nmaxiterations><manipname>%s</manipname><maxmanipaccel>%.15e</maxmanipaccel>'%(manip.GetName(),maxmanipaccel)
+            ret=planningutils.SmoothActiveDOFTrajectory(traj,robot,plannername='parabolicsmoother2',plannerparameters=plannerparameters)
+            assert(ret==PlannerStatusCode.HasSolution)
+
+            # the end effector acceleration from the dynamics has to agree with the cached jacobians/hessians the smoother checked
+            spec = traj.GetConfigurationSpecification()
+            dt = 0.001
+            for t in arange(0,traj.GetDuration()-dt,0.01):
+                data0 = traj.Sample(t)
+                data1 = traj.Sample(t+dt)
+                dofvelocities = zeros(robot.GetDOF())
+                dofvelocities[manip.GetArmIndices()] = spec.ExtractJointValues(data0,robot,manip.GetArmIndices(),1)
+                dofaccelerations = zeros(robot.GetDOF())
+                dofaccelerations[manip.GetArmIndices()] = (spec.ExtractJointValues(data1,robot,manip.GetArmIndices(),1)-dofvelocities[manip.GetArmIndices()])/dt
+                robot.SetActiveDOFValues(spec.ExtractJointValues(data0,robot,manip.GetArmIndices(),0))
+                robot.SetDOFVelocities(dofvelocities)
+                linkaccelerations = robot.GetLinkAccelerations(dofaccelerations)
+                eeaccel = linkaccelerations[manip.GetEndEffector().GetIndex()][0:3]
+                assert(linalg.norm(eeaccel) <= 1.1*maxmanipaccel)
+
+    def test_parallelshortcutting(self):
+        env = self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            basevalues = robot.GetActiveDOFValues()
+            traj = RaveCreateTrajectory(env,'')
+            traj.Init(robot.GetActiveConfigurationSpecification('linear'))
+            # zig-zag path around the initial configuration so there is something to shortcut
+            for i,delta in enumerate([0,0.1,-0.1,0.15,-0.05,0.2]):
+                with robot:
+                    robot.SetActiveDOFValues(basevalues+delta*ones(robot.GetActiveDOF()))
+                    if env.CheckCollision(robot) or robot.CheckSelfCollision():
+                        continue
+                traj.Insert(traj.GetNumWaypoints(),basevalues+delta*ones(robot.GetActiveDOF()))
+            plannerparameters = '<_nrandomgeneratorseed>1234</_nrandomgeneratorseed><_nmaxiterations>60</_nmaxiterations><nshortcutthreads>4</nshortcutthreads>'
+            durations = []
+            for itry in range(2):
+                trajclone = RaveClone(traj,0)
+                ret=planningutils.SmoothActiveDOFTrajectory(trajclone,robot,plannername='parabolicsmoother2',plannerparameters=plannerparameters)
+                assert(ret==PlannerStatusCode.HasSolution)
+                durations.append(trajclone.GetDuration())
+            # same seed gives the same result regardless of thread scheduling
+            assert(abs(durations[0]-durations[1]) <= g_epsilon)
+
+            # the parallel result has to be as feasible as the sequential one
+            trajsequential = RaveClone(traj,0)
+            ret=planningutils.SmoothActiveDOFTrajectory(trajsequential,robot,plannername='parabolicsmoother2',plannerparameters=plannerparameters.replace('<nshortcutthreads>4</nshortcutthreads>',''))
+            assert(ret==PlannerStatusCode.HasSolution)
+            parameters = Planner.PlannerParameters()
+            parameters.SetRobotActiveJoints(robot)
+            for testtraj in [trajsequential,trajclone]:
+                planningutils.VerifyTrajectory(parameters,testtraj,samplingstep=0.002)
+                assert(transdist(testtraj.GetWaypoint(0,robot.GetActiveConfigurationSpecification()),traj.GetWaypoint(0)) <= g_epsilon)
+                assert(transdist(testtraj.GetWaypoint(-1,robot.GetActiveConfigurationSpecification()),traj.GetWaypoint(-1)) <= g_epsilon)
+            self.RunTrajectory(robot,trajclone)
+
     def test_multipleretiming(self):
         env=self.env
         env.Load('robots/barrettwam.robot.xml')
@@ -355,6 +423,35 @@ class TestTrajectory(EnvironmentSetup):
             assert(retimer.PlanPath(testtraj,True)==PlannerStatusCode.HasSolution)
             assert(abs(traj.GetDuration()-testtraj.GetDuration()) <= g_epsilon)
             planningutils.VerifyTrajectory(parameters,testtraj,samplingstep=0.002)
+            planningutils.VerifyTrajectoryParallel(parameters,testtraj,samplingstep=0.002,numthreads=3)
+
+            # a failing trajectory has to fail in the parallel check too
+            slowparameters = Planner.PlannerParameters(parameters)
+            slowparameters.SetConfigVelocityLimit(0.5*robot.GetActiveDOFMaxVel())
+            for numthreads in [1,3]:
+                try:
+                    planningutils.VerifyTrajectoryParallel(slowparameters,testtraj,samplingstep=0.002,numthreads=numthreads)
+                    raise ValueError('trajectory exceeding the velocity limits passed with %d threads'%numthreads)
+                except openrave_exception,e:
+                    pass
+
+            # custom constraints cannot be cloned, so the parallel check has to fall back to checking them serially
+            for maxvalue, bvalid in [(1.0,True),(0.25,False)]:
+                customparameters = Planner.PlannerParameters()
+                customparameters.SetRobotActiveJoints(robot)
+                numchecks = [0]
+                def checkfn(q0,q1,timeelapsed):
+                    numchecks[0] += 1
+                    return q1[0] <= maxvalue
+                customparameters.AddCheckPathConstraintsFunction(checkfn)
+                for numthreads in [1,3]:
+                    numchecks[0] = 0
+                    try:
+                        planningutils.VerifyTrajectoryParallel(customparameters,testtraj,samplingstep=0.002,numthreads=numthreads)
+                        assert(bvalid)
+                    except openrave_exception,e:
+                        assert(not bvalid)
+                    assert(numchecks[0] > 0)
             
             robot.SetActiveDOFs(range(7,11))
             traj = RaveCreateTrajectory(env,'')
@@ -394,6 +491,14 @@ class TestTrajectory(EnvironmentSetup):
         self.RunTrajectory(robot, traj)
         assert( abs(traj.GetDuration()-1.01688888888873) < g_epsilon)
         
+    def test_batchinterpolation(self):
+        env=self.env
+        planner=RaveCreatePlanner(env,'ParabolicTrajectoryRetimer2')
+        for ndof in [6,7,14]:
+            scalartime, batchtime, maxdiff = [float(f) for f in planner.SendCommand('BenchmarkInterpolation %d 200 5'%ndof).split()]
+            log.info('ndof=%d, scalar=%fs, batch=%fs', ndof, scalartime, batchtime)
+            assert(maxdiff < g_epsilon)
+
     def test_ikparamretiming(self):
         self.log.info('retime workspace ikparam')
         env=self.env